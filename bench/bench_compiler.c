@@ -0,0 +1,268 @@
+// bench/bench_compiler.c
+#define _POSIX_C_SOURCE 200809L   // clock_gettime(), open_memstream()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/lexer.h"
+#include "../src/parser.h"
+#include "../src/ast.h"
+#include "../src/semantic.h"
+#include "../src/ir.h"
+#include "../src/optimizer.h"
+#include "../src/codegen.h"
+#include "../src/utils.h"
+#include "generator.h"
+
+// Allocation counting: the benchmark is linked with --wrap for malloc,
+// calloc and realloc, so every call made by the compiler lands here first
+// (allocations inside libc, e.g. by stdio, are not seen)
+static size_t allocation_count;
+static size_t allocation_bytes;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    allocation_count++;
+    allocation_bytes += size;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    allocation_count++;
+    allocation_bytes += count * size;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+    allocation_count++;
+    allocation_bytes += size;
+    return __real_realloc(pointer, size);
+}
+
+// Measured phases, in pipeline order
+typedef enum {
+    BENCH_LEXER,          // lexer_next_token() until the end of input
+    BENCH_PARSER,         // parser_parse_program()
+    BENCH_SEMANTIC,       // semantic_analyze()
+    BENCH_IR,             // optimizer_optimize_ast(), ir_lower_program(), optimizer_optimize_ir()
+    BENCH_CODEGEN,        // codegen_program() into /dev/null
+    BENCH_PHASE_COUNT
+} bench_phase_t;
+
+static const char* const phase_names[BENCH_PHASE_COUNT] = {
+    "lexer", "parser", "semantic", "ir", "codegen"
+};
+
+// Totals of one phase over every iteration
+typedef struct {
+    double seconds;
+    size_t allocations;
+    size_t bytes;
+} bench_result_t;
+
+// Phase measurement in progress
+typedef struct {
+    double start;
+    size_t allocations;
+    size_t bytes;
+} bench_timer_t;
+
+static double bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static void bench_start(bench_timer_t* timer) {
+    timer->allocations = allocation_count;
+    timer->bytes = allocation_bytes;
+    timer->start = bench_now();
+}
+
+static void bench_stop(const bench_timer_t* timer, bench_result_t* result) {
+    result->seconds += bench_now() - timer->start;
+    result->allocations += allocation_count - timer->allocations;
+    result->bytes += allocation_bytes - timer->bytes;
+}
+
+// Helper: Run the pipeline once over source, adding each phase to results.
+// Returns 0 if the program does not compile.
+static int bench_iteration(const char* source, size_t length, const optimizer_options_t* optimizer,
+                           bench_result_t* results, size_t* tokens) {
+    bench_timer_t timer;
+    int success = 0;
+
+    bench_start(&timer);
+    lexer_t* lexer = lexer_create_from_buffer(source, length);
+    size_t count = 0;
+    if (lexer) {
+        token_t token = lexer_next_token(lexer);
+        while (token.type != TOKEN_EOF && token.type != TOKEN_ERROR) {
+            count++;
+            token = lexer_next_token(lexer);
+        }
+    }
+    lexer_destroy(lexer);
+    bench_stop(&timer, &results[BENCH_LEXER]);
+    *tokens = count;
+
+    lexer = lexer_create_from_buffer(source, length);
+    parser_t* parser = lexer ? parser_create(lexer) : NULL;
+    arena_t* arena = arena_create(0);
+    if (!parser || !arena) goto cleanup_parser;
+    parser_set_arena(parser, arena);
+
+    bench_start(&timer);
+    ast_node_t* ast = parser_parse_program(parser);
+    bench_stop(&timer, &results[BENCH_PARSER]);
+    if (!ast || parser_has_errors(parser)) goto cleanup_parser;
+
+    semantic_analyzer_t* analyzer = semantic_create();
+    if (!analyzer) goto cleanup_parser;
+    bench_start(&timer);
+    int analyzed = semantic_analyze(analyzer, ast) && !semantic_has_errors(analyzer);
+    bench_stop(&timer, &results[BENCH_SEMANTIC]);
+    if (!analyzed) goto cleanup_analyzer;
+
+    optimizer_stats_t optimizer_stats = {0};
+    bench_start(&timer);
+    optimizer_optimize_ast(ast, optimizer, &optimizer_stats);
+    ir_program_t* ir = ir_lower_program(ast);
+    optimizer_optimize_ir(ir, optimizer, &optimizer_stats);
+    bench_stop(&timer, &results[BENCH_IR]);
+    if (!ir) goto cleanup_analyzer;
+    if (ir->unresolved) {
+        ir_program_destroy(ir);
+        goto cleanup_analyzer;
+    }
+
+    codegen_t* codegen = codegen_create("/dev/null");
+    if (codegen) {
+        codegen->peephole = optimizer->level >= 1;
+        bench_start(&timer);
+        codegen_program(codegen, ir);
+        bench_stop(&timer, &results[BENCH_CODEGEN]);
+        success = !codegen->write_failed;
+        codegen_destroy(codegen);
+    }
+    ir_program_destroy(ir);
+
+cleanup_analyzer:
+    semantic_destroy(analyzer);
+cleanup_parser:
+    arena_destroy(arena);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+
+    // Every iteration starts with an empty interner, like a new compile
+    intern_reset();
+    return success;
+}
+
+static void print_usage(const char* program_name) {
+    printf("Usage: %s [options]\n", program_name);
+    printf("Times each compiler phase on a generated program (see gen_program).\n");
+    printf("Options:\n");
+    printf("  --iterations <n>  Compile the program n times (default: 5)\n");
+    printf("  -O0, -O1          Optimization level (default: -O1)\n");
+    printf("  --functions <n>, --depth <n>, --locals <n>, --nesting <n>, --seed <n>\n");
+    printf("                    Shape of the program, as for gen_program\n");
+    printf("  -h, --help        Show this help\n");
+}
+
+int main(int argc, char** argv) {
+    generator_options_t shape;
+    generator_options_init(&shape);
+    optimizer_options_t optimizer;
+    optimizer_options_init(&optimizer);
+    optimizer.level = 1;
+    long iterations = 5;
+
+    for (int i = 1; i < argc; i++) {
+        char* end = NULL;
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "-O0") == 0 || strcmp(argv[i], "-O1") == 0) {
+            optimizer.level = argv[i][2] - '0';
+        } else if (i + 1 < argc && argv[i][0] == '-' && argv[i][1] == '-') {
+            const char* option = argv[i];
+            long value = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || value < 0) {
+                fprintf(stderr, "Invalid value for %s: %s\n", option, argv[i]);
+                return 1;
+            }
+            if (strcmp(option, "--iterations") == 0 && value > 0) {
+                iterations = value;
+            } else if (strcmp(option, "--functions") == 0) {
+                shape.functions = (size_t)value;
+            } else if (strcmp(option, "--depth") == 0) {
+                shape.expression_depth = (int)value;
+            } else if (strcmp(option, "--locals") == 0) {
+                shape.locals = (int)value;
+            } else if (strcmp(option, "--nesting") == 0) {
+                shape.nesting = (int)value;
+            } else if (strcmp(option, "--seed") == 0) {
+                shape.seed = (unsigned int)value;
+            } else {
+                fprintf(stderr, "Unknown option: %s\n", option);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // The program is generated in memory; its own allocations don't count
+    char* source = NULL;
+    size_t length = 0;
+    FILE* stream = open_memstream(&source, &length);
+    if (!stream || !generator_write(stream, &shape) || fclose(stream) != 0) {
+        fprintf(stderr, "Error: Could not generate the program (invalid shape?)\n");
+        return 1;
+    }
+
+    size_t lines = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (source[i] == '\n') lines++;
+    }
+
+    printf("=== COMPILER BENCHMARK ===\n");
+    printf("Program: %zu functions, expression depth %d, %d locals, nesting %d\n",
+           shape.functions, shape.expression_depth, shape.locals, shape.nesting);
+    printf("Size: %zu lines, %.1f KB; -O%d, %ld iterations\n\n", lines, (double)length / 1024.0,
+           optimizer.level, iterations);
+
+    bench_result_t results[BENCH_PHASE_COUNT];
+    memset(results, 0, sizeof(results));
+    size_t tokens = 0;
+    for (long i = 0; i < iterations; i++) {
+        if (!bench_iteration(source, length, &optimizer, results, &tokens)) {
+            fprintf(stderr, "Error: The generated program did not compile\n");
+            free(source);
+            return 1;
+        }
+    }
+
+    printf("%-10s %10s %14s %14s %12s\n", "phase", "ms/iter", "lines/sec", "allocs/iter", "KB/iter");
+    double total = 0.0;
+    for (int phase = 0; phase < BENCH_PHASE_COUNT; phase++) {
+        const bench_result_t* result = &results[phase];
+        double seconds = result->seconds / (double)iterations;
+        total += seconds;
+        printf("%-10s %10.3f %14.0f %14zu %12.1f\n", phase_names[phase], seconds * 1000.0,
+               seconds > 0.0 ? (double)lines / seconds : 0.0, result->allocations / (size_t)iterations,
+               (double)result->bytes / 1024.0 / (double)iterations);
+    }
+    printf("%-10s %10.3f %14.0f\n", "total", total * 1000.0, total > 0.0 ? (double)lines / total : 0.0);
+    printf("\n%zu tokens: %.0f tokens/sec in the lexer\n", tokens,
+           results[BENCH_LEXER].seconds > 0.0 ? (double)tokens * (double)iterations / results[BENCH_LEXER].seconds : 0.0);
+
+    free(source);
+    return 0;
+}
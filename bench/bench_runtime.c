@@ -0,0 +1,405 @@
+// bench/bench_runtime.c
+#define _DEFAULT_SOURCE   // wait4(), syscall()
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <linux/perf_event.h>
+
+// Compilers and levels every kernel is built with
+typedef struct {
+    const char* compiler;     // "tcc" or "gcc"
+    const char* level;
+} bench_config_t;
+
+static const bench_config_t configs[] = {
+    {"tcc", "-O0"}, {"tcc", "-O1"}, {"gcc", "-O0"}, {"gcc", "-O2"}
+};
+
+#define CONFIG_COUNT (sizeof(configs) / sizeof(configs[0]))
+#define REFERENCE_CONFIG 2    // gcc -O0: the output every build must print
+#define BASELINE_CONFIG 3     // gcc -O2: the time the others are compared to
+
+// Hardware counters read with perf_event_open(), like 'perf stat'
+static const struct {
+    const char* name;
+    unsigned long long config;
+} counters[] = {
+    {"instructions", PERF_COUNT_HW_INSTRUCTIONS},
+    {"cycles", PERF_COUNT_HW_CPU_CYCLES},
+    {"branches", PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {"branch_misses", PERF_COUNT_HW_BRANCH_MISSES}
+};
+
+#define COUNTER_COUNT (sizeof(counters) / sizeof(counters[0]))
+
+// Fastest run of one kernel built one way
+typedef struct {
+    int built;
+    int ran;                  // Every run exited with status 0
+    int output_matches;       // Printed the same as REFERENCE_CONFIG
+    char* output;             // Owned
+    size_t output_length;
+
+    double wall_seconds;
+    double user_seconds;
+    double system_seconds;
+    long max_rss_kb;
+    long minor_faults;
+    long context_switches;
+    int counter_valid[COUNTER_COUNT];   // 0 where the kernel or the machine has no such counter
+    unsigned long long counter_values[COUNTER_COUNT];
+} bench_measurement_t;
+
+// Harness settings
+typedef struct {
+    const char* tcc;
+    const char* cc;
+    const char* runtime;      // Prebuilt runtime object linked into every kernel
+    const char* work_dir;
+    int runs;
+} bench_options_t;
+
+static double bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// Helper: File name of path without directories and extension
+static void bench_kernel_name(const char* path, char* name, size_t size) {
+    const char* slash = strrchr(path, '/');
+    const char* start = slash ? slash + 1 : path;
+    const char* dot = strrchr(start, '.');
+    size_t length = dot ? (size_t)(dot - start) : strlen(start);
+    snprintf(name, size, "%.*s", (int)length, start);
+}
+
+// Helper: Build kernel into executable with config; 1 on success (0 also
+// when the paths do not fit in the command)
+static int bench_build(const bench_options_t* options, const char* kernel, const bench_config_t* config,
+                       const char* executable) {
+    char command[4096];
+    int length;
+    if (strcmp(config->compiler, "tcc") == 0) {
+        // tcc writes the object; gcc only links it with the runtime
+        length = snprintf(command, sizeof(command),
+                          "%s %s -c -o %s.o %s > /dev/null && %s -m64 -no-pie %s.o %s -o %s", options->tcc,
+                          config->level, executable, kernel, options->cc, executable, options->runtime,
+                          executable);
+    } else {
+        // TinyC is a subset of C, so the same source is the C version
+        length = snprintf(command, sizeof(command), "%s -m64 -no-pie %s -w -x c %s -x none %s -o %s",
+                          options->cc, config->level, kernel, options->runtime, executable);
+    }
+    if (length < 0 || (size_t)length >= sizeof(command)) return 0;
+    return system(command) == 0;
+}
+
+// Helper: Counter of the process that pid will exec, counting from the exec
+static int bench_open_counter(pid_t pid, unsigned long long config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.enable_on_exec = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, pid, -1, -1, 0);
+}
+
+// Helper: Run executable once with its output captured; 1 if it exited with 0
+static int bench_run_once(const char* executable, bench_measurement_t* run) {
+    int start_pipe[2], output_pipe[2];
+    if (pipe(start_pipe) != 0) return 0;
+    if (pipe(output_pipe) != 0) {
+        close(start_pipe[0]);
+        close(start_pipe[1]);
+        return 0;
+    }
+
+    // The child waits until its counters are attached before it execs
+    pid_t pid = fork();
+    if (pid == 0) {
+        char byte;
+        close(start_pipe[1]);
+        close(output_pipe[0]);
+        dup2(output_pipe[1], STDOUT_FILENO);
+        close(output_pipe[1]);
+        if (read(start_pipe[0], &byte, 1) != 1) _exit(127);
+        close(start_pipe[0]);
+        execl(executable, executable, (char*)NULL);
+        _exit(127);
+    }
+    close(start_pipe[0]);
+    close(output_pipe[1]);
+    if (pid < 0) {
+        close(start_pipe[1]);
+        close(output_pipe[0]);
+        return 0;
+    }
+
+    int counter_fds[COUNTER_COUNT];
+    for (size_t c = 0; c < COUNTER_COUNT; c++) {
+        counter_fds[c] = bench_open_counter(pid, counters[c].config);
+    }
+
+    double start = bench_now();
+    int started = write(start_pipe[1], "x", 1) == 1;
+    close(start_pipe[1]);
+
+    size_t capacity = 0;
+    run->output = NULL;
+    run->output_length = 0;
+    for (;;) {
+        if (run->output_length == capacity) {
+            capacity = capacity ? capacity * 2 : 4096;
+            char* grown = realloc(run->output, capacity);
+            if (!grown) break;
+            run->output = grown;
+        }
+        ssize_t count = read(output_pipe[0], run->output + run->output_length, capacity - run->output_length);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) break;
+        run->output_length += (size_t)count;
+    }
+    close(output_pipe[0]);
+
+    int status = 0;
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {
+    }
+    run->wall_seconds = bench_now() - start;
+
+    run->user_seconds = (double)usage.ru_utime.tv_sec + (double)usage.ru_utime.tv_usec / 1e6;
+    run->system_seconds = (double)usage.ru_stime.tv_sec + (double)usage.ru_stime.tv_usec / 1e6;
+    run->max_rss_kb = usage.ru_maxrss;
+    run->minor_faults = usage.ru_minflt;
+    run->context_switches = usage.ru_nvcsw + usage.ru_nivcsw;
+
+    for (size_t c = 0; c < COUNTER_COUNT; c++) {
+        unsigned long long value = 0;
+        run->counter_valid[c] = counter_fds[c] >= 0 && read(counter_fds[c], &value, sizeof(value)) == sizeof(value);
+        run->counter_values[c] = value;
+        if (counter_fds[c] >= 0) close(counter_fds[c]);
+    }
+
+    return started && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Helper: Build and run kernel with config, keeping the fastest of the runs
+static void bench_measure(const bench_options_t* options, const char* kernel, const char* name,
+                          size_t config_index, bench_measurement_t* result) {
+    const bench_config_t* config = &configs[config_index];
+    char executable[2048];
+    int length = snprintf(executable, sizeof(executable), "%s/%s.%s%s", options->work_dir, name,
+                          config->compiler, config->level);
+
+    memset(result, 0, sizeof(*result));
+    if (length < 0 || (size_t)length >= sizeof(executable)) return;
+    result->built = bench_build(options, kernel, config, executable);
+    if (!result->built) return;
+
+    result->ran = 1;
+    for (int r = 0; r < options->runs; r++) {
+        bench_measurement_t run;
+        memset(&run, 0, sizeof(run));
+        if (!bench_run_once(executable, &run)) result->ran = 0;
+
+        // Every run must print the same; the fastest one is kept
+        if (r > 0 && (run.output_length != result->output_length ||
+                      memcmp(run.output, result->output, run.output_length) != 0)) {
+            result->ran = 0;
+        }
+        if (r == 0 || run.wall_seconds < result->wall_seconds) {
+            free(result->output);
+            run.built = result->built;
+            run.ran = result->ran;
+            *result = run;
+        } else {
+            free(run.output);
+        }
+    }
+}
+
+// Helper: Text table of one kernel
+static void bench_print(const char* name, const bench_measurement_t* results) {
+    const bench_measurement_t* baseline = &results[BASELINE_CONFIG];
+    for (size_t i = 0; i < CONFIG_COUNT; i++) {
+        const bench_measurement_t* result = &results[i];
+        printf("%-12s %s %-4s", name, configs[i].compiler, configs[i].level);
+        if (!result->built) {
+            printf(" %10s\n", "build failed");
+            continue;
+        }
+        printf(" %10.2f", result->wall_seconds * 1000.0);
+        if (baseline->ran && baseline->wall_seconds > 0.0) {
+            printf(" %8.2fx", result->wall_seconds / baseline->wall_seconds);
+        } else {
+            printf(" %9s", "n/a");
+        }
+        if (result->counter_valid[0]) {
+            printf(" %15llu", result->counter_values[0]);
+        } else {
+            printf(" %15s", "n/a");
+        }
+        printf(" %8ld  %s\n", result->max_rss_kb,
+               !result->ran ? "FAILED" : result->output_matches ? "ok" : "WRONG OUTPUT");
+    }
+}
+
+// Helper: One kernel as a JSON object
+static void bench_write_json(FILE* output, const char* name, const bench_measurement_t* results) {
+    fprintf(output, "    {\n      \"name\": \"%s\",\n      \"results\": [", name);
+    for (size_t i = 0; i < CONFIG_COUNT; i++) {
+        const bench_measurement_t* result = &results[i];
+        fprintf(output, "%s\n        {\"compiler\": \"%s\", \"level\": \"%s\", \"built\": %s, \"ran\": %s, "
+                "\"output_matches\": %s",
+                i == 0 ? "" : ",", configs[i].compiler, configs[i].level, result->built ? "true" : "false",
+                result->ran ? "true" : "false", result->output_matches ? "true" : "false");
+        if (result->built) {
+            fprintf(output, ", \"wall_seconds\": %.6f, \"user_seconds\": %.6f, \"system_seconds\": %.6f, "
+                    "\"max_rss_kb\": %ld, \"minor_faults\": %ld, \"context_switches\": %ld",
+                    result->wall_seconds, result->user_seconds, result->system_seconds, result->max_rss_kb,
+                    result->minor_faults, result->context_switches);
+            for (size_t c = 0; c < COUNTER_COUNT; c++) {
+                if (result->counter_valid[c]) {
+                    fprintf(output, ", \"%s\": %llu", counters[c].name, result->counter_values[c]);
+                } else {
+                    fprintf(output, ", \"%s\": null", counters[c].name);
+                }
+            }
+        }
+        fprintf(output, "}");
+    }
+    fprintf(output, "\n      ]\n    }");
+}
+
+static void print_usage(const char* program_name) {
+    printf("Usage: %s [options] <kernel.tc>...\n", program_name);
+    printf("Builds each kernel with tcc -O0/-O1 and gcc -O0/-O2, runs every build and\n");
+    printf("compares their times, hardware counters and output.\n");
+    printf("Options:\n");
+    printf("  --tcc <path>      TinyC compiler (default: build/tcc)\n");
+    printf("  --cc <path>       C compiler and linker (default: gcc)\n");
+    printf("  --runtime <file>  Runtime object to link (default: build/runtime.o)\n");
+    printf("  --work-dir <dir>  Where the executables go (default: build/bench/kernels)\n");
+    printf("  --runs <n>        Runs of each build; the fastest counts (default: 5)\n");
+    printf("  --json <file>     Also write the results as JSON ('-' for stdout)\n");
+    printf("  -h, --help        Show this help\n");
+}
+
+int main(int argc, char** argv) {
+    bench_options_t options = {"build/tcc", "gcc", "build/runtime.o", "build/bench/kernels", 5};
+    const char* json_file = NULL;
+    const char** kernels = calloc((size_t)argc, sizeof(char*));
+    size_t kernel_count = 0;
+    if (!kernels) return 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            free(kernels);
+            return 0;
+        } else if (strcmp(argv[i], "--tcc") == 0 && i + 1 < argc) {
+            options.tcc = argv[++i];
+        } else if (strcmp(argv[i], "--cc") == 0 && i + 1 < argc) {
+            options.cc = argv[++i];
+        } else if (strcmp(argv[i], "--runtime") == 0 && i + 1 < argc) {
+            options.runtime = argv[++i];
+        } else if (strcmp(argv[i], "--work-dir") == 0 && i + 1 < argc) {
+            options.work_dir = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_file = argv[++i];
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            char* end;
+            long runs = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || runs < 1 || runs > 1000) {
+                fprintf(stderr, "Invalid run count: %s\n", argv[i]);
+                free(kernels);
+                return 1;
+            }
+            options.runs = (int)runs;
+        } else if (argv[i][0] != '-') {
+            kernels[kernel_count++] = argv[i];
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            free(kernels);
+            return 1;
+        }
+    }
+    if (kernel_count == 0) {
+        print_usage(argv[0]);
+        free(kernels);
+        return 1;
+    }
+    mkdir(options.work_dir, 0755);
+
+    bench_measurement_t* results = calloc(kernel_count * CONFIG_COUNT, sizeof(bench_measurement_t));
+    char (*names)[256] = calloc(kernel_count, sizeof(*names));
+    if (!results || !names) {
+        free(results);
+        free(names);
+        free(kernels);
+        return 1;
+    }
+
+    printf("=== GENERATED CODE BENCHMARK (fastest of %d runs) ===\n", options.runs);
+    printf("%-12s %-8s %10s %9s %15s %8s  %s\n", "kernel", "build", "wall ms", "vs -O2", "instructions",
+           "RSS KB", "output");
+
+    int failures = 0;
+    for (size_t k = 0; k < kernel_count; k++) {
+        bench_measurement_t* kernel_results = &results[k * CONFIG_COUNT];
+        bench_kernel_name(kernels[k], names[k], sizeof(names[k]));
+        for (size_t i = 0; i < CONFIG_COUNT; i++) {
+            bench_measure(&options, kernels[k], names[k], i, &kernel_results[i]);
+        }
+
+        // A wrong answer from either compiler is a failure, not a data point
+        const bench_measurement_t* reference = &kernel_results[REFERENCE_CONFIG];
+        for (size_t i = 0; i < CONFIG_COUNT; i++) {
+            bench_measurement_t* result = &kernel_results[i];
+            result->output_matches = result->ran && reference->ran &&
+                                     result->output_length == reference->output_length &&
+                                     memcmp(result->output, reference->output, result->output_length) == 0;
+            if (!result->output_matches) failures++;
+        }
+        bench_print(names[k], kernel_results);
+    }
+
+    if (json_file) {
+        FILE* output = strcmp(json_file, "-") == 0 ? stdout : fopen(json_file, "w");
+        if (output) {
+            fprintf(output, "{\n  \"runs\": %d,\n  \"kernels\": [", options.runs);
+            for (size_t k = 0; k < kernel_count; k++) {
+                fprintf(output, "%s\n", k == 0 ? "" : ",");
+                bench_write_json(output, names[k], &results[k * CONFIG_COUNT]);
+            }
+            fprintf(output, "\n  ]\n}\n");
+        }
+        int written = output && !ferror(output);
+        if (output && output != stdout && fclose(output) != 0) written = 0;
+        if (!written) {
+            fprintf(stderr, "Error: Could not write results to '%s'\n", json_file);
+            failures++;
+        }
+    }
+
+    for (size_t i = 0; i < kernel_count * CONFIG_COUNT; i++) {
+        free(results[i].output);
+    }
+    free(results);
+    free(names);
+    free(kernels);
+    return failures > 0;
+}
@@ -0,0 +1,72 @@
+// bench/gen_program.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "generator.h"
+
+static void print_usage(const char* program_name) {
+    generator_options_t defaults;
+    generator_options_init(&defaults);
+
+    printf("Usage: %s [options]\n", program_name);
+    printf("Writes a synthetic TinyC program for benchmarking the compiler.\n");
+    printf("Options:\n");
+    printf("  -o <file>         Output file (default: stdout)\n");
+    printf("  --functions <n>   Number of functions (default: %zu)\n", defaults.functions);
+    printf("  --depth <n>       Expression depth, 2^n operands each (default: %d)\n", defaults.expression_depth);
+    printf("  --locals <n>      Locals per function (default: %d)\n", defaults.locals);
+    printf("  --nesting <n>     Depth of nested if/for/while blocks (default: %d)\n", defaults.nesting);
+    printf("  --seed <n>        Random seed (default: %u)\n", defaults.seed);
+    printf("  -h, --help        Show this help\n");
+}
+
+// Helper: Parse a number option in [0, max]; returns 0 if it is not one
+static int parse_count(const char* text, unsigned long max, unsigned long* value) {
+    char* end;
+    *value = strtoul(text, &end, 10);
+    return text[0] != '\0' && text[0] != '-' && *end == '\0' && *value <= max;
+}
+
+int main(int argc, char** argv) {
+    generator_options_t options;
+    generator_options_init(&options);
+    const char* output_file = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        unsigned long value;
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (strcmp(argv[i], "--functions") == 0 && i + 1 < argc && parse_count(argv[++i], 10000000, &value)) {
+            options.functions = value;
+        } else if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc && parse_count(argv[++i], 16, &value)) {
+            options.expression_depth = (int)value;
+        } else if (strcmp(argv[i], "--locals") == 0 && i + 1 < argc && parse_count(argv[++i], 10000, &value)) {
+            options.locals = (int)value;
+        } else if (strcmp(argv[i], "--nesting") == 0 && i + 1 < argc && parse_count(argv[++i], 16, &value)) {
+            options.nesting = (int)value;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc && parse_count(argv[++i], 0xffffffffUL, &value)) {
+            options.seed = (unsigned int)value;
+        } else {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    FILE* output = output_file ? fopen(output_file, "w") : stdout;
+    if (!output) {
+        fprintf(stderr, "Error: Could not create output file '%s'\n", output_file);
+        return 1;
+    }
+
+    int success = generator_write(output, &options);
+    if (output != stdout && fclose(output) != 0) success = 0;
+    if (!success) {
+        fprintf(stderr, "Error: Could not write the program\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+// bench/generator.c
+#include "generator.h"
+
+// Largest expression depth and nesting accepted (programs grow as 2^n)
+#define GENERATOR_MAX_DEPTH 16
+
+// Binary operators; the last two only get positive literal divisors
+static const char* const binary_operators[] = {
+    "+", "-", "*", "<", ">=", "==", "!=", "&&", "||", "/", "%"
+};
+
+#define OPERATOR_COUNT (sizeof(binary_operators) / sizeof(binary_operators[0]))
+#define DIVISION_OPERATORS 2
+
+// Generator state
+typedef struct {
+    FILE* output;
+    const generator_options_t* options;
+    unsigned int state;       // xorshift32
+} generator_t;
+
+void generator_options_init(generator_options_t* options) {
+    options->functions = 500;
+    options->expression_depth = 3;
+    options->locals = 8;
+    options->nesting = 3;
+    options->seed = 1;
+}
+
+// Helper: Pseudo-random number below bound
+static unsigned int generator_random(generator_t* generator, unsigned int bound) {
+    unsigned int x = generator->state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    generator->state = x;
+    return x % bound;
+}
+
+static void generator_indent(generator_t* generator, int indent) {
+    fprintf(generator->output, "%*s", indent * 4, "");
+}
+
+// Helper: A parameter, one of the first available locals, or a literal
+static void generator_operand(generator_t* generator, int available) {
+    unsigned int choice = generator_random(generator, (unsigned int)available + 3);
+    switch (choice) {
+        case 0: fputc('a', generator->output); break;
+        case 1: fputc('b', generator->output); break;
+        case 2: fprintf(generator->output, "%u", generator_random(generator, 100)); break;
+        default: fprintf(generator->output, "v%u", choice - 3); break;
+    }
+}
+
+// Helper: Full expression tree of the given depth
+static void generator_expression(generator_t* generator, int depth, int available) {
+    if (depth == 0) {
+        generator_operand(generator, available);
+        return;
+    }
+
+    if (generator_random(generator, 8) == 0) fputc('-', generator->output);
+
+    unsigned int op = generator_random(generator, OPERATOR_COUNT);
+    fputc('(', generator->output);
+    generator_expression(generator, depth - 1, available);
+    if (op >= OPERATOR_COUNT - DIVISION_OPERATORS) {
+        fprintf(generator->output, " %s %u)", binary_operators[op], generator_random(generator, 8) + 2);
+        return;
+    }
+    fprintf(generator->output, " %s ", binary_operators[op]);
+    generator_expression(generator, depth - 1, available);
+    fputc(')', generator->output);
+}
+
+// Helper: Two assignments and, above nesting 0, one if/else, for or while
+// whose bodies nest one level less. Loops run three times.
+static void generator_statements(generator_t* generator, int indent, int nesting) {
+    const generator_options_t* options = generator->options;
+    FILE* output = generator->output;
+
+    for (int i = 0; i < 2; i++) {
+        generator_indent(generator, indent);
+        if (options->locals > 0) {
+            fprintf(output, "v%u = ", generator_random(generator, (unsigned int)options->locals));
+        } else {
+            fprintf(output, "a = ");
+        }
+        generator_expression(generator, options->expression_depth, options->locals);
+        fprintf(output, ";\n");
+    }
+    if (nesting == 0) return;
+
+    generator_indent(generator, indent);
+    switch (generator_random(generator, 3)) {
+        case 0:
+            fprintf(output, "if (");
+            generator_expression(generator, options->expression_depth, options->locals);
+            fprintf(output, ") {\n");
+            generator_statements(generator, indent + 1, nesting - 1);
+            generator_indent(generator, indent);
+            fprintf(output, "} else {\n");
+            generator_statements(generator, indent + 1, nesting - 1);
+            break;
+
+        case 1:
+            // Counters are named after the nesting level, so nested loops differ
+            fprintf(output, "for (int i%d = 0; i%d < 3; i%d = i%d + 1) {\n", nesting, nesting, nesting, nesting);
+            generator_statements(generator, indent + 1, nesting - 1);
+            break;
+
+        default:
+            fprintf(output, "int w%d = 0;\n", nesting);
+            generator_indent(generator, indent);
+            fprintf(output, "while (w%d < 3) {\n", nesting);
+            generator_indent(generator, indent + 1);
+            fprintf(output, "w%d = w%d + 1;\n", nesting, nesting);
+            generator_statements(generator, indent + 1, nesting - 1);
+            break;
+    }
+    generator_indent(generator, indent);
+    fprintf(output, "}\n");
+}
+
+int generator_write(FILE* output, const generator_options_t* options) {
+    if (options->expression_depth < 0 || options->expression_depth > GENERATOR_MAX_DEPTH ||
+        options->nesting < 0 || options->nesting > GENERATOR_MAX_DEPTH || options->locals < 0) {
+        return 0;
+    }
+
+    generator_t generator = {output, options, options->seed ? options->seed : 1};
+
+    fprintf(output, "// Generated program: %zu functions, expression depth %d, %d locals, nesting %d, seed %u\n\n",
+            options->functions, options->expression_depth, options->locals, options->nesting, options->seed);
+    fprintf(output, "void print_int(int x);\n\n");
+
+    for (size_t f = 0; f < options->functions; f++) {
+        fprintf(output, "int f%zu(int a, int b) {\n", f);
+        for (int v = 0; v < options->locals; v++) {
+            fprintf(output, "    int v%d = ", v);
+            generator_expression(&generator, options->expression_depth, v);
+            fprintf(output, ";\n");
+        }
+        generator_statements(&generator, 1, options->nesting);
+
+        fprintf(output, "    return ");
+        generator_expression(&generator, options->expression_depth, options->locals);
+        if (f > 0) {
+            fprintf(output, " + f%zu(", f - 1);
+            generator_operand(&generator, options->locals);
+            fprintf(output, ", ");
+            generator_operand(&generator, options->locals);
+            fputc(')', output);
+        }
+        fprintf(output, ";\n}\n\n");
+    }
+
+    fprintf(output, "int main() {\n");
+    if (options->functions > 0) {
+        fprintf(output, "    print_int(f%zu(1, 2));\n", options->functions - 1);
+    }
+    fprintf(output, "    return 0;\n}\n");
+
+    return !ferror(output);
+}
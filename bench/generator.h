@@ -0,0 +1,30 @@
+// bench/generator.h
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Shape of a generated program
+typedef struct {
+    size_t functions;       // Functions besides main; each calls the one before it
+    int expression_depth;   // Depth of every expression tree (2^depth operands)
+    int locals;             // Locals declared at the top of each function
+    int nesting;            // Depth of nested if/for/while blocks in each body
+    unsigned int seed;      // Same seed and shape, same program
+} generator_options_t;
+
+// Defaults used by 'make bench'
+void generator_options_init(generator_options_t* options);
+
+/**
+ * @brief Writes a valid TinyC program with the given shape
+ *
+ * Operands are random parameters, locals and literals; division only by
+ * positive literals and bounded loops keep the program safe to run.
+ *
+ * @return int 1 on success, 0 on invalid options or a write error
+ */
+int generator_write(FILE* output, const generator_options_t* options);
+
+#endif // GENERATOR_H
@@ -0,0 +1,165 @@
+    # Generated by TinyC Compiler
+.section .text
+.global classify
+classify:
+    pushq %rdi
+    pushq %rsi
+    popq %rsi
+    popq %rcx
+    movq $0, %rdi
+    cmpq %rdi, %rcx
+    jle .Lclassify.0
+    movq $10, %rdi
+    cmpq %rdi, %rsi
+    jl .Lclassify.1
+    cmpq %rsi, %rcx
+    je .Lclassify.0
+.Lclassify.1:
+    movq $1, %rdi
+    movq %rdi, %rax
+    jmp .Lclassify.return
+.Lclassify.0:
+    movq $0, %rdi
+    cmpq %rdi, %rcx
+    je .Lclassify.3
+    movq $0, %rcx
+    cmpq %rcx, %rsi
+    jne .Lclassify.2
+.Lclassify.3:
+    movq $2, %rcx
+    movq %rcx, %rax
+    jmp .Lclassify.return
+.Lclassify.2:
+    movq $3, %rcx
+    movq %rcx, %rax
+    jmp .Lclassify.return
+    movq $0, %rax
+.Lclassify.return:
+    ret
+
+.global count
+count:
+    pushq %rbp
+    movq %rsp, %rbp
+    pushq %rbx
+    subq $8, %rsp
+    movq %rdi, %rbx
+    movq %rbx, %rdi
+    call print_int
+    movq %rbx, %rax
+    jmp .Lcount.return
+    movq $0, %rax
+.Lcount.return:
+    leaq -8(%rbp), %rsp
+    popq %rbx
+    popq %rbp
+    ret
+
+.global main
+main:
+    pushq %rbp
+    movq %rsp, %rbp
+    pushq %rbx
+    subq $8, %rsp
+    movq $0, %rcx
+    movq %rcx, %rbx
+    movq $4, %rcx
+    movq $2, %rsi
+    pushq %rcx
+    pushq %rsi
+    popq %rsi
+    popq %rdi
+    call classify
+    movslq %eax, %rax
+    movq %rax, %rdi
+    movq %rdi, %rdi
+    call print_int
+    movq $1, %rcx
+    movq %rcx, %rsi
+    negq %rsi
+    movq $10, %rcx
+    pushq %rsi
+    pushq %rcx
+    popq %rsi
+    popq %rdi
+    call classify
+    movslq %eax, %rax
+    movq %rax, %rdi
+    movq %rdi, %rdi
+    call print_int
+    movq $0, %rcx
+    movq $20, %rsi
+    pushq %rcx
+    pushq %rsi
+    popq %rsi
+    popq %rdi
+    call classify
+    movslq %eax, %rax
+    movq %rax, %rdi
+    movq %rdi, %rdi
+    call print_int
+    movq $0, %rcx
+    cmpq %rcx, %rbx
+    jle .Lmain.0
+    movq $7, %rcx
+    movq %rcx, %rdi
+    call count
+    movslq %eax, %rax
+    movq %rax, %rsi
+    testq %rsi, %rsi
+    je .Lmain.0
+    movq $100, %rcx
+    movq %rcx, %rbx
+.Lmain.0:
+    movq $0, %rcx
+    cmpq %rcx, %rbx
+    je .Lmain.2
+    movq $8, %rcx
+    movq %rcx, %rdi
+    call count
+    movslq %eax, %rax
+    movq %rax, %rsi
+    testq %rsi, %rsi
+    je .Lmain.1
+.Lmain.2:
+    movq $1, %rcx
+    movq %rbx, %rsi
+    addq %rcx, %rsi
+    movq %rsi, %rbx
+.Lmain.1:
+    movq $0, %rcx
+    movq %rcx, %rsi
+.Lmain.3:
+    movq $4, %rcx
+    cmpq %rcx, %rsi
+    jge .Lmain.4
+    movq $9, %rcx
+    cmpq %rcx, %rsi
+    je .Lmain.4
+    movq $2, %rcx
+    movq %rbx, %rdi
+    addq %rcx, %rdi
+    movq %rdi, %rbx
+    movq $1, %rcx
+    movq %rsi, %rdi
+    addq %rcx, %rdi
+    movq %rdi, %rsi
+    jmp .Lmain.3
+.Lmain.4:
+    movq $0, %rcx
+    movq %rcx, %rdi
+    call print_int
+    movq $4, %rcx
+    movq %rbx, %rsi
+    subq %rcx, %rsi
+    movq %rsi, %rdi
+    call print_int
+    movq %rbx, %rax
+    jmp .Lmain.return
+    movq $0, %rax
+.Lmain.return:
+    leaq -8(%rbp), %rsp
+    popq %rbx
+    popq %rbp
+    ret
+
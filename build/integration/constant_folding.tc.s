@@ -0,0 +1,8 @@
+    # Generated by TinyC Compiler
+.section .text
+.global main
+main:
+    movq $33, %rax
+.Lmain.return:
+    ret
+
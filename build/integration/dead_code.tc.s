@@ -0,0 +1,13 @@
+    # Generated by TinyC Compiler
+.section .text
+.global main
+main:
+    pushq %rbp
+    movq %rsp, %rbp
+    movq $7, %rdi
+    call print_int
+    movq $0, %rax
+.Lmain.return:
+    popq %rbp
+    ret
+
@@ -0,0 +1,208 @@
+    # Generated by TinyC Compiler
+.section .text
+.global id
+id:
+    movq %rdi, %rcx
+    movq %rcx, %rax
+    jmp .Lid.return
+    movq $0, %rax
+.Lid.return:
+    ret
+
+.global weigh
+weigh:
+    pushq %rbp
+    movq %rsp, %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    subq $8, %rsp
+    pushq %rdi
+    pushq %rsi
+    pushq %rdx
+    pushq %rcx
+    pushq %r8
+    pushq %r9
+    popq %r10
+    popq %r9
+    popq %r8
+    popq %rdi
+    popq %rsi
+    popq %rcx
+    movq 16(%rbp), %r11
+    movq 24(%rbp), %rbx
+    movq $2, %r12
+    movq %rsi, %r13
+    imulq %r12, %r13
+    movq %rcx, %rsi
+    addq %r13, %rsi
+    movq %rsi, %rcx
+    addq %rdi, %rcx
+    movq %rcx, %rsi
+    addq %r8, %rsi
+    movq %rsi, %rcx
+    addq %r9, %rcx
+    movq %rcx, %rsi
+    addq %r10, %rsi
+    movq $3, %rcx
+    movq %r11, %rdi
+    imulq %rcx, %rdi
+    movq %rsi, %rcx
+    addq %rdi, %rcx
+    movq %rcx, %rsi
+    addq %rbx, %rsi
+    movq %rsi, %rax
+    jmp .Lweigh.return
+    movq $0, %rax
+.Lweigh.return:
+    leaq -24(%rbp), %rsp
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+
+.global main
+main:
+    pushq %rbp
+    movq %rsp, %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $8, %rsp
+    movq $5, %rcx
+    movq %rcx, %rdi
+    call id
+    movslq %eax, %rax
+    movq %rax, %rsi
+    movq %rsi, %rbx
+    movq $7, %rcx
+    movq %rcx, %rdi
+    call id
+    movslq %eax, %rax
+    movq %rax, %rsi
+    movq %rsi, %r12
+    movq $9, %rcx
+    movq %rcx, %rdi
+    call id
+    movslq %eax, %rax
+    movq %rax, %rsi
+    movq %rsi, %r13
+    movq $1, %rcx
+    movq $2, %rsi
+    movq $3, %rdi
+    movq $4, %r8
+    movq $5, %r9
+    movq $6, %r10
+    movq $7, %r11
+    movq $8, %r14
+    pushq %r14
+    pushq %r11
+    pushq %rcx
+    pushq %rsi
+    pushq %rdi
+    pushq %r8
+    pushq %r9
+    pushq %r10
+    popq %r9
+    popq %r8
+    popq %rcx
+    popq %rdx
+    popq %rsi
+    popq %rdi
+    call weigh
+    addq $16, %rsp
+    movslq %eax, %rax
+    movq %rax, %r15
+    movq %r15, %r14
+    movq %r14, %rdi
+    call print_int
+    pushq %r12
+    pushq %rbx
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    popq %r9
+    popq %r8
+    popq %rcx
+    popq %rdx
+    popq %rsi
+    popq %rdi
+    call weigh
+    addq $16, %rsp
+    movslq %eax, %rax
+    movq %rax, %rcx
+    movq %rcx, %rsi
+    addq %rbx, %rsi
+    movq %rsi, %rcx
+    addq %r12, %rcx
+    movq %rcx, %rsi
+    addq %r13, %rsi
+    movq %rsi, %rdi
+    call print_int
+    movq $1, %r15
+    movq $1, %rcx
+    movq $1, %rsi
+    movq $1, %rdi
+    movq $1, %r8
+    movq $1, %r9
+    pushq %rcx
+    pushq %rsi
+    pushq %rdi
+    pushq %r8
+    pushq %r9
+    subq $8, %rsp
+    movq %r14, %rdi
+    call id
+    addq $8, %rsp
+    movslq %eax, %rax
+    popq %r9
+    popq %r8
+    popq %rdi
+    popq %rsi
+    popq %rcx
+    movq %rax, %r10
+    pushq %r10
+    pushq %r9
+    pushq %r14
+    pushq %r15
+    pushq %rcx
+    pushq %rsi
+    pushq %rdi
+    pushq %r8
+    popq %r9
+    popq %r8
+    popq %rcx
+    popq %rdx
+    popq %rsi
+    popq %rdi
+    call weigh
+    addq $16, %rsp
+    movslq %eax, %rax
+    movq %rax, %r11
+    movq %r11, %rdi
+    call print_int
+    movq %r14, %rcx
+    addq %rbx, %rcx
+    movq %rcx, %rsi
+    addq %r12, %rsi
+    movq %rsi, %rcx
+    addq %r13, %rcx
+    movq %rcx, %rax
+    jmp .Lmain.return
+    movq $0, %rax
+.Lmain.return:
+    leaq -40(%rbp), %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+
@@ -0,0 +1,72 @@
+    # Generated by TinyC Compiler
+.section .text
+.global scale
+scale:
+    movq %rdi, %rcx
+    imulq $100000, %rcx, %rsi
+    movq %rsi, %rax
+.Lscale.return:
+    ret
+
+.global bump
+bump:
+    movq %rdi, %rsi
+    addq $1, %rsi
+    movq %rsi, %rax
+.Lbump.return:
+    ret
+
+.global main
+main:
+    pushq %rbp
+    movq %rsp, %rbp
+    pushq %rbx
+    pushq %r12
+    movq $0, %rcx
+.Lmain.5:
+    movq %rcx, %rsi
+    addq $1, %rsi
+    movq %rsi, %rbx
+    addq $1, %rcx
+    cmpq $100000, %rcx
+    jl .Lmain.5
+    movq %rbx, %rcx
+    imulq $100000, %rcx, %rsi
+    movq %rsi, %rax
+    movslq %eax, %rax
+    movq %rax, %rcx
+    movq $100000, %rsi
+    movq %rcx, %rax
+    cqto
+    idivq %rsi
+    movq %rax, %r12
+    movq %rbx, %rcx
+    imulq $100000, %rcx, %rsi
+    movq %rsi, %rax
+    movslq %eax, %rax
+    movq %rax, %rdi
+    call print_int
+    movq %r12, %rdi
+    call print_int
+    movq $100000, %rcx
+    movq %rbx, %rax
+    cqto
+    idivq %rcx
+    movq %rax, %rcx
+    addq $2147483646, %rcx
+    addq $1, %rcx
+    movq %rcx, %rax
+    movslq %eax, %rax
+    movq %rax, %rdi
+    call print_int
+    movq $256, %rcx
+    movq %r12, %rax
+    cqto
+    idivq %rcx
+    movq %rdx, %rax
+.Lmain.return:
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+
@@ -0,0 +1,101 @@
+    # Generated by TinyC Compiler
+.section .text
+.global abs_value
+abs_value:
+    movq %rdi, %rcx
+    cmpq $0, %rcx
+    jge .Labs_value.0
+    movq %rcx, %rsi
+    negq %rsi
+    movq %rsi, %rax
+    jmp .Labs_value.return
+.Labs_value.0:
+    movq %rcx, %rax
+.Labs_value.return:
+    ret
+
+.global square
+square:
+    movq %rdi, %rcx
+    movq %rcx, %rsi
+    imulq %rcx, %rsi
+    movq %rsi, %rax
+.Lsquare.return:
+    ret
+
+.global fact
+fact:
+    pushq %rbp
+    movq %rsp, %rbp
+    pushq %rbx
+    subq $8, %rsp
+    movq %rdi, %rbx
+    cmpq $1, %rbx
+    jg .Lfact.0
+    movq $1, %rax
+    jmp .Lfact.return
+.Lfact.0:
+    movq %rbx, %rcx
+    subq $1, %rcx
+    movq %rcx, %rdi
+    call fact
+    movslq %eax, %rax
+    movq %rax, %rsi
+    movq %rbx, %rcx
+    imulq %rsi, %rcx
+    movq %rcx, %rax
+.Lfact.return:
+    leaq -8(%rbp), %rsp
+    popq %rbx
+    popq %rbp
+    ret
+
+.global main
+main:
+    pushq %rbp
+    movq %rsp, %rbp
+    pushq %rbx
+    subq $8, %rsp
+    movq $0, %rbx
+    movq $-3, %rcx
+.Lmain.7:
+    movq %rcx, %rsi
+    cmpq $0, %rsi
+    jge .Lmain.2
+    movq %rsi, %rdi
+    negq %rdi
+    movq %rdi, %rax
+    movslq %eax, %rax
+    movq %rax, %r8
+    jmp .Lmain.3
+.Lmain.2:
+    movq %rsi, %rax
+    movslq %eax, %rax
+    movq %rax, %r8
+.Lmain.3:
+    movq %rcx, %rsi
+    movq %rsi, %rdi
+    imulq %rsi, %rdi
+    movq %rdi, %rax
+    movslq %eax, %rax
+    movq %rax, %rsi
+    movq %r8, %rdi
+    imulq %rsi, %rdi
+    addq %rdi, %rbx
+    addq $1, %rcx
+    cmpq $4, %rcx
+    jl .Lmain.7
+    movq $25, %rdi
+    call print_int
+    movq $5, %rdi
+    call fact
+    movslq %eax, %rax
+    movq %rax, %rdi
+    call print_int
+    movq %rbx, %rax
+.Lmain.return:
+    leaq -8(%rbp), %rsp
+    popq %rbx
+    popq %rbp
+    ret
+
@@ -0,0 +1,134 @@
+    # Generated by TinyC Compiler
+.section .text
+.global weighted
+weighted:
+    pushq %rdi
+    pushq %rsi
+    popq %rsi
+    popq %rcx
+    movq $0, %rdi
+    movq $0, %r8
+    imulq $3, %rsi, %r9
+    movq $0, %rsi
+    cmpq $0, %rcx
+    jle .Lweighted.1
+.Lweighted.2:
+    movq %rdi, %r10
+    addq %rsi, %r10
+    movq %r10, %r11
+    addq %r9, %r11
+    movq %r11, %rdi
+    addq $1, %r8
+    addq $7, %rsi
+    cmpq %rcx, %r8
+    jl .Lweighted.2
+.Lweighted.1:
+    movq %rdi, %rax
+.Lweighted.return:
+    ret
+
+.global skip_ahead
+skip_ahead:
+    movq %rdi, %rcx
+    movq $0, %rsi
+    movq $0, %rdi
+    movq $0, %r8
+    cmpq $0, %rcx
+    jle .Lskip_ahead.1
+.Lskip_ahead.3:
+    addq %r8, %rsi
+    cmpq $100, %rsi
+    jle .Lskip_ahead.2
+    addq $2, %rdi
+    addq $12, %r8
+.Lskip_ahead.2:
+    addq $1, %rdi
+    addq $6, %r8
+    cmpq %rcx, %rdi
+    jl .Lskip_ahead.3
+.Lskip_ahead.1:
+    movq %rsi, %rax
+.Lskip_ahead.return:
+    ret
+
+.global main
+main:
+    pushq %rbp
+    movq %rsp, %rbp
+    pushq %rbx
+    pushq %r12
+    movq $0, %rbx
+    movq $3, %r12
+    movq $0, %rcx
+    movq $0, %rsi
+    movq $0, %rdi
+.Lmain.14:
+    movq %rcx, %r8
+    addq %rdi, %r8
+    movq %r8, %r9
+    addq $30, %r9
+    movq %r9, %rcx
+    addq $1, %rsi
+    addq $7, %rdi
+    cmpq $10, %rsi
+    jl .Lmain.14
+    movq %rcx, %rax
+    movslq %eax, %rax
+    movq %rax, %rdi
+    call print_int
+    movq $0, %rdi
+    call print_int
+    movq $0, %rcx
+    movq $0, %rsi
+    movq $0, %rdi
+.Lmain.16:
+    addq %rdi, %rcx
+    cmpq $100, %rcx
+    jle .Lmain.12
+    addq $2, %rsi
+    addq $12, %rdi
+.Lmain.12:
+    addq $1, %rsi
+    addq $6, %rdi
+    cmpq $10, %rsi
+    jl .Lmain.16
+    movq %rcx, %rax
+    movslq %eax, %rax
+    movq %rax, %rdi
+    call print_int
+    movq $0, %rcx
+    imulq $5, %r12, %rsi
+    cmpq $0, %r12
+    jle .Lmain.1
+.Lmain.18:
+    cmpq $1000, %rcx
+    jge .Lmain.1
+    movq $0, %rdi
+    movq %r12, %r8
+    salq $2, %r8
+    movq %rsi, %r9
+    cmpq $0, %r8
+    jle .Lmain.3
+.Lmain.17:
+    addq %r9, %rcx
+    addq $1, %rdi
+    cmpq %r8, %rdi
+    jl .Lmain.17
+.Lmain.3:
+    addq $2, %rbx
+    subq $1, %r12
+    addq $-5, %rsi
+    cmpq $0, %r12
+    jg .Lmain.18
+.Lmain.1:
+    movq %rcx, %rsi
+    subq $190, %rsi
+    movq %rsi, %rdi
+    call print_int
+    movq %rbx, %rax
+.Lmain.return:
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+
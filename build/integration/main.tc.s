@@ -0,0 +1,32 @@
+    # Generated by TinyC Compiler
+.section .text
+.global main
+main:
+    pushq %rbp
+    movq %rsp, %rbp
+    movq $7, %rcx
+    movq %rcx, %rdi
+    call square
+    movslq %eax, %rax
+    movq %rax, %rsi
+    movq %rsi, %rdi
+    call print_int
+    movq $4, %rcx
+    movq %rcx, %rdi
+    call sum_to
+    movslq %eax, %rax
+    movq %rax, %rsi
+    movq %rsi, %rdi
+    call print_int
+    movq $3, %rcx
+    movq %rcx, %rdi
+    call cube
+    movslq %eax, %rax
+    movq %rax, %rsi
+    movq %rsi, %rax
+    jmp .Lmain.return
+    movq $0, %rax
+.Lmain.return:
+    popq %rbp
+    ret
+
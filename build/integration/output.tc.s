@@ -0,0 +1,50 @@
+    # Generated by TinyC Compiler
+.section .text
+.global main
+main:
+    pushq %rbp
+    movq %rsp, %rbp
+    leaq .LC0(%rip), %rcx
+    movq %rcx, %rdi
+    call print
+    movq $0, %rcx
+    movq %rcx, %rdi
+    call print_int
+    movq $42, %rcx
+    movq %rcx, %rsi
+    negq %rsi
+    movq %rsi, %rdi
+    call print_int
+    movq $2147483647, %rcx
+    movq %rcx, %rsi
+    negq %rsi
+    movq $1, %rcx
+    movq %rsi, %rdi
+    subq %rcx, %rdi
+    movq %rdi, %rdi
+    call print_int
+    movq $2147483647, %rcx
+    movq %rcx, %rdi
+    call print_int
+    call flush
+    movq $111, %rcx
+    movq %rcx, %rdi
+    call print_char
+    movq $107, %rcx
+    movq %rcx, %rdi
+    call print_char
+    movq $10, %rcx
+    movq %rcx, %rdi
+    call print_char
+    movq $0, %rcx
+    movq %rcx, %rax
+    jmp .Lmain.return
+    movq $0, %rax
+.Lmain.return:
+    popq %rbp
+    ret
+
+.section .data
+.LC0:
+    .string "buffered"
+
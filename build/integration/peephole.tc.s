@@ -0,0 +1,72 @@
+    # Generated by TinyC Compiler
+.section .text
+.global scale
+scale:
+    movq %rdi, %rsi
+    salq $3, %rsi
+    movq %rsi, %rax
+.Lscale.return:
+    ret
+
+.global count_above
+count_above:
+    movq %rdi, %rcx
+    movq $0, %rsi
+    movq $0, %rdi
+    cmpq $0, %rcx
+    jle .Lcount_above.1
+.Lcount_above.3:
+    movq %rdi, %r8
+    salq $2, %r8
+    cmpq $10, %r8
+    jle .Lcount_above.2
+    addq $1, %rsi
+.Lcount_above.2:
+    addq $1, %rdi
+    cmpq %rcx, %rdi
+    jl .Lcount_above.3
+.Lcount_above.1:
+    movq %rsi, %rax
+.Lcount_above.return:
+    ret
+
+.global main
+main:
+    pushq %rbp
+    movq %rsp, %rbp
+    movq $40, %rdi
+    call print_int
+    movq $0, %rcx
+    movq $0, %rsi
+.Lmain.9:
+    movq %rsi, %rdi
+    salq $2, %rdi
+    cmpq $10, %rdi
+    jle .Lmain.3
+    addq $1, %rcx
+.Lmain.3:
+    addq $1, %rsi
+    cmpq $20, %rsi
+    jl .Lmain.9
+    movq %rcx, %rax
+    movslq %eax, %rax
+    movq %rax, %rdi
+    call print_int
+    movq $0, %rcx
+    movq $0, %rsi
+.Lmain.10:
+    movq %rsi, %rdi
+    salq $2, %rdi
+    cmpq $10, %rdi
+    jle .Lmain.7
+    addq $1, %rcx
+.Lmain.7:
+    addq $1, %rsi
+    cmpq $7, %rsi
+    jl .Lmain.10
+    movq %rcx, %rax
+    movslq %eax, %rax
+.Lmain.return:
+    popq %rbp
+    ret
+
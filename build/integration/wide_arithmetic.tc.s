@@ -0,0 +1,188 @@
+    # Generated by TinyC Compiler
+.section .text
+.global id
+id:
+    movq %rdi, %rax
+.Lid.return:
+    ret
+
+.global main
+main:
+    pushq %rbp
+    movq %rsp, %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $24, %rsp
+    movq $2147483647, %rdi
+    call id
+    movslq %eax, %rax
+    movq %rax, %rsi
+    addq $1, %rsi
+    cmpq $0, %rsi
+    setg %al
+    movzbl %al, %eax
+    movq %rax, %rdi
+    call print_int
+    movq $1, %rdi
+    call print_int
+    movq $4294967296, %rbx
+    movq $65536, %rdi
+    call id
+    movslq %eax, %rax
+    movq %rax, %rsi
+    movq %rbx, %rax
+    cqto
+    idivq %rsi
+    movq %rax, %rdi
+    call print_int
+    movq $4294967296, %rbx
+    movq $8589934592, %r12
+    movq $12884901888, %r13
+    movq $17179869184, %r14
+    movq $21474836480, %r15
+    movq $25769803776, %rax
+    movq %rax, -56(%rbp)
+    movq $30064771072, %rax
+    movq %rax, -48(%rbp)
+    movq $4294967297, %rdi
+    call id
+    movslq %eax, %rax
+    movq %rax, %rdi
+    movq $8589934594, %r8
+    pushq %rdi
+    subq $8, %rsp
+    movq %r8, %rdi
+    call id
+    addq $8, %rsp
+    movslq %eax, %rax
+    popq %rdi
+    movq %rax, %r8
+    movq $12884901891, %r9
+    pushq %rdi
+    pushq %r8
+    movq %r9, %rdi
+    call id
+    movslq %eax, %rax
+    popq %r8
+    popq %rdi
+    movq %rax, %r9
+    movq $17179869188, %r10
+    pushq %rdi
+    pushq %r8
+    pushq %r9
+    subq $8, %rsp
+    movq %r10, %rdi
+    call id
+    addq $8, %rsp
+    movslq %eax, %rax
+    popq %r9
+    popq %r8
+    popq %rdi
+    movq %rax, %r10
+    movq $21474836485, %r11
+    pushq %rdi
+    pushq %r8
+    pushq %r9
+    pushq %r10
+    movq %r11, %rdi
+    call id
+    movslq %eax, %rax
+    popq %r10
+    popq %r9
+    popq %r8
+    popq %rdi
+    movq %rax, %r11
+    movq $25769803782, %rsi
+    pushq %rdi
+    pushq %r8
+    pushq %r9
+    pushq %r10
+    pushq %r11
+    subq $8, %rsp
+    movq %rsi, %rdi
+    call id
+    addq $8, %rsp
+    movslq %eax, %rax
+    popq %r11
+    popq %r10
+    popq %r9
+    popq %r8
+    popq %rdi
+    movq %rax, -64(%rbp)
+    movq $30064771079, %rcx
+    pushq %rdi
+    pushq %r8
+    pushq %r9
+    pushq %r10
+    pushq %r11
+    subq $8, %rsp
+    movq %rcx, %rdi
+    call id
+    addq $8, %rsp
+    movslq %eax, %rax
+    popq %r11
+    popq %r10
+    popq %r9
+    popq %r8
+    popq %rdi
+    movq %rax, %rcx
+    subq %rbx, %rdi
+    addq $0, %rdi
+    addq $65536, %rdi
+    movq %r8, %rsi
+    subq %r12, %rsi
+    movq %rdi, %r8
+    addq %rsi, %r8
+    movq %r8, %rsi
+    addq $131072, %rsi
+    movq %rsi, %rdi
+    movq %r9, %rsi
+    subq %r13, %rsi
+    movq %rdi, %r8
+    addq %rsi, %r8
+    movq %r8, %rsi
+    addq $196608, %rsi
+    movq %rsi, %rdi
+    movq %r10, %rsi
+    subq %r14, %rsi
+    movq %rdi, %r8
+    addq %rsi, %r8
+    movq %r8, %rsi
+    addq $262144, %rsi
+    movq %rsi, %rdi
+    movq %r11, %rsi
+    subq %r15, %rsi
+    movq %rdi, %r8
+    addq %rsi, %r8
+    movq %r8, %rsi
+    addq $327680, %rsi
+    movq %rsi, %rdi
+    movq -64(%rbp), %rsi
+    subq -56(%rbp), %rsi
+    movq %rdi, %r8
+    addq %rsi, %r8
+    movq %r8, %rsi
+    addq $393216, %rsi
+    movq %rsi, %rdi
+    movq %rcx, %rsi
+    subq -48(%rbp), %rsi
+    movq %rdi, %rcx
+    addq %rsi, %rcx
+    movq %rcx, %rsi
+    addq $458752, %rsi
+    movq %rsi, %rdi
+    call print_int
+    movq $0, %rax
+.Lmain.return:
+    leaq -40(%rbp), %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+
@@ -1,39 +1,139 @@
 // runtime/runtime.c
 // Simple runtime library for TinyC programs
 
-#include <stdio.h>
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include "runtime.h"
 
-// Print a string (for our TinyC programs)
+// Output is collected here and written when the buffer fills, at flush(),
+// at exit and, when stdout is a terminal, at the end of every line
+#define RUNTIME_OUTPUT_SIZE (64 * 1024)
+#define RUNTIME_INPUT_SIZE 4096
+
+static char output_buffer[RUNTIME_OUTPUT_SIZE];
+static size_t output_length;
+static int output_state;          // 0 until first use, then 1 (pipe or file) or 2 (terminal)
+
+static char input_buffer[RUNTIME_INPUT_SIZE];
+static size_t input_start;
+static size_t input_end;
+
+// Helper: Write all of data to fd, retrying partial writes
+static void runtime_write_all(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return;     // Nowhere to report it; the output is lost
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+}
+
+// Helper: Decide on line buffering and register the flush at exit
+static void runtime_start_output(void) {
+    output_state = isatty(1) ? 2 : 1;
+    atexit(flush);
+}
+
+static void runtime_put(const char* data, size_t length) {
+    if (output_state == 0) runtime_start_output();
+
+    if (length > RUNTIME_OUTPUT_SIZE - output_length) {
+        flush();
+        if (length >= RUNTIME_OUTPUT_SIZE) {
+            runtime_write_all(1, data, length);
+            return;
+        }
+    }
+    memcpy(output_buffer + output_length, data, length);
+    output_length += length;
+}
+
+// Helper: Finish a line, which a terminal sees right away
+static void runtime_end_line(void) {
+    runtime_put("\n", 1);
+    if (output_state == 2) flush();
+}
+
+void flush(void) {
+    if (output_length == 0) return;
+    runtime_write_all(1, output_buffer, output_length);
+    output_length = 0;
+}
+
+// Print a string and a newline
 void print(char* str) {
     if (str) {
-        write(1, str, strlen(str));  // stdout
-        write(1, "\n", 1);          // newline
+        runtime_put(str, strlen(str));
+        runtime_end_line();
     }
 }
 
-// Print an integer
+// Print an integer and a newline
 void print_int(int n) {
-    char buffer[32];
-    sprintf(buffer, "%d", n);
-    write(1, buffer, strlen(buffer));
-    write(1, "\n", 1);
+    char digits[16];
+    char* start = digits + sizeof(digits);
+
+    // Negated as unsigned so INT_MIN works too
+    unsigned int value = n < 0 ? 0u - (unsigned int)n : (unsigned int)n;
+    do {
+        *--start = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    if (n < 0) *--start = '-';
+
+    runtime_put(start, (size_t)(digits + sizeof(digits) - start));
+    runtime_end_line();
 }
 
 // Print a character
 void print_char(char c) {
-    write(1, &c, 1);
+    if (c == '\n') {
+        runtime_end_line();
+    } else {
+        runtime_put(&c, 1);
+    }
+}
+
+// Helper: Next input byte, or -1 at the end of input
+static int runtime_getc(void) {
+    if (input_start == input_end) {
+        // Prompts written so far must be visible before waiting for input
+        flush();
+
+        ssize_t count;
+        do {
+            count = read(0, input_buffer, sizeof(input_buffer));
+        } while (count < 0 && errno == EINTR);
+        if (count <= 0) return -1;
+        input_start = 0;
+        input_end = (size_t)count;
+    }
+    return (unsigned char)input_buffer[input_start++];
 }
 
-// Simple input function (reads a line)
-int read_int() {
-    char buffer[32];
-    int bytes_read = read(0, buffer, sizeof(buffer) - 1);  // stdin
-    if (bytes_read > 0) {
-        buffer[bytes_read] = '\0';
-        return atoi(buffer);
+// Read one line and return the integer it starts with (0 if none, like
+// atoi); the rest of the line is skipped
+int read_int(void) {
+    int c = runtime_getc();
+    while (c == ' ' || c == '\t' || c == '\r') c = runtime_getc();
+
+    int negative = 0;
+    if (c == '-' || c == '+') {
+        negative = c == '-';
+        c = runtime_getc();
     }
-    return 0;
-}
\ No newline at end of file
+
+    unsigned int value = 0;
+    while (c >= '0' && c <= '9') {
+        value = value * 10 + (unsigned int)(c - '0');
+        c = runtime_getc();
+    }
+
+    while (c != '\n' && c != -1) c = runtime_getc();
+    return negative ? (int)(0u - value) : (int)value;
+}
@@ -7,5 +7,6 @@ void print(char* str);
 void print_int(int n);
 void print_char(char c);
 int read_int(void);
+void flush(void);      // Write out buffered output (also done at exit)
 
 #endif // RUNTIME_H
\ No newline at end of file
@@ -4,9 +4,67 @@
 #include <string.h>
 #include "ast.h"
 
+// Helper: Allocate zeroed memory from the arena, or the heap when arena is NULL
+static void* ast_alloc(arena_t* arena, size_t size) {
+    if (arena) {
+        return arena_alloc(arena, size);
+    }
+    return calloc(1, size);
+}
+
+// Helper: Append to a child array, doubling its capacity when full
+static int ast_array_append(arena_t* arena, ast_node_t*** items, size_t* count,
+                            size_t* capacity, ast_node_t* item) {
+    if (*count >= *capacity) {
+        size_t new_capacity = *capacity ? *capacity * 2 : 4;
+        ast_node_t** new_items;
+
+        if (arena) {
+            new_items = arena_realloc(arena, *items,
+                                      *capacity * sizeof(ast_node_t*),
+                                      new_capacity * sizeof(ast_node_t*));
+        } else {
+            new_items = realloc(*items, new_capacity * sizeof(ast_node_t*));
+        }
+
+        if (!new_items) return 0;
+
+        *items = new_items;
+        *capacity = new_capacity;
+    }
+
+    (*items)[(*count)++] = item;
+    return 1;
+}
+
+// Size of a node with room for the data member of its type only
+#define AST_NODE_SIZE(member) (offsetof(ast_node_t, data) + sizeof(((ast_node_t*)0)->data.member))
+
+size_t ast_node_size(ast_node_type_t type) {
+    switch (type) {
+        case AST_PROGRAM: return AST_NODE_SIZE(program);
+        case AST_FUNCTION_DECL: return AST_NODE_SIZE(function_decl);
+        case AST_VARIABLE_DECL: return AST_NODE_SIZE(variable_decl);
+        case AST_PARAMETER: return AST_NODE_SIZE(parameter);
+        case AST_COMPOUND_STMT: return AST_NODE_SIZE(compound_stmt);
+        case AST_IF_STMT: return AST_NODE_SIZE(if_stmt);
+        case AST_WHILE_STMT: return AST_NODE_SIZE(while_stmt);
+        case AST_FOR_STMT: return AST_NODE_SIZE(for_stmt);
+        case AST_RETURN_STMT: return AST_NODE_SIZE(return_stmt);
+        case AST_EXPRESSION_STMT: return AST_NODE_SIZE(expression_stmt);
+        case AST_BINARY_OP: return AST_NODE_SIZE(binary_op);
+        case AST_UNARY_OP: return AST_NODE_SIZE(unary_op);
+        case AST_FUNCTION_CALL: return AST_NODE_SIZE(function_call);
+        case AST_IDENTIFIER: return AST_NODE_SIZE(identifier);
+        case AST_NUMBER: return AST_NODE_SIZE(number);
+        case AST_STRING: return AST_NODE_SIZE(string);
+    }
+    return sizeof(ast_node_t);
+}
+
 // Create a new AST node
-ast_node_t* ast_create_node(ast_node_type_t type) {
-    ast_node_t* node =  malloc(sizeof(ast_node_t));
+ast_node_t* ast_create_node(arena_t* arena, ast_node_type_t type) {
+    ast_node_t* node = ast_alloc(arena, ast_node_size(type));
     if (!node) {
         fprintf(stderr, "Error: Failed to allocate memory for AST node\n");
         return NULL;
@@ -14,85 +72,82 @@ ast_node_t* ast_create_node(ast_node_type_t type) {
 
     node->type= type;
     node->data_type = TYPE_VOID; // Defualt
-
-    memset(&node->data, 0, sizeof(node->data));
+    node->flags = arena ? AST_FLAG_ARENA : 0;
 
     return node;
 }
 
+// Record where node starts in the source (positions less than 1 are unknown)
+void ast_set_position(ast_node_t* node, int line, int column) {
+    if (!node) return;
+    node->line = line > 0 ? (unsigned int)line : 0;
+    node->column = column > 0 ? (unsigned int)(column < AST_MAX_COLUMN ? column : AST_MAX_COLUMN) : 0;
+}
+
 // Create specific node types with helper functions
-ast_node_t* ast_create_program() {
-    ast_node_t* node = ast_create_node(AST_PROGRAM);
+ast_node_t* ast_create_program(arena_t* arena) {
+    ast_node_t* node = ast_create_node(arena, AST_PROGRAM);
     if (!node) return NULL;
 
     node->data.program.declarations = NULL;
     node->data.program.declaration_count = 0;
+    node->data.program.declaration_capacity = 0;
 
     return node;
 }
 
-ast_node_t* ast_create_function_decl(data_type_t return_type, const char* name) {
-    ast_node_t* node = ast_create_node(AST_FUNCTION_DECL);
+ast_node_t* ast_create_function_decl(arena_t* arena, data_type_t return_type, const char* name) {
+    ast_node_t* node = ast_create_node(arena, AST_FUNCTION_DECL);
     if (!node) return NULL;
 
     node->data.function_decl.return_type = return_type;
-    node->data.function_decl.name = malloc(strlen(name) + 1);
-    if (!node->data.function_decl.name) {
-        free(node);
-        return NULL;
-    }
-    strcpy(node->data.function_decl.name, name);
+    node->data.function_decl.name = name;
 
     node->data.function_decl.parameters = NULL;
     node->data.function_decl.parameter_count = 0;
+    node->data.function_decl.parameter_capacity = 0;
     node->data.function_decl.body = NULL;
+    node->data.function_decl.local_count = 0;
 
     return node;
 }
 
-ast_node_t* ast_create_variable_decl(data_type_t var_type, const char* name, ast_node_t* intializer) {
-    ast_node_t* node = ast_create_node(AST_VARIABLE_DECL);
+ast_node_t* ast_create_variable_decl(arena_t* arena, data_type_t var_type, const char* name, ast_node_t* intializer) {
+    ast_node_t* node = ast_create_node(arena, AST_VARIABLE_DECL);
     if (!node) return NULL;
 
     node->data.variable_decl.var_type = var_type;
-    node->data.variable_decl.name = malloc(strlen(name) + 1);
-    if (!node->data.variable_decl.name) {
-        free(node);
-        return NULL;
-    }
-    strcpy(node->data.variable_decl.name, name);
+    node->data.variable_decl.name = name;
     node->data.variable_decl.initializer = intializer;
+    node->data.variable_decl.slot = AST_NO_SLOT;
 
     return node;
 }
 
-ast_node_t* ast_create_parameter(data_type_t param_type, const char* name) {
-    ast_node_t* node = ast_create_node(AST_PARAMETER);
+ast_node_t* ast_create_parameter(arena_t* arena, data_type_t param_type, const char* name) {
+    ast_node_t* node = ast_create_node(arena, AST_PARAMETER);
     if (!node) return NULL;
     
     node->data.parameter.param_type = param_type;
-    node->data.parameter.name = malloc(strlen(name) + 1);
-    if (!node->data.parameter.name) {
-        free(node);
-        return NULL;
-    }
-    strcpy(node->data.parameter.name, name);
+    node->data.parameter.name = name;
+    node->data.parameter.slot = AST_NO_SLOT;
     
     return node;
 }
 
-ast_node_t* ast_create_compound_stmt() {
-    ast_node_t* node = ast_create_node(AST_COMPOUND_STMT);
+ast_node_t* ast_create_compound_stmt(arena_t* arena) {
+    ast_node_t* node = ast_create_node(arena, AST_COMPOUND_STMT);
     if (!node) return NULL;
     
     node->data.compound_stmt.statements = NULL;
     node->data.compound_stmt.statement_count = 0;
+    node->data.compound_stmt.statement_capacity = 0;
     
     return node;
 }
 
-ast_node_t* ast_create_if_stmt(ast_node_t* condition, ast_node_t* then_stmt, ast_node_t* else_stmt) {
-    ast_node_t* node = ast_create_node(AST_IF_STMT);
+ast_node_t* ast_create_if_stmt(arena_t* arena, ast_node_t* condition, ast_node_t* then_stmt, ast_node_t* else_stmt) {
+    ast_node_t* node = ast_create_node(arena, AST_IF_STMT);
     if (!node) return NULL;
     
     node->data.if_stmt.condition = condition;
@@ -102,8 +157,8 @@ ast_node_t* ast_create_if_stmt(ast_node_t* condition, ast_node_t* then_stmt, ast
     return node;
 }
 
-ast_node_t* ast_create_while_stmt(ast_node_t* condition, ast_node_t* body) {
-    ast_node_t* node = ast_create_node(AST_WHILE_STMT);
+ast_node_t* ast_create_while_stmt(arena_t* arena, ast_node_t* condition, ast_node_t* body) {
+    ast_node_t* node = ast_create_node(arena, AST_WHILE_STMT);
     if (!node) return NULL;
     
     node->data.while_stmt.condition = condition;
@@ -112,8 +167,8 @@ ast_node_t* ast_create_while_stmt(ast_node_t* condition, ast_node_t* body) {
     return node;
 }
 
-ast_node_t* ast_create_for_stmt(ast_node_t* init, ast_node_t* condition, ast_node_t* update, ast_node_t* body) {
-    ast_node_t* node = ast_create_node(AST_FOR_STMT);
+ast_node_t* ast_create_for_stmt(arena_t* arena, ast_node_t* init, ast_node_t* condition, ast_node_t* update, ast_node_t* body) {
+    ast_node_t* node = ast_create_node(arena, AST_FOR_STMT);
     if (!node) return NULL;
     
     node->data.for_stmt.init = init;
@@ -124,8 +179,8 @@ ast_node_t* ast_create_for_stmt(ast_node_t* init, ast_node_t* condition, ast_nod
     return node;
 }
 
-ast_node_t* ast_create_return_stmt(ast_node_t* value) {
-    ast_node_t* node = ast_create_node(AST_RETURN_STMT);
+ast_node_t* ast_create_return_stmt(arena_t* arena, ast_node_t* value) {
+    ast_node_t* node = ast_create_node(arena, AST_RETURN_STMT);
     if (!node) return NULL;
     
     node->data.return_stmt.value = value;
@@ -133,8 +188,8 @@ ast_node_t* ast_create_return_stmt(ast_node_t* value) {
     return node;
 }
 
-ast_node_t* ast_create_expression_stmt(ast_node_t* expression) {
-    ast_node_t* node = ast_create_node(AST_EXPRESSION_STMT);
+ast_node_t* ast_create_expression_stmt(arena_t* arena, ast_node_t* expression) {
+    ast_node_t* node = ast_create_node(arena, AST_EXPRESSION_STMT);
     if (!node) return NULL;
     
     node->data.expression_stmt.expression = expression;
@@ -142,72 +197,52 @@ ast_node_t* ast_create_expression_stmt(ast_node_t* expression) {
     return node;
 }
 
-ast_node_t* ast_create_binary_op(const char* oper, ast_node_t* left, ast_node_t* right) {
-    ast_node_t* node = ast_create_node(AST_BINARY_OP);
+ast_node_t* ast_create_binary_op(arena_t* arena, ast_operator_t oper, ast_node_t* left, ast_node_t* right) {
+    ast_node_t* node = ast_create_node(arena, AST_BINARY_OP);
     if (!node) return NULL;
     
-    node->data.binary_op.oper = malloc(strlen(oper) + 1);
-    if (!node->data.binary_op.oper) {
-        free(node);
-        return NULL;
-    }
-    strcpy(node->data.binary_op.oper, oper);
-    
+    node->data.binary_op.oper = oper;
     node->data.binary_op.left = left;
     node->data.binary_op.right = right;
     
     return node;
 }
 
-ast_node_t* ast_create_unary_op(const char* oper, ast_node_t* operand) {
-    ast_node_t* node = ast_create_node(AST_UNARY_OP);
+ast_node_t* ast_create_unary_op(arena_t* arena, ast_operator_t oper, ast_node_t* operand) {
+    ast_node_t* node = ast_create_node(arena, AST_UNARY_OP);
     if (!node) return NULL;
     
-    node->data.unary_op.oper = malloc(strlen(oper) + 1);
-    if (!node->data.unary_op.oper) {
-        free(node);
-        return NULL;
-    }
-    strcpy(node->data.unary_op.oper, oper);
-    
+    node->data.unary_op.oper = oper;
     node->data.unary_op.operand = operand;
     
     return node;
 }
 
-ast_node_t* ast_create_function_call(const char* name) {
-    ast_node_t* node = ast_create_node(AST_FUNCTION_CALL);
+ast_node_t* ast_create_function_call(arena_t* arena, const char* name) {
+    ast_node_t* node = ast_create_node(arena, AST_FUNCTION_CALL);
     if (!node) return NULL;
     
-    node->data.function_call.name = malloc(strlen(name) + 1);
-    if (!node->data.function_call.name) {
-        free(node);
-        return NULL;
-    }
-    strcpy(node->data.function_call.name, name);
+    node->data.function_call.name = name;
     
     node->data.function_call.arguments = NULL;
     node->data.function_call.argument_count = 0;
+    node->data.function_call.argument_capacity = 0;
     
     return node;
 }
 
-ast_node_t* ast_create_identifier(const char* name) {
-    ast_node_t* node = ast_create_node(AST_IDENTIFIER);
+ast_node_t* ast_create_identifier(arena_t* arena, const char* name) {
+    ast_node_t* node = ast_create_node(arena, AST_IDENTIFIER);
     if (!node) return NULL;
     
-    node->data.identifier.name = malloc(strlen(name) + 1);
-    if (!node->data.identifier.name) {
-        free(node);
-        return NULL;
-    }
-    strcpy(node->data.identifier.name, name);
+    node->data.identifier.name = name;
+    node->data.identifier.slot = AST_NO_SLOT;
     
     return node;
 }
 
-ast_node_t* ast_create_number(int value) {
-    ast_node_t* node = ast_create_node(AST_NUMBER);
+ast_node_t* ast_create_number(arena_t* arena, int value) {
+    ast_node_t* node = ast_create_node(arena, AST_NUMBER);
     if (!node) return NULL;
     
     node->data.number.value = value;
@@ -216,94 +251,72 @@ ast_node_t* ast_create_number(int value) {
     return node;
 }
 
-ast_node_t* ast_create_string(const char* value) {
-    ast_node_t* node = ast_create_node(AST_STRING);
+ast_node_t* ast_create_string(arena_t* arena, const char* value) {
+    ast_node_t* node = ast_create_node(arena, AST_STRING);
     if (!node) return NULL;
     
-    node->data.string.value = malloc(strlen(value) + 1);
-    if (!node->data.string.value) {
-        free(node);
-        return NULL;
-    }
-    strcpy(node->data.string.value, value);
+    node->data.string.value = value;
     node->data_type = TYPE_CHAR_PTR;
     
     return node;
 }
 
 // Helper functions for dynamic arrays
-void ast_add_declaration(ast_node_t* program, ast_node_t* declaration) {
+void ast_add_declaration(arena_t* arena, ast_node_t* program, ast_node_t* declaration) {
     if (!program || program->type != AST_PROGRAM || !declaration) return;
     
-    program->data.program.declarations = realloc(
-        program->data.program.declarations,
-        (program->data.program.declaration_count + 1) * sizeof(ast_node_t*)
-    );
-    
-    if (!program->data.program.declarations) {
+    if (!ast_array_append(arena,
+                          &program->data.program.declarations,
+                          &program->data.program.declaration_count,
+                          &program->data.program.declaration_capacity,
+                          declaration)) {
         fprintf(stderr, "Error: Failed to reallocate memory for declarations\n");
-        return;
     }
-    
-    program->data.program.declarations[program->data.program.declaration_count] = declaration;
-    program->data.program.declaration_count++;
 }
 
-void ast_add_parameter(ast_node_t* function, ast_node_t* parameter) {
+void ast_add_parameter(arena_t* arena, ast_node_t* function, ast_node_t* parameter) {
     if (!function || function->type != AST_FUNCTION_DECL || !parameter) return;
     
-    function->data.function_decl.parameters = realloc(
-        function->data.function_decl.parameters,
-        (function->data.function_decl.parameter_count + 1) * sizeof(ast_node_t*)
-    );
-    
-    if (!function->data.function_decl.parameters) {
+    if (!ast_array_append(arena,
+                          &function->data.function_decl.parameters,
+                          &function->data.function_decl.parameter_count,
+                          &function->data.function_decl.parameter_capacity,
+                          parameter)) {
         fprintf(stderr, "Error: Failed to reallocate memory for parameters\n");
-        return;
     }
-    
-    function->data.function_decl.parameters[function->data.function_decl.parameter_count] = parameter;
-    function->data.function_decl.parameter_count++;
 }
 
-void ast_add_statement(ast_node_t* compound, ast_node_t* statement) {
+void ast_add_statement(arena_t* arena, ast_node_t* compound, ast_node_t* statement) {
     if (!compound || compound->type != AST_COMPOUND_STMT || !statement) return;
     
-    compound->data.compound_stmt.statements = realloc(
-        compound->data.compound_stmt.statements,
-        (compound->data.compound_stmt.statement_count + 1) * sizeof(ast_node_t*)
-    );
-    
-    if (!compound->data.compound_stmt.statements) {
+    if (!ast_array_append(arena,
+                          &compound->data.compound_stmt.statements,
+                          &compound->data.compound_stmt.statement_count,
+                          &compound->data.compound_stmt.statement_capacity,
+                          statement)) {
         fprintf(stderr, "Error: Failed to reallocate memory for statements\n");
-        return;
     }
-    
-    compound->data.compound_stmt.statements[compound->data.compound_stmt.statement_count] = statement;
-    compound->data.compound_stmt.statement_count++;
 }
 
-void ast_add_argument(ast_node_t* function_call, ast_node_t* argument) {
+void ast_add_argument(arena_t* arena, ast_node_t* function_call, ast_node_t* argument) {
     if (!function_call || function_call->type != AST_FUNCTION_CALL || !argument) return;
     
-    function_call->data.function_call.arguments = realloc(
-        function_call->data.function_call.arguments,
-        (function_call->data.function_call.argument_count + 1) * sizeof(ast_node_t*)
-    );
-    
-    if (!function_call->data.function_call.arguments) {
+    if (!ast_array_append(arena,
+                          &function_call->data.function_call.arguments,
+                          &function_call->data.function_call.argument_count,
+                          &function_call->data.function_call.argument_capacity,
+                          argument)) {
         fprintf(stderr, "Error: Failed to reallocate memory for arguments\n");
-        return;
     }
-    
-    function_call->data.function_call.arguments[function_call->data.function_call.argument_count] = argument;
-    function_call->data.function_call.argument_count++;
 }
 
 // Destroy AST and free all memory
 void ast_destroy(ast_node_t* node) {
     if (!node) return;
     
+    // Arena-owned trees are released in bulk by arena_destroy()
+    if (node->flags & AST_FLAG_ARENA) return;
+    
     switch (node->type) {
         case AST_PROGRAM:
             for (size_t i = 0; i < node->data.program.declaration_count; i++) {
@@ -313,7 +326,6 @@ void ast_destroy(ast_node_t* node) {
             break;
             
         case AST_FUNCTION_DECL:
-            free(node->data.function_decl.name);
             for (size_t i = 0; i < node->data.function_decl.parameter_count; i++) {
                 ast_destroy(node->data.function_decl.parameters[i]);
             }
@@ -322,12 +334,11 @@ void ast_destroy(ast_node_t* node) {
             break;
             
         case AST_VARIABLE_DECL:
-            free(node->data.variable_decl.name);
             ast_destroy(node->data.variable_decl.initializer);
             break;
             
         case AST_PARAMETER:
-            free(node->data.parameter.name);
+            // Name is interned, nothing to free
             break;
             
         case AST_COMPOUND_STMT:
@@ -364,18 +375,15 @@ void ast_destroy(ast_node_t* node) {
             break;
             
         case AST_BINARY_OP:
-            free(node->data.binary_op.oper);
             ast_destroy(node->data.binary_op.left);
             ast_destroy(node->data.binary_op.right);
             break;
             
         case AST_UNARY_OP:
-            free(node->data.unary_op.oper);
             ast_destroy(node->data.unary_op.operand);
             break;
             
         case AST_FUNCTION_CALL:
-            free(node->data.function_call.name);
             for (size_t i = 0; i < node->data.function_call.argument_count; i++) {
                 ast_destroy(node->data.function_call.arguments[i]);
             }
@@ -383,7 +391,7 @@ void ast_destroy(ast_node_t* node) {
             break;
             
         case AST_IDENTIFIER:
-            free(node->data.identifier.name);
+            // Name is interned, nothing to free
             break;
             
         case AST_NUMBER:
@@ -391,13 +399,93 @@ void ast_destroy(ast_node_t* node) {
             break;
             
         case AST_STRING:
-            free(node->data.string.value);
+            // Value is interned, nothing to free
             break;
     }
     
     free(node);
 }
 
+// Count node and every node below it
+size_t ast_count_nodes(const ast_node_t* node) {
+    if (!node) return 0;
+    
+    size_t count = 1;
+    switch (node->type) {
+        case AST_PROGRAM:
+            for (size_t i = 0; i < node->data.program.declaration_count; i++) {
+                count += ast_count_nodes(node->data.program.declarations[i]);
+            }
+            break;
+            
+        case AST_FUNCTION_DECL:
+            for (size_t i = 0; i < node->data.function_decl.parameter_count; i++) {
+                count += ast_count_nodes(node->data.function_decl.parameters[i]);
+            }
+            count += ast_count_nodes(node->data.function_decl.body);
+            break;
+            
+        case AST_VARIABLE_DECL:
+            count += ast_count_nodes(node->data.variable_decl.initializer);
+            break;
+            
+        case AST_COMPOUND_STMT:
+            for (size_t i = 0; i < node->data.compound_stmt.statement_count; i++) {
+                count += ast_count_nodes(node->data.compound_stmt.statements[i]);
+            }
+            break;
+            
+        case AST_IF_STMT:
+            count += ast_count_nodes(node->data.if_stmt.condition);
+            count += ast_count_nodes(node->data.if_stmt.then_stmt);
+            count += ast_count_nodes(node->data.if_stmt.else_stmt);
+            break;
+            
+        case AST_WHILE_STMT:
+            count += ast_count_nodes(node->data.while_stmt.condition);
+            count += ast_count_nodes(node->data.while_stmt.body);
+            break;
+            
+        case AST_FOR_STMT:
+            count += ast_count_nodes(node->data.for_stmt.init);
+            count += ast_count_nodes(node->data.for_stmt.condition);
+            count += ast_count_nodes(node->data.for_stmt.update);
+            count += ast_count_nodes(node->data.for_stmt.body);
+            break;
+            
+        case AST_RETURN_STMT:
+            count += ast_count_nodes(node->data.return_stmt.value);
+            break;
+            
+        case AST_EXPRESSION_STMT:
+            count += ast_count_nodes(node->data.expression_stmt.expression);
+            break;
+            
+        case AST_BINARY_OP:
+            count += ast_count_nodes(node->data.binary_op.left);
+            count += ast_count_nodes(node->data.binary_op.right);
+            break;
+            
+        case AST_UNARY_OP:
+            count += ast_count_nodes(node->data.unary_op.operand);
+            break;
+            
+        case AST_FUNCTION_CALL:
+            for (size_t i = 0; i < node->data.function_call.argument_count; i++) {
+                count += ast_count_nodes(node->data.function_call.arguments[i]);
+            }
+            break;
+            
+        case AST_PARAMETER:
+        case AST_IDENTIFIER:
+        case AST_NUMBER:
+        case AST_STRING:
+            break;
+    }
+    
+    return count;
+}
+
 // Convert AST node type to string (for debugging)
 const char* ast_node_type_to_string(ast_node_type_t type) {
     switch (type) {
@@ -431,6 +519,19 @@ const char* data_type_to_string(data_type_t type) {
     }
 }
 
+const char* ast_operator_to_string(ast_operator_t oper) {
+    static const char* const names[] = {
+        [OP_ASSIGN] = "=",  [OP_ADD] = "+",  [OP_SUB] = "-",  [OP_MUL] = "*",
+        [OP_DIV] = "/",     [OP_MOD] = "%",  [OP_EQ] = "==",  [OP_NE] = "!=",
+        [OP_LT] = "<",      [OP_LE] = "<=",  [OP_GT] = ">",   [OP_GE] = ">=",
+        [OP_AND] = "&&",    [OP_OR] = "||",  [OP_NEG] = "-",  [OP_POS] = "+",
+        [OP_NOT] = "!"
+    };
+    
+    if ((unsigned int)oper >= OP_INVALID) return "?";
+    return names[oper];
+}
+
 
 // Print AST (for debugging)
 void ast_print(ast_node_t* node, int indent) {
@@ -548,13 +649,13 @@ void ast_print(ast_node_t* node, int indent) {
             break;
             
         case AST_BINARY_OP:
-            printf(" '%s'\n", node->data.binary_op.oper);
+            printf(" '%s'\n", ast_operator_to_string(node->data.binary_op.oper));
             ast_print(node->data.binary_op.left, indent + 1);
             ast_print(node->data.binary_op.right, indent + 1);
             break;
             
         case AST_UNARY_OP:
-            printf(" '%s'\n", node->data.unary_op.oper);
+            printf(" '%s'\n", ast_operator_to_string(node->data.unary_op.oper));
             ast_print(node->data.unary_op.operand, indent + 1);
             break;
             
@@ -3,6 +3,7 @@
 #define AST_H
 
 #include <stddef.h>
+#include "utils.h"
 
 // AST node types
 typedef enum {
@@ -32,42 +33,89 @@ typedef enum {
     TYPE_CHAR_PTR
 } data_type_t;
 
+// Operators (binary and unary)
+typedef enum {
+    OP_ASSIGN,     // =
+    OP_ADD,        // +
+    OP_SUB,        // -
+    OP_MUL,        // *
+    OP_DIV,        // /
+    OP_MOD,        // %
+    OP_EQ,         // ==
+    OP_NE,         // !=
+    OP_LT,         // <
+    OP_LE,         // <=
+    OP_GT,         // >
+    OP_GE,         // >=
+    OP_AND,        // &&
+    OP_OR,         // ||
+    OP_NEG,        // unary -
+    OP_POS,        // unary +
+    OP_NOT,        // !
+    OP_INVALID
+} ast_operator_t;
+
+// Node flags
+#define AST_FLAG_ARENA 0x1   // Node (and its children/strings) live in an arena
+
+// Slot of a name that does not resolve to a function local (see below).
+// Slots are plain numbers in the tree, so they stay valid without the
+// semantic analyzer that assigned them; its symbols are freed as each
+// scope closes, during analysis.
+#define AST_NO_SLOT -1
+
+// Largest column a node records; later columns are clamped to it
+#define AST_MAX_COLUMN 0xFFFFFF
+
 // Forward declaration
 typedef struct ast_node ast_node_t;
 
 // AST node structure
+// Nodes are size-classed: each is allocated with room for its own member of
+// data only (see ast_node_size()), so a node may only be accessed through
+// the member for its type, and may only be retyped in place to a type whose
+// member is no larger (the folder turns operators into AST_NUMBER).
 struct ast_node {
     ast_node_type_t type;
-    data_type_t data_type;
+    data_type_t data_type;    // Expression type, set by semantic_analyze()
+    unsigned int line;        // Source position of the node's token; 0 if unknown
+    unsigned int column : 24;
+    unsigned int flags : 8;
     
     union {
         struct {
             ast_node_t** declarations;
             size_t declaration_count;
+            size_t declaration_capacity;
         } program;
         
         struct {
             data_type_t return_type;
-            char* name;
+            int local_count;     // Slots numbered by semantic_analyze()
+            const char* name;    // Interned
             ast_node_t** parameters;
             size_t parameter_count;
+            size_t parameter_capacity;
             ast_node_t* body;
         } function_decl;
         
         struct {
             data_type_t var_type;
-            char* name;
+            int slot;            // Function local number, or AST_NO_SLOT (globals)
+            const char* name;    // Interned
             ast_node_t* initializer;
         } variable_decl;
         
         struct {
             data_type_t param_type;
-            char* name;
+            int slot;
+            const char* name;    // Interned
         } parameter;
         
         struct {
             ast_node_t** statements;
             size_t statement_count;
+            size_t statement_capacity;
         } compound_stmt;
         
         struct {
@@ -97,24 +145,26 @@ struct ast_node {
         } expression_stmt;
         
         struct {
-            char* oper;
+            ast_operator_t oper;
             ast_node_t* left;
             ast_node_t* right;
         } binary_op;
         
         struct {
-            char* oper;
+            ast_operator_t oper;
             ast_node_t* operand;
         } unary_op;
         
         struct {
-            char* name;
+            const char* name;    // Interned
             ast_node_t** arguments;
             size_t argument_count;
+            size_t argument_capacity;
         } function_call;
         
         struct {
-            char* name;
+            const char* name;    // Interned
+            int slot;            // Slot of the local it resolves to, or AST_NO_SLOT
         } identifier;
         
         struct {
@@ -122,43 +172,53 @@ struct ast_node {
         } number;
         
         struct {
-            char* value;
+            const char* value;   // Interned
         } string;
     } data;
 };
 
 // Core AST functions
-ast_node_t* ast_create_node(ast_node_type_t type);
+// Every constructor takes the arena to allocate from; pass NULL to use the heap.
+// Arena-allocated trees are released in bulk with arena_destroy(), and
+// ast_destroy() is a no-op on them. Names and string values must already be
+// interned (see intern_string()); nodes store the pointer without copying.
+ast_node_t* ast_create_node(arena_t* arena, ast_node_type_t type);
+size_t ast_node_size(ast_node_type_t type);   // Bytes allocated for a node of type
+void ast_set_position(ast_node_t* node, int line, int column);
 void ast_destroy(ast_node_t* node);
+size_t ast_count_nodes(const ast_node_t* node);
 void ast_print(ast_node_t* node, int indent);
 const char* ast_node_type_to_string(ast_node_type_t type);
 const char* data_type_to_string(data_type_t type);
+const char* ast_operator_to_string(ast_operator_t oper);
 
 // Convenience constructors for specific node types
-ast_node_t* ast_create_program(void);
-ast_node_t* ast_create_function_decl(data_type_t return_type, const char* name);
-ast_node_t* ast_create_variable_decl(data_type_t var_type, const char* name, ast_node_t* initializer);
-ast_node_t* ast_create_parameter(data_type_t param_type, const char* name);
-ast_node_t* ast_create_compound_stmt(void);
-ast_node_t* ast_create_if_stmt(ast_node_t* condition, ast_node_t* then_stmt, ast_node_t* else_stmt);
-ast_node_t* ast_create_while_stmt(ast_node_t* condition, ast_node_t* body);
-ast_node_t* ast_create_for_stmt(ast_node_t* init, ast_node_t* condition, ast_node_t* update, ast_node_t* body);
-ast_node_t* ast_create_return_stmt(ast_node_t* value);
-ast_node_t* ast_create_expression_stmt(ast_node_t* expression);
-ast_node_t* ast_create_binary_op(const char* oper, ast_node_t* left, ast_node_t* right);
-ast_node_t* ast_create_unary_op(const char* oper, ast_node_t* operand);
-ast_node_t* ast_create_function_call(const char* name);
-ast_node_t* ast_create_identifier(const char* name);
-ast_node_t* ast_create_number(int value);
-ast_node_t* ast_create_string(const char* value);
+ast_node_t* ast_create_program(arena_t* arena);
+ast_node_t* ast_create_function_decl(arena_t* arena, data_type_t return_type, const char* name);
+ast_node_t* ast_create_variable_decl(arena_t* arena, data_type_t var_type, const char* name, ast_node_t* initializer);
+ast_node_t* ast_create_parameter(arena_t* arena, data_type_t param_type, const char* name);
+ast_node_t* ast_create_compound_stmt(arena_t* arena);
+ast_node_t* ast_create_if_stmt(arena_t* arena, ast_node_t* condition, ast_node_t* then_stmt, ast_node_t* else_stmt);
+ast_node_t* ast_create_while_stmt(arena_t* arena, ast_node_t* condition, ast_node_t* body);
+ast_node_t* ast_create_for_stmt(arena_t* arena, ast_node_t* init, ast_node_t* condition, ast_node_t* update, ast_node_t* body);
+ast_node_t* ast_create_return_stmt(arena_t* arena, ast_node_t* value);
+ast_node_t* ast_create_expression_stmt(arena_t* arena, ast_node_t* expression);
+ast_node_t* ast_create_binary_op(arena_t* arena, ast_operator_t oper, ast_node_t* left, ast_node_t* right);
+ast_node_t* ast_create_unary_op(arena_t* arena, ast_operator_t oper, ast_node_t* operand);
+ast_node_t* ast_create_function_call(arena_t* arena, const char* name);
+ast_node_t* ast_create_identifier(arena_t* arena, const char* name);
+ast_node_t* ast_create_number(arena_t* arena, int value);
+ast_node_t* ast_create_string(arena_t* arena, const char* value);
 
-// Helper functions for dynamic arrays
-void ast_add_declaration(ast_node_t* program, ast_node_t* declaration);
-void ast_add_parameter(ast_node_t* function, ast_node_t* parameter);
-void ast_add_statement(ast_node_t* compound, ast_node_t* statement);
-void ast_add_argument(ast_node_t* function_call, ast_node_t* argument);
+// Helper functions for dynamic arrays (arena must match the one the parent was created in)
+void ast_add_declaration(arena_t* arena, ast_node_t* program, ast_node_t* declaration);
+void ast_add_parameter(arena_t* arena, ast_node_t* function, ast_node_t* parameter);
+void ast_add_statement(arena_t* arena, ast_node_t* compound, ast_node_t* statement);
+void ast_add_argument(arena_t* arena, ast_node_t* function_call, ast_node_t* argument);
 
 // Type conversion helpers
 data_type_t token_to_data_type(int token_type);
+ast_operator_t token_to_binary_operator(int token_type);   // OP_INVALID if not a binary operator
+ast_operator_t token_to_unary_operator(int token_type);    // OP_INVALID if not a unary operator
 
 #endif // AST_H
\ No newline at end of file
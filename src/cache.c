@@ -0,0 +1,256 @@
+// src/cache.c
+#define _POSIX_C_SOURCE 200809L   // mkstemp(), fdopen()
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cache.h"
+
+// Bytes copied per read
+#define CACHE_COPY_CHUNK (64 * 1024)
+
+// Two independent 64-bit lanes: FNV-1a and a multiply-rotate mix
+typedef struct {
+    uint64_t fnv;
+    uint64_t mix;
+} cache_hash_t;
+
+static void cache_hash_init(cache_hash_t* hash) {
+    hash->fnv = 0xcbf29ce484222325ULL;
+    hash->mix = 0x9e3779b97f4a7c15ULL;
+}
+
+static void cache_hash_update(cache_hash_t* hash, const void* data, size_t length) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash->fnv = (hash->fnv ^ bytes[i]) * 0x100000001b3ULL;
+        hash->mix = (hash->mix ^ bytes[i]) * 0xff51afd7ed558ccdULL;
+        hash->mix = (hash->mix << 31) | (hash->mix >> 33);
+    }
+}
+
+static void cache_hash_format(const cache_hash_t* hash, char key[CACHE_KEY_SIZE]) {
+    snprintf(key, CACHE_KEY_SIZE, "%016llx%016llx",
+             (unsigned long long)hash->fnv, (unsigned long long)hash->mix);
+}
+
+void cache_key(const char* source, size_t length, const char* configuration, char key[CACHE_KEY_SIZE]) {
+    cache_hash_t hash;
+    cache_hash_init(&hash);
+
+    // Lengths first, so no split of the bytes between the parts collides
+    uint64_t lengths[2] = {length, strlen(configuration)};
+    cache_hash_update(&hash, lengths, sizeof(lengths));
+    cache_hash_update(&hash, configuration, lengths[1]);
+    cache_hash_update(&hash, source, length);
+    cache_hash_format(&hash, key);
+}
+
+void cache_compiler_identity(char identity[CACHE_KEY_SIZE]) {
+    FILE* file = fopen("/proc/self/exe", "rb");
+    if (!file) {
+        snprintf(identity, CACHE_KEY_SIZE, "unknown");
+        return;
+    }
+
+    cache_hash_t hash;
+    cache_hash_init(&hash);
+    char* buffer = malloc(CACHE_COPY_CHUNK);
+    size_t count;
+    while (buffer && (count = fread(buffer, 1, CACHE_COPY_CHUNK, file)) > 0) {
+        cache_hash_update(&hash, buffer, count);
+    }
+    fclose(file);
+
+    if (buffer) {
+        cache_hash_format(&hash, identity);
+    } else {
+        snprintf(identity, CACHE_KEY_SIZE, "unknown");
+    }
+    free(buffer);
+}
+
+// Helper: Copy everything from input to output; 1 on success
+static int cache_copy(FILE* input, FILE* output) {
+    char* buffer = malloc(CACHE_COPY_CHUNK);
+    if (!buffer) return 0;
+
+    size_t count;
+    int success = 1;
+    while ((count = fread(buffer, 1, CACHE_COPY_CHUNK, input)) > 0) {
+        if (fwrite(buffer, 1, count, output) != count) {
+            success = 0;
+            break;
+        }
+    }
+    free(buffer);
+    return success && !ferror(input);
+}
+
+// Helper: Path of the entry for key
+static char* cache_entry_path(const char* directory, const char* key, const char* extension) {
+    size_t size = strlen(directory) + strlen(key) + strlen(extension) + 2;
+    char* path = malloc(size);
+    if (path) snprintf(path, size, "%s/%s%s", directory, key, extension);
+    return path;
+}
+
+int cache_fetch(const char* directory, const char* key, const char* extension, const char* output_path) {
+    char* path = cache_entry_path(directory, key, extension);
+    if (!path) return 0;
+    FILE* entry = fopen(path, "rb");
+    free(path);
+    if (!entry) return 0;
+
+    FILE* output = fopen(output_path, "wb");
+    int success = output && cache_copy(entry, output);
+    fclose(entry);
+    if (output && fclose(output) != 0) success = 0;
+    return success;
+}
+
+int cache_store(const char* directory, const char* key, const char* extension, const char* path) {
+    FILE* input = fopen(path, "rb");
+    if (!input) return 0;
+
+    // Only the last directory component is created
+    mkdir(directory, 0777);
+
+    char* temporary = cache_entry_path(directory, key, ".XXXXXX");
+    char* entry = cache_entry_path(directory, key, extension);
+    int fd = temporary && entry ? mkstemp(temporary) : -1;
+    FILE* output = fd >= 0 ? fdopen(fd, "wb") : NULL;
+    if (!output && fd >= 0) close(fd);
+
+    int success = output && cache_copy(input, output);
+    fclose(input);
+    if (output && fclose(output) != 0) success = 0;
+
+    if (success) {
+        // mkstemp() creates the file private to the user
+        chmod(temporary, 0644);
+        success = rename(temporary, entry) == 0;
+    }
+    if (!success && fd >= 0) unlink(temporary);
+
+    free(temporary);
+    free(entry);
+    return success;
+}
+
+// One output held in memory
+typedef struct {
+    char key[CACHE_KEY_SIZE];
+    char* data;
+    size_t length;
+} cache_memory_entry_t;
+
+struct cache_memory {
+    pthread_mutex_t lock;         // Guards everything below
+    cache_memory_entry_t* entries;    // Oldest first
+    size_t count;
+    size_t capacity;
+    size_t bytes;                 // Sum of the entry lengths
+    size_t limit;
+};
+
+cache_memory_t* cache_memory_create(size_t limit) {
+    cache_memory_t* cache = calloc(1, sizeof(cache_memory_t));
+    if (!cache) return NULL;
+    if (pthread_mutex_init(&cache->lock, NULL) != 0) {
+        free(cache);
+        return NULL;
+    }
+    cache->limit = limit;
+    return cache;
+}
+
+void cache_memory_destroy(cache_memory_t* cache) {
+    if (!cache) return;
+    for (size_t i = 0; i < cache->count; i++) {
+        free(cache->entries[i].data);
+    }
+    free(cache->entries);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache);
+}
+
+// Helper: Entry for key, or NULL (the lock must be held)
+static cache_memory_entry_t* cache_memory_find(cache_memory_t* cache, const char* key) {
+    for (size_t i = 0; i < cache->count; i++) {
+        if (strcmp(cache->entries[i].key, key) == 0) return &cache->entries[i];
+    }
+    return NULL;
+}
+
+int cache_memory_fetch(cache_memory_t* cache, const char* key, const char* output_path) {
+    pthread_mutex_lock(&cache->lock);
+    cache_memory_entry_t* entry = cache_memory_find(cache, key);
+    int success = 0;
+    if (entry) {
+        FILE* output = fopen(output_path, "wb");
+        success = output && fwrite(entry->data, 1, entry->length, output) == entry->length;
+        if (output && fclose(output) != 0) success = 0;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return success;
+}
+
+int cache_memory_store(cache_memory_t* cache, const char* key, const char* path) {
+    FILE* input = fopen(path, "rb");
+    if (!input) return 0;
+
+    long size = fseek(input, 0, SEEK_END) == 0 ? ftell(input) : -1;
+    char* data = size >= 0 && (size_t)size <= cache->limit ? malloc(size ? (size_t)size : 1) : NULL;
+    int success = data && fseek(input, 0, SEEK_SET) == 0 && fread(data, 1, (size_t)size, input) == (size_t)size;
+    fclose(input);
+    if (!success) {
+        free(data);
+        return 0;
+    }
+    size_t length = (size_t)size;
+
+    pthread_mutex_lock(&cache->lock);
+    cache_memory_entry_t* old = cache_memory_find(cache, key);
+    if (old) {
+        cache->bytes -= old->length;
+        free(old->data);
+        cache->count--;
+        memmove(old, old + 1, (size_t)(cache->entries + cache->count - old) * sizeof(cache_memory_entry_t));
+    }
+
+    // Make room by dropping the oldest entries
+    size_t dropped = 0;
+    while (dropped < cache->count && cache->bytes + length > cache->limit) {
+        cache->bytes -= cache->entries[dropped].length;
+        free(cache->entries[dropped].data);
+        dropped++;
+    }
+    if (dropped > 0) {
+        cache->count -= dropped;
+        memmove(cache->entries, cache->entries + dropped, cache->count * sizeof(cache_memory_entry_t));
+    }
+
+    if (cache->count == cache->capacity) {
+        size_t capacity = cache->capacity ? cache->capacity * 2 : 16;
+        cache_memory_entry_t* grown = realloc(cache->entries, capacity * sizeof(cache_memory_entry_t));
+        if (!grown) {
+            pthread_mutex_unlock(&cache->lock);
+            free(data);
+            return 0;
+        }
+        cache->entries = grown;
+        cache->capacity = capacity;
+    }
+
+    cache_memory_entry_t* entry = &cache->entries[cache->count++];
+    snprintf(entry->key, sizeof(entry->key), "%s", key);
+    entry->data = data;
+    entry->length = length;
+    cache->bytes += length;
+    pthread_mutex_unlock(&cache->lock);
+    return 1;
+}
@@ -0,0 +1,80 @@
+// src/cache.h
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+
+// Hex digits of a cache key (128-bit hash) plus the terminator
+#define CACHE_KEY_SIZE 33
+
+// Content-addressed store of compiler outputs: one file per key in a cache
+// directory, named <key><extension>. Entries are written to a temporary
+// file and renamed into place, so concurrent compilers never see a partial
+// entry.
+
+/**
+ * @brief Hashes source bytes together with everything else the output
+ *        depends on
+ *
+ * @param source Source text (need not be null-terminated)
+ * @param length Number of bytes in source
+ * @param configuration Compiler identity and output-affecting options
+ * @param key Receives the key as hex digits
+ */
+void cache_key(const char* source, size_t length, const char* configuration, char key[CACHE_KEY_SIZE]);
+
+/**
+ * @brief Identity of the running compiler: a hash of its own executable
+ *
+ * @param identity Receives the hash as hex digits (a fixed string if the
+ *        executable cannot be read)
+ */
+void cache_compiler_identity(char identity[CACHE_KEY_SIZE]);
+
+/**
+ * @brief Copies the entry for key to output_path
+ *
+ * @return int 1 on a hit, 0 if there is no entry (or it cannot be copied)
+ */
+int cache_fetch(const char* directory, const char* key, const char* extension, const char* output_path);
+
+/**
+ * @brief Stores a copy of path as the entry for key
+ *
+ * @return int 1 on success, 0 on failure (the cache is left unchanged)
+ *
+ * @note Creates directory if it does not exist yet
+ */
+int cache_store(const char* directory, const char* key, const char* extension, const char* path);
+
+// In-memory store of compiler outputs for a long-running compiler
+// (--server), under the same keys. It holds up to a byte limit of outputs
+// and drops the oldest entries first. Safe to use from several threads.
+typedef struct cache_memory cache_memory_t;
+
+/**
+ * @brief Creates an empty store holding at most limit bytes of outputs
+ *
+ * @return cache_memory_t* The store, or NULL if out of memory
+ */
+cache_memory_t* cache_memory_create(size_t limit);
+
+void cache_memory_destroy(cache_memory_t* cache);
+
+/**
+ * @brief Writes the entry for key to output_path
+ *
+ * @return int 1 on a hit, 0 if there is no entry (or it cannot be written)
+ */
+int cache_memory_fetch(cache_memory_t* cache, const char* key, const char* output_path);
+
+/**
+ * @brief Stores the contents of path as the entry for key, replacing any
+ *        earlier one
+ *
+ * @return int 1 on success, 0 if path cannot be read or is larger than the
+ *         whole store
+ */
+int cache_memory_store(cache_memory_t* cache, const char* key, const char* path);
+
+#endif // CACHE_H
@@ -1,9 +1,21 @@
 // src/codegen.c
+#define _POSIX_C_SOURCE 200809L   // fileno()
+
+// The BSD register_t these headers declare would clash with codegen.h's
+#define register_t system_register_t
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#undef register_t
 #include "codegen.h"
+#include "peephole.h"
+#include "object.h"
+#include "utils.h"
 
 // Register names for different sizes
 static const char* register_names[][3] = {
@@ -14,29 +26,81 @@ static const char* register_names[][3] = {
     {"rsi", "esi", "sil"}, // REG_RSI
     {"rdi", "edi", "dil"}, // REG_RDI
     {"r8",  "r8d", "r8b"}, // REG_R8
-    {"r9",  "r9d", "r9b"}  // REG_R9
+    {"r9",  "r9d", "r9b"}, // REG_R9
+    {"r10", "r10d", "r10b"}, // REG_R10
+    {"r11", "r11d", "r11b"}, // REG_R11
+    {"r12", "r12d", "r12b"}, // REG_R12
+    {"r13", "r13d", "r13b"}, // REG_R13
+    {"r14", "r14d", "r14b"}, // REG_R14
+    {"r15", "r15d", "r15b"}, // REG_R15
+    {"rsp", "esp", "spl"}, // REG_RSP
+    {"rbp", "ebp", "bpl"}  // REG_RBP
+};
+
+// The same names as operands, with their lengths, for the assembly writer
+typedef struct {
+    const char* text;
+    size_t length;
+} codegen_text_t;
+
+#define CODEGEN_TEXT(literal) {literal, sizeof(literal) - 1}
+#define CODEGEN_REGISTER(q, l, b) {CODEGEN_TEXT("%" q), CODEGEN_TEXT("%" l), CODEGEN_TEXT("%" b)}
+
+static const codegen_text_t register_operands[][3] = {
+    CODEGEN_REGISTER("rax", "eax", "al"),
+    CODEGEN_REGISTER("rbx", "ebx", "bl"),
+    CODEGEN_REGISTER("rcx", "ecx", "cl"),
+    CODEGEN_REGISTER("rdx", "edx", "dl"),
+    CODEGEN_REGISTER("rsi", "esi", "sil"),
+    CODEGEN_REGISTER("rdi", "edi", "dil"),
+    CODEGEN_REGISTER("r8", "r8d", "r8b"),
+    CODEGEN_REGISTER("r9", "r9d", "r9b"),
+    CODEGEN_REGISTER("r10", "r10d", "r10b"),
+    CODEGEN_REGISTER("r11", "r11d", "r11b"),
+    CODEGEN_REGISTER("r12", "r12d", "r12b"),
+    CODEGEN_REGISTER("r13", "r13d", "r13b"),
+    CODEGEN_REGISTER("r14", "r14d", "r14b"),
+    CODEGEN_REGISTER("r15", "r15d", "r15b"),
+    CODEGEN_REGISTER("rsp", "esp", "spl"),
+    CODEGEN_REGISTER("rbp", "ebp", "bpl")
+};
+
+// Integer argument registers in System V order
+static const register_t argument_registers[MAX_REGISTER_ARGS] = {
+    REG_RDI, REG_RSI, REG_RDX, REG_RCX, REG_R8, REG_R9
+};
+
+// Allocatable registers; values live across a call prefer callee-saved ones
+static const register_t caller_saved_registers[] = {
+    REG_RCX, REG_RSI, REG_RDI, REG_R8, REG_R9, REG_R10, REG_R11
 };
+static const register_t callee_saved_registers[] = {
+    REG_RBX, REG_R12, REG_R13, REG_R14, REG_R15
+};
+
+#define COUNT_OF(array) (sizeof(array) / sizeof((array)[0]))
 
 // Code generator lifecycle
-codegen_t* codegen_create(const char* output_filename) {
+// Helper: Generator writing to output (NULL for one that only buffers)
+static codegen_t* codegen_alloc(FILE* output) {
     codegen_t* codegen = malloc(sizeof(codegen_t));
     if (!codegen) return NULL;
     
-    codegen->output = fopen(output_filename, "w");
-    if (!codegen->output) {
-        free(codegen);
-        return NULL;
-    }
-    
+    codegen->output = output;
     codegen->current_function = NULL;
     codegen->string_counter = 0;
-    codegen->label_counter = 0;
-    codegen->next_temp_register = REG_RAX;
-    
-    // Initialize register allocation
-    for (int i = 0; i < MAX_REGISTERS; i++) {
-        codegen->register_used[i] = 0;
-    }
+    codegen->peephole = 0;
+    codegen->object = NULL;
+    codegen->pool = NULL;
+    codegen->use_writev = 0;
+    codegen->write_failed = 0;
+    codegen->emitted_count = 0;
+    codegen->chunk_count = 0;
+    memset(codegen->chunks, 0, sizeof(codegen->chunks));
+    
+    codegen->instr_count = 0;
+    codegen->instr_capacity = 64;
+    codegen->instrs = malloc(codegen->instr_capacity * sizeof(asm_instr_t));
     
     // Initialize string literals
     codegen->string_literal_count = 0;
@@ -44,6 +108,21 @@ codegen_t* codegen_create(const char* output_filename) {
     codegen->string_literals = malloc(codegen->string_literal_capacity * 
                                     sizeof(string_literal_t));
     
+    if (!codegen->instrs || !codegen->string_literals) {
+        free(codegen->instrs);
+        free(codegen->string_literals);
+        free(codegen);
+        return NULL;
+    }
+    return codegen;
+}
+
+codegen_t* codegen_create(const char* output_filename) {
+    FILE* output = fopen(output_filename, "w");
+    if (!output) return NULL;
+    
+    codegen_t* codegen = codegen_alloc(output);
+    if (!codegen) fclose(output);
     return codegen;
 }
 
@@ -51,68 +130,540 @@ void codegen_destroy(codegen_t* codegen) {
     if (!codegen) return;
     
     if (codegen->output) {
+        codegen_write_flush(codegen);
         fclose(codegen->output);
     }
+    for (size_t i = 0; i < CODEGEN_MAX_CHUNKS && codegen->chunks[i]; i++) {
+        free(codegen->chunks[i]);
+    }
     
     if (codegen->current_function) {
         function_context_destroy(codegen->current_function);
     }
     
-    // Free string literals
-    for (size_t i = 0; i < codegen->string_literal_count; i++) {
-        free(codegen->string_literals[i].value);
-        free(codegen->string_literals[i].label);
-    }
     free(codegen->string_literals);
+    free(codegen->instrs);
+    object_destroy(codegen->object);
     
     free(codegen);
 }
 
+// Sized mnemonics: name followed by one suffix character
+static const struct {
+    const char* name;
+    asm_opcode_t opcode;
+} sized_mnemonics[] = {
+    {"mov", ASM_MOV}, {"movzb", ASM_MOVZB}, {"movsb", ASM_MOVSB}, {"movsl", ASM_MOVSL},
+    {"lea", ASM_LEA}, {"add", ASM_ADD}, {"sub", ASM_SUB}, {"imul", ASM_IMUL},
+    {"idiv", ASM_IDIV}, {"neg", ASM_NEG}, {"sal", ASM_SAL}, {"cmp", ASM_CMP},
+    {"test", ASM_TEST}, {"push", ASM_PUSH}, {"pop", ASM_POP}
+};
+
+// Helper: Comparison operator whose condition suffix is text, or -1
+static int codegen_parse_condition(const char* text) {
+    for (int oper = OP_EQ; oper <= OP_GE; oper++) {
+        if (strcmp(codegen_condition_suffix((ast_operator_t)oper), text) == 0) return oper;
+    }
+    return -1;
+}
+
+// Helper: Parse one operand (length bytes of text)
+static void codegen_parse_operand(const char* text, size_t length, asm_operand_t* operand) {
+    char buffer[256];
+    if (length >= sizeof(buffer)) length = sizeof(buffer) - 1;
+    memcpy(buffer, text, length);
+    buffer[length] = '\0';
+    
+    operand->kind = ASM_OPERAND_SYMBOL;
+    operand->reg = REG_NONE;
+    operand->size = 8;
+    operand->value = 0;
+    operand->text = intern_string(buffer);
+    
+    char* end;
+    if (buffer[0] == '%') {
+        for (int reg = 0; reg < MAX_REGISTERS; reg++) {
+            static const int sizes[] = {8, 4, 1};
+            for (size_t i = 0; i < COUNT_OF(sizes); i++) {
+                if (strcmp(buffer + 1, codegen_register_name((register_t)reg, sizes[i])) == 0) {
+                    operand->kind = ASM_OPERAND_REGISTER;
+                    operand->reg = (register_t)reg;
+                    operand->size = sizes[i];
+                    return;
+                }
+            }
+        }
+    } else if (buffer[0] == '$') {
+        long value = strtol(buffer + 1, &end, 10);
+        if (end != buffer + 1 && *end == '\0') {
+            operand->kind = ASM_OPERAND_IMMEDIATE;
+            operand->value = value;
+        }
+    } else {
+        long value = strtol(buffer, &end, 10);
+        if (end != buffer && end[0] == '(' && end[1] == '%') {
+            asm_operand_t base;
+            codegen_parse_operand(end + 1, strcspn(end + 1, ")"), &base);
+            if (base.kind == ASM_OPERAND_REGISTER && base.size == 8) {
+                operand->kind = ASM_OPERAND_MEMORY;
+                operand->reg = base.reg;
+                operand->value = value;
+            }
+        }
+    }
+}
+
+int codegen_parse_instruction(const char* text, asm_instr_t* instr) {
+    memset(instr, 0, sizeof(*instr));
+    instr->kind = ASM_INSTRUCTION;
+    instr->opcode = ASM_OTHER;
+    
+    size_t length = strcspn(text, " \t");
+    if (length == 0 || length >= 16) return 0;
+    char mnemonic[16];
+    memcpy(mnemonic, text, length);
+    mnemonic[length] = '\0';
+    instr->text = intern_string(mnemonic);
+    
+    for (size_t i = 0; i < COUNT_OF(sized_mnemonics) && instr->opcode == ASM_OTHER; i++) {
+        size_t name_length = strlen(sized_mnemonics[i].name);
+        if (length == name_length + 1 && strncmp(mnemonic, sized_mnemonics[i].name, name_length) == 0 &&
+            strchr("bwlq", mnemonic[name_length])) {
+            instr->opcode = sized_mnemonics[i].opcode;
+            instr->suffix = mnemonic[name_length];
+        }
+    }
+    if (instr->opcode == ASM_OTHER) {
+        if (strcmp(mnemonic, "jmp") == 0) instr->opcode = ASM_JMP;
+        else if (strcmp(mnemonic, "call") == 0) {
+            instr->opcode = ASM_CALL;
+            instr->call_arguments = MAX_REGISTER_ARGS;
+        }
+        else if (strcmp(mnemonic, "ret") == 0) instr->opcode = ASM_RET;
+        else if (strcmp(mnemonic, "cqto") == 0) instr->opcode = ASM_CQTO;
+        else if (strncmp(mnemonic, "set", 3) == 0 && codegen_parse_condition(mnemonic + 3) >= 0) {
+            instr->opcode = ASM_SET;
+            instr->condition = (ast_operator_t)codegen_parse_condition(mnemonic + 3);
+        } else if (mnemonic[0] == 'j' && codegen_parse_condition(mnemonic + 1) >= 0) {
+            instr->opcode = ASM_JCC;
+            instr->condition = (ast_operator_t)codegen_parse_condition(mnemonic + 1);
+        }
+    }
+    
+    // Operands are separated by commas outside parentheses
+    const char* cursor = text + length;
+    while (*cursor && instr->operand_count < ASM_MAX_OPERANDS) {
+        while (*cursor == ' ' || *cursor == '\t' || *cursor == ',') cursor++;
+        if (!*cursor) break;
+        
+        const char* start = cursor;
+        int depth = 0;
+        while (*cursor && (depth > 0 || *cursor != ',')) {
+            if (*cursor == '(') depth++;
+            if (*cursor == ')') depth--;
+            cursor++;
+        }
+        const char* end = cursor;
+        while (end > start && (end[-1] == ' ' || end[-1] == '\t')) end--;
+        codegen_parse_operand(start, end - start, &instr->operands[instr->operand_count++]);
+    }
+    return 1;
+}
+
+// Instruction text is assembled piecewise into a bounded buffer; length
+// keeps counting past its end so callers learn the size they need
+typedef struct {
+    char* buffer;
+    size_t size;
+    size_t length;
+} codegen_line_t;
+
+static void codegen_line_put(codegen_line_t* line, const char* text, size_t length) {
+    if (line->length < line->size) {
+        size_t room = line->size - line->length;
+        memcpy(line->buffer + line->length, text, length < room ? length : room);
+    }
+    line->length += length;
+}
+
+static void codegen_line_puts(codegen_line_t* line, const char* text) {
+    codegen_line_put(line, text, strlen(text));
+}
+
+static void codegen_line_char(codegen_line_t* line, char c) {
+    codegen_line_put(line, &c, 1);
+}
+
+static void codegen_line_number(codegen_line_t* line, long value) {
+    char digits[24];
+    char* start = digits + sizeof(digits);
+    unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+    do {
+        *--start = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) *--start = '-';
+    codegen_line_put(line, start, digits + sizeof(digits) - start);
+}
+
+// Helper: Name of local label id of function, as in .Lmain.3
+static void codegen_line_label(codegen_line_t* line, const char* function, long label) {
+    codegen_line_put(line, ".L", 2);
+    codegen_line_puts(line, function);
+    if (label == ASM_RETURN_LABEL) {
+        codegen_line_put(line, ".return", 7);
+    } else {
+        codegen_line_char(line, '.');
+        codegen_line_number(line, label);
+    }
+}
+
+static void codegen_line_register(codegen_line_t* line, register_t reg, int size) {
+    if (reg < 0 || reg >= MAX_REGISTERS) {
+        codegen_line_puts(line, "%INVALID");
+        return;
+    }
+    const codegen_text_t* name = &register_operands[reg][size == 4 ? 1 : size == 1 ? 2 : 0];
+    codegen_line_put(line, name->text, name->length);
+}
+
+// Helper: Format the mnemonic of instr
+static void codegen_line_mnemonic(codegen_line_t* line, const asm_instr_t* instr) {
+    switch (instr->opcode) {
+        case ASM_SET:
+            codegen_line_put(line, "set", 3);
+            codegen_line_puts(line, codegen_condition_suffix(instr->condition));
+            return;
+        case ASM_JCC:
+            codegen_line_char(line, 'j');
+            codegen_line_puts(line, codegen_condition_suffix(instr->condition));
+            return;
+        case ASM_OTHER:
+            codegen_line_puts(line, instr->text);
+            return;
+        default:
+            break;
+    }
+    
+    for (size_t i = 0; i < COUNT_OF(sized_mnemonics); i++) {
+        if (sized_mnemonics[i].opcode == instr->opcode) {
+            codegen_line_puts(line, sized_mnemonics[i].name);
+            if (instr->suffix) codegen_line_char(line, instr->suffix);
+            return;
+        }
+    }
+    codegen_line_puts(line, instr->opcode == ASM_JMP ? "jmp" : instr->opcode == ASM_CALL ? "call" :
+                      instr->opcode == ASM_RET ? "ret" : "cqto");
+}
+
+size_t codegen_format_instruction(const asm_instr_t* instr, char* buffer, size_t size) {
+    codegen_line_t line = {buffer, size > 0 ? size - 1 : 0, 0};
+    
+    if (instr->kind == ASM_LABEL) {
+        if (instr->operand_count == 1) {
+            codegen_line_label(&line, instr->operands[0].text, instr->operands[0].value);
+        } else {
+            codegen_line_puts(&line, instr->text);
+        }
+        codegen_line_put(&line, ":\n", 2);
+    } else if (instr->kind == ASM_COMMENT) {
+        codegen_line_put(&line, "    # ", 6);
+        codegen_line_puts(&line, instr->text);
+        codegen_line_char(&line, '\n');
+    } else {
+        codegen_line_put(&line, "    ", 4);
+        codegen_line_mnemonic(&line, instr);
+        for (int i = 0; i < instr->operand_count; i++) {
+            const asm_operand_t* operand = &instr->operands[i];
+            if (i == 0) {
+                codegen_line_char(&line, ' ');
+            } else {
+                codegen_line_put(&line, ", ", 2);
+            }
+            switch (operand->kind) {
+                case ASM_OPERAND_REGISTER:
+                    codegen_line_register(&line, operand->reg, operand->size);
+                    break;
+                case ASM_OPERAND_IMMEDIATE:
+                    codegen_line_char(&line, '$');
+                    codegen_line_number(&line, operand->value);
+                    break;
+                case ASM_OPERAND_MEMORY:
+                    codegen_line_number(&line, operand->value);
+                    codegen_line_char(&line, '(');
+                    codegen_line_register(&line, operand->reg, 8);
+                    codegen_line_char(&line, ')');
+                    break;
+                case ASM_OPERAND_SYMBOL:
+                    codegen_line_puts(&line, operand->text);
+                    break;
+                case ASM_OPERAND_LABEL:
+                    codegen_line_label(&line, operand->text, operand->value);
+                    break;
+            }
+        }
+        codegen_line_char(&line, '\n');
+    }
+    
+    if (size > 0) buffer[line.length < line.size ? line.length : line.size] = '\0';
+    return line.length;
+}
+
+// Longest line formatted in place; longer ones (long names) take a detour
+#define CODEGEN_LINE_SIZE 512
+
+void codegen_print_instruction(FILE* output, const asm_instr_t* instr) {
+    char buffer[CODEGEN_LINE_SIZE];
+    size_t length = codegen_format_instruction(instr, buffer, sizeof(buffer));
+    if (length < sizeof(buffer)) {
+        fwrite(buffer, 1, length, output);
+        return;
+    }
+    
+    char* line = malloc(length + 1);
+    if (!line) return;
+    codegen_format_instruction(instr, line, length + 1);
+    fwrite(line, 1, length, output);
+    free(line);
+}
+
+// Helper: Write every chunk but the one being filled (all of them if last)
+static void codegen_write_chunks(codegen_t* codegen, size_t count) {
+    if (codegen->use_writev) {
+        // Text fprintf()-ed to the stream before must come first
+        fflush(codegen->output);
+        struct iovec vectors[CODEGEN_MAX_CHUNKS];
+        int used = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (codegen->chunk_sizes[i] == 0) continue;
+            vectors[used].iov_base = codegen->chunks[i];
+            vectors[used].iov_len = codegen->chunk_sizes[i];
+            used++;
+        }
+        
+        // Short writes resume with what is left of the vectors
+        struct iovec* next = vectors;
+        while (used > 0) {
+            ssize_t written = writev(fileno(codegen->output), next, used);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                codegen->write_failed = 1;
+                break;
+            }
+            while (used > 0 && (size_t)written >= next->iov_len) {
+                written -= (ssize_t)next->iov_len;
+                next++;
+                used--;
+            }
+            if (used > 0) {
+                next->iov_base = (char*)next->iov_base + written;
+                next->iov_len -= (size_t)written;
+            }
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            if (fwrite(codegen->chunks[i], 1, codegen->chunk_sizes[i], codegen->output) !=
+                codegen->chunk_sizes[i]) {
+                codegen->write_failed = 1;
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < count; i++) codegen->chunk_sizes[i] = 0;
+}
+
+void codegen_write_flush(codegen_t* codegen) {
+    if (!codegen->output || codegen->chunk_count == 0) return;
+    codegen_write_chunks(codegen, codegen->chunk_count);
+    codegen->chunk_count = 0;
+    if (!codegen->use_writev && fflush(codegen->output) != 0) {
+        codegen->write_failed = 1;
+    }
+}
+
+// Helper: Room for size bytes (at most CODEGEN_CHUNK_SIZE) at the end of the
+// text, starting a new chunk or writing them all out when the last is full
+static char* codegen_write_space(codegen_t* codegen, size_t size) {
+    size_t last = codegen->chunk_count - 1;
+    if (codegen->chunk_count > 0 && CODEGEN_CHUNK_SIZE - codegen->chunk_sizes[last] >= size) {
+        return codegen->chunks[last] + codegen->chunk_sizes[last];
+    }
+    
+    if (codegen->chunk_count == CODEGEN_MAX_CHUNKS) {
+        codegen_write_flush(codegen);
+    }
+    size_t index = codegen->chunk_count;
+    if (!codegen->chunks[index]) {
+        codegen->chunks[index] = malloc(CODEGEN_CHUNK_SIZE);
+        if (!codegen->chunks[index]) {
+            codegen->write_failed = 1;
+            return NULL;
+        }
+    }
+    codegen->chunk_sizes[index] = 0;
+    codegen->chunk_count++;
+    return codegen->chunks[index];
+}
+
+// Helper: Append length bytes of text (of any length) to the output
+static void codegen_write(codegen_t* codegen, const char* text, size_t length) {
+    while (length > 0) {
+        size_t piece = length < CODEGEN_CHUNK_SIZE ? length : CODEGEN_CHUNK_SIZE;
+        if (codegen->chunk_count > 0) {
+            size_t room = CODEGEN_CHUNK_SIZE - codegen->chunk_sizes[codegen->chunk_count - 1];
+            if (room > 0 && room < piece) piece = room;
+        }
+        char* space = codegen_write_space(codegen, piece);
+        if (!space) return;
+        memcpy(space, text, piece);
+        codegen->chunk_sizes[codegen->chunk_count - 1] += piece;
+        text += piece;
+        length -= piece;
+    }
+}
+
+static void codegen_write_string(codegen_t* codegen, const char* text) {
+    codegen_write(codegen, text, strlen(text));
+}
+
+// Helper: Append instr as a line of assembly
+static void codegen_write_instruction(codegen_t* codegen, const asm_instr_t* instr) {
+    char* space = codegen_write_space(codegen, CODEGEN_LINE_SIZE);
+    if (!space) return;
+    size_t length = codegen_format_instruction(instr, space, CODEGEN_LINE_SIZE);
+    if (length < CODEGEN_LINE_SIZE) {
+        codegen->chunk_sizes[codegen->chunk_count - 1] += length;
+        return;
+    }
+    
+    char* line = malloc(length + 1);
+    if (!line) return;
+    codegen_format_instruction(instr, line, length + 1);
+    codegen_write(codegen, line, length);
+    free(line);
+}
+
+// Helper: Next free slot of the instruction buffer. When it cannot grow,
+// the instruction goes to codegen->discarded and the output is failed.
+static asm_instr_t* codegen_append(codegen_t* codegen) {
+    if (codegen->instr_count >= codegen->instr_capacity) {
+        asm_instr_t* instrs = realloc(codegen->instrs, codegen->instr_capacity * 2 * sizeof(asm_instr_t));
+        if (!instrs) {
+            codegen->write_failed = 1;
+            return &codegen->discarded;
+        }
+        codegen->instrs = instrs;
+        codegen->instr_capacity *= 2;
+    }
+    return &codegen->instrs[codegen->instr_count++];
+}
+
 // Assembly output helpers
+// Instructions are formatted as text and parsed back into the buffer, so
+// callers can write plain AT&T syntax; the generator itself builds them
+// with codegen_emit_instr().
 void codegen_emit(codegen_t* codegen, const char* format, ...) {
+    char text[256];
     va_list args;
     va_start(args, format);
-    
-    fprintf(codegen->output, "    ");
-    vfprintf(codegen->output, format, args);
-    fprintf(codegen->output, "\n");
-    
+    vsnprintf(text, sizeof(text), format, args);
     va_end(args);
+    
+    codegen_parse_instruction(text, codegen_append(codegen));
 }
 
 void codegen_emit_label(codegen_t* codegen, const char* label) {
-    fprintf(codegen->output, "%s:\n", label);
+    asm_instr_t* instr = codegen_append(codegen);
+    memset(instr, 0, sizeof(*instr));
+    instr->kind = ASM_LABEL;
+    instr->text = intern_string(label);
 }
 
 void codegen_emit_comment(codegen_t* codegen, const char* comment) {
-    fprintf(codegen->output, "    # %s\n", comment);
+    asm_instr_t* instr = codegen_append(codegen);
+    memset(instr, 0, sizeof(*instr));
+    instr->kind = ASM_COMMENT;
+    instr->text = intern_string(comment);
 }
 
-// Register management
-register_t codegen_allocate_register(codegen_t* codegen) {
-    for (int i = 0; i < MAX_REGISTERS; i++) {
-        if (!codegen->register_used[i]) {
-            codegen->register_used[i] = 1;
-            return (register_t)i;
-        }
-    }
+// Structured emission
+asm_operand_t codegen_register_operand(register_t reg, int size) {
+    asm_operand_t operand = {ASM_OPERAND_REGISTER, reg, size, 0, NULL};
+    return operand;
+}
+
+asm_operand_t codegen_immediate_operand(long value) {
+    asm_operand_t operand = {ASM_OPERAND_IMMEDIATE, REG_NONE, 8, value, NULL};
+    return operand;
+}
+
+asm_operand_t codegen_memory_operand(register_t base, long offset) {
+    asm_operand_t operand = {ASM_OPERAND_MEMORY, base, 8, offset, NULL};
+    return operand;
+}
+
+asm_operand_t codegen_symbol_operand(const char* text) {
+    asm_operand_t operand = {ASM_OPERAND_SYMBOL, REG_NONE, 8, 0, text};
+    return operand;
+}
+
+asm_operand_t codegen_label_operand(const char* function, long label) {
+    asm_operand_t operand = {ASM_OPERAND_LABEL, REG_NONE, 8, label, function};
+    return operand;
+}
+
+asm_instr_t* codegen_emit_instr(codegen_t* codegen, asm_opcode_t opcode, char suffix, int operand_count, ...) {
+    asm_instr_t* instr = codegen_append(codegen);
+    memset(instr, 0, sizeof(*instr));
+    instr->kind = ASM_INSTRUCTION;
+    instr->opcode = opcode;
+    instr->suffix = suffix;
+    if (opcode == ASM_CALL) instr->call_arguments = MAX_REGISTER_ARGS;
     
-    // If we run out of registers, just reuse RAX (simple strategy)
-    return REG_RAX;
+    va_list args;
+    va_start(args, operand_count);
+    for (int i = 0; i < operand_count && i < ASM_MAX_OPERANDS; i++) {
+        instr->operands[instr->operand_count++] = va_arg(args, asm_operand_t);
+    }
+    va_end(args);
+    return instr;
 }
 
-void codegen_free_register(codegen_t* codegen, register_t reg) {
-    if (reg >= 0 && reg < MAX_REGISTERS) {
-        codegen->register_used[reg] = 0;
+void codegen_emit_local_label(codegen_t* codegen, const char* function, long label) {
+    asm_instr_t* instr = codegen_append(codegen);
+    memset(instr, 0, sizeof(*instr));
+    instr->kind = ASM_LABEL;
+    instr->operands[0] = codegen_label_operand(function, label);
+    instr->operand_count = 1;
+}
+
+// Helper: Print or encode the buffered instructions and empty the buffer
+static void codegen_write_instrs(codegen_t* codegen) {
+    for (size_t i = 0; i < codegen->instr_count; i++) {
+        if (codegen->instrs[i].kind == ASM_INSTRUCTION) codegen->emitted_count++;
+    }
+    if (codegen->object) {
+        // Encoding stops at the first failure, which object_write() reports
+        if (!codegen->object->failed) {
+            object_encode(codegen->object, codegen->instrs, codegen->instr_count);
+        }
+        codegen->instr_count = 0;
+        return;
+    }
+    for (size_t i = 0; i < codegen->instr_count; i++) {
+        codegen_write_instruction(codegen, &codegen->instrs[i]);
     }
+    codegen->instr_count = 0;
 }
 
-void codegen_free_all_registers(codegen_t* codegen) {
-    for (int i = 0; i < MAX_REGISTERS; i++) {
-        codegen->register_used[i] = 0;
+void codegen_flush(codegen_t* codegen) {
+    if (codegen->peephole) {
+        peephole_optimize(codegen);
     }
+    codegen_write_instrs(codegen);
 }
 
+// Register management
 const char* codegen_register_name(register_t reg, int size) {
     if (reg < 0 || reg >= MAX_REGISTERS) return "INVALID";
     
@@ -124,112 +675,229 @@ const char* codegen_register_name(register_t reg, int size) {
     }
 }
 
+int codegen_register_is_callee_saved(register_t reg) {
+    for (size_t i = 0; i < COUNT_OF(callee_saved_registers); i++) {
+        if (callee_saved_registers[i] == reg) return 1;
+    }
+    return 0;
+}
+
 // Function context management
-function_context_t* function_context_create(const char* name) {
+function_context_t* function_context_create(ir_function_t* function) {
     function_context_t* context = malloc(sizeof(function_context_t));
     if (!context) return NULL;
     
-    context->name = malloc(strlen(name) + 1);
-    strcpy(context->name, name);
-    context->stack_size = 0;
-    context->variable_count = 0;
-    context->variable_capacity = 10;
-    context->label_counter = 0;
+    int vreg_count = function->vreg_count > 0 ? function->vreg_count : 1;
     
-    context->variables = malloc(context->variable_capacity * sizeof(stack_var_t));
-    if (!context->variables) {
-        free(context->name);
+    context->name = function->name;
+    context->ir = function;
+    context->spill_count = 0;
+    context->stack_size = 0;
+    context->saved_register_count = 0;
+    context->call_clobbered_count = 0;
+    
+    context->intervals = malloc(vreg_count * sizeof(ir_interval_t));
+    context->locations = malloc(vreg_count * sizeof(vreg_location_t));
+    context->call_clobbered = malloc(vreg_count * sizeof(int));
+    if (!context->intervals || !context->locations || !context->call_clobbered) {
+        free(context->intervals);
+        free(context->locations);
+        free(context->call_clobbered);
         free(context);
         return NULL;
     }
     
+    for (int v = 0; v < function->vreg_count; v++) {
+        context->locations[v].reg = REG_NONE;
+        context->locations[v].offset = 0;
+    }
+    
+    ir_compute_intervals(function, context->intervals);
+    function_context_allocate_registers(context);
+    
     return context;
 }
 
 void function_context_destroy(function_context_t* context) {
     if (!context) return;
     
-    free(context->name);
-    
-    for (size_t i = 0; i < context->variable_count; i++) {
-        free(context->variables[i].name);
-    }
-    free(context->variables);
+    // Name and IR are owned by the IR program
+    free(context->intervals);
+    free(context->locations);
+    free(context->call_clobbered);
     
     free(context);
 }
 
-int function_context_add_variable(function_context_t* context, const char* name, data_type_t type) {
-    if (!context) return -1;
+// Helper: Order intervals by start point (ties by vreg for determinism)
+static int interval_compare_start(const void* a, const void* b) {
+    const ir_interval_t* left = *(const ir_interval_t* const*)a;
+    const ir_interval_t* right = *(const ir_interval_t* const*)b;
     
-    if (context->variable_count >= context->variable_capacity) {
-        context->variable_capacity *= 2;
-        context->variables = realloc(context->variables,
-                                   context->variable_capacity * sizeof(stack_var_t));
-        if (!context->variables) return -1;
+    if (left->start != right->start) return left->start < right->start ? -1 : 1;
+    return left->vreg - right->vreg;
+}
+
+// Helper: Give vreg its own spill slot
+static void function_context_spill(function_context_t* context, int vreg) {
+    context->locations[vreg].reg = REG_NONE;
+    context->locations[vreg].offset = -8 * ++context->spill_count;
+}
+
+// Helper: First register of pool not marked busy
+static register_t function_context_free_register(const register_t* pool, size_t count,
+                                                 const int* busy) {
+    for (size_t i = 0; i < count; i++) {
+        if (!busy[pool[i]]) return pool[i];
+    }
+    return REG_NONE;
+}
+
+// Linear-scan register allocation (Poletto & Sarkar). Intervals are visited
+// in order of increasing start; when no register is free, whichever of the
+// current interval and the active interval ending last is spilled whole.
+void function_context_allocate_registers(function_context_t* context) {
+    ir_function_t* function = context->ir;
+    ir_interval_t** sorted = malloc((function->vreg_count + 1) * sizeof(ir_interval_t*));
+    ir_interval_t* active[MAX_REGISTERS];
+    size_t active_count = 0;
+    size_t interval_count = 0;
+    int busy[MAX_REGISTERS] = {0};
+    int used[MAX_REGISTERS] = {0};
+    
+    if (!sorted) return;
+    
+    for (int v = 0; v < function->vreg_count; v++) {
+        if (context->intervals[v].start >= 0) {
+            sorted[interval_count++] = &context->intervals[v];
+        }
     }
+    qsort(sorted, interval_count, sizeof(ir_interval_t*), interval_compare_start);
     
-    stack_var_t* var = &context->variables[context->variable_count++];
-    var->name = malloc(strlen(name) + 1);
-    strcpy(var->name, name);
-    var->type = type;
+    for (size_t i = 0; i < interval_count; i++) {
+        ir_interval_t* current = sorted[i];
+        
+        // Expire intervals that ended before this one starts
+        size_t kept = 0;
+        for (size_t a = 0; a < active_count; a++) {
+            if (active[a]->end < current->start) {
+                busy[context->locations[active[a]->vreg].reg] = 0;
+            } else {
+                active[kept++] = active[a];
+            }
+        }
+        active_count = kept;
+        
+        // A call clobbers caller-saved registers, so values live across one
+        // take a callee-saved register first (saved once in the prologue)
+        // and fall back to a caller-saved one saved around each call
+        register_t reg = REG_NONE;
+        if (!current->crosses_call) {
+            reg = function_context_free_register(caller_saved_registers,
+                                                 COUNT_OF(caller_saved_registers), busy);
+        }
+        if (reg == REG_NONE) {
+            reg = function_context_free_register(callee_saved_registers,
+                                                 COUNT_OF(callee_saved_registers), busy);
+        }
+        if (reg == REG_NONE && current->crosses_call) {
+            reg = function_context_free_register(caller_saved_registers,
+                                                 COUNT_OF(caller_saved_registers), busy);
+        }
+        
+        if (reg == REG_NONE) {
+            // Spill whichever interval ends last
+            size_t victim = active_count;
+            for (size_t a = 0; a < active_count; a++) {
+                if (victim == active_count || active[a]->end > active[victim]->end) {
+                    victim = a;
+                }
+            }
+            
+            if (victim == active_count || active[victim]->end <= current->end) {
+                function_context_spill(context, current->vreg);
+                continue;
+            }
+            
+            reg = context->locations[active[victim]->vreg].reg;
+            function_context_spill(context, active[victim]->vreg);
+            active[victim] = active[--active_count];
+        }
+        
+        context->locations[current->vreg].reg = reg;
+        busy[reg] = 1;
+        used[reg] = 1;
+        active[active_count++] = current;
+    }
     
-    // Allocate stack space (align to 8 bytes)
-    int size = codegen_type_size(type);
-    context->stack_size += (size + 7) & ~7;
-    var->offset = -context->stack_size;
+    free(sorted);
     
-    return var->offset;
-}
-
-stack_var_t* function_context_find_variable(function_context_t* context, const char* name) {
-    if (!context) return NULL;
+    for (int v = 0; v < function->vreg_count; v++) {
+        register_t reg = context->locations[v].reg;
+        if (reg != REG_NONE && context->intervals[v].crosses_call && !codegen_register_is_callee_saved(reg)) {
+            context->call_clobbered[context->call_clobbered_count++] = v;
+        }
+    }
     
-    for (size_t i = 0; i < context->variable_count; i++) {
-        if (strcmp(context->variables[i].name, name) == 0) {
-            return &context->variables[i];
+    // Callee-saved registers we touch are pushed below the frame pointer,
+    // so spill slots start after them
+    for (size_t i = 0; i < COUNT_OF(callee_saved_registers); i++) {
+        if (used[callee_saved_registers[i]]) {
+            context->saved_registers[context->saved_register_count++] = callee_saved_registers[i];
         }
     }
     
-    return NULL;
-}
-
-// Label generation
-char* codegen_generate_label(codegen_t* codegen, const char* prefix) {
-    char* label = malloc(64);
-    snprintf(label, 64, ".L%s%d", prefix, codegen->label_counter++);
-    return label;
-}
-
-char* codegen_generate_string_label(codegen_t* codegen) {
-    char* label = malloc(32);
-    snprintf(label, 32, ".LC%d", codegen->string_counter++);
-    return label;
+    int saved_bytes = 8 * context->saved_register_count;
+    for (int v = 0; v < function->vreg_count; v++) {
+        if (context->locations[v].offset) {
+            context->locations[v].offset -= saved_bytes;
+        }
+    }
+    
+    // Keep %rsp 16-byte aligned after the prologue
+    context->stack_size = 8 * context->spill_count;
+    if ((saved_bytes + context->stack_size) % 16) {
+        context->stack_size += 8;
+    }
 }
 
 // String literal management
-const char* codegen_add_string_literal(codegen_t* codegen, const char* value) {
-    // Check if string already exists
+// Helper: Entry for value, added if it is new (NULL, failing the output,
+// when the table cannot grow)
+static string_literal_t* codegen_string_literal(codegen_t* codegen, const char* value) {
+    // Check if string already exists (interned, so pointer equality suffices)
     for (size_t i = 0; i < codegen->string_literal_count; i++) {
-        if (strcmp(codegen->string_literals[i].value, value) == 0) {
-            return codegen->string_literals[i].label;
+        if (codegen->string_literals[i].value == value) {
+            return &codegen->string_literals[i];
         }
     }
     
     // Add new string literal
     if (codegen->string_literal_count >= codegen->string_literal_capacity) {
+        string_literal_t* literals = realloc(codegen->string_literals,
+                                             codegen->string_literal_capacity * 2 *
+                                             sizeof(string_literal_t));
+        if (!literals) {
+            codegen->write_failed = 1;
+            return NULL;
+        }
+        codegen->string_literals = literals;
         codegen->string_literal_capacity *= 2;
-        codegen->string_literals = realloc(codegen->string_literals,
-                                          codegen->string_literal_capacity * 
-                                          sizeof(string_literal_t));
     }
     
     string_literal_t* literal = &codegen->string_literals[codegen->string_literal_count++];
-    literal->value = malloc(strlen(value) + 1);
-    strcpy(literal->value, value);
-    literal->label = codegen_generate_string_label(codegen);
+    literal->value = value;
+    literal->id = codegen->string_counter++;
     
-    return literal->label;
+    char address[48];
+    snprintf(address, sizeof(address), ".LC%d(%%rip)", literal->id);
+    literal->address = intern_string(address);
+    return literal;
+}
+
+int codegen_add_string_literal(codegen_t* codegen, const char* value) {
+    string_literal_t* literal = codegen_string_literal(codegen, value);
+    return literal ? literal->id : -1;
 }
 
 // Utility functions
@@ -252,456 +920,704 @@ const char* codegen_type_suffix(data_type_t type) {
     }
 }
 
+// Condition code for a comparison operator (setCC / jCC suffix)
+const char* codegen_condition_suffix(ast_operator_t oper) {
+    static const char* const suffixes[] = {
+        [OP_EQ] = "e", [OP_NE] = "ne",
+        [OP_LT] = "l", [OP_LE] = "le",
+        [OP_GT] = "g", [OP_GE] = "ge"
+    };
+    
+    if ((unsigned int)oper >= sizeof(suffixes) / sizeof(suffixes[0]) || !suffixes[oper]) {
+        return "e";
+    }
+    return suffixes[oper];
+}
+
+// Comparison that holds exactly when oper does not
+ast_operator_t codegen_inverse_condition(ast_operator_t oper) {
+    switch (oper) {
+        case OP_EQ: return OP_NE;
+        case OP_NE: return OP_EQ;
+        case OP_LT: return OP_GE;
+        case OP_LE: return OP_GT;
+        case OP_GT: return OP_LE;
+        case OP_GE: return OP_LT;
+        default: return oper;
+    }
+}
+
 // Main code generation
 int codegen_generate(codegen_t* codegen, ast_node_t* ast) {
     if (!codegen || !ast) return 0;
     
-    codegen_program(codegen, ast);
+    ir_program_t* program = ir_lower_program(ast);
+    if (!program) return 0;
+    if (program->unresolved) {
+        ir_program_destroy(program);
+        return 0;
+    }
+    
+    codegen_program(codegen, program);
+    ir_program_destroy(program);
     return 1;
 }
 
-void codegen_program(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_PROGRAM) return;
+static void codegen_functions_parallel(codegen_t* codegen, ir_program_t* program);
+
+void codegen_program(codegen_t* codegen, ir_program_t* program) {
+    if (!program) return;
     
     // Emit assembly header
-    codegen_emit_comment(codegen, "Generated by TinyC Compiler");
-    fprintf(codegen->output, ".section .data\n");
+    if (!codegen->object) {
+        codegen_emit_comment(codegen, "Generated by TinyC Compiler");
+        codegen_flush(codegen);
+        codegen_write_string(codegen, ".section .text\n");
+    }
+    
+    if (codegen->pool && program->function_count > 1) {
+        codegen_functions_parallel(codegen, program);
+    } else {
+        for (size_t i = 0; i < program->function_count; i++) {
+            codegen_function(codegen, program->functions[i]);
+        }
+    }
     
-    // Generate code for all functions first to collect string literals
-    for (size_t i = 0; i < node->data.program.declaration_count; i++) {
-        ast_node_t* decl = node->data.program.declarations[i];
-        if (decl->type == AST_FUNCTION_DECL && decl->data.function_decl.body) {
-            // We'll generate functions in the text section
+    if (codegen->object) {
+        for (size_t i = 0; i < codegen->string_literal_count; i++) {
+            char label[32];
+            snprintf(label, sizeof(label), ".LC%d", codegen->string_literals[i].id);
+            object_add_string(codegen->object, label, codegen->string_literals[i].value);
         }
+        return;
     }
     
-    // Emit string literals if any were collected
+    // String literals are collected while the functions are generated
     if (codegen->string_literal_count > 0) {
+        codegen_write_string(codegen, ".section .data\n");
         for (size_t i = 0; i < codegen->string_literal_count; i++) {
-            fprintf(codegen->output, "%s:\n", codegen->string_literals[i].label);
-            fprintf(codegen->output, "    .string \"%s\"\n", codegen->string_literals[i].value);
+            char label[32];
+            snprintf(label, sizeof(label), ".LC%d:\n    .string \"", codegen->string_literals[i].id);
+            codegen_write_string(codegen, label);
+            codegen_write_string(codegen, codegen->string_literals[i].value);
+            codegen_write_string(codegen, "\"\n");
         }
-        fprintf(codegen->output, "\n");
+        codegen_write_string(codegen, "\n");
     }
+    codegen_write_flush(codegen);
+}
+
+// Helper: Register holding vreg, or REG_NONE if it lives in a spill slot
+static register_t codegen_vreg_register(codegen_t* codegen, int vreg) {
+    return codegen->current_function->locations[vreg].reg;
+}
+
+// Helper: The location of vreg as an operand
+static asm_operand_t codegen_operand(codegen_t* codegen, int vreg) {
+    vreg_location_t* location = &codegen->current_function->locations[vreg];
     
-    fprintf(codegen->output, ".section .text\n");
+    if (location->reg != REG_NONE) {
+        return codegen_register_operand(location->reg, 8);
+    }
+    return codegen_memory_operand(REG_RBP, location->offset);
+}
+
+// Helper: The 64-bit register reg as an operand
+static asm_operand_t codegen_quad(register_t reg) {
+    return codegen_register_operand(reg, 8);
+}
+
+// Helper: Emit "opq src, dst" over two vreg locations
+static void codegen_emit_vreg_op(codegen_t* codegen, asm_opcode_t opcode, int src, int dst) {
+    codegen_emit_instr(codegen, opcode, 'q', 2, codegen_operand(codegen, src), codegen_operand(codegen, dst));
+}
+
+// Helper: Emit "movq vreg, %reg" / "movq %reg, vreg"
+static void codegen_emit_load(codegen_t* codegen, int vreg, register_t reg) {
+    codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_operand(codegen, vreg), codegen_quad(reg));
+}
+
+static void codegen_emit_store(codegen_t* codegen, register_t reg, int vreg) {
+    codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_quad(reg), codegen_operand(codegen, vreg));
+}
+
+// Helper: Emit "pushq x" / "popq x"
+static void codegen_emit_push(codegen_t* codegen, asm_operand_t operand) {
+    codegen_emit_instr(codegen, ASM_PUSH, 'q', 1, operand);
+}
+
+static void codegen_emit_pop(codegen_t* codegen, asm_operand_t operand) {
+    codegen_emit_instr(codegen, ASM_POP, 'q', 1, operand);
+}
+
+// Helper: dst = src between arbitrary locations (memory to memory goes through %rax)
+static void codegen_emit_move(codegen_t* codegen, int dst, int src) {
+    vreg_location_t* locations = codegen->current_function->locations;
     
-    // Generate code for all functions
-    for (size_t i = 0; i < node->data.program.declaration_count; i++) {
-        ast_node_t* decl = node->data.program.declarations[i];
-        if (decl->type == AST_FUNCTION_DECL) {
-            codegen_function_decl(codegen, decl);
-        }
+    if (locations[dst].reg == locations[src].reg && locations[dst].offset == locations[src].offset) {
+        return;
+    }
+    
+    if (locations[dst].reg == REG_NONE && locations[src].reg == REG_NONE) {
+        codegen_emit_load(codegen, src, REG_RAX);
+        codegen_emit_store(codegen, REG_RAX, dst);
+    } else {
+        codegen_emit_vreg_op(codegen, ASM_MOV, src, dst);
     }
 }
 
-void codegen_function_decl(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_FUNCTION_DECL) return;
+// Helper: True if the value instr writes is never read
+static int codegen_is_dead_definition(codegen_t* codegen, size_t index) {
+    ir_instr_t* instr = &codegen->current_function->ir->instrs[index];
     
-    // Skip function declarations without bodies
-    if (!node->data.function_decl.body) return;
+    if (instr->dst == IR_NO_VREG) return 0;
+    if (codegen->current_function->intervals[instr->dst].end != (int)index) return 0;
     
-    // Create function context
-    codegen->current_function = function_context_create(node->data.function_decl.name);
+    for (size_t u = 0; u < ir_instr_use_count(instr); u++) {
+        if (ir_instr_use(instr, u) == instr->dst) return 0;
+    }
+    return 1;
+}
+
+// Helper: True if instrs[index] is a comparison read only by the conditional
+// jump right after it, which then branches on the flags of the cmp
+static int codegen_is_fused_compare(codegen_t* codegen, size_t index) {
+    function_context_t* context = codegen->current_function;
+    if (index + 1 >= context->ir->instr_count) return 0;
+    
+    ir_instr_t* instr = &context->ir->instrs[index];
+    ir_instr_t* next = &context->ir->instrs[index + 1];
+    if (instr->opcode != IR_BINARY || instr->oper < OP_EQ || instr->oper > OP_GE) return 0;
+    if (next->opcode != IR_JUMP_ZERO && next->opcode != IR_JUMP_NONZERO) return 0;
+    if (next->src1 != instr->dst) return 0;
+    
+    // A value live into either successor would extend past the jump
+    const ir_interval_t* interval = &context->intervals[instr->dst];
+    return interval->start == (int)index && interval->end == (int)index + 1;
+}
+
+// Helper: Move incoming argument registers into the parameters' locations.
+// Pushing them all first keeps this correct whatever registers were assigned.
+static void codegen_store_parameters(codegen_t* codegen) {
+    ir_function_t* function = codegen->current_function->ir;
+    ir_instr_t* params[MAX_REGISTER_ARGS];
+    size_t count = 0;
+    
+    for (size_t i = 0; i < function->instr_count && function->instrs[i].opcode == IR_PARAM; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->imm < MAX_REGISTER_ARGS && !codegen_is_dead_definition(codegen, i)) {
+            params[count++] = instr;
+        }
+    }
     
-    // Add parameters to function context
-    for (size_t i = 0; i < node->data.function_decl.parameter_count; i++) {
-        ast_node_t* param = node->data.function_decl.parameters[i];
-        function_context_add_variable(codegen->current_function,
-                                    param->data.parameter.name,
-                                    param->data.parameter.param_type);
+    if (count == 1) {
+        codegen_emit_store(codegen, argument_registers[params[0]->imm], params[0]->dst);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            codegen_emit_push(codegen, codegen_quad(argument_registers[params[i]->imm]));
+        }
+        while (count > 0) {
+            count--;
+            codegen_emit_pop(codegen, codegen_operand(codegen, params[count]->dst));
+        }
     }
     
-    // Make main function global
-    if (strcmp(node->data.function_decl.name, "main") == 0) {
-        fprintf(codegen->output, ".global main\n");
+    // Stack arguments sit above the saved %rbp and return address; load
+    // them last so they cannot overwrite an argument register still unread
+    for (size_t i = 0; i < function->instr_count && function->instrs[i].opcode == IR_PARAM; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->imm < MAX_REGISTER_ARGS || codegen_is_dead_definition(codegen, i)) continue;
+        
+        register_t reg = codegen_vreg_register(codegen, instr->dst);
+        codegen_emit_instr(codegen, ASM_MOV, 'q', 2,
+                           codegen_memory_operand(REG_RBP, 16 + 8 * (instr->imm - MAX_REGISTER_ARGS)),
+                           codegen_quad(reg != REG_NONE ? reg : REG_RAX));
+        if (reg == REG_NONE) {
+            codegen_emit_store(codegen, REG_RAX, instr->dst);
+        }
     }
+}
+
+// Helper: Generate function into the instruction buffer; 0 on failure
+static int codegen_function_body(codegen_t* codegen, ir_function_t* function) {
+    // Allocate registers for the whole function up front
+    codegen->current_function = function_context_create(function);
+    if (!codegen->current_function) return 0;
+    function_context_t* context = codegen->current_function;
     
     // Function label
-    fprintf(codegen->output, "%s:\n", node->data.function_decl.name);
+    codegen_emit_label(codegen, function->name);
+    
+    // Leaf functions that keep everything in caller-saved registers never
+    // address the frame, so they skip setting up %rbp
+    int needs_frame = context->stack_size > 0 || context->saved_register_count > 0 ||
+                      function->param_count > MAX_REGISTER_ARGS;
+    for (size_t i = 0; i < function->instr_count && !needs_frame; i++) {
+        needs_frame = function->instrs[i].opcode == IR_CALL;
+    }
     
     // Function prologue
-    codegen_emit(codegen, "pushq %%rbp");
-    codegen_emit(codegen, "movq %%rsp, %%rbp");
-    
-    // Allocate stack space if needed
-    if (codegen->current_function->stack_size > 0) {
-        codegen_emit(codegen, "subq $%d, %%rsp", 
-                    (codegen->current_function->stack_size + 15) & ~15); // Align to 16 bytes
+    if (needs_frame) {
+        codegen_emit_push(codegen, codegen_quad(REG_RBP));
+        codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_quad(REG_RSP), codegen_quad(REG_RBP));
+    }
+    for (int i = 0; i < context->saved_register_count; i++) {
+        codegen_emit_push(codegen, codegen_quad(context->saved_registers[i]));
+    }
+    if (context->stack_size > 0) {
+        codegen_emit_instr(codegen, ASM_SUB, 'q', 2, codegen_immediate_operand(context->stack_size),
+                           codegen_quad(REG_RSP));
     }
+    codegen_store_parameters(codegen);
     
-    // Generate function body
-    codegen_compound_stmt(codegen, node->data.function_decl.body);
+    // Function body
+    for (size_t i = 0; i < function->instr_count; i++) {
+        codegen_instruction(codegen, i);
+    }
     
     // Function epilogue
-    codegen_emit_label(codegen, ".Lreturn");
-    if (node->data.function_decl.return_type == TYPE_VOID) {
-        codegen_emit(codegen, "movq $0, %%rax");  // Default return value for void
+    codegen_emit_local_label(codegen, function->name, ASM_RETURN_LABEL);
+    if (context->saved_register_count > 0) {
+        if (context->stack_size > 0) {
+            codegen_emit_instr(codegen, ASM_LEA, 'q', 2,
+                               codegen_memory_operand(REG_RBP, -8 * context->saved_register_count),
+                               codegen_quad(REG_RSP));
+        }
+        for (int i = context->saved_register_count; i > 0; i--) {
+            codegen_emit_pop(codegen, codegen_quad(context->saved_registers[i - 1]));
+        }
+    } else if (context->stack_size > 0) {
+        codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_quad(REG_RBP), codegen_quad(REG_RSP));
     }
-    codegen_emit(codegen, "movq %%rbp, %%rsp");
-    codegen_emit(codegen, "popq %%rbp");
-    codegen_emit(codegen, "ret");
-    
-    fprintf(codegen->output, "\n");
+    if (needs_frame) {
+        codegen_emit_pop(codegen, codegen_quad(REG_RBP));
+    }
+    codegen_emit_instr(codegen, ASM_RET, '\0', 0);
     
     // Clean up function context
     function_context_destroy(codegen->current_function);
     codegen->current_function = NULL;
+    return 1;
 }
 
-void codegen_statement(codegen_t* codegen, ast_node_t* node) {
-    if (!node) return;
+// Helper: Write out the buffered body of function name
+static void codegen_function_write(codegen_t* codegen, const char* name) {
+    // Every function is global so other files can call it
+    if (codegen->object) {
+        object_set_global(codegen->object, name);
+    } else {
+        codegen_write_string(codegen, ".global ");
+        codegen_write_string(codegen, name);
+        codegen_write_string(codegen, "\n");
+    }
     
-    switch (node->type) {
-        case AST_COMPOUND_STMT:
-            codegen_compound_stmt(codegen, node);
-            break;
-        case AST_IF_STMT:
-            codegen_if_stmt(codegen, node);
-            break;
-        case AST_WHILE_STMT:
-            codegen_while_stmt(codegen, node);
-            break;
-        case AST_FOR_STMT:
-            codegen_for_stmt(codegen, node);
-            break;
-        case AST_RETURN_STMT:
-            codegen_return_stmt(codegen, node);
-            break;
-        case AST_EXPRESSION_STMT:
-            codegen_expression_stmt(codegen, node);
-            break;
-        case AST_VARIABLE_DECL:
-            codegen_variable_decl(codegen, node);
-            break;
-        default:
-            break;
+    codegen_write_instrs(codegen);
+    if (!codegen->object) {
+        codegen_write_string(codegen, "\n");
     }
 }
 
-void codegen_compound_stmt(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_COMPOUND_STMT) return;
+void codegen_function(codegen_t* codegen, ir_function_t* function) {
+    if (!function || !codegen_function_body(codegen, function)) return;
     
-    for (size_t i = 0; i < node->data.compound_stmt.statement_count; i++) {
-        codegen_statement(codegen, node->data.compound_stmt.statements[i]);
+    if (codegen->peephole) {
+        peephole_optimize(codegen);
     }
+    codegen_function_write(codegen, function->name);
 }
 
-void codegen_if_stmt(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_IF_STMT) return;
-    
-    char* else_label = codegen_generate_label(codegen, "else");
-    char* end_label = codegen_generate_label(codegen, "endif");
-    
-    // Evaluate condition
-    register_t cond_reg = codegen_expression(codegen, node->data.if_stmt.condition);
-    codegen_emit(codegen, "testq %%%s, %%%s", 
-                codegen_register_name(cond_reg, 8),
-                codegen_register_name(cond_reg, 8));
-    codegen_free_register(codegen, cond_reg);
-    
-    // Jump to else if condition is false
-    if (node->data.if_stmt.else_stmt) {
-        codegen_emit(codegen, "jz %s", else_label);
-    } else {
-        codegen_emit(codegen, "jz %s", end_label);
-    }
-    
-    // Then branch
-    codegen_statement(codegen, node->data.if_stmt.then_stmt);
-    
-    if (node->data.if_stmt.else_stmt) {
-        codegen_emit(codegen, "jmp %s", end_label);
-        codegen_emit_label(codegen, else_label);
-        codegen_statement(codegen, node->data.if_stmt.else_stmt);
+// Function generated on a pool thread
+typedef struct {
+    codegen_t* codegen;   // Own generator buffering the function's instructions
+    ir_function_t* function;
+    int generated;
+} codegen_function_job_t;
+
+// Helper: Generate and peephole-optimize one function (a pool_function_t)
+static void codegen_function_job(void* argument) {
+    codegen_function_job_t* job = argument;
+    job->generated = codegen_function_body(job->codegen, job->function);
+    if (job->generated && job->codegen->peephole) {
+        peephole_optimize(job->codegen);
     }
-    
-    codegen_emit_label(codegen, end_label);
-    
-    free(else_label);
-    free(end_label);
 }
 
-void codegen_while_stmt(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_WHILE_STMT) return;
-    
-    char* loop_label = codegen_generate_label(codegen, "while");
-    char* end_label = codegen_generate_label(codegen, "endwhile");
-    
-    // Loop label
-    codegen_emit_label(codegen, loop_label);
-    
-    // Evaluate condition
-    register_t cond_reg = codegen_expression(codegen, node->data.while_stmt.condition);
-    codegen_emit(codegen, "testq %%%s, %%%s",
-                codegen_register_name(cond_reg, 8),
-                codegen_register_name(cond_reg, 8));
-    codegen_free_register(codegen, cond_reg);
-    
-    // Jump to end if condition is false
-    codegen_emit(codegen, "jz %s", end_label);
-    
-    // Loop body
-    codegen_statement(codegen, node->data.while_stmt.body);
-    
-    // Jump back to condition
-    codegen_emit(codegen, "jmp %s", loop_label);
-    
-    codegen_emit_label(codegen, end_label);
+// Helper: Rename the string labels in worker's buffer to those of codegen
+static void codegen_merge_strings(codegen_t* codegen, codegen_t* worker) {
+    if (worker->string_literal_count == 0) return;
+    
+    // Worker operands are the interned addresses of worker->string_literals
+    const char** addresses = malloc(worker->string_literal_count * sizeof(char*));
+    if (!addresses) {
+        codegen->write_failed = 1;
+        return;
+    }
+    int renamed = 0;
+    for (size_t i = 0; i < worker->string_literal_count; i++) {
+        string_literal_t* literal = codegen_string_literal(codegen, worker->string_literals[i].value);
+        if (!literal) {
+            free(addresses);
+            return;
+        }
+        addresses[i] = literal->address;
+        renamed |= addresses[i] != worker->string_literals[i].address;
+    }
     
-    free(loop_label);
-    free(end_label);
+    for (size_t i = 0; renamed && i < worker->instr_count; i++) {
+        asm_instr_t* instr = &worker->instrs[i];
+        if (instr->kind != ASM_INSTRUCTION) continue;
+        for (int o = 0; o < instr->operand_count; o++) {
+            asm_operand_t* operand = &instr->operands[o];
+            if (operand->kind != ASM_OPERAND_SYMBOL) continue;
+            for (size_t s = 0; s < worker->string_literal_count; s++) {
+                if (operand->text == worker->string_literals[s].address) {
+                    operand->text = addresses[s];
+                    break;
+                }
+            }
+        }
+    }
+    free(addresses);
 }
 
-void codegen_for_stmt(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_FOR_STMT) return;
-    
-    char* loop_label = codegen_generate_label(codegen, "for");
-    char* update_label = codegen_generate_label(codegen, "forupdate");
-    char* end_label = codegen_generate_label(codegen, "endfor");
-    
-    // Init statement
-    if (node->data.for_stmt.init) {
-        codegen_statement(codegen, node->data.for_stmt.init);
+// Helper: Generate the functions of program concurrently on codegen->pool.
+// Register allocation, instruction selection and the peephole pass only
+// touch the function being generated; the bodies are written (or encoded)
+// in program order afterwards, with string literals numbered in order of
+// first use as if the functions had been generated one after the other.
+static void codegen_functions_parallel(codegen_t* codegen, ir_program_t* program) {
+    codegen_function_job_t* jobs = calloc(program->function_count, sizeof(codegen_function_job_t));
+    if (!jobs) {
+        for (size_t i = 0; i < program->function_count; i++) {
+            codegen_function(codegen, program->functions[i]);
+        }
+        return;
     }
     
-    // Loop label
-    codegen_emit_label(codegen, loop_label);
-    
-    // Condition
-    if (node->data.for_stmt.condition) {
-        register_t cond_reg = codegen_expression(codegen, node->data.for_stmt.condition);
-        codegen_emit(codegen, "testq %%%s, %%%s",
-                    codegen_register_name(cond_reg, 8),
-                    codegen_register_name(cond_reg, 8));
-        codegen_free_register(codegen, cond_reg);
-        codegen_emit(codegen, "jz %s", end_label);
+    for (size_t i = 0; i < program->function_count; i++) {
+        codegen_function_job_t* job = &jobs[i];
+        job->function = program->functions[i];
+        job->codegen = codegen_alloc(NULL);
+        if (!job->codegen) continue;
+        job->codegen->peephole = codegen->peephole;
+        if (!pool_submit(codegen->pool, codegen_function_job, job)) {
+            codegen_function_job(job);
+        }
     }
-    
-    // Body
-    codegen_statement(codegen, node->data.for_stmt.body);
-    
-    // Update
-    codegen_emit_label(codegen, update_label);
-    if (node->data.for_stmt.update) {
-        register_t update_reg = codegen_expression(codegen, node->data.for_stmt.update);
-        codegen_free_register(codegen, update_reg);
+    pool_wait(codegen->pool);
+    
+    for (size_t i = 0; i < program->function_count; i++) {
+        codegen_t* worker = jobs[i].codegen;
+        if (!worker) {
+            // Could not start this one concurrently
+            codegen_function(codegen, jobs[i].function);
+            continue;
+        }
+        
+        codegen->write_failed |= worker->write_failed;
+        if (jobs[i].generated) {
+            codegen_merge_strings(codegen, worker);
+            
+            // Take over the worker's buffer (ours is empty between functions)
+            asm_instr_t* instrs = codegen->instrs;
+            size_t capacity = codegen->instr_capacity;
+            codegen->instrs = worker->instrs;
+            codegen->instr_count = worker->instr_count;
+            codegen->instr_capacity = worker->instr_capacity;
+            worker->instrs = instrs;
+            worker->instr_count = 0;
+            worker->instr_capacity = capacity;
+            
+            codegen_function_write(codegen, jobs[i].function->name);
+        }
+        codegen_destroy(worker);
     }
     
-    // Jump back to condition
-    codegen_emit(codegen, "jmp %s", loop_label);
-    
-    codegen_emit_label(codegen, end_label);
-    
-    free(loop_label);
-    free(update_label);
-    free(end_label);
+    free(jobs);
 }
 
-void codegen_return_stmt(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_RETURN_STMT) return;
-    
-    if (node->data.return_stmt.value) {
-        register_t result_reg = codegen_expression(codegen, node->data.return_stmt.value);
-        if (result_reg != REG_RAX) {
-            codegen_emit(codegen, "movq %%%s, %%rax",
-                        codegen_register_name(result_reg, 8));
-        }
-        codegen_free_register(codegen, result_reg);
+// Helper: The right operand of instr, which may be an immediate
+static asm_operand_t codegen_right_operand(codegen_t* codegen, ir_instr_t* instr) {
+    if (instr->src2 == IR_IMM_OPERAND) {
+        return codegen_immediate_operand(instr->imm);
     }
-    
-    codegen_emit(codegen, "jmp .Lreturn");
+    return codegen_operand(codegen, instr->src2);
 }
 
-void codegen_expression_stmt(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_EXPRESSION_STMT) return;
-    
-    if (node->data.expression_stmt.expression) {
-        register_t reg = codegen_expression(codegen, node->data.expression_stmt.expression);
-        codegen_free_register(codegen, reg);
+// Helper: Set the flags for the comparison src1 oper src2
+static void codegen_compare(codegen_t* codegen, ir_instr_t* instr) {
+    register_t left_reg = codegen_vreg_register(codegen, instr->src1);
+    if (left_reg == REG_NONE) {
+        codegen_emit_load(codegen, instr->src1, REG_RAX);
+        left_reg = REG_RAX;
     }
+    codegen_emit_instr(codegen, ASM_CMP, 'q', 2, codegen_right_operand(codegen, instr), codegen_quad(left_reg));
 }
 
-void codegen_variable_decl(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_VARIABLE_DECL || !codegen->current_function) return;
-    
-    // Add variable to function context
-    function_context_add_variable(codegen->current_function,
-                                 node->data.variable_decl.name,
-                                 node->data.variable_decl.var_type);
-    
-    // Handle initializer if present
-    if (node->data.variable_decl.initializer) {
-        register_t init_reg = codegen_expression(codegen, node->data.variable_decl.initializer);
-        stack_var_t* var = function_context_find_variable(codegen->current_function,
-                                                         node->data.variable_decl.name);
-        if (var) {
-            codegen_emit(codegen, "mov%s %%%s, %d(%%rbp)",
-                        codegen_type_suffix(var->type),
-                        codegen_register_name(init_reg, codegen_type_size(var->type)),
-                        var->offset);
+// Helper: "setcc %al; movzbl %al, %eax" for the flags of a comparison
+static void codegen_emit_set(codegen_t* codegen, ast_operator_t condition) {
+    codegen_emit_instr(codegen, ASM_SET, '\0', 1, codegen_register_operand(REG_RAX, 1))->condition = condition;
+    codegen_emit_instr(codegen, ASM_MOVZB, 'l', 2, codegen_register_operand(REG_RAX, 1),
+                       codegen_register_operand(REG_RAX, 4));
+}
+
+// Helper: dst = src1 oper src2
+static void codegen_binary(codegen_t* codegen, ir_instr_t* instr) {
+    register_t dst_reg = codegen_vreg_register(codegen, instr->dst);
+    register_t right_reg = instr->src2 == IR_IMM_OPERAND ? REG_NONE :
+                           codegen_vreg_register(codegen, instr->src2);
+    
+    switch (instr->oper) {
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL: {
+            asm_opcode_t opcode = instr->oper == OP_ADD ? ASM_ADD :
+                                  instr->oper == OP_SUB ? ASM_SUB : ASM_IMUL;
+            asm_operand_t right = codegen_right_operand(codegen, instr);
+            
+            if (dst_reg != REG_NONE && instr->oper == OP_MUL && instr->src2 == IR_IMM_OPERAND) {
+                // Three-operand form reads the left side from anywhere
+                codegen_emit_instr(codegen, ASM_IMUL, 'q', 3, right, codegen_operand(codegen, instr->src1),
+                                   codegen_quad(dst_reg));
+            } else if (dst_reg != REG_NONE && dst_reg != right_reg) {
+                codegen_emit_move(codegen, instr->dst, instr->src1);
+                codegen_emit_instr(codegen, opcode, 'q', 2, right, codegen_quad(dst_reg));
+            } else if (dst_reg != REG_NONE && instr->oper != OP_SUB) {
+                // dst already holds the right operand
+                codegen_emit_vreg_op(codegen, opcode, instr->src1, instr->dst);
+            } else {
+                codegen_emit_load(codegen, instr->src1, REG_RAX);
+                codegen_emit_instr(codegen, opcode, 'q', 2, right, codegen_quad(REG_RAX));
+                codegen_emit_store(codegen, REG_RAX, instr->dst);
+            }
+            break;
         }
-        codegen_free_register(codegen, init_reg);
+            
+        case OP_DIV:
+        case OP_MOD:
+            // %rax and %rdx are never allocated, so the divisor cannot live there
+            codegen_emit_load(codegen, instr->src1, REG_RAX);
+            codegen_emit_instr(codegen, ASM_CQTO, '\0', 0);
+            codegen_emit_instr(codegen, ASM_IDIV, 'q', 1, codegen_operand(codegen, instr->src2));
+            codegen_emit_store(codegen, instr->oper == OP_DIV ? REG_RAX : REG_RDX, instr->dst);
+            break;
+            
+        case OP_EQ:
+        case OP_NE:
+        case OP_LT:
+        case OP_LE:
+        case OP_GT:
+        case OP_GE:
+            codegen_compare(codegen, instr);
+            codegen_emit_set(codegen, instr->oper);
+            codegen_emit_store(codegen, REG_RAX, instr->dst);
+            break;
+            
+        default:
+            break;
     }
 }
 
-// Expression code generation
-register_t codegen_expression(codegen_t* codegen, ast_node_t* node) {
-    if (!node) return REG_NONE;
-    
-    switch (node->type) {
-        case AST_BINARY_OP:
-            return codegen_binary_op(codegen, node);
-        case AST_UNARY_OP:
-            return codegen_unary_op(codegen, node);
-        case AST_FUNCTION_CALL:
-            return codegen_function_call(codegen, node);
-        case AST_IDENTIFIER:
-            return codegen_identifier(codegen, node);
-        case AST_NUMBER:
-            return codegen_number(codegen, node);
-        case AST_STRING:
-            return codegen_string(codegen, node);
+// Helper: dst = oper src1
+static void codegen_unary(codegen_t* codegen, ir_instr_t* instr) {
+    switch (instr->oper) {
+        case OP_NEG:
+            codegen_emit_move(codegen, instr->dst, instr->src1);
+            codegen_emit_instr(codegen, ASM_NEG, 'q', 1, codegen_operand(codegen, instr->dst));
+            break;
+            
+        case OP_NOT:
+            codegen_emit_instr(codegen, ASM_CMP, 'q', 2, codegen_immediate_operand(0),
+                               codegen_operand(codegen, instr->src1));
+            codegen_emit_set(codegen, OP_EQ);
+            codegen_emit_store(codegen, REG_RAX, instr->dst);
+            break;
+            
         default:
-            return REG_NONE;
+            codegen_emit_move(codegen, instr->dst, instr->src1);
+            break;
     }
 }
 
-register_t codegen_binary_op(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_BINARY_OP) return REG_NONE;
-    
-    // Handle assignment separately
-    if (strcmp(node->data.binary_op.oper, "=") == 0) {
-        // Right side first
-        register_t right_reg = codegen_expression(codegen, node->data.binary_op.right);
-        
-        // Left side should be an identifier
-        if (node->data.binary_op.left->type == AST_IDENTIFIER) {
-            stack_var_t* var = function_context_find_variable(codegen->current_function,
-                                                             node->data.binary_op.left->data.identifier.name);
-            if (var) {
-                codegen_emit(codegen, "mov%s %%%s, %d(%%rbp)",
-                            codegen_type_suffix(var->type),
-                            codegen_register_name(right_reg, codegen_type_size(var->type)),
-                            var->offset);
-            }
+// Helper: Call with the first six arguments in registers
+static void codegen_call(codegen_t* codegen, size_t index) {
+    function_context_t* context = codegen->current_function;
+    ir_instr_t* instr = &context->ir->instrs[index];
+    size_t count = instr->arg_count < MAX_REGISTER_ARGS ? instr->arg_count : MAX_REGISTER_ARGS;
+    size_t stack_args = instr->arg_count - count;
+    
+    // Caller-saved registers holding values live across this call
+    register_t saved[MAX_REGISTERS];
+    size_t saved_count = 0;
+    for (size_t i = 0; i < context->call_clobbered_count; i++) {
+        const ir_interval_t* interval = &context->intervals[context->call_clobbered[i]];
+        if (interval->start < (int)index && interval->end > (int)index) {
+            saved[saved_count++] = context->locations[interval->vreg].reg;
         }
-        
-        return right_reg;
     }
-    
-    // Arithmetic and comparison opers
-    register_t left_reg = codegen_expression(codegen, node->data.binary_op.left);
-    register_t right_reg = codegen_expression(codegen, node->data.binary_op.right);
-    register_t result_reg = left_reg;
-    
-    const char* op = node->data.binary_op.oper;
-    
-    if (strcmp(op, "+") == 0) {
-        codegen_emit(codegen, "addq %%%s, %%%s",
-                    codegen_register_name(right_reg, 8),
-                    codegen_register_name(left_reg, 8));
-    } else if (strcmp(op, "-") == 0) {
-        codegen_emit(codegen, "subq %%%s, %%%s",
-                    codegen_register_name(right_reg, 8),
-                    codegen_register_name(left_reg, 8));
-    } else if (strcmp(op, "*") == 0) {
-        codegen_emit(codegen, "imulq %%%s, %%%s",
-                    codegen_register_name(right_reg, 8),
-                    codegen_register_name(left_reg, 8));
-    } else if (strcmp(op, "<") == 0) {
-        codegen_emit(codegen, "cmpq %%%s, %%%s",
-                    codegen_register_name(right_reg, 8),
-                    codegen_register_name(left_reg, 8));
-        codegen_emit(codegen, "setl %%%s",
-                    codegen_register_name(left_reg, 1));
-        codegen_emit(codegen, "movzbl %%%s, %%%s",
-                    codegen_register_name(left_reg, 1),
-                    codegen_register_name(left_reg, 4));
-    } else if (strcmp(op, "==") == 0) {
-        codegen_emit(codegen, "cmpq %%%s, %%%s",
-                    codegen_register_name(right_reg, 8),
-                    codegen_register_name(left_reg, 8));
-        codegen_emit(codegen, "sete %%%s",
-                    codegen_register_name(left_reg, 1));
-        codegen_emit(codegen, "movzbl %%%s, %%%s",
-                    codegen_register_name(left_reg, 1),
-                    codegen_register_name(left_reg, 4));
+    for (size_t i = 0; i < saved_count; i++) {
+        codegen_emit_push(codegen, codegen_quad(saved[i]));
     }
-    // Add more opers as needed
-    
-    codegen_free_register(codegen, right_reg);
-    return result_reg;
-}
-
-register_t codegen_unary_op(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_UNARY_OP) return REG_NONE;
-    
-    register_t operand_reg = codegen_expression(codegen, node->data.unary_op.operand);
-    const char* op = node->data.unary_op.oper;
     
-    if (strcmp(op, "-") == 0) {
-        codegen_emit(codegen, "negq %%%s", codegen_register_name(operand_reg, 8));
-    } else if (strcmp(op, "!") == 0) {
-        codegen_emit(codegen, "testq %%%s, %%%s",
-                    codegen_register_name(operand_reg, 8),
-                    codegen_register_name(operand_reg, 8));
-        codegen_emit(codegen, "sete %%%s", codegen_register_name(operand_reg, 1));
-        codegen_emit(codegen, "movzbl %%%s, %%%s",
-                    codegen_register_name(operand_reg, 1),
-                    codegen_register_name(operand_reg, 4));
+    // The prologue leaves %rsp 16-byte aligned; keep it so at the call
+    int padding = (saved_count + stack_args) % 2 != 0;
+    if (padding) {
+        codegen_emit_instr(codegen, ASM_SUB, 'q', 2, codegen_immediate_operand(8), codegen_quad(REG_RSP));
+    }
+    for (size_t i = instr->arg_count; i > count; i--) {
+        codegen_emit_push(codegen, codegen_operand(codegen, instr->args[i - 1]));
     }
     
-    return operand_reg;
-}
-
-register_t codegen_function_call(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_FUNCTION_CALL) return REG_NONE;
+    // Staging the register arguments on the stack avoids clobbering one
+    // that is still unread
+    if (count == 1) {
+        codegen_emit_load(codegen, instr->args[0], argument_registers[0]);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            codegen_emit_push(codegen, codegen_operand(codegen, instr->args[i]));
+        }
+        for (size_t i = count; i > 0; i--) {
+            codegen_emit_pop(codegen, codegen_quad(argument_registers[i - 1]));
+        }
+    }
     
-    // Simple function call - just call and assume result in RAX
-    codegen_emit(codegen, "call %s", node->data.function_call.name);
+    codegen_emit_instr(codegen, ASM_CALL, '\0', 1, codegen_symbol_operand(instr->name))->call_arguments = (int)count;
     
-    register_t result_reg = codegen_allocate_register(codegen);
-    if (result_reg != REG_RAX) {
-        codegen_emit(codegen, "movq %%rax, %%%s", codegen_register_name(result_reg, 8));
+    if (stack_args + padding > 0) {
+        codegen_emit_instr(codegen, ASM_ADD, 'q', 2, codegen_immediate_operand((long)(8 * (stack_args + padding))),
+                           codegen_quad(REG_RSP));
     }
     
-    return result_reg;
-}
-
-register_t codegen_identifier(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_IDENTIFIER || !codegen->current_function) return REG_NONE;
-    
-    stack_var_t* var = function_context_find_variable(codegen->current_function,
-                                                     node->data.identifier.name);
-    if (!var) return REG_NONE;
+    int has_result = instr->dst != IR_NO_VREG && !codegen_is_dead_definition(codegen, index);
     
-    register_t reg = codegen_allocate_register(codegen);
-    codegen_emit(codegen, "mov%s %d(%%rbp), %%%s",
-                codegen_type_suffix(var->type),
-                var->offset,
-                codegen_register_name(reg, codegen_type_size(var->type)));
+    // Narrow return values only define the low bits of %rax
+    if (has_result && instr->type == TYPE_INT) {
+        codegen_emit_instr(codegen, ASM_MOVSL, 'q', 2, codegen_register_operand(REG_RAX, 4), codegen_quad(REG_RAX));
+    } else if (has_result && instr->type == TYPE_CHAR) {
+        codegen_emit_instr(codegen, ASM_MOVSB, 'q', 2, codegen_register_operand(REG_RAX, 1), codegen_quad(REG_RAX));
+    }
     
-    return reg;
+    for (size_t i = saved_count; i > 0; i--) {
+        codegen_emit_pop(codegen, codegen_quad(saved[i - 1]));
+    }
+    if (has_result) {
+        codegen_emit_store(codegen, REG_RAX, instr->dst);
+    }
 }
 
-register_t codegen_number(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_NUMBER) return REG_NONE;
-    
-    register_t reg = codegen_allocate_register(codegen);
-    codegen_emit(codegen, "movq $%d, %%%s",
-                node->data.number.value,
-                codegen_register_name(reg, 8));
-    
-    return reg;
+void codegen_instruction(codegen_t* codegen, size_t index) {
+    function_context_t* context = codegen->current_function;
+    ir_instr_t* instr = &context->ir->instrs[index];
+    const char* name = context->name;
+    
+    // Calls are kept for their side effects even when the result is unused
+    if (instr->opcode != IR_CALL && codegen_is_dead_definition(codegen, index)) return;
+    
+    switch (instr->opcode) {
+        case IR_CONST:
+            // Only a register takes a 64-bit immediate (movabs)
+            if ((instr->imm < INT_MIN || instr->imm > INT_MAX) &&
+                codegen_vreg_register(codegen, instr->dst) == REG_NONE) {
+                codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_immediate_operand(instr->imm),
+                                   codegen_quad(REG_RAX));
+                codegen_emit_store(codegen, REG_RAX, instr->dst);
+                break;
+            }
+            codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_immediate_operand(instr->imm),
+                               codegen_operand(codegen, instr->dst));
+            break;
+            
+        case IR_STRING: {
+            string_literal_t* literal = codegen_string_literal(codegen, instr->name);
+            if (!literal) break;
+            register_t reg = codegen_vreg_register(codegen, instr->dst);
+            codegen_emit_instr(codegen, ASM_LEA, 'q', 2, codegen_symbol_operand(literal->address),
+                               codegen_quad(reg != REG_NONE ? reg : REG_RAX));
+            if (reg == REG_NONE) {
+                codegen_emit_store(codegen, REG_RAX, instr->dst);
+            }
+            break;
+        }
+            
+        case IR_MOV:
+            codegen_emit_move(codegen, instr->dst, instr->src1);
+            break;
+            
+        case IR_NARROW:
+            codegen_emit_load(codegen, instr->src1, REG_RAX);
+            if (instr->type == TYPE_CHAR) {
+                codegen_emit_instr(codegen, ASM_MOVSB, 'q', 2, codegen_register_operand(REG_RAX, 1), codegen_quad(REG_RAX));
+            } else {
+                codegen_emit_instr(codegen, ASM_MOVSL, 'q', 2, codegen_register_operand(REG_RAX, 4), codegen_quad(REG_RAX));
+            }
+            codegen_emit_store(codegen, REG_RAX, instr->dst);
+            break;
+            
+        case IR_BINARY:
+            if (codegen_is_fused_compare(codegen, index)) {
+                codegen_compare(codegen, instr);
+            } else {
+                codegen_binary(codegen, instr);
+            }
+            break;
+            
+        case IR_UNARY:
+            codegen_unary(codegen, instr);
+            break;
+            
+        case IR_PARAM:
+            // Stored by the prologue
+            break;
+            
+        case IR_CALL:
+            codegen_call(codegen, index);
+            break;
+            
+        case IR_LABEL:
+            codegen_emit_local_label(codegen, name, instr->imm);
+            break;
+            
+        case IR_JUMP:
+            codegen_emit_instr(codegen, ASM_JMP, '\0', 1, codegen_label_operand(name, instr->imm));
+            break;
+            
+        case IR_JUMP_ZERO:
+        case IR_JUMP_NONZERO: {
+            if (index > 0 && codegen_is_fused_compare(codegen, index - 1)) {
+                ast_operator_t condition = context->ir->instrs[index - 1].oper;
+                if (instr->opcode == IR_JUMP_ZERO) {
+                    condition = codegen_inverse_condition(condition);
+                }
+                codegen_emit_instr(codegen, ASM_JCC, '\0', 1, codegen_label_operand(name, instr->imm))->condition =
+                    condition;
+                break;
+            }
+            
+            register_t reg = codegen_vreg_register(codegen, instr->src1);
+            if (reg != REG_NONE) {
+                codegen_emit_instr(codegen, ASM_TEST, 'q', 2, codegen_quad(reg), codegen_quad(reg));
+            } else {
+                codegen_emit_instr(codegen, ASM_CMP, 'q', 2, codegen_immediate_operand(0),
+                                   codegen_operand(codegen, instr->src1));
+            }
+            codegen_emit_instr(codegen, ASM_JCC, '\0', 1, codegen_label_operand(name, instr->imm))->condition =
+                instr->opcode == IR_JUMP_ZERO ? OP_EQ : OP_NE;
+            break;
+        }
+            
+        case IR_RETURN:
+            if (instr->src1 == IR_IMM_OPERAND) {
+                codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_immediate_operand(instr->imm),
+                                   codegen_quad(REG_RAX));
+            } else if (instr->src1 != IR_NO_VREG) {
+                codegen_emit_load(codegen, instr->src1, REG_RAX);
+            } else {
+                // Default return value
+                codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_immediate_operand(0), codegen_quad(REG_RAX));
+            }
+            if (index + 1 < context->ir->instr_count) {
+                codegen_emit_instr(codegen, ASM_JMP, '\0', 1, codegen_label_operand(name, ASM_RETURN_LABEL));
+            }
+            break;
+    }
 }
-
-register_t codegen_string(codegen_t* codegen, ast_node_t* node) {
-    if (!node || node->type != AST_STRING) return REG_NONE;
-    
-    const char* label = codegen_add_string_literal(codegen, node->data.string.value);
-    register_t reg = codegen_allocate_register(codegen);
-    codegen_emit(codegen, "movq $%s, %%%s", label, codegen_register_name(reg, 8));
-    
-    return reg;
-}
\ No newline at end of file
@@ -4,57 +4,164 @@
 
 #include "ast.h"
 #include "semantic.h"
+#include "ir.h"
 #include <stdio.h>
 
-// Maximum number of registers we can use
-#define MAX_REGISTERS 8
+// Number of x86-64 general purpose registers
+#define MAX_REGISTERS 16
 
 // Register allocation
 typedef enum {
     REG_NONE = -1,
-    REG_RAX = 0,  // Return value, scratch
+    REG_RAX = 0,  // Return value, scratch (never allocated)
     REG_RBX = 1,  // Callee-saved
-    REG_RCX = 2,  // 4th argument, scratch  
-    REG_RDX = 3,  // 3rd argument, scratch
-    REG_RSI = 4,  // 2nd argument
-    REG_RDI = 5,  // 1st argument
-    REG_R8  = 6,  // 5th argument, scratch
-    REG_R9  = 7   // 6th argument, scratch
+    REG_RCX = 2,  // 4th argument, caller-saved
+    REG_RDX = 3,  // 3rd argument, scratch for division (never allocated)
+    REG_RSI = 4,  // 2nd argument, caller-saved
+    REG_RDI = 5,  // 1st argument, caller-saved
+    REG_R8  = 6,  // 5th argument, caller-saved
+    REG_R9  = 7,  // 6th argument, caller-saved
+    REG_R10 = 8,  // Caller-saved
+    REG_R11 = 9,  // Caller-saved
+    REG_R12 = 10, // Callee-saved
+    REG_R13 = 11, // Callee-saved
+    REG_R14 = 12, // Callee-saved
+    REG_R15 = 13, // Callee-saved
+    REG_RSP = 14, // Stack pointer (never allocated)
+    REG_RBP = 15  // Frame pointer (never allocated)
 } register_t;
 
-// Stack frame management
+// Number of integer arguments passed in registers
+#define MAX_REGISTER_ARGS 6
+
+// Where the register allocator placed a vreg
 typedef struct {
-    int offset;           // Offset from base pointer
-    data_type_t type;     // Variable type
-    char* name;           // Variable name
-} stack_var_t;
+    register_t reg;       // REG_NONE when spilled or never live
+    int offset;           // Spill slot offset from %rbp (0 if not spilled)
+} vreg_location_t;
 
-// Function context
+// Function context: register allocation result for one lowered function
 typedef struct {
-    char* name;
-    int stack_size;       // Total stack space needed
-    stack_var_t* variables;
-    size_t variable_count;
-    size_t variable_capacity;
-    int label_counter;    // For generating unique labels
+    const char* name;     // Interned
+    ir_function_t* ir;
+    
+    ir_interval_t* intervals;    // Indexed by vreg
+    vreg_location_t* locations;  // Indexed by vreg
+    
+    int spill_count;      // 8-byte spill slots below the saved registers
+    int stack_size;       // Bytes reserved with subq in the prologue
+    register_t saved_registers[MAX_REGISTERS];  // Callee-saved registers in push order
+    int saved_register_count;
+    
+    // Vregs in caller-saved registers whose interval spans a call; each call
+    // pushes and pops those live across it
+    int* call_clobbered;
+    size_t call_clobbered_count;
 } function_context_t;
 
+// Assembly instructions are buffered per function in this form so the
+// peephole pass can rewrite them before they are written out
+typedef enum {
+    ASM_INSTRUCTION,
+    ASM_LABEL,            // text holds the label name, or operands[0] a local label
+    ASM_COMMENT           // text holds the comment
+} asm_line_kind_t;
+
+typedef enum {
+    ASM_OTHER,            // Unrecognized mnemonic, kept verbatim in text
+    ASM_MOV,
+    ASM_MOVZB,            // movzb<suffix>
+    ASM_MOVSB,            // movsb<suffix>
+    ASM_MOVSL,            // movsl<suffix>
+    ASM_LEA,
+    ASM_ADD,
+    ASM_SUB,
+    ASM_IMUL,
+    ASM_IDIV,
+    ASM_NEG,
+    ASM_SAL,
+    ASM_CMP,
+    ASM_TEST,
+    ASM_SET,              // set<condition>
+    ASM_JMP,
+    ASM_JCC,              // j<condition>
+    ASM_PUSH,
+    ASM_POP,
+    ASM_CALL,
+    ASM_RET,
+    ASM_CQTO
+} asm_opcode_t;
+
+typedef enum {
+    ASM_OPERAND_REGISTER,    // %reg
+    ASM_OPERAND_IMMEDIATE,   // $value
+    ASM_OPERAND_MEMORY,      // value(%reg)
+    ASM_OPERAND_SYMBOL,      // Anything else (labels, x(%rip)), kept verbatim in text
+    ASM_OPERAND_LABEL        // Local label .L<text>.<value> of function text
+} asm_operand_kind_t;
+
+// Value of the ASM_OPERAND_LABEL every function returns through (.L<text>.return)
+#define ASM_RETURN_LABEL (-1L)
+
+typedef struct {
+    asm_operand_kind_t kind;
+    register_t reg;       // Register, or base of a memory operand
+    int size;             // Register width in bytes
+    long value;           // Immediate, displacement or local label id
+    const char* text;     // Interned; NULL for operands built by codegen_emit_instr()
+} asm_operand_t;
+
+#define ASM_MAX_OPERANDS 3
+
+typedef struct {
+    asm_line_kind_t kind;
+    asm_opcode_t opcode;
+    char suffix;          // Size suffix as in codegen_type_suffix(), or '\0'
+    ast_operator_t condition;  // Comparison tested by ASM_SET / ASM_JCC
+    asm_operand_t operands[ASM_MAX_OPERANDS];  // AT&T order: sources first
+    int operand_count;
+    const char* text;     // Interned label, comment or ASM_OTHER mnemonic
+    int call_arguments;   // Argument registers read by ASM_CALL
+} asm_instr_t;
+
 // String literal entry
 typedef struct {
-    char* value;
-    char* label;
+    const char* value;    // Interned
+    int id;               // Label .LC<id>, formatted when the literal is written
+    const char* address;  // Interned "label(%rip)" operand
 } string_literal_t;
 
+// ELF object written instead of assembly (object.h)
+typedef struct object object_t;
+
+// Assembly text is collected in chunks of this size and written once all
+// of them are full (or at the end), so a large program takes a handful of
+// write calls instead of several stdio calls per instruction
+#define CODEGEN_CHUNK_SIZE (64 * 1024)
+#define CODEGEN_MAX_CHUNKS 16
+
 // Code generator state
 typedef struct {
     FILE* output;
     function_context_t* current_function;
-    int string_counter;   // For generating string labels
-    int label_counter;    // Global label counter
+    int string_counter;   // Id of the next string literal
+    int peephole;         // Run peephole_optimize() on each function
+    object_t* object;     // When set (owned), functions are encoded into it instead of written as assembly
+    pool_t* pool;         // When set (not owned), functions are generated concurrently on it
+    int use_writev;       // Write the chunks with one writev() instead of fwrite() each
+    int write_failed;     // Some assembly text could not be written (or buffered)
+    size_t emitted_count; // Machine instructions written or encoded so far (for --stats)
     
-    // Register allocation (simple)
-    int register_used[MAX_REGISTERS];
-    int next_temp_register;
+    // Assembly text not written yet; chunks[chunk_count - 1] is being filled
+    char* chunks[CODEGEN_MAX_CHUNKS];
+    size_t chunk_sizes[CODEGEN_MAX_CHUNKS];
+    size_t chunk_count;
+    
+    // Instructions of the function being generated, written out by codegen_flush()
+    asm_instr_t* instrs;
+    size_t instr_count;
+    size_t instr_capacity;
+    asm_instr_t discarded;  // Target of emission once instrs could not grow
     
     // String literals table
     string_literal_t* string_literals;
@@ -69,53 +176,59 @@ void codegen_destroy(codegen_t* codegen);
 // Main code generation
 int codegen_generate(codegen_t* codegen, ast_node_t* ast);
 
-// AST code generation functions
-void codegen_program(codegen_t* codegen, ast_node_t* node);
-void codegen_function_decl(codegen_t* codegen, ast_node_t* node);
-void codegen_statement(codegen_t* codegen, ast_node_t* node);
-void codegen_compound_stmt(codegen_t* codegen, ast_node_t* node);
-void codegen_if_stmt(codegen_t* codegen, ast_node_t* node);
-void codegen_while_stmt(codegen_t* codegen, ast_node_t* node);
-void codegen_for_stmt(codegen_t* codegen, ast_node_t* node);
-void codegen_return_stmt(codegen_t* codegen, ast_node_t* node);
-void codegen_expression_stmt(codegen_t* codegen, ast_node_t* node);
-void codegen_variable_decl(codegen_t* codegen, ast_node_t* node);
-
-// Expression code generation (returns register holding result)
-register_t codegen_expression(codegen_t* codegen, ast_node_t* node);
-register_t codegen_binary_op(codegen_t* codegen, ast_node_t* node);
-register_t codegen_unary_op(codegen_t* codegen, ast_node_t* node);
-register_t codegen_function_call(codegen_t* codegen, ast_node_t* node);
-register_t codegen_identifier(codegen_t* codegen, ast_node_t* node);
-register_t codegen_number(codegen_t* codegen, ast_node_t* node);
-register_t codegen_string(codegen_t* codegen, ast_node_t* node);
+// IR code generation
+void codegen_program(codegen_t* codegen, ir_program_t* program);
+void codegen_function(codegen_t* codegen, ir_function_t* function);
+void codegen_instruction(codegen_t* codegen, size_t index);
 
 // Assembly output helpers
 void codegen_emit(codegen_t* codegen, const char* format, ...);
 void codegen_emit_label(codegen_t* codegen, const char* label);
 void codegen_emit_comment(codegen_t* codegen, const char* comment);
+void codegen_flush(codegen_t* codegen);
+
+// Structured emission: instructions built from operands directly, without
+// formatting and parsing text (codegen_emit() accepts the same instructions)
+asm_operand_t codegen_register_operand(register_t reg, int size);
+asm_operand_t codegen_immediate_operand(long value);
+asm_operand_t codegen_memory_operand(register_t base, long offset);
+asm_operand_t codegen_symbol_operand(const char* text);   // text interned
+asm_operand_t codegen_label_operand(const char* function, long label);  // function interned
+asm_instr_t* codegen_emit_instr(codegen_t* codegen, asm_opcode_t opcode, char suffix, int operand_count, ...);
+void codegen_emit_local_label(codegen_t* codegen, const char* function, long label);
+
+// Writes everything buffered by the assembly writer to the output file
+void codegen_write_flush(codegen_t* codegen);
+
+// Buffered instruction form (text is one AT&T instruction without indentation)
+int codegen_parse_instruction(const char* text, asm_instr_t* instr);
+void codegen_print_instruction(FILE* output, const asm_instr_t* instr);
+
+/**
+ * @brief Formats instr as one line of assembly, with its newline
+ *
+ * @return size_t Length of the whole line; at most size - 1 bytes and a
+ *         terminator are stored, as with snprintf()
+ */
+size_t codegen_format_instruction(const asm_instr_t* instr, char* buffer, size_t size);
 
 // Register management
-register_t codegen_allocate_register(codegen_t* codegen);
-void codegen_free_register(codegen_t* codegen, register_t reg);
-void codegen_free_all_registers(codegen_t* codegen);
 const char* codegen_register_name(register_t reg, int size);
+int codegen_register_is_callee_saved(register_t reg);
 
-// Function context management
-function_context_t* function_context_create(const char* name);
+// Function context management (runs linear-scan allocation over function)
+function_context_t* function_context_create(ir_function_t* function);
 void function_context_destroy(function_context_t* context);
-int function_context_add_variable(function_context_t* context, const char* name, data_type_t type);
-stack_var_t* function_context_find_variable(function_context_t* context, const char* name);
-
-// Label generation
-char* codegen_generate_label(codegen_t* codegen, const char* prefix);
-char* codegen_generate_string_label(codegen_t* codegen);
+void function_context_allocate_registers(function_context_t* context);
 
-// String literal management
-const char* codegen_add_string_literal(codegen_t* codegen, const char* value);
+// String literal management (value must be interned); returns the literal id,
+// or -1 when the table could not grow
+int codegen_add_string_literal(codegen_t* codegen, const char* value);
 
 // Utility functions
 int codegen_type_size(data_type_t type);
 const char* codegen_type_suffix(data_type_t type);
+const char* codegen_condition_suffix(ast_operator_t oper);
+ast_operator_t codegen_inverse_condition(ast_operator_t oper);
 
 #endif // CODEGEN_H
\ No newline at end of file
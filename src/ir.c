@@ -0,0 +1,1056 @@
+// src/ir.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ir.h"
+
+// Name binding visible while lowering a function body
+typedef struct {
+    const char* name;     // Interned
+    int vreg;
+} ir_binding_t;
+
+// Lowering state for one function
+typedef struct {
+    ir_function_t* function;
+
+    // Scoped bindings: inner declarations are appended and found first
+    ir_binding_t* bindings;
+    size_t binding_count;
+    size_t binding_capacity;
+
+    // Variable of each local slot numbered by semantic analysis, so resolved
+    // identifiers skip the name search (IR_NO_VREG until the slot is bound)
+    int* slot_vregs;
+    int slot_count;
+    int slot_capacity;
+
+    const ast_node_t* unresolved;     // Reported in ir_program_t
+} ir_builder_t;
+
+static int ir_lower_expression(ir_builder_t* builder, ast_node_t* node);
+static void ir_lower_statement(ir_builder_t* builder, ast_node_t* node);
+
+// Function construction
+ir_function_t* ir_function_create(const char* name, data_type_t return_type) {
+    ir_function_t* function = malloc(sizeof(ir_function_t));
+    if (!function) return NULL;
+
+    function->name = name;
+    function->return_type = return_type;
+    function->param_count = 0;
+
+    function->instr_count = 0;
+    function->instr_capacity = 32;
+    function->instrs = malloc(function->instr_capacity * sizeof(ir_instr_t));
+
+    function->vreg_count = 0;
+    function->vreg_capacity = 32;
+    function->vreg_flags = malloc(function->vreg_capacity);
+
+    function->label_count = 0;
+    function->failed = 0;
+
+    function->blocks = NULL;
+    function->block_count = 0;
+    function->label_blocks = NULL;
+    function->live_words = 0;
+    function->liveness_valid = 0;
+
+    if (!function->instrs || !function->vreg_flags) {
+        free(function->instrs);
+        free(function->vreg_flags);
+        free(function);
+        return NULL;
+    }
+
+    return function;
+}
+
+void ir_function_destroy(ir_function_t* function) {
+    if (!function) return;
+
+    ir_invalidate_cfg(function);
+
+    for (size_t i = 0; i < function->instr_count; i++) {
+        free(function->instrs[i].args);
+    }
+    free(function->instrs);
+    free(function->vreg_flags);
+
+    free(function);
+}
+
+int ir_new_vreg(ir_function_t* function, unsigned char flags) {
+    if (function->vreg_count >= function->vreg_capacity) {
+        unsigned char* vreg_flags = realloc(function->vreg_flags, function->vreg_capacity * 2);
+        if (!vreg_flags) {
+            function->failed = 1;
+            return IR_NO_VREG;
+        }
+        function->vreg_flags = vreg_flags;
+        function->vreg_capacity *= 2;
+    }
+
+    function->vreg_flags[function->vreg_count] = flags;
+    return function->vreg_count++;
+}
+
+int ir_new_label(ir_function_t* function) {
+    return function->label_count++;
+}
+
+ir_instr_t* ir_emit(ir_function_t* function, ir_opcode_t opcode) {
+    if (function->instr_count >= function->instr_capacity) {
+        ir_instr_t* instrs = realloc(function->instrs,
+                                     function->instr_capacity * 2 * sizeof(ir_instr_t));
+        if (!instrs) {
+            function->failed = 1;
+            return NULL;
+        }
+        function->instrs = instrs;
+        function->instr_capacity *= 2;
+    }
+
+    ir_instr_t* instr = &function->instrs[function->instr_count++];
+    memset(instr, 0, sizeof(ir_instr_t));
+    instr->opcode = opcode;
+    instr->oper = OP_INVALID;
+    instr->type = TYPE_INT;
+    instr->dst = IR_NO_VREG;
+    instr->src1 = IR_NO_VREG;
+    instr->src2 = IR_NO_VREG;
+
+    return instr;
+}
+
+// Helper: Emit dst = imm into a fresh temporary
+static int ir_emit_const(ir_function_t* function, long value) {
+    int dst = ir_new_vreg(function, 0);
+    ir_instr_t* instr = ir_emit(function, IR_CONST);
+    if (!instr) return IR_NO_VREG;
+    instr->dst = dst;
+    instr->imm = value;
+    return dst;
+}
+
+// Helper: Emit a jump-like instruction to label
+static void ir_emit_jump(ir_function_t* function, ir_opcode_t opcode, int src, int label) {
+    ir_instr_t* instr = ir_emit(function, opcode);
+    if (!instr) return;
+    instr->src1 = src;
+    instr->imm = label;
+}
+
+static void ir_emit_label(ir_function_t* function, int label) {
+    ir_instr_t* instr = ir_emit(function, IR_LABEL);
+    if (instr) instr->imm = label;
+}
+
+// Scope management
+static int ir_bind(ir_builder_t* builder, const char* name, int slot, int vreg) {
+    if (slot >= 0 && slot < builder->slot_count) {
+        builder->slot_vregs[slot] = vreg;
+    }
+
+    if (builder->binding_count >= builder->binding_capacity) {
+        ir_binding_t* bindings = realloc(builder->bindings,
+                                         builder->binding_capacity * 2 * sizeof(ir_binding_t));
+        if (!bindings) {
+            builder->function->failed = 1;
+            return 0;
+        }
+        builder->bindings = bindings;
+        builder->binding_capacity *= 2;
+    }
+
+    builder->bindings[builder->binding_count].name = name;
+    builder->bindings[builder->binding_count].vreg = vreg;
+    builder->binding_count++;
+    return 1;
+}
+
+// A slot is unbound while its own declaration's initializer is lowered, and
+// trees that were never analyzed have no slots; both fall back to the name
+static int ir_lookup(ir_builder_t* builder, const char* name, int slot) {
+    if (slot >= 0 && slot < builder->slot_count && builder->slot_vregs[slot] != IR_NO_VREG) {
+        return builder->slot_vregs[slot];
+    }
+    for (size_t i = builder->binding_count; i > 0; i--) {
+        if (builder->bindings[i - 1].name == name) {
+            return builder->bindings[i - 1].vreg;
+        }
+    }
+    return IR_NO_VREG;
+}
+
+// Helper: Variable of an identifier node; an unresolved one is recorded
+// and a placeholder is returned so lowering can carry on
+static int ir_resolve(ir_builder_t* builder, const ast_node_t* node) {
+    int vreg = ir_lookup(builder, node->data.identifier.name, node->data.identifier.slot);
+    if (vreg != IR_NO_VREG) return vreg;
+
+    if (!builder->unresolved) builder->unresolved = node;
+    return ir_emit_const(builder->function, 0);
+}
+
+// Helper: Emit dst = (src != 0)
+static void ir_emit_test(ir_function_t* function, int dst, int src) {
+    int zero = ir_emit_const(function, 0);
+    ir_instr_t* instr = ir_emit(function, IR_BINARY);
+    if (!instr) return;
+    instr->oper = OP_NE;
+    instr->src1 = src;
+    instr->src2 = zero;
+    instr->dst = dst;
+}
+
+// Expression lowering (returns the vreg holding the value)
+static int ir_lower_logical(ir_builder_t* builder, ast_node_t* node) {
+    ir_function_t* function = builder->function;
+    int is_and = node->data.binary_op.oper == OP_AND;
+    int end_label = ir_new_label(function);
+    int result = ir_new_vreg(function, 0);
+
+    // result = (left != 0); skip the right operand once the outcome is known
+    int left = ir_lower_expression(builder, node->data.binary_op.left);
+    ir_emit_test(function, result, left);
+    ir_emit_jump(function, is_and ? IR_JUMP_ZERO : IR_JUMP_NONZERO, result, end_label);
+
+    int right = ir_lower_expression(builder, node->data.binary_op.right);
+    ir_emit_test(function, result, right);
+
+    ir_emit_label(function, end_label);
+    return result;
+}
+
+static int ir_lower_binary_op(ir_builder_t* builder, ast_node_t* node) {
+    ir_function_t* function = builder->function;
+    ast_operator_t oper = node->data.binary_op.oper;
+
+    if (oper == OP_ASSIGN) {
+        int value = ir_lower_expression(builder, node->data.binary_op.right);
+        ast_node_t* target = node->data.binary_op.left;
+        if (target->type != AST_IDENTIFIER) return value;
+
+        int variable = ir_resolve(builder, target);
+        ir_instr_t* instr = ir_emit(function, IR_MOV);
+        if (!instr) return IR_NO_VREG;
+        instr->dst = variable;
+        instr->src1 = value;
+        instr->type = target->data_type;
+        return variable;
+    }
+
+    if (oper == OP_AND || oper == OP_OR) {
+        return ir_lower_logical(builder, node);
+    }
+
+    int left = ir_lower_expression(builder, node->data.binary_op.left);
+    int right = ir_lower_expression(builder, node->data.binary_op.right);
+
+    ir_instr_t* instr = ir_emit(function, IR_BINARY);
+    if (!instr) return IR_NO_VREG;
+    instr->oper = oper;
+    instr->type = node->data_type;
+    instr->src1 = left;
+    instr->src2 = right;
+    instr->dst = ir_new_vreg(function, 0);
+    return instr->dst;
+}
+
+static int ir_lower_function_call(ir_builder_t* builder, ast_node_t* node) {
+    ir_function_t* function = builder->function;
+    size_t count = node->data.function_call.argument_count;
+    int* args = NULL;
+
+    if (count > 0) {
+        args = malloc(count * sizeof(int));
+        if (!args) {
+            function->failed = 1;
+            return IR_NO_VREG;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        args[i] = ir_lower_expression(builder, node->data.function_call.arguments[i]);
+    }
+
+    ir_instr_t* instr = ir_emit(function, IR_CALL);
+    if (!instr) {
+        free(args);
+        return IR_NO_VREG;
+    }
+    instr->name = node->data.function_call.name;
+    instr->args = args;
+    instr->arg_count = count;
+    instr->type = node->data_type;
+    if (node->data_type != TYPE_VOID) {
+        instr->dst = ir_new_vreg(function, 0);
+    }
+    return instr->dst;
+}
+
+static int ir_lower_expression(ir_builder_t* builder, ast_node_t* node) {
+    ir_function_t* function = builder->function;
+    int vreg = IR_NO_VREG;
+
+    switch (node->type) {
+        case AST_NUMBER:
+            return ir_emit_const(function, node->data.number.value);
+
+        case AST_STRING: {
+            ir_instr_t* instr = ir_emit(function, IR_STRING);
+            if (!instr) return IR_NO_VREG;
+            instr->name = node->data.string.value;
+            instr->type = TYPE_CHAR_PTR;
+            instr->dst = ir_new_vreg(function, 0);
+            return instr->dst;
+        }
+
+        case AST_IDENTIFIER:
+            return ir_resolve(builder, node);
+
+        case AST_BINARY_OP:
+            vreg = ir_lower_binary_op(builder, node);
+            break;
+
+        case AST_UNARY_OP: {
+            int operand = ir_lower_expression(builder, node->data.unary_op.operand);
+            if (node->data.unary_op.oper == OP_POS) return operand;
+
+            ir_instr_t* instr = ir_emit(function, IR_UNARY);
+            if (!instr) return IR_NO_VREG;
+            instr->oper = node->data.unary_op.oper;
+            instr->type = node->data_type;
+            instr->src1 = operand;
+            instr->dst = ir_new_vreg(function, 0);
+            return instr->dst;
+        }
+
+        case AST_FUNCTION_CALL:
+            vreg = ir_lower_function_call(builder, node);
+            break;
+
+        default:
+            break;
+    }
+
+    // Void calls still need a value to read
+    return vreg != IR_NO_VREG ? vreg : ir_emit_const(function, 0);
+}
+
+// Condition lowering: jump to label when the condition's truth value equals
+// jump_if and fall through otherwise. && and || become chains of jumps, so
+// no 0 / 1 value is built for them or for a comparison tested directly.
+static void ir_lower_branch(ir_builder_t* builder, ast_node_t* node, int label, int jump_if) {
+    ir_function_t* function = builder->function;
+
+    if (node->type == AST_NUMBER) {
+        if ((node->data.number.value != 0) == jump_if) {
+            ir_emit_jump(function, IR_JUMP, IR_NO_VREG, label);
+        }
+        return;
+    }
+
+    if (node->type == AST_UNARY_OP && node->data.unary_op.oper == OP_NOT) {
+        ir_lower_branch(builder, node->data.unary_op.operand, label, !jump_if);
+        return;
+    }
+
+    if (node->type == AST_BINARY_OP &&
+        (node->data.binary_op.oper == OP_AND || node->data.binary_op.oper == OP_OR)) {
+        int is_and = node->data.binary_op.oper == OP_AND;
+        if (is_and != jump_if) {
+            // Either operand alone decides the jump (false for &&, true for ||)
+            ir_lower_branch(builder, node->data.binary_op.left, label, jump_if);
+            ir_lower_branch(builder, node->data.binary_op.right, label, jump_if);
+        } else {
+            // The left operand can only rule the jump out by skipping the right one
+            int skip_label = ir_new_label(function);
+            ir_lower_branch(builder, node->data.binary_op.left, skip_label, !jump_if);
+            ir_lower_branch(builder, node->data.binary_op.right, label, jump_if);
+            ir_emit_label(function, skip_label);
+        }
+        return;
+    }
+
+    int condition = ir_lower_expression(builder, node);
+    ir_emit_jump(function, jump_if ? IR_JUMP_NONZERO : IR_JUMP_ZERO, condition, label);
+}
+
+// Statement lowering
+static void ir_lower_variable_decl(ir_builder_t* builder, ast_node_t* node) {
+    ir_function_t* function = builder->function;
+
+    // The initializer sees the enclosing binding of a shadowed name
+    int value = IR_NO_VREG;
+    if (node->data.variable_decl.initializer) {
+        value = ir_lower_expression(builder, node->data.variable_decl.initializer);
+    }
+
+    int variable = ir_new_vreg(function, IR_VREG_VARIABLE);
+    ir_bind(builder, node->data.variable_decl.name, node->data.variable_decl.slot, variable);
+
+    ir_instr_t* instr = value != IR_NO_VREG ? ir_emit(function, IR_MOV) : NULL;
+    if (instr) {
+        instr->dst = variable;
+        instr->src1 = value;
+        instr->type = node->data.variable_decl.var_type;
+    }
+}
+
+static void ir_lower_if_stmt(ir_builder_t* builder, ast_node_t* node) {
+    ir_function_t* function = builder->function;
+    int else_label = ir_new_label(function);
+
+    ir_lower_branch(builder, node->data.if_stmt.condition, else_label, 0);
+
+    ir_lower_statement(builder, node->data.if_stmt.then_stmt);
+
+    if (node->data.if_stmt.else_stmt) {
+        int end_label = ir_new_label(function);
+        ir_emit_jump(function, IR_JUMP, IR_NO_VREG, end_label);
+        ir_emit_label(function, else_label);
+        ir_lower_statement(builder, node->data.if_stmt.else_stmt);
+        ir_emit_label(function, end_label);
+    } else {
+        ir_emit_label(function, else_label);
+    }
+}
+
+static void ir_lower_while_stmt(ir_builder_t* builder, ast_node_t* node) {
+    ir_function_t* function = builder->function;
+    int loop_label = ir_new_label(function);
+    int end_label = ir_new_label(function);
+
+    ir_emit_label(function, loop_label);
+    ir_lower_branch(builder, node->data.while_stmt.condition, end_label, 0);
+
+    ir_lower_statement(builder, node->data.while_stmt.body);
+
+    ir_emit_jump(function, IR_JUMP, IR_NO_VREG, loop_label);
+    ir_emit_label(function, end_label);
+}
+
+static void ir_lower_for_stmt(ir_builder_t* builder, ast_node_t* node) {
+    ir_function_t* function = builder->function;
+    size_t scope_mark = builder->binding_count;
+    int loop_label = ir_new_label(function);
+    int end_label = ir_new_label(function);
+
+    if (node->data.for_stmt.init) {
+        ir_lower_statement(builder, node->data.for_stmt.init);
+    }
+
+    ir_emit_label(function, loop_label);
+    if (node->data.for_stmt.condition) {
+        ir_lower_branch(builder, node->data.for_stmt.condition, end_label, 0);
+    }
+
+    ir_lower_statement(builder, node->data.for_stmt.body);
+
+    if (node->data.for_stmt.update) {
+        ir_lower_expression(builder, node->data.for_stmt.update);
+    }
+
+    ir_emit_jump(function, IR_JUMP, IR_NO_VREG, loop_label);
+    ir_emit_label(function, end_label);
+
+    builder->binding_count = scope_mark;
+}
+
+static void ir_lower_statement(ir_builder_t* builder, ast_node_t* node) {
+    if (!node) return;
+
+    switch (node->type) {
+        case AST_COMPOUND_STMT: {
+            size_t scope_mark = builder->binding_count;
+            for (size_t i = 0; i < node->data.compound_stmt.statement_count; i++) {
+                ir_lower_statement(builder, node->data.compound_stmt.statements[i]);
+            }
+            builder->binding_count = scope_mark;
+            break;
+        }
+        case AST_IF_STMT:
+            ir_lower_if_stmt(builder, node);
+            break;
+        case AST_WHILE_STMT:
+            ir_lower_while_stmt(builder, node);
+            break;
+        case AST_FOR_STMT:
+            ir_lower_for_stmt(builder, node);
+            break;
+        case AST_RETURN_STMT: {
+            int value = IR_NO_VREG;
+            if (node->data.return_stmt.value) {
+                value = ir_lower_expression(builder, node->data.return_stmt.value);
+            }
+            ir_instr_t* instr = ir_emit(builder->function, IR_RETURN);
+            if (instr) instr->src1 = value;
+            break;
+        }
+        case AST_EXPRESSION_STMT:
+            if (node->data.expression_stmt.expression) {
+                ir_lower_expression(builder, node->data.expression_stmt.expression);
+            }
+            break;
+        case AST_VARIABLE_DECL:
+            ir_lower_variable_decl(builder, node);
+            break;
+        default:
+            break;
+    }
+}
+
+// Helper: Lower one function definition
+static ir_function_t* ir_lower_function(ir_builder_t* builder, ast_node_t* node) {
+    ir_function_t* function = ir_function_create(node->data.function_decl.name,
+                                                 node->data.function_decl.return_type);
+    if (!function) return NULL;
+
+    builder->function = function;
+    builder->binding_count = 0;
+
+    int local_count = node->data.function_decl.local_count;
+    if (local_count > builder->slot_capacity) {
+        int* slot_vregs = realloc(builder->slot_vregs, (size_t)local_count * sizeof(int));
+        if (!slot_vregs) {
+            ir_function_destroy(function);
+            return NULL;
+        }
+        builder->slot_vregs = slot_vregs;
+        builder->slot_capacity = local_count;
+    }
+    builder->slot_count = local_count;
+    for (int i = 0; i < local_count; i++) {
+        builder->slot_vregs[i] = IR_NO_VREG;
+    }
+
+    function->param_count = node->data.function_decl.parameter_count;
+    for (size_t i = 0; i < function->param_count; i++) {
+        ast_node_t* param = node->data.function_decl.parameters[i];
+        int vreg = ir_new_vreg(function, IR_VREG_VARIABLE);
+        ir_bind(builder, param->data.parameter.name, param->data.parameter.slot, vreg);
+
+        ir_instr_t* instr = ir_emit(function, IR_PARAM);
+        if (!instr) break;
+        instr->dst = vreg;
+        instr->imm = (long)i;
+        instr->type = param->data.parameter.param_type;
+    }
+
+    ir_lower_statement(builder, node->data.function_decl.body);
+
+    // Falling off the end returns without a value
+    ir_emit(function, IR_RETURN);
+
+    if (function->failed) {
+        ir_function_destroy(function);
+        return NULL;
+    }
+    return function;
+}
+
+// Lowering
+ir_program_t* ir_lower_program(ast_node_t* ast) {
+    if (!ast || ast->type != AST_PROGRAM) return NULL;
+
+    ir_program_t* program = malloc(sizeof(ir_program_t));
+    if (!program) return NULL;
+
+    program->function_count = 0;
+    program->function_capacity = 8;
+    program->unresolved = NULL;
+    program->unresolved_line = 0;
+    program->unresolved_column = 0;
+    program->functions = malloc(program->function_capacity * sizeof(ir_function_t*));
+
+    ir_builder_t builder;
+    builder.function = NULL;
+    builder.binding_count = 0;
+    builder.binding_capacity = 32;
+    builder.bindings = malloc(builder.binding_capacity * sizeof(ir_binding_t));
+    builder.slot_vregs = NULL;
+    builder.slot_count = 0;
+    builder.slot_capacity = 0;
+    builder.unresolved = NULL;
+
+    if (!program->functions || !builder.bindings) {
+        free(builder.bindings);
+        ir_program_destroy(program);
+        return NULL;
+    }
+
+    // A function that could not be lowered (out of memory) fails the program
+    int failed = 0;
+    for (size_t i = 0; i < ast->data.program.declaration_count; i++) {
+        ast_node_t* decl = ast->data.program.declarations[i];
+        if (decl->type != AST_FUNCTION_DECL || !decl->data.function_decl.body) continue;
+
+        ir_function_t* function = ir_lower_function(&builder, decl);
+        if (!function) {
+            failed = 1;
+            break;
+        }
+
+        if (program->function_count >= program->function_capacity) {
+            ir_function_t** functions = realloc(program->functions,
+                                                program->function_capacity * 2 * sizeof(ir_function_t*));
+            if (!functions) {
+                ir_function_destroy(function);
+                failed = 1;
+                break;
+            }
+            program->functions = functions;
+            program->function_capacity *= 2;
+        }
+        program->functions[program->function_count++] = function;
+    }
+
+    free(builder.bindings);
+    free(builder.slot_vregs);
+    if (failed) {
+        ir_program_destroy(program);
+        return NULL;
+    }
+
+    if (builder.unresolved) {
+        program->unresolved = builder.unresolved->data.identifier.name;
+        program->unresolved_line = builder.unresolved->line;
+        program->unresolved_column = builder.unresolved->column;
+    }
+    return program;
+}
+
+void ir_program_destroy(ir_program_t* program) {
+    if (!program) return;
+
+    for (size_t i = 0; i < program->function_count; i++) {
+        ir_function_destroy(program->functions[i]);
+    }
+    free(program->functions);
+
+    free(program);
+}
+
+// Instruction operands
+size_t ir_instr_use_count(const ir_instr_t* instr) {
+    if (instr->opcode == IR_CALL) return instr->arg_count;
+    return (instr->src1 >= 0) + (instr->src2 >= 0);
+}
+
+int ir_instr_use(const ir_instr_t* instr, size_t index) {
+    if (instr->opcode == IR_CALL) return instr->args[index];
+    return index == 0 && instr->src1 >= 0 ? instr->src1 : instr->src2;
+}
+
+// Helper: True if instr ends a basic block
+static int ir_is_terminator(const ir_instr_t* instr) {
+    return instr->opcode == IR_JUMP || instr->opcode == IR_JUMP_ZERO ||
+           instr->opcode == IR_JUMP_NONZERO || instr->opcode == IR_RETURN;
+}
+
+// Helper: Record the edge from -> to
+static int ir_add_edge(ir_function_t* function, int from, int to) {
+    ir_block_t* source = &function->blocks[from];
+    ir_block_t* target = &function->blocks[to];
+
+    source->successors[source->successor_count++] = to;
+
+    int* predecessors = realloc(target->predecessors,
+                                (target->predecessor_count + 1) * sizeof(int));
+    if (!predecessors) return 0;
+
+    target->predecessors = predecessors;
+    target->predecessors[target->predecessor_count++] = from;
+    return 1;
+}
+
+// Control flow graph
+int ir_build_cfg(ir_function_t* function) {
+    if (function->blocks) return 1;
+
+    size_t count = function->instr_count;
+
+    // Leaders: the first instruction, every label, and whatever follows a terminator
+    size_t block_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i == 0 || function->instrs[i].opcode == IR_LABEL ||
+            ir_is_terminator(&function->instrs[i - 1])) {
+            block_count++;
+        }
+    }
+
+    function->blocks = calloc(block_count ? block_count : 1, sizeof(ir_block_t));
+    function->label_blocks = malloc((function->label_count + 1) * sizeof(int));
+    if (!function->blocks || !function->label_blocks) {
+        ir_invalidate_cfg(function);
+        return 0;
+    }
+
+    function->block_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (i == 0 || instr->opcode == IR_LABEL || ir_is_terminator(&function->instrs[i - 1])) {
+            if (function->block_count > 0) {
+                function->blocks[function->block_count - 1].end = i;
+            }
+            function->blocks[function->block_count++].start = i;
+        }
+        if (instr->opcode == IR_LABEL) {
+            function->label_blocks[instr->imm] = (int)function->block_count - 1;
+        }
+    }
+    if (function->block_count > 0) {
+        function->blocks[function->block_count - 1].end = count;
+    }
+
+    for (size_t b = 0; b < function->block_count; b++) {
+        ir_instr_t* last = &function->instrs[function->blocks[b].end - 1];
+        int next = b + 1 < function->block_count ? (int)b + 1 : -1;
+        int ok = 1;
+
+        switch (last->opcode) {
+            case IR_JUMP:
+                ok = ir_add_edge(function, (int)b, function->label_blocks[last->imm]);
+                break;
+            case IR_JUMP_ZERO:
+            case IR_JUMP_NONZERO:
+                if (next >= 0) ok = ir_add_edge(function, (int)b, next);
+                if (ok) ok = ir_add_edge(function, (int)b, function->label_blocks[last->imm]);
+                break;
+            case IR_RETURN:
+                break;
+            default:
+                if (next >= 0) ok = ir_add_edge(function, (int)b, next);
+                break;
+        }
+
+        if (!ok) {
+            ir_invalidate_cfg(function);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void ir_invalidate_cfg(ir_function_t* function) {
+    if (function->blocks) {
+        for (size_t b = 0; b < function->block_count; b++) {
+            free(function->blocks[b].predecessors);
+        }
+        // Bitsets of all blocks share one allocation hung off block 0
+        free(function->blocks[0].live_in);
+    }
+    free(function->blocks);
+    free(function->label_blocks);
+
+    function->blocks = NULL;
+    function->block_count = 0;
+    function->label_blocks = NULL;
+    function->live_words = 0;
+    function->liveness_valid = 0;
+}
+
+// Bitset helpers
+int ir_bitset_test(const unsigned long* set, int bit) {
+    return (set[bit / IR_BITSET_WORD_BITS] >> (bit % IR_BITSET_WORD_BITS)) & 1;
+}
+
+void ir_bitset_set(unsigned long* set, int bit) {
+    set[bit / IR_BITSET_WORD_BITS] |= 1UL << (bit % IR_BITSET_WORD_BITS);
+}
+
+void ir_bitset_clear(unsigned long* set, int bit) {
+    set[bit / IR_BITSET_WORD_BITS] &= ~(1UL << (bit % IR_BITSET_WORD_BITS));
+}
+
+// Lowest set bit at or after from, or -1 (skips empty words)
+int ir_bitset_next(const unsigned long* set, size_t words, int from) {
+    size_t w = from / IR_BITSET_WORD_BITS;
+    if (w >= words) return -1;
+
+    unsigned long word = set[w] & (~0UL << (from % IR_BITSET_WORD_BITS));
+    while (!word) {
+        if (++w >= words) return -1;
+        word = set[w];
+    }
+
+    int bit = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        bit++;
+    }
+    return (int)(w * IR_BITSET_WORD_BITS) + bit;
+}
+
+int ir_compute_liveness(ir_function_t* function) {
+    if (function->liveness_valid) return 1;
+    if (!ir_build_cfg(function) || function->block_count == 0) return 0;
+
+    size_t words = (function->vreg_count + IR_BITSET_WORD_BITS - 1) / IR_BITSET_WORD_BITS;
+    if (words == 0) words = 1;
+
+    // live_in, live_out, use and def sets for every block
+    size_t block_count = function->block_count;
+    unsigned long* storage = calloc(4 * block_count * words, sizeof(unsigned long));
+    if (!storage) return 0;
+
+    unsigned long* uses = storage + 2 * block_count * words;
+    unsigned long* defs = storage + 3 * block_count * words;
+
+    for (size_t b = 0; b < block_count; b++) {
+        ir_block_t* block = &function->blocks[b];
+        unsigned long* use = uses + b * words;
+        unsigned long* def = defs + b * words;
+
+        block->live_in = storage + b * words;
+        block->live_out = storage + (block_count + b) * words;
+
+        // A vreg read before any write in the block is upward exposed
+        for (size_t i = block->start; i < block->end; i++) {
+            ir_instr_t* instr = &function->instrs[i];
+            for (size_t u = 0; u < ir_instr_use_count(instr); u++) {
+                int vreg = ir_instr_use(instr, u);
+                if (!ir_bitset_test(def, vreg)) ir_bitset_set(use, vreg);
+            }
+            if (instr->dst != IR_NO_VREG) ir_bitset_set(def, instr->dst);
+        }
+    }
+
+    // live_out = union of successors' live_in; live_in = use | (live_out & ~def).
+    // Visiting blocks backwards converges in a few rounds for reducible CFGs.
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (size_t b = block_count; b > 0; b--) {
+            ir_block_t* block = &function->blocks[b - 1];
+            unsigned long* use = uses + (b - 1) * words;
+            unsigned long* def = defs + (b - 1) * words;
+
+            for (size_t w = 0; w < words; w++) {
+                unsigned long out = 0;
+                for (size_t s = 0; s < block->successor_count; s++) {
+                    out |= function->blocks[block->successors[s]].live_in[w];
+                }
+                unsigned long in = use[w] | (out & ~def[w]);
+
+                if (out != block->live_out[w] || in != block->live_in[w]) {
+                    block->live_out[w] = out;
+                    block->live_in[w] = in;
+                    changed = 1;
+                }
+            }
+        }
+    }
+
+    function->live_words = words;
+    function->liveness_valid = 1;
+    return 1;
+}
+
+int ir_vreg_live_in(const ir_function_t* function, size_t block, int vreg) {
+    return function->liveness_valid && ir_bitset_test(function->blocks[block].live_in, vreg);
+}
+
+int ir_vreg_live_out(const ir_function_t* function, size_t block, int vreg) {
+    return function->liveness_valid && ir_bitset_test(function->blocks[block].live_out, vreg);
+}
+
+// Helper: Widen an interval to cover position
+static void ir_interval_touch(ir_interval_t* interval, int position) {
+    if (interval->start < 0 || position < interval->start) interval->start = position;
+    if (position > interval->end) interval->end = position;
+}
+
+// Live intervals
+void ir_compute_intervals(ir_function_t* function, ir_interval_t* intervals) {
+    int count = (int)function->instr_count;
+
+    for (int v = 0; v < function->vreg_count; v++) {
+        intervals[v].vreg = v;
+        intervals[v].start = -1;
+        intervals[v].end = -1;
+        intervals[v].crosses_call = 0;
+    }
+
+    int* calls_before = malloc((count + 1) * sizeof(int));
+    if (!calls_before || !ir_compute_liveness(function)) {
+        free(calls_before);
+        return;
+    }
+
+    calls_before[0] = 0;
+    for (int i = 0; i < count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+
+        for (size_t u = 0; u < ir_instr_use_count(instr); u++) {
+            ir_interval_touch(&intervals[ir_instr_use(instr, u)], i);
+        }
+        if (instr->dst != IR_NO_VREG) {
+            ir_interval_touch(&intervals[instr->dst], i);
+        }
+
+        calls_before[i + 1] = calls_before[i] + (instr->opcode == IR_CALL);
+    }
+
+    // Values flowing into or out of a block are live at its boundary, which
+    // is what keeps loop-carried values alive across the back edge
+    for (size_t b = 0; b < function->block_count; b++) {
+        ir_block_t* block = &function->blocks[b];
+        for (int v = ir_bitset_next(block->live_in, function->live_words, 0); v >= 0;
+             v = ir_bitset_next(block->live_in, function->live_words, v + 1)) {
+            ir_interval_touch(&intervals[v], (int)block->start);
+        }
+        for (int v = ir_bitset_next(block->live_out, function->live_words, 0); v >= 0;
+             v = ir_bitset_next(block->live_out, function->live_words, v + 1)) {
+            ir_interval_touch(&intervals[v], (int)block->end - 1);
+        }
+    }
+
+    for (int v = 0; v < function->vreg_count; v++) {
+        ir_interval_t* interval = &intervals[v];
+        if (interval->start >= 0) {
+            interval->crosses_call = calls_before[interval->end] - calls_before[interval->start + 1] > 0;
+        }
+    }
+
+    free(calls_before);
+}
+
+// Helper: Print one instruction
+static void ir_print_instr(FILE* output, const ir_instr_t* instr) {
+    if (instr->opcode == IR_LABEL) {
+        fprintf(output, "  L%ld:\n", instr->imm);
+        return;
+    }
+
+    fprintf(output, "    ");
+    if (instr->dst != IR_NO_VREG) {
+        fprintf(output, "v%d = ", instr->dst);
+    }
+
+    switch (instr->opcode) {
+        case IR_CONST:
+            fprintf(output, "%ld", instr->imm);
+            break;
+        case IR_STRING:
+            fprintf(output, "\"%s\"", instr->name);
+            break;
+        case IR_MOV:
+            fprintf(output, "v%d", instr->src1);
+            break;
+        case IR_NARROW:
+            fprintf(output, "narrow v%d", instr->src1);
+            break;
+        case IR_BINARY:
+            fprintf(output, "v%d %s ", instr->src1, ast_operator_to_string(instr->oper));
+            if (instr->src2 == IR_IMM_OPERAND) fprintf(output, "%ld", instr->imm);
+            else fprintf(output, "v%d", instr->src2);
+            break;
+        case IR_UNARY:
+            fprintf(output, "%sv%d", ast_operator_to_string(instr->oper), instr->src1);
+            break;
+        case IR_PARAM:
+            fprintf(output, "param %ld", instr->imm);
+            break;
+        case IR_CALL:
+            fprintf(output, "call %s(", instr->name);
+            for (size_t i = 0; i < instr->arg_count; i++) {
+                fprintf(output, "%sv%d", i ? ", " : "", instr->args[i]);
+            }
+            fprintf(output, ")");
+            break;
+        case IR_JUMP:
+            fprintf(output, "jump L%ld", instr->imm);
+            break;
+        case IR_JUMP_ZERO:
+        case IR_JUMP_NONZERO:
+            fprintf(output, "if v%d %s 0 jump L%ld", instr->src1,
+                    instr->opcode == IR_JUMP_ZERO ? "==" : "!=", instr->imm);
+            break;
+        case IR_RETURN:
+            fprintf(output, "return");
+            if (instr->src1 == IR_IMM_OPERAND) fprintf(output, " %ld", instr->imm);
+            else if (instr->src1 != IR_NO_VREG) fprintf(output, " v%d", instr->src1);
+            break;
+        default:
+            fprintf(output, "%s", ir_opcode_to_string(instr->opcode));
+            break;
+    }
+
+    if (instr->dst != IR_NO_VREG) {
+        fprintf(output, " : %s", data_type_to_string(instr->type));
+    }
+    fprintf(output, "\n");
+}
+
+// Helper: Print the vregs of a bitset as "v1 v4 ..."
+static void ir_print_vreg_set(FILE* output, const ir_function_t* function, const unsigned long* set) {
+    for (int v = ir_bitset_next(set, function->live_words, 0); v >= 0;
+         v = ir_bitset_next(set, function->live_words, v + 1)) {
+        fprintf(output, " v%d", v);
+    }
+}
+
+// Debug output
+void ir_print_function(FILE* output, ir_function_t* function) {
+    fprintf(output, "function %s (%zu params) : %s\n", function->name,
+            function->param_count, data_type_to_string(function->return_type));
+
+    int have_liveness = ir_compute_liveness(function);
+
+    for (size_t b = 0; b < function->block_count; b++) {
+        ir_block_t* block = &function->blocks[b];
+
+        fprintf(output, "  block %zu:", b);
+        fprintf(output, " preds");
+        for (size_t p = 0; p < block->predecessor_count; p++) {
+            fprintf(output, " %d", block->predecessors[p]);
+        }
+        fprintf(output, ";  succs");
+        for (size_t s = 0; s < block->successor_count; s++) {
+            fprintf(output, " %d", block->successors[s]);
+        }
+        if (have_liveness) {
+            fprintf(output, ";  live-in");
+            ir_print_vreg_set(output, function, block->live_in);
+        }
+        fprintf(output, "\n");
+
+        for (size_t i = block->start; i < block->end; i++) {
+            ir_print_instr(output, &function->instrs[i]);
+        }
+    }
+    fprintf(output, "\n");
+}
+
+void ir_print_program(FILE* output, ir_program_t* program) {
+    if (!program) return;
+
+    for (size_t i = 0; i < program->function_count; i++) {
+        ir_print_function(output, program->functions[i]);
+    }
+}
+
+// Utility functions
+const char* ir_opcode_to_string(ir_opcode_t opcode) {
+    switch (opcode) {
+        case IR_CONST: return "const";
+        case IR_STRING: return "string";
+        case IR_MOV: return "mov";
+        case IR_NARROW: return "narrow";
+        case IR_BINARY: return "binary";
+        case IR_UNARY: return "unary";
+        case IR_PARAM: return "param";
+        case IR_CALL: return "call";
+        case IR_LABEL: return "label";
+        case IR_JUMP: return "jump";
+        case IR_JUMP_ZERO: return "jump_zero";
+        case IR_JUMP_NONZERO: return "jump_nonzero";
+        case IR_RETURN: return "return";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,172 @@
+// src/ir.h
+#ifndef IR_H
+#define IR_H
+
+#include <stdio.h>
+#include "ast.h"
+
+// Lowered intermediate representation
+// Each function body is flattened into a linear list of three-address
+// instructions over an unbounded set of virtual registers (vregs). Locals and
+// parameters own one vreg for their whole lifetime; every expression result
+// gets a fresh temporary vreg. Control flow is expressed with labels and
+// jumps, so the list is in the order the backend emits it. Basic blocks and
+// the CFG are derived from that list on demand, so passes may rewrite the
+// instructions and rebuild them afterwards.
+
+#define IR_NO_VREG (-1)
+#define IR_IMM_OPERAND (-2)  // Operand is the constant in imm: src2 of IR_BINARY
+                             // (except / and %) or src1 of IR_RETURN
+
+// IR opcodes
+typedef enum {
+    IR_CONST,      // dst = imm
+    IR_STRING,     // dst = address of string literal name
+    IR_MOV,        // dst = src1
+    IR_NARROW,     // dst = src1 sign-extended from its low int or char (type) bits
+    IR_BINARY,     // dst = src1 oper src2 (arithmetic and comparisons)
+    IR_UNARY,      // dst = oper src1
+    IR_PARAM,      // dst = incoming parameter number imm
+    IR_CALL,       // dst = name(args...) (dst may be IR_NO_VREG)
+    IR_LABEL,      // label imm:
+    IR_JUMP,       // goto label imm
+    IR_JUMP_ZERO,  // if src1 == 0 goto label imm
+    IR_JUMP_NONZERO, // if src1 != 0 goto label imm
+    IR_RETURN      // return src1 (src1 may be IR_NO_VREG)
+} ir_opcode_t;
+
+// IR instruction
+typedef struct {
+    ir_opcode_t opcode;
+    ast_operator_t oper;  // IR_BINARY / IR_UNARY
+    data_type_t type;     // Type of the value written to dst
+    int dst;
+    int src1;
+    int src2;
+    long imm;             // Constant, parameter number or label id
+    const char* name;     // Callee or string literal value (interned)
+    int* args;            // IR_CALL argument vregs
+    size_t arg_count;
+} ir_instr_t;
+
+// Vreg flags
+#define IR_VREG_VARIABLE 0x1  // Vreg holds a named local or parameter
+
+// Basic block: a maximal run of instructions entered only at the top
+typedef struct {
+    size_t start;             // First instruction
+    size_t end;               // One past the last instruction
+    int successors[2];        // Block indices; [0] is the fallthrough if there is one
+    size_t successor_count;
+    int* predecessors;
+    size_t predecessor_count;
+    unsigned long* live_in;   // Vreg bitsets, filled by ir_compute_liveness()
+    unsigned long* live_out;
+} ir_block_t;
+
+// Bits per word of a vreg bitset
+#define IR_BITSET_WORD_BITS (sizeof(unsigned long) * 8)
+
+// Vreg bitset helpers
+int ir_bitset_test(const unsigned long* set, int bit);
+void ir_bitset_set(unsigned long* set, int bit);
+void ir_bitset_clear(unsigned long* set, int bit);
+int ir_bitset_next(const unsigned long* set, size_t words, int from);  // -1 if none
+
+// Lowered function
+typedef struct {
+    const char* name;     // Interned
+    data_type_t return_type;
+    size_t param_count;
+
+    ir_instr_t* instrs;
+    size_t instr_count;
+    size_t instr_capacity;
+
+    unsigned char* vreg_flags;
+    int vreg_count;
+    int vreg_capacity;
+
+    int label_count;
+    int failed;           // An instruction or vreg could not be added
+
+    // CFG (NULL until ir_build_cfg(), cleared by ir_invalidate_cfg())
+    ir_block_t* blocks;
+    size_t block_count;
+    int* label_blocks;        // Block index of each label
+    size_t live_words;        // Words per vreg bitset
+    int liveness_valid;
+} ir_function_t;
+
+// Lowered program (functions with bodies only)
+typedef struct {
+    ir_function_t** functions;
+    size_t function_count;
+    size_t function_capacity;
+    // First identifier that is not a local or parameter (globals have no
+    // storage yet), or NULL; a program with one must not be compiled
+    const char* unresolved;           // Interned
+    unsigned int unresolved_line;
+    unsigned int unresolved_column;
+} ir_program_t;
+
+// Live interval of a vreg over instruction indices [start, end]
+typedef struct {
+    int vreg;
+    int start;
+    int end;
+    int crosses_call;     // An IR_CALL lies strictly inside the interval
+} ir_interval_t;
+
+// Lowering (ast must be an AST_PROGRAM annotated by semantic_analyze());
+// NULL when out of memory
+ir_program_t* ir_lower_program(ast_node_t* ast);
+void ir_program_destroy(ir_program_t* program);
+
+// Function construction
+ir_function_t* ir_function_create(const char* name, data_type_t return_type);
+void ir_function_destroy(ir_function_t* function);
+// ir_new_vreg() and ir_emit() return IR_NO_VREG / NULL and set failed when
+// the function cannot grow
+int ir_new_vreg(ir_function_t* function, unsigned char flags);
+int ir_new_label(ir_function_t* function);
+ir_instr_t* ir_emit(ir_function_t* function, ir_opcode_t opcode);
+
+// Control flow graph
+int ir_build_cfg(ir_function_t* function);
+void ir_invalidate_cfg(ir_function_t* function);  // Call after changing instrs
+
+/**
+ * @brief Computes live-in/live-out vreg sets of every block by backward
+ *        dataflow iteration (builds the CFG first if needed)
+ *
+ * @return int 1 on success, 0 on allocation failure
+ */
+int ir_compute_liveness(ir_function_t* function);
+int ir_vreg_live_in(const ir_function_t* function, size_t block, int vreg);
+int ir_vreg_live_out(const ir_function_t* function, size_t block, int vreg);
+
+/**
+ * @brief Computes the live interval of every vreg in function
+ *
+ * @param function The function to analyze
+ * @param intervals Output array indexed by vreg (vreg_count entries); vregs
+ *                  that never occur get start = -1
+ *
+ * @note Each interval is the hull of the positions where the vreg occurs or
+ *       is live on block entry/exit, so holes are not modelled.
+ */
+void ir_compute_intervals(ir_function_t* function, ir_interval_t* intervals);
+
+// Vregs read by an instruction, in operand order (immediates are skipped)
+size_t ir_instr_use_count(const ir_instr_t* instr);
+int ir_instr_use(const ir_instr_t* instr, size_t index);
+
+// Debug output
+void ir_print_function(FILE* output, ir_function_t* function);
+void ir_print_program(FILE* output, ir_program_t* program);
+
+// Utility functions
+const char* ir_opcode_to_string(ir_opcode_t opcode);
+
+#endif // IR_H
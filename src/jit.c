@@ -0,0 +1,145 @@
+// src/jit.c
+#define _DEFAULT_SOURCE   // MAP_ANONYMOUS
+
+// The BSD register_t these headers declare would clash with codegen.h's
+#define register_t system_register_t
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#undef register_t
+
+#include "jit.h"
+
+// Import stub: jmp *0(%rip) followed by the 64-bit target address
+#define JIT_STUB_SIZE 16
+static const unsigned char jit_stub_code[] = {0xFF, 0x25, 0x00, 0x00, 0x00, 0x00};
+
+// Helper: Round size up to a multiple of the page size
+static size_t jit_page_align(size_t size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (size + page - 1) / page * page;
+}
+
+// Helper: Address of import name, or NULL if it is not provided
+static void* jit_import(const jit_symbol_t* imports, size_t import_count, const char* name) {
+    for (size_t i = 0; i < import_count; i++) {
+        if (strcmp(imports[i].name, name) == 0) return imports[i].address;
+    }
+    return NULL;
+}
+
+jit_image_t* jit_load(const object_t* object, const jit_symbol_t* imports, size_t import_count,
+                      const char** error) {
+    if (error) *error = NULL;
+    if (!object || object->failed) return NULL;
+
+    // Undefined symbols each get a stub after .text
+    size_t stub_count = 0;
+    for (size_t i = 0; i < object->symbol_count; i++) {
+        if (object->symbols[i].section == OBJECT_UNDEFINED) stub_count++;
+    }
+    size_t stubs_offset = (object->text.size + JIT_STUB_SIZE - 1) / JIT_STUB_SIZE * JIT_STUB_SIZE;
+    size_t code_size = jit_page_align(stubs_offset + stub_count * JIT_STUB_SIZE);
+    size_t size = code_size + jit_page_align(object->data.size > 0 ? object->data.size : 1);
+
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) return NULL;
+
+    jit_image_t* image = malloc(sizeof(jit_image_t));
+    if (!image) {
+        munmap(memory, size);
+        return NULL;
+    }
+    image->memory = memory;
+    image->size = size;
+    image->text = image->memory;
+    image->data = image->memory + code_size;
+    image->object = object;
+
+    if (object->text.size > 0) memcpy(image->text, object->text.data, object->text.size);
+    if (object->data.size > 0) memcpy(image->data, object->data.data, object->data.size);
+
+    // Stub addresses, indexed like object->symbols
+    unsigned char** stubs = calloc(object->symbol_count + 1, sizeof(unsigned char*));
+    int success = stubs != NULL;
+    unsigned char* stub = image->text + stubs_offset;
+    for (size_t i = 0; success && i < object->symbol_count; i++) {
+        const object_symbol_t* symbol = &object->symbols[i];
+        if (symbol->section != OBJECT_UNDEFINED) continue;
+
+        void* address = jit_import(imports, import_count, symbol->name);
+        if (!address) {
+            // Only names that are actually referenced matter
+            int referenced = 0;
+            for (size_t f = 0; f < object->fixup_count && !referenced; f++) {
+                referenced = object->fixups[f].symbol == symbol->name;
+            }
+            if (!referenced) continue;
+            if (error) *error = symbol->name;
+            success = 0;
+            break;
+        }
+        memcpy(stub, jit_stub_code, sizeof(jit_stub_code));
+        memcpy(stub + sizeof(jit_stub_code), &address, sizeof(address));
+        stubs[i] = stub;
+        stub += JIT_STUB_SIZE;
+    }
+
+    // Every fixup is a 32-bit displacement from the end of its field
+    for (size_t f = 0; success && f < object->fixup_count; f++) {
+        const object_fixup_t* fixup = &object->fixups[f];
+        size_t s = 0;
+        while (object->symbols[s].name != fixup->symbol) s++;
+        const object_symbol_t* symbol = &object->symbols[s];
+
+        unsigned char* target;
+        if (symbol->section == OBJECT_TEXT) {
+            target = image->text + symbol->offset;
+        } else if (symbol->section == OBJECT_DATA) {
+            target = image->data + symbol->offset;
+        } else {
+            target = stubs[s];
+        }
+        if (!target) {
+            if (error) *error = symbol->name;
+            success = 0;
+            break;
+        }
+
+        int64_t displacement = (int64_t)(target - (image->text + fixup->offset)) + fixup->addend;
+        int32_t field = (int32_t)displacement;
+        memcpy(image->text + fixup->offset, &field, sizeof(field));
+    }
+    free(stubs);
+
+    if (success) {
+        success = mprotect(image->text, code_size, PROT_READ | PROT_EXEC) == 0;
+    }
+    if (!success) {
+        jit_destroy(image);
+        return NULL;
+    }
+    return image;
+}
+
+void* jit_lookup(const jit_image_t* image, const char* name) {
+    if (!image || !name) return NULL;
+
+    for (size_t i = 0; i < image->object->symbol_count; i++) {
+        const object_symbol_t* symbol = &image->object->symbols[i];
+        if (strcmp(symbol->name, name) != 0) continue;
+        if (symbol->section == OBJECT_TEXT) return image->text + symbol->offset;
+        if (symbol->section == OBJECT_DATA) return image->data + symbol->offset;
+        return NULL;
+    }
+    return NULL;
+}
+
+void jit_destroy(jit_image_t* image) {
+    if (!image) return;
+
+    munmap(image->memory, image->size);
+    free(image);
+}
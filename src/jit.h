@@ -0,0 +1,47 @@
+// src/jit.h
+#ifndef JIT_H
+#define JIT_H
+
+#include <stddef.h>
+#include "object.h"
+
+// Native function the loaded code may call by name (runtime functions)
+typedef struct {
+    const char* name;
+    void* address;
+} jit_symbol_t;
+
+// Object placed in executable memory: .text and import stubs are mapped
+// read/execute, .data sits on its own read/write pages after them
+typedef struct {
+    unsigned char* memory;    // mmap'd region holding everything below
+    size_t size;
+    unsigned char* text;
+    unsigned char* data;
+    const object_t* object;   // Symbols are looked up in the encoded object
+} jit_image_t;
+
+/**
+ * @brief Copies an encoded object into executable memory and resolves it
+ *
+ * Calls to names the object does not define go through a stub that jumps
+ * to the matching import, so imports may lie anywhere in the address space.
+ *
+ * @param object Encoded object (its failed flag must be clear)
+ * @param imports Functions provided to the code
+ * @param import_count Number of imports
+ * @param error Set to the name of an unresolved symbol on failure (may be NULL)
+ * @return jit_image_t* Loaded image, or NULL on failure
+ *
+ * @note The object must outlive the image
+ */
+jit_image_t* jit_load(const object_t* object, const jit_symbol_t* imports, size_t import_count,
+                      const char** error);
+
+// Address of the function or data label name in image, or NULL if not defined
+void* jit_lookup(const jit_image_t* image, const char* name);
+
+// Unmap the image (safe to call with NULL pointer)
+void jit_destroy(jit_image_t* image);
+
+#endif // JIT_H
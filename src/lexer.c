@@ -1,25 +1,51 @@
 // src/lexer.c
+#define _POSIX_C_SOURCE 200809L   // fileno(), mmap()
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "lexer.h"
+#include "utils.h"
 
-// Keywords lookup table
-static const struct {
-    const char* word;
-    token_type_t token;
-} keywords[] = {
-    {"int", TOKEN_INT},
-    {"char", TOKEN_CHAR},
-    {"void", TOKEN_VOID},
-    {"if", TOKEN_IF},
-    {"else", TOKEN_ELSE},
-    {"while", TOKEN_WHILE},
-    {"for", TOKEN_FOR},
-    {"return", TOKEN_RETURN},
-    {NULL, TOKEN_EOF}
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define LEXER_USE_SSE2 1
+#endif
+
+// Character classes
+#define LEXER_CHAR_SPACE 0x1   // ' ', \t, \n, \v, \f, \r
+#define LEXER_CHAR_ALPHA 0x2   // Letters and '_' (may start an identifier)
+#define LEXER_CHAR_DIGIT 0x4   // '0'-'9'
+#define LEXER_CHAR_IDENT (LEXER_CHAR_ALPHA | LEXER_CHAR_DIGIT)
+
+// Character class of every byte value (non-ASCII bytes have no class)
+#define S LEXER_CHAR_SPACE
+#define A LEXER_CHAR_ALPHA
+#define D LEXER_CHAR_DIGIT
+static const unsigned char lexer_char_class[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, S, S, S, S, S, 0, 0,   // 0x00
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 0x10
+    S, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 0x20
+    D, D, D, D, D, D, D, D, D, D, 0, 0, 0, 0, 0, 0,   // 0x30
+    0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A,   // 0x40
+    A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, A,   // 0x50
+    0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A,   // 0x60
+    A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, 0, 0,   // 0x70
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 0x80
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 0x90
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 0xA0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 0xB0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 0xC0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 0xD0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 0xE0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 0xF0
 };
+#undef S
+#undef A
+#undef D
+
+#define LEXER_CLASS(c) (lexer_char_class[(unsigned char)(c)])
 
 // Token type to string mapping for debugging
 const char* token_type_to_string(token_type_t type) {
@@ -62,72 +88,152 @@ const char* token_type_to_string(token_type_t type) {
     }
 }
 
-// Create lexer from source string
-lexer_t* lexer_create(const char* source) {
-    if (!source) return NULL;
+// Helper: Reset a token to the empty EOF token
+static void lexer_clear_token(token_t* token) {
+    token->type = TOKEN_EOF;
+    token->start = 0;
+    token->length = 0;
+    token->line = 0;
+    token->column = 0;
+    token->message = NULL;
+    token->name = NULL;
+}
+
+// Keyword table, laid out at compile time by KEYWORD_HASH (see lexer.h). A
+// new keyword goes in the slot its hash names, which no other C89 keyword
+// uses; test_keyword_hash checks every entry is where lookups expect it.
+static const struct {
+    const char* word;
+    size_t length;
+    token_type_t token;
+} keyword_slots[KEYWORD_HASH_SIZE] = {
+    [3] = {"void", 4, TOKEN_VOID},
+    [4] = {"else", 4, TOKEN_ELSE},
+    [9] = {"return", 6, TOKEN_RETURN},
+    [21] = {"char", 4, TOKEN_CHAR},
+    [22] = {"int", 3, TOKEN_INT},
+    [23] = {"while", 5, TOKEN_WHILE},
+    [32] = {"for", 3, TOKEN_FOR},
+    [55] = {"if", 2, TOKEN_IF},
+};
+
+// Keyword recognition on a source span
+token_type_t lexer_lookup_keyword(const char* text, size_t length) {
+    if (length < 2) return TOKEN_IDENTIFIER;  // No one-letter keywords
+    
+    // The hash is perfect, so the word's own slot is the only candidate
+    unsigned int slot = KEYWORD_HASH(text, length);
+    if (keyword_slots[slot].length == length &&
+        memcmp(keyword_slots[slot].word, text, length) == 0) {
+        return keyword_slots[slot].token;
+    }
     
+    return TOKEN_IDENTIFIER;
+}
+
+// Helper: Allocate a lexer positioned at the start of the given input
+static lexer_t* lexer_alloc(const char* source, size_t length, lexer_input_kind_t kind) {
     lexer_t* lexer = malloc(sizeof(lexer_t));
     if (!lexer) return NULL;
     
-    lexer->length = strlen(source);
-    lexer->source = malloc(lexer->length + 1);
-    if (!lexer->source) {
-        free(lexer);
-        return NULL;
-    }
-    
-    strcpy(lexer->source, source);
+    lexer->source = source;
+    lexer->length = length;
     lexer->position = 0;
+    lexer->input_kind = kind;
+    lexer->capacity = 0;
+    lexer->stream = NULL;
+    lexer->owns_stream = 0;
     lexer->line = 1;
-    lexer->column = 1;
-    lexer->current_token.type = TOKEN_EOF;
-    lexer->current_token.value = NULL;
-    lexer->current_token.line = 0;
-    lexer->current_token.column = 0;
+    lexer->line_start = 0;
+    lexer->lookahead_head = 0;
+    lexer->lookahead_count = 0;
+    lexer_clear_token(&lexer->current_token);
+    
+    return lexer;
+}
+
+// Create lexer from source string
+lexer_t* lexer_create(const char* source) {
+    if (!source) return NULL;
+    
+    size_t length = strlen(source);
+    char* copy = malloc(length + 1);
+    if (!copy) return NULL;
+    memcpy(copy, source, length + 1);
+    
+    lexer_t* lexer = lexer_alloc(copy, length, LEXER_INPUT_OWNED);
+    if (!lexer) free(copy);
     
     return lexer;
 }
 
+// Create lexer over a caller-owned buffer
+lexer_t* lexer_create_from_buffer(const char* source, size_t length) {
+    if (!source) return NULL;
+    return lexer_alloc(source, length, LEXER_INPUT_BORROWED);
+}
+
 // Create lexer from file
 lexer_t* lexer_create_from_file(const char* filename) {
+    if (!filename) return NULL;
+    
+    if (strcmp(filename, "-") == 0) {
+        return lexer_create_from_stream(stdin);
+    }
+    
     FILE* file = fopen(filename, "r");
     if (!file) {
         fprintf(stderr, "Error: Cannot open file '%s'\n", filename);
         return NULL;
     }
     
-    // Get file size
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    // Pipes, FIFOs and character devices have no size up front: stream them
+    struct stat info;
+    if (fstat(fileno(file), &info) != 0 || !S_ISREG(info.st_mode)) {
+        lexer_t* lexer = lexer_create_from_stream(file);
+        if (!lexer) {
+            fclose(file);
+            return NULL;
+        }
+        lexer->owns_stream = 1;
+        return lexer;
+    }
     
-    // Read entire file
-    char* source = malloc(file_size + 1);
-    if (!source) {
+    size_t file_size = (size_t)info.st_size;
+    if (file_size == 0) {
         fclose(file);
-        return NULL;
+        return lexer_alloc("", 0, LEXER_INPUT_BORROWED);
     }
     
-    size_t bytes_read = fread(source, 1, file_size, file);
-    source[bytes_read] = '\0';
+    // Map the file read-only; the mapping survives closing the descriptor
+    void* mapped = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
     fclose(file);
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "Error: Cannot map file '%s'\n", filename);
+        return NULL;
+    }
     
-    // Create lexer directly instead of calling lexer_create
-    lexer_t* lexer = malloc(sizeof(lexer_t));
-    if (!lexer) {
-        free(source);
+    lexer_t* lexer = lexer_alloc(mapped, file_size, LEXER_INPUT_MAPPED);
+    if (!lexer) munmap(mapped, file_size);
+    
+    return lexer;
+}
+
+// Create lexer that reads from a stream on demand
+lexer_t* lexer_create_from_stream(FILE* stream) {
+    if (!stream) return NULL;
+    
+    lexer_t* lexer = lexer_alloc(NULL, 0, LEXER_INPUT_STREAM);
+    if (!lexer) return NULL;
+    
+    lexer->source = malloc(LEXER_STREAM_CHUNK_SIZE);
+    if (!lexer->source) {
+        free(lexer);
         return NULL;
     }
     
-    lexer->length = bytes_read;
-    lexer->source = source; // Take ownership of the source string
-    lexer->position = 0;
-    lexer->line = 1;
-    lexer->column = 1;
-    lexer->current_token.type = TOKEN_EOF;
-    lexer->current_token.value = NULL;
-    lexer->current_token.line = 0;
-    lexer->current_token.column = 0;
+    lexer->capacity = LEXER_STREAM_CHUNK_SIZE;
+    lexer->stream = stream;
     
     return lexer;
 }
@@ -136,14 +242,75 @@ lexer_t* lexer_create_from_file(const char* filename) {
 void lexer_destroy(lexer_t* lexer) {
     if (!lexer) return;
     
-    if (lexer->source) free(lexer->source);
-    if (lexer->current_token.value) free(lexer->current_token.value);
+    switch (lexer->input_kind) {
+        case LEXER_INPUT_OWNED:
+        case LEXER_INPUT_STREAM:
+            free((char*)lexer->source);
+            break;
+        case LEXER_INPUT_MAPPED:
+            munmap((void*)lexer->source, lexer->length);
+            break;
+        case LEXER_INPUT_BORROWED:
+            break;
+    }
+    
+    if (lexer->stream && lexer->owns_stream) {
+        fclose(lexer->stream);
+    }
+    
     free(lexer);
 }
 
+// Token text access
+const char* lexer_token_text(const lexer_t* lexer, token_t token) {
+    return lexer->source + token.start;
+}
+
+int lexer_token_equals(const lexer_t* lexer, token_t token, const char* text) {
+    size_t length = strlen(text);
+    return token.length == length &&
+           memcmp(lexer->source + token.start, text, length) == 0;
+}
+
+// Helper: Read the next chunk of a streamed source, returns 0 once input is exhausted
+static int lexer_fill(lexer_t* lexer) {
+    if (!lexer->stream) return 0;
+    
+    if (lexer->capacity - lexer->length < LEXER_STREAM_CHUNK_SIZE) {
+        size_t new_capacity = lexer->capacity * 2;
+        char* new_source = realloc((char*)lexer->source, new_capacity);
+        if (!new_source) {
+            fprintf(stderr, "Error: Out of memory while reading input\n");
+            return 0;
+        }
+        lexer->source = new_source;
+        lexer->capacity = new_capacity;
+    }
+    
+    size_t bytes_read = fread((char*)lexer->source + lexer->length, 1,
+                              LEXER_STREAM_CHUNK_SIZE, lexer->stream);
+    lexer->length += bytes_read;
+    
+    if (bytes_read < LEXER_STREAM_CHUNK_SIZE) {
+        // EOF or read error: nothing more will arrive
+        if (lexer->owns_stream) fclose(lexer->stream);
+        lexer->stream = NULL;
+    }
+    
+    return bytes_read > 0;
+}
+
+// Helper: Make sure the byte at offset is loaded, returns 0 past the end of input
+static int lexer_available(lexer_t* lexer, size_t offset) {
+    while (offset >= lexer->length) {
+        if (!lexer_fill(lexer)) return 0;
+    }
+    return 1;
+}
+
 // Helper: Check if we're at end of source
 static int lexer_at_end(lexer_t* lexer) {
-    return lexer->position >= lexer->length;
+    return !lexer_available(lexer, lexer->position);
 }
 
 // Helper: Peek at current character without advancing
@@ -154,10 +321,15 @@ static char lexer_peek(lexer_t* lexer) {
 
 // Helper: Peek at next character
 static char lexer_peek_next(lexer_t* lexer) {
-    if (lexer->position + 1 >= lexer->length) return '\0';
+    if (!lexer_available(lexer, lexer->position + 1)) return '\0';
     return lexer->source[lexer->position + 1];
 }
 
+// Helper: Column of the current position (computed from the start of the line)
+static int lexer_column(const lexer_t* lexer) {
+    return (int)(lexer->position - lexer->line_start) + 1;
+}
+
 // Helper: Advance position and return current character
 static char lexer_advance(lexer_t* lexer) {
     if (lexer_at_end(lexer)) return '\0';
@@ -166,38 +338,140 @@ static char lexer_advance(lexer_t* lexer) {
     
     if (c == '\n') {
         lexer->line++;
-        lexer->column = 1;
-    } else {
-        lexer->column++;
+        lexer->line_start = lexer->position;
     }
     
     return c;
 }
 
+#ifdef LEXER_USE_SSE2
+// Helper: Number of leading bytes of p[0..n) in class cls, 16 bytes at a time.
+// Stops at the first block containing a byte outside the class.
+static size_t lexer_span_sse2(const char* p, size_t n, unsigned char cls) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab_below = _mm_set1_epi8('\t' - 1);
+    const __m128i cr_above = _mm_set1_epi8('\r' + 1);
+    const __m128i digit_below = _mm_set1_epi8('0' - 1);
+    const __m128i digit_above = _mm_set1_epi8('9' + 1);
+    const __m128i lower_below = _mm_set1_epi8('a' - 1);
+    const __m128i lower_above = _mm_set1_epi8('z' + 1);
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i underscore = _mm_set1_epi8('_');
+    
+    size_t i = 0;
+    while (i + 16 <= n) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(p + i));
+        __m128i match = _mm_setzero_si128();
+        
+        // Signed compares: bytes >= 0x80 are negative and never match
+        if (cls & LEXER_CHAR_SPACE) {
+            __m128i control = _mm_and_si128(_mm_cmpgt_epi8(bytes, tab_below),
+                                            _mm_cmplt_epi8(bytes, cr_above));
+            match = _mm_or_si128(match, _mm_or_si128(control, _mm_cmpeq_epi8(bytes, space)));
+        }
+        if (cls & LEXER_CHAR_DIGIT) {
+            match = _mm_or_si128(match, _mm_and_si128(_mm_cmpgt_epi8(bytes, digit_below),
+                                                      _mm_cmplt_epi8(bytes, digit_above)));
+        }
+        if (cls & LEXER_CHAR_ALPHA) {
+            __m128i folded = _mm_or_si128(bytes, case_bit);
+            __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(folded, lower_below),
+                                           _mm_cmplt_epi8(folded, lower_above));
+            match = _mm_or_si128(match, _mm_or_si128(letter, _mm_cmpeq_epi8(bytes, underscore)));
+        }
+        
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(match);
+        if (mask != 0xFFFF) {
+            return i + (size_t)__builtin_ctz(~mask);
+        }
+        i += 16;
+    }
+    
+    return i;
+}
+#endif
+
+// Helper: Number of leading bytes of p[0..n) in class cls
+static size_t lexer_span(const char* p, size_t n, unsigned char cls) {
+    size_t i = 0;
+    
+#ifdef LEXER_USE_SSE2
+    i = lexer_span_sse2(p, n, cls);
+    if (i < n && !(LEXER_CLASS(p[i]) & cls)) return i;
+#endif
+    
+    while (i < n && (LEXER_CLASS(p[i]) & cls)) {
+        i++;
+    }
+    
+    return i;
+}
+
+// Helper: Move position forward by count bytes, updating line bookkeeping
+static void lexer_skip_bytes(lexer_t* lexer, size_t count) {
+    const char* p = lexer->source + lexer->position;
+    const char* end = p + count;
+    
+    while ((p = memchr(p, '\n', (size_t)(end - p))) != NULL) {
+        lexer->line++;
+        p++;
+        lexer->line_start = (size_t)(p - lexer->source);
+    }
+    
+    lexer->position += count;
+}
+
+// Helper: Skip the run of characters in class cls starting at the current position
+static void lexer_skip_class(lexer_t* lexer, unsigned char cls) {
+    while (lexer_available(lexer, lexer->position)) {
+        size_t available = lexer->length - lexer->position;
+        size_t run = lexer_span(lexer->source + lexer->position, available, cls);
+        
+        if (cls & LEXER_CHAR_SPACE) {
+            lexer_skip_bytes(lexer, run);
+        } else {
+            lexer->position += run;  // No newlines in identifiers or numbers
+        }
+        
+        if (run < available) return;
+    }
+}
+
+// Helper: Skip up to (not including) the next occurrence of c, or to the end of input
+static void lexer_skip_until(lexer_t* lexer, char c) {
+    while (lexer_available(lexer, lexer->position)) {
+        const char* p = lexer->source + lexer->position;
+        size_t available = lexer->length - lexer->position;
+        const char* found = memchr(p, c, available);
+        
+        lexer_skip_bytes(lexer, found ? (size_t)(found - p) : available);
+        if (found) return;
+    }
+}
+
 // Helper: Skip whitespace and comments
 static void lexer_skip_whitespace(lexer_t* lexer) {
     while (!lexer_at_end(lexer)) {
         char c = lexer_peek(lexer);
         
-        if (isspace(c)) {
-            lexer_advance(lexer);
+        if (LEXER_CLASS(c) & LEXER_CHAR_SPACE) {
+            lexer_skip_class(lexer, LEXER_CHAR_SPACE);
         } else if (c == '/' && lexer_peek_next(lexer) == '/') {
             // Skip line comment
-            while (!lexer_at_end(lexer) && lexer_peek(lexer) != '\n') {
-                lexer_advance(lexer);
-            }
+            lexer_skip_until(lexer, '\n');
         } else if (c == '/' && lexer_peek_next(lexer) == '*') {
             // Skip block comment
-            lexer_advance(lexer); // consume '/'
-            lexer_advance(lexer); // consume '*'
+            lexer->position += 2; // consume '/*'
             
             while (!lexer_at_end(lexer)) {
-                if (lexer_peek(lexer) == '*' && lexer_peek_next(lexer) == '/') {
-                    lexer_advance(lexer); // consume '*'
-                    lexer_advance(lexer); // consume '/'
+                lexer_skip_until(lexer, '*');
+                if (lexer_at_end(lexer)) break;
+                
+                lexer->position++; // consume '*'
+                if (lexer_peek(lexer) == '/') {
+                    lexer->position++; // consume '/'
                     break;
                 }
-                lexer_advance(lexer);
             }
         } else {
             break;
@@ -205,63 +479,49 @@ static void lexer_skip_whitespace(lexer_t* lexer) {
     }
 }
 
-// Helper: Create a token
-static token_t lexer_make_token(lexer_t* lexer, token_type_t type, const char* value) {
+// Helper: Create a token spanning from start to the current position
+static token_t lexer_make_token(lexer_t* lexer, token_type_t type, size_t start,
+                                int line, int column) {
     token_t token;
     token.type = type;
-    token.line = lexer->line;
-    token.column = lexer->column;
-    
-    if (value) {
-        token.value = malloc(strlen(value) + 1);
-        strcpy(token.value, value);
-    } else {
-        token.value = NULL;
-    }
+    token.start = start;
+    token.length = lexer->position - start;
+    token.line = line;
+    token.column = column;
+    token.message = NULL;
+    token.name = NULL;
     
     return token;
 }
 
-// Helper: Check if string is a keyword
-static token_type_t lexer_check_keyword(const char* text) {
-    for (int i = 0; keywords[i].word != NULL; i++) {
-        if (strcmp(text, keywords[i].word) == 0) {
-            return keywords[i].token;
-        }
-    }
-    return TOKEN_IDENTIFIER;
+// Helper: Create an error token covering the offending text
+static token_t lexer_error_token(lexer_t* lexer, const char* message, size_t start,
+                                 int line, int column) {
+    token_t token = lexer_make_token(lexer, TOKEN_ERROR, start, line, column);
+    token.message = message;
+    return token;
 }
 
 // Helper: Scan identifier or keyword
 static token_t lexer_scan_identifier(lexer_t* lexer) {
     int start_line = lexer->line;
-    int start_column = lexer->column;
+    int start_column = lexer_column(lexer);
     
     size_t start = lexer->position;
     
-    // First character must be letter or underscore
-    if (isalpha(lexer_peek(lexer)) || lexer_peek(lexer) == '_') {
-        lexer_advance(lexer);
-        
-        // Subsequent characters can be letters, digits, or underscores
-        while (!lexer_at_end(lexer) && 
-               (isalnum(lexer_peek(lexer)) || lexer_peek(lexer) == '_')) {
-            lexer_advance(lexer);
-        }
+    // First character must be letter or underscore, the rest may also be digits
+    if (LEXER_CLASS(lexer_peek(lexer)) & LEXER_CHAR_ALPHA) {
+        lexer->position++;
+        lexer_skip_class(lexer, LEXER_CHAR_IDENT);
     }
     
-    size_t length = lexer->position - start;
-    char* text = malloc(length + 1);
-    strncpy(text, &lexer->source[start], length);
-    text[length] = '\0';
+    token_t token = lexer_make_token(lexer, TOKEN_IDENTIFIER, start, start_line, start_column);
     
-    token_type_t type = lexer_check_keyword(text);
-    
-    token_t token;
-    token.type = type;
-    token.value = text;
-    token.line = start_line;
-    token.column = start_column;
+    // Keywords are recognized on the span; only real identifiers get interned
+    token.type = lexer_lookup_keyword(&lexer->source[start], token.length);
+    if (token.type == TOKEN_IDENTIFIER) {
+        token.name = intern_string_n(&lexer->source[start], token.length);
+    }
     
     return token;
 }
@@ -269,32 +529,19 @@ static token_t lexer_scan_identifier(lexer_t* lexer) {
 // Helper: Scan number literal
 static token_t lexer_scan_number(lexer_t* lexer) {
     int start_line = lexer->line;
-    int start_column = lexer->column;
+    int start_column = lexer_column(lexer);
     
     size_t start = lexer->position;
     
-    while (!lexer_at_end(lexer) && isdigit(lexer_peek(lexer))) {
-        lexer_advance(lexer);
-    }
+    lexer_skip_class(lexer, LEXER_CHAR_DIGIT);
     
-    size_t length = lexer->position - start;
-    char* text = malloc(length + 1);
-    strncpy(text, &lexer->source[start], length);
-    text[length] = '\0';
-    
-    token_t token;
-    token.type = TOKEN_NUMBER;
-    token.value = text;
-    token.line = start_line;
-    token.column = start_column;
-    
-    return token;
+    return lexer_make_token(lexer, TOKEN_NUMBER, start, start_line, start_column);
 }
 
 // Helper: Scan string literal
 static token_t lexer_scan_string(lexer_t* lexer) {
     int start_line = lexer->line;
-    int start_column = lexer->column;
+    int start_column = lexer_column(lexer);
     
     lexer_advance(lexer); // consume opening quote
     
@@ -313,38 +560,30 @@ static token_t lexer_scan_string(lexer_t* lexer) {
     
     if (lexer_at_end(lexer)) {
         // Unterminated string
-        token_t token;
-        token.type = TOKEN_ERROR;
-        token.value = malloc(20);
-        strcpy(token.value, "Unterminated string");
-        token.line = start_line;
-        token.column = start_column;
-        return token;
+        return lexer_error_token(lexer, "Unterminated string", start - 1,
+                                 start_line, start_column);
     }
     
-    size_t length = lexer->position - start;
-    char* text = malloc(length + 1);
-    strncpy(text, &lexer->source[start], length);
-    text[length] = '\0';
+    // The span covers the contents between the quotes
+    token_t token = lexer_make_token(lexer, TOKEN_STRING, start, start_line, start_column);
     
     lexer_advance(lexer); // consume closing quote
     
-    token_t token;
-    token.type = TOKEN_STRING;
-    token.value = text;
-    token.line = start_line;
-    token.column = start_column;
-    
     return token;
 }
 
-// Main tokenization function
-token_t lexer_next_token(lexer_t* lexer) {
+// Helper: Scan one token from the source
+static token_t lexer_scan_token(lexer_t* lexer) {
+    token_t token;
     lexer_skip_whitespace(lexer);
     
+    size_t start = lexer->position;
+    int line = lexer->line;
+    int column = lexer_column(lexer);
+    
     if (lexer_at_end(lexer)) {
-        lexer->current_token = lexer_make_token(lexer, TOKEN_EOF, NULL);
-        return lexer->current_token;
+        token = lexer_make_token(lexer, TOKEN_EOF, start, line, column);
+        return token;
     }
     
     char c = lexer_advance(lexer);
@@ -352,141 +591,150 @@ token_t lexer_next_token(lexer_t* lexer) {
     // Single character tokens
     switch (c) {
         case '+': 
-            lexer->current_token = lexer_make_token(lexer, TOKEN_PLUS, NULL);
+            token = lexer_make_token(lexer, TOKEN_PLUS, start, line, column);
             break;
         case '-': 
-            lexer->current_token = lexer_make_token(lexer, TOKEN_MINUS, NULL);
+            token = lexer_make_token(lexer, TOKEN_MINUS, start, line, column);
             break;
         case '*': 
-            lexer->current_token = lexer_make_token(lexer, TOKEN_MULTIPLY, NULL);
+            token = lexer_make_token(lexer, TOKEN_MULTIPLY, start, line, column);
             break;
         case '/': 
-            lexer->current_token = lexer_make_token(lexer, TOKEN_DIVIDE, NULL);
+            token = lexer_make_token(lexer, TOKEN_DIVIDE, start, line, column);
             break;
         case '%': 
-            lexer->current_token = lexer_make_token(lexer, TOKEN_MODULO, NULL);
+            token = lexer_make_token(lexer, TOKEN_MODULO, start, line, column);
             break;
         case ';': 
-            lexer->current_token = lexer_make_token(lexer, TOKEN_SEMICOLON, NULL);
+            token = lexer_make_token(lexer, TOKEN_SEMICOLON, start, line, column);
             break;
         case ',': 
-            lexer->current_token = lexer_make_token(lexer, TOKEN_COMMA, NULL);
+            token = lexer_make_token(lexer, TOKEN_COMMA, start, line, column);
             break;
         case '(': 
-            lexer->current_token = lexer_make_token(lexer, TOKEN_LEFT_PAREN, NULL);
+            token = lexer_make_token(lexer, TOKEN_LEFT_PAREN, start, line, column);
             break;
         case ')': 
-            lexer->current_token = lexer_make_token(lexer, TOKEN_RIGHT_PAREN, NULL);
+            token = lexer_make_token(lexer, TOKEN_RIGHT_PAREN, start, line, column);
             break;
         case '{': 
-            lexer->current_token = lexer_make_token(lexer, TOKEN_LEFT_BRACE, NULL);
+            token = lexer_make_token(lexer, TOKEN_LEFT_BRACE, start, line, column);
             break;
         case '}': 
-            lexer->current_token = lexer_make_token(lexer, TOKEN_RIGHT_BRACE, NULL);
+            token = lexer_make_token(lexer, TOKEN_RIGHT_BRACE, start, line, column);
             break;
             
         // Multi-character tokens
         case '=':
             if (lexer_peek(lexer) == '=') {
                 lexer_advance(lexer);
-                lexer->current_token = lexer_make_token(lexer, TOKEN_EQUAL, NULL);
+                token = lexer_make_token(lexer, TOKEN_EQUAL, start, line, column);
             } else {
-                lexer->current_token = lexer_make_token(lexer, TOKEN_ASSIGN, NULL);
+                token = lexer_make_token(lexer, TOKEN_ASSIGN, start, line, column);
             }
             break;
             
         case '!':
             if (lexer_peek(lexer) == '=') {
                 lexer_advance(lexer);
-                lexer->current_token = lexer_make_token(lexer, TOKEN_NOT_EQUAL, NULL);
+                token = lexer_make_token(lexer, TOKEN_NOT_EQUAL, start, line, column);
             } else {
-                lexer->current_token = lexer_make_token(lexer, TOKEN_LOGICAL_NOT, NULL);
+                token = lexer_make_token(lexer, TOKEN_LOGICAL_NOT, start, line, column);
             }
             break;
             
         case '<':
             if (lexer_peek(lexer) == '=') {
                 lexer_advance(lexer);
-                lexer->current_token = lexer_make_token(lexer, TOKEN_LESS_EQUAL, NULL);
+                token = lexer_make_token(lexer, TOKEN_LESS_EQUAL, start, line, column);
             } else {
-                lexer->current_token = lexer_make_token(lexer, TOKEN_LESS, NULL);
+                token = lexer_make_token(lexer, TOKEN_LESS, start, line, column);
             }
             break;
             
         case '>':
             if (lexer_peek(lexer) == '=') {
                 lexer_advance(lexer);
-                lexer->current_token = lexer_make_token(lexer, TOKEN_GREATER_EQUAL, NULL);
+                token = lexer_make_token(lexer, TOKEN_GREATER_EQUAL, start, line, column);
             } else {
-                lexer->current_token = lexer_make_token(lexer, TOKEN_GREATER, NULL);
+                token = lexer_make_token(lexer, TOKEN_GREATER, start, line, column);
             }
             break;
             
         case '&':
             if (lexer_peek(lexer) == '&') {
                 lexer_advance(lexer);
-                lexer->current_token = lexer_make_token(lexer, TOKEN_LOGICAL_AND, NULL);
+                token = lexer_make_token(lexer, TOKEN_LOGICAL_AND, start, line, column);
             } else {
-                lexer->current_token = lexer_make_token(lexer, TOKEN_ERROR, "Unexpected character");
+                token = lexer_error_token(lexer, "Unexpected character", start, line, column);
             }
             break;
             
         case '|':
             if (lexer_peek(lexer) == '|') {
                 lexer_advance(lexer);
-                lexer->current_token = lexer_make_token(lexer, TOKEN_LOGICAL_OR, NULL);
+                token = lexer_make_token(lexer, TOKEN_LOGICAL_OR, start, line, column);
             } else {
-                lexer->current_token = lexer_make_token(lexer, TOKEN_ERROR, "Unexpected character");
+                token = lexer_error_token(lexer, "Unexpected character", start, line, column);
             }
             break;
             
         case '"':
             // Put back the quote for string scanning
             lexer->position--;
-            lexer->column--;
-            lexer->current_token = lexer_scan_string(lexer);
+            token = lexer_scan_string(lexer);
             break;
             
         default:
-            if (isalpha(c) || c == '_') {
+            if (LEXER_CLASS(c) & LEXER_CHAR_ALPHA) {
                 // Put back the character for identifier scanning
                 lexer->position--;
-                lexer->column--;
-                lexer->current_token = lexer_scan_identifier(lexer);
-            } else if (isdigit(c)) {
+                token = lexer_scan_identifier(lexer);
+            } else if (LEXER_CLASS(c) & LEXER_CHAR_DIGIT) {
                 // Put back the character for number scanning
                 lexer->position--;
-                lexer->column--;
-                lexer->current_token = lexer_scan_number(lexer);
+                token = lexer_scan_number(lexer);
             } else {
-                char error_msg[50];
-                snprintf(error_msg, sizeof(error_msg), "Unexpected character: '%c'", c);
-                lexer->current_token = lexer_make_token(lexer, TOKEN_ERROR, error_msg);
+                token = lexer_error_token(lexer, "Unexpected character", start, line, column);
             }
             break;
     }
     
+    return token;
+}
+
+// Main tokenization function
+token_t lexer_next_token(lexer_t* lexer) {
+    if (lexer->lookahead_count > 0) {
+        lexer->current_token = lexer->lookahead[lexer->lookahead_head];
+        lexer->lookahead_head = (lexer->lookahead_head + 1) % LEXER_MAX_LOOKAHEAD;
+        lexer->lookahead_count--;
+    } else {
+        lexer->current_token = lexer_scan_token(lexer);
+    }
+    
     return lexer->current_token;
 }
 
 // Peek at next token without consuming it
 token_t lexer_peek_token(lexer_t* lexer) {
-    // Save current state
-    size_t saved_position = lexer->position;
-    int saved_line = lexer->line;
-    int saved_column = lexer->column;
-    token_t saved_token = lexer->current_token;
-    
-    // Get next token
-    token_t next_token = lexer_next_token(lexer);
+    return lexer_peek_token_at(lexer, 0);
+}
+
+token_t lexer_peek_token_at(lexer_t* lexer, size_t offset) {
+    if (offset >= LEXER_MAX_LOOKAHEAD) {
+        return lexer_error_token(lexer, "Lookahead exceeds LEXER_MAX_LOOKAHEAD",
+                                 lexer->position, lexer->line, lexer_column(lexer));
+    }
     
-    // Restore state
-    lexer->position = saved_position;
-    lexer->line = saved_line;
-    lexer->column = saved_column;
-    lexer->current_token = saved_token;
+    // Scan forward until the ring holds the requested token
+    while (lexer->lookahead_count <= offset) {
+        size_t tail = (lexer->lookahead_head + lexer->lookahead_count) % LEXER_MAX_LOOKAHEAD;
+        lexer->lookahead[tail] = lexer_scan_token(lexer);
+        lexer->lookahead_count++;
+    }
     
-    return next_token;
+    return lexer->lookahead[(lexer->lookahead_head + offset) % LEXER_MAX_LOOKAHEAD];
 }
 
 // Reset lexer to beginning
@@ -495,13 +743,10 @@ void lexer_reset(lexer_t* lexer) {
     
     lexer->position = 0;
     lexer->line = 1;
-    lexer->column = 1;
-    
-    if (lexer->current_token.value) {
-        free(lexer->current_token.value);
-        lexer->current_token.value = NULL;
-    }
-    lexer->current_token.type = TOKEN_EOF;
+    lexer->line_start = 0;
+    lexer->lookahead_head = 0;
+    lexer->lookahead_count = 0;
+    lexer_clear_token(&lexer->current_token);
 }
 
 // Print all tokens (for debugging)
@@ -515,8 +760,11 @@ void lexer_print_tokens(lexer_t* lexer) {
         token = lexer_next_token(lexer);
         printf("%-15s", token_type_to_string(token.type));
         
-        if (token.value) {
-            printf(" '%s'", token.value);
+        if (TOKEN_HAS_VALUE(token)) {
+            printf(" '%.*s'", (int)token.length, lexer_token_text(lexer, token));
+        }
+        if (token.message) {
+            printf(" (%s)", token.message);
         }
         
         printf(" [%d:%d]\n", token.line, token.column);
@@ -524,4 +772,4 @@ void lexer_print_tokens(lexer_t* lexer) {
     } while (token.type != TOKEN_EOF && token.type != TOKEN_ERROR);
     
     printf("===================\n\n");
-}
\ No newline at end of file
+}
@@ -54,21 +54,54 @@ typedef enum {
 } token_type_t;
 
 // Token structure
+// Tokens do not own any memory: their text is a span of lexer_t::source
+// that stays valid until the lexer is destroyed.
 typedef struct {
     token_type_t type;     // Type of the token
-    char* value;           // String value (for identifiers, numbers, strings)
+    size_t start;          // Offset of the token text in the source
+    size_t length;         // Length of the token text (string tokens exclude the quotes)
     int line;              // Line number where token appears
     int column;            // Column number where token starts
+    const char* message;   // Static description for TOKEN_ERROR, NULL otherwise
+    const char* name;      // Interned text for identifiers, NULL otherwise
 } token_t;
 
+// How the lexer holds its source text
+typedef enum {
+    LEXER_INPUT_OWNED,     // Private heap copy, freed by lexer_destroy()
+    LEXER_INPUT_BORROWED,  // Caller's buffer, must outlive the lexer
+    LEXER_INPUT_MAPPED,    // Read-only mmap of the input file
+    LEXER_INPUT_STREAM     // Heap buffer filled in chunks from a stream on demand
+} lexer_input_kind_t;
+
+// Number of bytes read from a stream per refill
+#define LEXER_STREAM_CHUNK_SIZE (64 * 1024)
+
+// Maximum number of tokens that can be peeked ahead of the current one
+#ifndef LEXER_MAX_LOOKAHEAD
+#define LEXER_MAX_LOOKAHEAD 4
+#endif
+
 // Lexer state structure
 typedef struct {
-    char* source;          // Source code string
-    size_t length;         // Length of source code
+    const char* source;    // Source code text (not necessarily null-terminated)
+    size_t length;         // Length of source code read so far
     size_t position;       // Current position in source
+    
+    // Input backing
+    lexer_input_kind_t input_kind;
+    size_t capacity;       // Allocated size of source (LEXER_INPUT_STREAM)
+    FILE* stream;          // Stream still being read, NULL once exhausted
+    int owns_stream;       // Close stream when done (opened by the lexer itself)
+    
     int line;              // Current line number
-    int column;            // Current column number
+    size_t line_start;     // Offset where the current line begins (column = position - line_start + 1)
     token_t current_token; // Currently processed token
+    
+    // Ring of tokens already scanned by lexer_peek_token*() but not yet consumed
+    token_t lookahead[LEXER_MAX_LOOKAHEAD];
+    size_t lookahead_head;
+    size_t lookahead_count;
 } lexer_t;
 
 // Lexer lifecycle functions
@@ -83,17 +116,42 @@ typedef struct {
  */
 lexer_t* lexer_create(const char* source);
 
+/**
+ * @brief Creates a new lexer over a caller-owned buffer without copying it
+ * 
+ * @param source The source code to tokenize (need not be null-terminated)
+ * @param length Number of bytes in source
+ * @return lexer_t* Pointer to new lexer instance, or NULL on failure
+ * 
+ * @note source must stay valid and unchanged until lexer_destroy()
+ */
+lexer_t* lexer_create_from_buffer(const char* source, size_t length);
+
 /**
  * @brief Creates a new lexer instance from a source file
  * 
- * @param filename Path to the source file to read and tokenize
+ * @param filename Path to the source file to read and tokenize ("-" for stdin)
  * @return lexer_t* Pointer to new lexer instance, or NULL on failure
  * 
+ * @note Regular files are memory-mapped; pipes, FIFOs and stdin are streamed
  * @note The caller is responsible for freeing the lexer with lexer_destroy()
- * @see lexer_destroy(), lexer_create()
+ * @see lexer_destroy(), lexer_create(), lexer_create_from_stream()
  */
 lexer_t* lexer_create_from_file(const char* filename);
 
+/**
+ * @brief Creates a new lexer that reads its source from a stream in chunks
+ * 
+ * @param stream Open stream to read from (e.g. stdin or a pipe)
+ * @return lexer_t* Pointer to new lexer instance, or NULL on failure
+ * 
+ * @note Input is read LEXER_STREAM_CHUNK_SIZE bytes at a time as the lexer
+ *       advances. Token offsets stay valid as the buffer grows, but
+ *       lexer_token_text() pointers are only valid until the next token.
+ * @note The stream is not closed by the lexer
+ */
+lexer_t* lexer_create_from_stream(FILE* stream);
+
 /**
  * @brief Destroys a lexer instance and frees all associated memory
  * 
@@ -110,8 +168,9 @@ void lexer_destroy(lexer_t* lexer);
  * @param lexer The lexer instance
  * @return token_t The next token in the stream
  * 
- * @warning The returned token's value pointer may be invalidated by
- *          subsequent calls to lexer_next_token()
+ * @note For in-memory and memory-mapped input the token's text stays valid
+ *       until lexer_destroy(). Streamed input (pipes, stdin) only keeps it
+ *       until the next token; see lexer_create_from_stream()
  * @note Returns TOKEN_EOF when end of input is reached
  * @note Returns TOKEN_ERROR for invalid input
  */
@@ -123,11 +182,23 @@ token_t lexer_next_token(lexer_t* lexer);
  * @param lexer The lexer instance
  * @return token_t The next token that would be returned by lexer_next_token()
  * 
- * @note This function does not advance the lexer position
+ * @note The token is scanned once and buffered; the following
+ *       lexer_next_token() returns it without scanning again
  * @note Multiple calls will return the same token
  */
 token_t lexer_peek_token(lexer_t* lexer);
 
+/**
+ * @brief Peeks further ahead without consuming any tokens
+ * 
+ * @param lexer The lexer instance
+ * @param offset Number of tokens to skip (0 is the same as lexer_peek_token())
+ * @return token_t The token lexer_next_token() would return offset + 1 calls from now
+ * 
+ * @note offset must be less than LEXER_MAX_LOOKAHEAD, otherwise a TOKEN_ERROR is returned
+ */
+token_t lexer_peek_token_at(lexer_t* lexer, size_t offset);
+
 /**
  * @brief Resets the lexer to the beginning of the source
  * 
@@ -137,6 +208,28 @@ token_t lexer_peek_token(lexer_t* lexer);
  */
 void lexer_reset(lexer_t* lexer);
 
+// Token text access
+/**
+ * @brief Returns a pointer to the first character of a token's text
+ * 
+ * @param lexer The lexer that produced the token
+ * @param token The token
+ * @return const char* Start of the token's span in the source (not null-terminated)
+ * 
+ * @note Use token.length for the number of characters in the span
+ */
+const char* lexer_token_text(const lexer_t* lexer, token_t token);
+
+/**
+ * @brief Compares a token's text against a null-terminated string
+ * 
+ * @param lexer The lexer that produced the token
+ * @param token The token
+ * @param text The string to compare against
+ * @return int 1 if the token's span equals text, 0 otherwise
+ */
+int lexer_token_equals(const lexer_t* lexer, token_t token, const char* text);
+
 // Utility functions
 /**
  * @brief Prints all tokens in the source (for debugging)
@@ -159,6 +252,28 @@ void lexer_print_tokens(lexer_t* lexer);
  */
 const char* token_type_to_string(token_type_t type);
 
+// Keyword hash table size (power of two)
+#define KEYWORD_HASH_SIZE 64
+
+// Keyword hash on length, first two and last characters (length >= 2). The
+// constants give each of the 32 C89 keywords its own slot, so keywords like
+// break, continue or struct can be added without a collision.
+#define KEYWORD_HASH(text, length) \
+    (((unsigned char)(text)[0] + 3u * (unsigned char)(text)[1] + \
+      27u * (unsigned char)(text)[(length) - 1] + 13u * (unsigned int)(length)) & (KEYWORD_HASH_SIZE - 1))
+
+/**
+ * @brief Recognizes a keyword from its spelling
+ * 
+ * @param text Start of the candidate word (need not be null-terminated)
+ * @param length Number of characters in the word
+ * @return token_type_t The keyword's token type, or TOKEN_IDENTIFIER if it is not a keyword
+ * 
+ * @note Uses a perfect hash on length, first two and last characters, so at most
+ *       one string comparison is made per lookup
+ */
+token_type_t lexer_lookup_keyword(const char* text, size_t length);
+
 // Token helper macros
 #define TOKEN_IS_KEYWORD(token) \
     ((token).type >= TOKEN_INT && (token).type <= TOKEN_RETURN)
@@ -173,6 +288,6 @@ const char* token_type_to_string(token_type_t type);
     ((token).type >= TOKEN_SEMICOLON && (token).type <= TOKEN_RIGHT_BRACE)
 
 #define TOKEN_HAS_VALUE(token) \
-    ((token).value != NULL)
+    (TOKEN_IS_LITERAL(token) || (token).type == TOKEN_ERROR)
 
 #endif // LEXER_H
\ No newline at end of file
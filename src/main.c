@@ -1,213 +1,939 @@
+#define _POSIX_C_SOURCE 200809L   // getcwd(), mkstemp()
+#include <limits.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "lexer.h"
 #include "parser.h"
 #include "ast.h"
 #include "semantic.h"
+#include "ir.h"
+#include "optimizer.h"
 #include "codegen.h"
+#include "object.h"
+#include "jit.h"
+#include "pool.h"
+#include "cache.h"
+#include "stats.h"
+#include "server.h"
+#include "utils.h"
+#include "../runtime/runtime.h"
+
+// Runtime functions --run resolves in-process
+static const jit_symbol_t runtime_symbols[] = {
+    {"print", (void*)print},
+    {"print_int", (void*)print_int},
+    {"print_char", (void*)print_char},
+    {"read_int", (void*)read_int},
+    {"flush", (void*)flush}
+};
+
+// Progress messages; --run leaves stdout to the program, and several inputs
+// compiled in parallel report only their results
+static int verbose = 1;
+
+static void report(const char* format, ...) {
+    if (!verbose) return;
+    
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
 
 void print_usage(const char* program_name) {
-    printf("Usage: %s [options] <input_file>\n", program_name);
+    printf("Usage: %s [options] <input_file>...\n", program_name);
+    printf("       (use '-' as input_file to read the source from stdin, and @file to\n");
+    printf("       read input files from a manifest with one path per line)\n");
     printf("Options:\n");
-    printf("  -o <file>         Output file (default: out.s)\n");
+    printf("  -o <file>         Output file (default: out.o, out.s with --compile-only);\n");
+    printf("                    with several inputs, the executable (default: a.out)\n");
+    printf("  -j <n>            Compile several inputs on n threads (default: one per CPU)\n");
+    printf("  --parallel-functions\n");
+    printf("                    Analyze and generate the functions of a single input on\n");
+    printf("                    -j threads\n");
+    printf("  -O0, -O1          Optimization level (default: -O0)\n");
+    printf("  --inline-threshold <n>\n");
+    printf("                    Inline leaf functions of up to n IR instructions at -O1\n");
+    printf("                    (default: %d, 0 disables inlining)\n", OPTIMIZER_DEFAULT_INLINE_THRESHOLD);
     printf("  --debug-tokens    Print token stream\n");
     printf("  --debug-ast       Print AST\n");
     printf("  --debug-symbols   Print symbol table\n");
+    printf("  --debug-ir        Print lowered IR with basic blocks and liveness\n");
+    printf("  -c                Write the ELF object only (don't link)\n");
     printf("  --compile-only    Generate assembly only (don't assemble)\n");
+    printf("  --writev          Write the assembly with writev() from the buffered chunks\n");
+    printf("  --run             Run main() in memory instead of writing files; the exit\n");
+    printf("                    status is its return value\n");
+    printf("  --stats, --time-report\n");
+    printf("                    Report the time and memory of each phase with token, AST\n");
+    printf("                    node, symbol probe and instruction counts\n");
+    printf("  --stats-json <file>\n");
+    printf("                    Write the same measurements as JSON to file ('-' for stdout)\n");
+    printf("  --cache-dir <dir> Reuse the output of an identical earlier compile from dir\n");
+    printf("                    and store new outputs there (default: $TINYC_CACHE_DIR)\n");
     printf("  -h, --help        Show this help\n");
+    printf("Compile server:\n");
+    printf("  %s --server <socket>\n", program_name);
+    printf("                    Serve compile requests on a Unix socket until interrupted\n");
+    printf("  %s --connect <socket> [options] <input_file>...\n", program_name);
+    printf("                    Run the compile on that server (also done for every\n");
+    printf("                    command when $TINYC_SERVER names a running server)\n");
 }
 
-int main(int argc, char** argv) {
-    if (argc < 2) {
-        print_usage(argv[0]);
-        return 1;
-    }
-    
-    char* input_file = NULL;
-    char* output_file = "out.s";
-    int debug_tokens = 0;
-    int debug_ast = 0;
-    int debug_symbols = 0;
-    int compile_only = 0;
-    
-    // Parse command line arguments
-    for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
-            print_usage(argv[0]);
-            return 0;
-        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
-            output_file = argv[++i];
-        } else if (strcmp(argv[i], "--debug-tokens") == 0) {
-            debug_tokens = 1;
-        } else if (strcmp(argv[i], "--debug-ast") == 0) {
-            debug_ast = 1;
-        } else if (strcmp(argv[i], "--debug-symbols") == 0) {
-            debug_symbols = 1;
-        } else if (strcmp(argv[i], "--compile-only") == 0) {
-            compile_only = 1;
-        } else if (argv[i][0] != '-') {
-            input_file = argv[i];
-        } else {
-            fprintf(stderr, "Unknown option: %s\n", argv[i]);
-            return 1;
-        }
+// Outputs kept in memory by --server, oldest dropped first
+#define SERVER_CACHE_BYTES (256 * 1024 * 1024)
+
+// Interned strings kept between --server requests before starting afresh
+#define SERVER_INTERN_LIMIT (1024 * 1024)
+
+// --server: what stays warm between requests
+typedef struct {
+    char identity[CACHE_KEY_SIZE];    // cache_compiler_identity(), hashed once
+    char runtime[PATH_MAX];           // Absolute path of the runtime object
+    int runtime_built;                // runtime was compiled at startup; removed at exit
+    cache_memory_t* outputs;          // Outputs of earlier requests
+} server_state_t;
+
+// Options shared by every input file
+typedef struct {
+    optimizer_options_t optimizer;
+    int debug_tokens;
+    int debug_ast;
+    int debug_symbols;
+    int debug_ir;
+    int compile_only;     // Write assembly instead of an object
+    int use_writev;       // Write assembly with writev() (output is the same)
+    int run;              // Keep the encoded object for --run instead of writing it
+    int stats;            // Measure the phases into compile_job_t.stats
+    size_t function_threads;  // Analyze and generate function bodies on a pool this large (0: don't)
+    const char* cache_dir;    // Output cache, or NULL
+    cache_memory_t* memory_cache;   // --server: outputs kept in memory, or NULL
+    char cache_configuration[128];  // Compiler identity and output-affecting options
+} compile_options_t;
+
+// One input file; compile_file() fills in the result
+typedef struct {
+    const compile_options_t* options;
+    const char* input_file;
+    char* output_file;    // Owned
+    object_t* object;     // --run only: encoded program, owned by the caller
+    int success;
+    int cached;           // The output came from the cache
+    compile_stats_t stats;    // With options->stats
+} compile_job_t;
+
+// Helper: Number of tokens before the end of input, leaving lexer at the start
+static size_t count_tokens(lexer_t* lexer) {
+    size_t count = 0;
+    token_t token = lexer_next_token(lexer);
+    while (token.type != TOKEN_EOF && token.type != TOKEN_ERROR) {
+        count++;
+        token = lexer_next_token(lexer);
     }
-    
-    if (!input_file) {
-        fprintf(stderr, "Error: No input file specified\n");
-        print_usage(argv[0]);
-        return 1;
+    lexer_reset(lexer);
+    return count;
+}
+
+// Helper: IR instructions left in program
+static size_t count_ir_instructions(const ir_program_t* program) {
+    size_t count = 0;
+    for (size_t i = 0; program && i < program->function_count; i++) {
+        count += program->functions[i]->instr_count;
     }
+    return count;
+}
+
+// Compile one input file through code generation (a pool_function_t). Lexer,
+// parser, analyzer and codegen state is local to the job; only the string
+// interner is shared, and it stays populated until main() resets it.
+static void compile_file(void* argument) {
+    compile_job_t* job = argument;
+    const compile_options_t* options = job->options;
+    const char* input_file = job->input_file;
+    const char* output_file = job->output_file;
+    compile_stats_t* stats = &job->stats;
+    stats->input_file = input_file;
+    job->success = 0;
     
-    printf("TinyC Compiler - Complete Pipeline\n");
-    printf("Processing file: %s\n", input_file);
-    if (compile_only) {
-        printf("Output: %s\n\n", output_file);
-    } else {
-        printf("Assembly: %s\n\n", output_file);
-    }
+    report("TinyC Compiler - Complete Pipeline\n");
+    report("Processing file: %s\n", input_file);
+    report("Output: %s\n\n", output_file);
     
     // Phase 1: Lexical Analysis
     lexer_t* lexer = lexer_create_from_file(input_file);
     if (!lexer) {
         fprintf(stderr, "Error: Could not read input file '%s'\n", input_file);
-        return 1;
+        return;
+    }
+    
+    // An identical source compiled with the same options skips phases 2-4.
+    // Streams are not cached: their bytes are only read as lexing goes.
+    char cache_key_text[CACHE_KEY_SIZE];
+    const char* extension = options->compile_only ? ".s" : ".o";
+    int cacheable = (options->cache_dir || options->memory_cache) && !options->run &&
+                    lexer->input_kind != LEXER_INPUT_STREAM &&
+                    !options->debug_tokens && !options->debug_ast && !options->debug_symbols &&
+                    !options->debug_ir;
+    if (cacheable) {
+        cache_key(lexer->source, lexer->length, options->cache_configuration, cache_key_text);
+        int hit = options->memory_cache && cache_memory_fetch(options->memory_cache, cache_key_text, output_file);
+        if (!hit && options->cache_dir && cache_fetch(options->cache_dir, cache_key_text, extension, output_file)) {
+            hit = 1;
+            if (options->memory_cache) cache_memory_store(options->memory_cache, cache_key_text, output_file);
+        }
+        if (hit) {
+            report("✓ Cache hit (%s)\n", cache_key_text);
+            report("  %s written to: %s\n", options->compile_only ? "Assembly" : "Object", output_file);
+            lexer_destroy(lexer);
+            job->cached = 1;
+            stats->cached = 1;
+            job->success = 1;
+            return;
+        }
     }
     
-    if (debug_tokens) {
+    if (options->debug_tokens) {
         printf("=== LEXICAL ANALYSIS ===\n");
         lexer_print_tokens(lexer);
         lexer_reset(lexer);
     }
     
+    // Tokens are produced on demand while parsing, so lexing is timed on
+    // its own in an extra pass (and parsing scans the source again)
+    if (options->stats) {
+        stats_begin(stats, STATS_LEX);
+        stats->tokens = count_tokens(lexer);
+        stats_end(stats);
+    }
+    
     // Phase 2: Parsing
-    printf("=== PARSING ===\n");
+    report("=== PARSING ===\n");
     parser_t* parser = parser_create(lexer);
     if (!parser) {
         fprintf(stderr, "Error: Could not create parser\n");
         lexer_destroy(lexer);
-        return 1;
+        return;
+    }
+    
+    // The whole AST lives in one arena and is freed in bulk
+    arena_t* ast_arena = arena_create(0);
+    if (!ast_arena) {
+        fprintf(stderr, "Error: Could not create AST arena\n");
+        parser_destroy(parser);
+        lexer_destroy(lexer);
+        return;
     }
+    parser_set_arena(parser, ast_arena);
     
+    if (options->stats) stats_begin(stats, STATS_PARSE);
     ast_node_t* ast = parser_parse_program(parser);
+    if (options->stats) {
+        stats_end(stats);
+        stats->ast_nodes = ast_count_nodes(ast);
+    }
     
     if (parser_has_errors(parser)) {
-        printf("✗ Parsing failed with errors:\n");
+        printf("✗ Parsing %s failed with errors:\n", input_file);
         parser_print_errors(parser);
         
-        if (ast) ast_destroy(ast);
+        arena_destroy(ast_arena);
         parser_destroy(parser);
         lexer_destroy(lexer);
-        return 1;
+        return;
     }
     
-    printf("✓ Parsing completed successfully!\n\n");
+    report("✓ Parsing completed successfully!\n\n");
     
-    if (debug_ast && ast) {
+    if (options->debug_ast && ast) {
         printf("=== ABSTRACT SYNTAX TREE ===\n");
         ast_print(ast, 0);
         printf("============================\n\n");
     }
     
     // Phase 3: Semantic Analysis
-    printf("=== SEMANTIC ANALYSIS ===\n");
+    report("=== SEMANTIC ANALYSIS ===\n");
     semantic_analyzer_t* analyzer = semantic_create();
     if (!analyzer) {
         fprintf(stderr, "Error: Could not create semantic analyzer\n");
-        ast_destroy(ast);
+        arena_destroy(ast_arena);
         parser_destroy(parser);
         lexer_destroy(lexer);
-        return 1;
+        return;
+    }
+    
+    // Function bodies share one pool for analysis and code generation; the
+    // output is the same as without it
+    pool_t* pool = NULL;
+    if (options->function_threads > 0) {
+        pool = pool_create(options->function_threads);
+        if (!pool) {
+            fprintf(stderr, "Warning: Could not start threads, compiling %s sequentially\n", input_file);
+        }
     }
+    analyzer->pool = pool;
     
+    if (options->stats) stats_begin(stats, STATS_SEMANTIC);
     int semantic_success = semantic_analyze(analyzer, ast);
+    if (options->stats) {
+        stats_end(stats);
+        stats->symbol_probes = analyzer->symbols->probes;
+    }
     
     if (semantic_has_errors(analyzer)) {
-        printf("✗ Semantic analysis failed with errors:\n");
+        printf("✗ Semantic analysis of %s failed with errors:\n", input_file);
         semantic_print_errors(analyzer);
         semantic_success = 0;
     } else {
-        printf("✓ Semantic analysis completed successfully!\n\n");
+        report("✓ Semantic analysis completed successfully!\n\n");
     }
     
     if (!semantic_success) {
+        pool_destroy(pool);
         semantic_destroy(analyzer);
-        ast_destroy(ast);
+        arena_destroy(ast_arena);
         parser_destroy(parser);
         lexer_destroy(lexer);
-        return 1;
+        return;
     }
     
-    if (debug_symbols) {
+    if (options->debug_symbols) {
         printf("=== SYMBOL TABLE DEBUG ===\n");
         printf("(Symbol table debugging not yet implemented)\n");
         printf("==========================\n\n");
     }
     
+    // Constant subexpressions are folded before lowering, then again on the
+    // IR where propagation through variables exposes more of them
+    optimizer_stats_t optimizer_stats = {0};
+    if (options->stats) stats_begin(stats, STATS_IR);
+    optimizer_optimize_ast(ast, &options->optimizer, &optimizer_stats);
+    if (options->stats) stats_end(stats);
+    
     // Phase 4: Code Generation
-    printf("=== CODE GENERATION ===\n");
-    codegen_t* codegen = codegen_create(output_file);
+    report("=== CODE GENERATION ===\n");
+    codegen_t* codegen = codegen_create(options->run ? "/dev/null" : output_file);
     if (!codegen) {
-        fprintf(stderr, "Error: Could not create code generator\n");
+        fprintf(stderr, "Error: Could not create code generator for '%s'\n", output_file);
+        pool_destroy(pool);
         semantic_destroy(analyzer);
-        ast_destroy(ast);
+        arena_destroy(ast_arena);
         parser_destroy(parser);
         lexer_destroy(lexer);
-        return 1;
+        return;
     }
+    codegen->peephole = options->optimizer.level >= 1;
+    codegen->pool = pool;
+    codegen->use_writev = options->use_writev;
     
-    int codegen_success = codegen_generate(codegen, ast);
+    // Without --compile-only machine code is encoded directly, no assembler
+    if (!options->compile_only) {
+        codegen->object = object_create();
+        if (!codegen->object) {
+            fprintf(stderr, "Error: Could not create object file\n");
+            codegen_destroy(codegen);
+            pool_destroy(pool);
+            semantic_destroy(analyzer);
+            arena_destroy(ast_arena);
+            parser_destroy(parser);
+            lexer_destroy(lexer);
+            return;
+        }
+    }
+    
+    if (options->stats) stats_begin(stats, STATS_IR);
+    ir_program_t* ir = ir_lower_program(ast);
+    int codegen_success = ir != NULL;
+    if (!ir) {
+        fprintf(stderr, "Error: Could not lower '%s' (out of memory)\n", input_file);
+    } else if (ir->unresolved) {
+        fprintf(stderr, "Error at line %u, column %u: '%s' is not a local variable or parameter "
+                "(global variables are not supported)\n",
+                ir->unresolved_line, ir->unresolved_column, ir->unresolved);
+        ir_program_destroy(ir);
+        ir = NULL;
+        codegen_success = 0;
+    }
+    optimizer_optimize_ir(ir, &options->optimizer, &optimizer_stats);
+    if (options->stats) {
+        stats_end(stats);
+        stats->ir_instructions = count_ir_instructions(ir);
+        stats->optimizer = optimizer_stats;
+    }
+    
+    if (options->debug_ir && ir) {
+        printf("=== INTERMEDIATE REPRESENTATION ===\n");
+        ir_print_program(stdout, ir);
+        printf("===================================\n\n");
+    }
+    
+    if (options->stats) stats_begin(stats, STATS_CODEGEN);
+    if (ir) {
+        codegen_program(codegen, ir);
+    }
+    
+    if (codegen_success && codegen->write_failed) {
+        fprintf(stderr, "Error: Could not write assembly file '%s'\n", output_file);
+        codegen_success = 0;
+    }
+    
+    if (codegen_success && codegen->object) {
+        if (codegen->object->failed) {
+            fprintf(stderr, "Error: Cannot encode instruction:\n");
+            codegen_print_instruction(stderr, &codegen->object->failed_instr);
+            codegen_success = 0;
+        } else if (options->run) {
+            job->object = codegen->object;
+            codegen->object = NULL;
+        } else if (!object_write(codegen->object, codegen->output)) {
+            fprintf(stderr, "Error: Could not write object file '%s'\n", output_file);
+            codegen_success = 0;
+        }
+    }
+    if (options->stats) {
+        stats_end(stats);
+        stats->instructions = codegen->emitted_count;
+    }
     
     if (codegen_success) {
-        printf("✓ Code generation completed successfully!\n");
-        printf("  Assembly written to: %s\n", output_file);
+        report("✓ Code generation completed successfully!\n");
+        report("  %s written to: %s\n", options->compile_only ? "Assembly" : "Object", output_file);
     } else {
-        printf("✗ Code generation failed!\n");
+        printf("✗ Code generation for %s failed!\n", input_file);
     }
     
     // Cleanup
+    ir_program_destroy(ir);
     codegen_destroy(codegen);
+    pool_destroy(pool);
     semantic_destroy(analyzer);
-    ast_destroy(ast);
+    arena_destroy(ast_arena);
     parser_destroy(parser);
     lexer_destroy(lexer);
     
-    if (!codegen_success) {
+    // Stored once the output file is complete
+    if (codegen_success && cacheable && options->cache_dir &&
+        !cache_store(options->cache_dir, cache_key_text, extension, output_file)) {
+        fprintf(stderr, "Warning: Could not store %s in the cache at '%s'\n", output_file, options->cache_dir);
+    }
+    if (codegen_success && cacheable && options->memory_cache) {
+        cache_memory_store(options->memory_cache, cache_key_text, output_file);
+    }
+    
+    job->success = codegen_success;
+}
+
+// Helper: Copy of path with its extension (if any) replaced by extension
+static char* replace_extension(const char* path, const char* extension) {
+    const char* slash = strrchr(path, '/');
+    const char* dot = strrchr(path, '.');
+    size_t length = dot && (!slash || dot > slash) ? (size_t)(dot - path) : strlen(path);
+    
+    char* result = malloc(length + strlen(extension) + 1);
+    if (!result) return NULL;
+    memcpy(result, path, length);
+    strcpy(result + length, extension);
+    return result;
+}
+
+// Helper: Append the paths listed in manifest (one per line, '#' comments)
+static int read_manifest(const char* manifest, char*** inputs, size_t* count, size_t* capacity) {
+    FILE* file = fopen(manifest, "r");
+    if (!file) {
+        fprintf(stderr, "Error: Could not read manifest '%s'\n", manifest);
+        return 0;
+    }
+    
+    char line[4096];
+    while (fgets(line, sizeof(line), file)) {
+        char* start = line;
+        while (*start == ' ' || *start == '\t') start++;
+        size_t length = strcspn(start, "\r\n");
+        while (length > 0 && (start[length - 1] == ' ' || start[length - 1] == '\t')) length--;
+        if (length == 0 || start[0] == '#') continue;
+        
+        if (*count == *capacity) {
+            *capacity = *capacity ? *capacity * 2 : 16;
+            char** grown = realloc(*inputs, *capacity * sizeof(char*));
+            if (!grown) {
+                fclose(file);
+                return 0;
+            }
+            *inputs = grown;
+        }
+        start[length] = '\0';
+        (*inputs)[*count] = malloc(length + 1);
+        if (!(*inputs)[*count]) {
+            fclose(file);
+            return 0;
+        }
+        memcpy((*inputs)[*count], start, length + 1);
+        (*count)++;
+    }
+    
+    fclose(file);
+    return 1;
+}
+
+// Helper: Path of the runtime to link: the object prebuilt next to the
+// compiler, or else its source; returns 1 for the object
+static int find_runtime(const char* program_name, char* path, size_t size) {
+    const char* slash = strrchr(program_name, '/');
+    snprintf(path, size, "%.*sruntime.o", slash ? (int)(slash - program_name + 1) : 0, program_name);
+    FILE* runtime_file = fopen(path, "r");
+    if (runtime_file) {
+        fclose(runtime_file);
+        return 1;
+    }
+    snprintf(path, size, "runtime/runtime.c");
+    return 0;
+}
+
+// Helper: Print the --stats tables and write the --stats-json file; returns 0
+// if the JSON could not be written
+static int report_stats(const compile_job_t* jobs, size_t count, const compile_stats_t* link_stats,
+                        FILE* text_output, const char* json_file) {
+    if (text_output) {
+        for (size_t i = 0; i < count; i++) {
+            fprintf(text_output, "\n");
+            stats_print(text_output, &jobs[i].stats);
+        }
+        const stats_phase_result_t* link = &link_stats->phases[STATS_LINK];
+        if (link->ran) {
+            fprintf(text_output, "link: %.3f ms, peak RSS %ld KB\n", link->seconds * 1000.0, link->peak_rss_kb);
+        }
+    }
+    if (!json_file) return 1;
+    
+    compile_stats_t* files = malloc((count ? count : 1) * sizeof(compile_stats_t));
+    FILE* output = strcmp(json_file, "-") == 0 ? stdout : fopen(json_file, "w");
+    int success = files && output;
+    if (success) {
+        for (size_t i = 0; i < count; i++) {
+            files[i] = jobs[i].stats;
+        }
+        stats_write_json(output, files, count, &link_stats->phases[STATS_LINK]);
+        success = !ferror(output);
+    }
+    if (output && output != stdout && fclose(output) != 0) success = 0;
+    if (!success) {
+        fprintf(stderr, "Error: Could not write statistics to '%s'\n", json_file);
+    }
+    free(files);
+    return success;
+}
+
+// Compile as the command line asks; server is NULL except for --server
+// requests, which reuse its state
+static int compile_command(int argc, char** argv, server_state_t* server) {
+    verbose = 1;
+    if (argc < 2) {
+        print_usage(argv[0]);
         return 1;
     }
     
-    // Phase 5: Assembly and Linking (optional)
-    if (!compile_only) {
-        printf("\n=== ASSEMBLY & LINKING ===\n");
+    // Inputs are always copies so they can be freed alike (argv or manifest)
+    char** inputs = NULL;
+    size_t input_count = 0;
+    size_t input_capacity = 0;
+    char* output_file = NULL;
+    int object_only = 0;
+    long thread_count = 0;
+    int parallel_functions = 0;
+    int print_stats = 0;
+    const char* stats_json = NULL;
+    compile_stats_t link_stats;
+    memset(&link_stats, 0, sizeof(link_stats));
+    int compiled = 0;     // The jobs ran, so there are statistics to report
+    compile_options_t options;
+    memset(&options, 0, sizeof(options));
+    optimizer_options_init(&options.optimizer);
+    int status = 1;
+    
+    // Parse command line arguments
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            status = 0;
+            goto done;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (strcmp(argv[i], "-O0") == 0 || strcmp(argv[i], "-O1") == 0) {
+            options.optimizer.level = argv[i][2] - '0';
+        } else if (strcmp(argv[i], "--inline-threshold") == 0 && i + 1 < argc) {
+            char* end;
+            long threshold = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || threshold < 0 || threshold > 100000) {
+                fprintf(stderr, "Invalid inline threshold: %s\n", argv[i]);
+                goto done;
+            }
+            options.optimizer.inline_threshold = (int)threshold;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            char* end;
+            thread_count = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || thread_count < 1 || thread_count > 1024) {
+                fprintf(stderr, "Invalid thread count: %s\n", argv[i]);
+                goto done;
+            }
+        } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            options.cache_dir = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--time-report") == 0) {
+            print_stats = 1;
+        } else if (strcmp(argv[i], "--stats-json") == 0 && i + 1 < argc) {
+            stats_json = argv[++i];
+        } else if (strcmp(argv[i], "--parallel-functions") == 0) {
+            parallel_functions = 1;
+        } else if (strcmp(argv[i], "--debug-tokens") == 0) {
+            options.debug_tokens = 1;
+        } else if (strcmp(argv[i], "--debug-ast") == 0) {
+            options.debug_ast = 1;
+        } else if (strcmp(argv[i], "--debug-symbols") == 0) {
+            options.debug_symbols = 1;
+        } else if (strcmp(argv[i], "--debug-ir") == 0) {
+            options.debug_ir = 1;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            object_only = 1;
+        } else if (strcmp(argv[i], "--compile-only") == 0) {
+            options.compile_only = 1;
+        } else if (strcmp(argv[i], "--writev") == 0) {
+            options.use_writev = 1;
+        } else if (strcmp(argv[i], "--run") == 0) {
+            options.run = 1;
+        } else if (argv[i][0] == '@' && argv[i][1] != '\0') {
+            if (!read_manifest(argv[i] + 1, &inputs, &input_count, &input_capacity)) goto done;
+        } else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) {
+            if (input_count == input_capacity) {
+                input_capacity = input_capacity ? input_capacity * 2 : 16;
+                char** grown = realloc(inputs, input_capacity * sizeof(char*));
+                if (!grown) goto done;
+                inputs = grown;
+            }
+            inputs[input_count] = malloc(strlen(argv[i]) + 1);
+            if (!inputs[input_count]) goto done;
+            strcpy(inputs[input_count++], argv[i]);
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            goto done;
+        }
+    }
+    
+    if (input_count == 0) {
+        fprintf(stderr, "Error: No input file specified\n");
+        print_usage(argv[0]);
+        goto done;
+    }
+    
+    int compile_only = options.compile_only;
+    int multiple = input_count > 1;
+    if (options.run && (compile_only || object_only)) {
+        fprintf(stderr, "Error: --run cannot be combined with -c or --compile-only\n");
+        goto done;
+    }
+    if (options.run && multiple) {
+        fprintf(stderr, "Error: --run takes a single input file\n");
+        goto done;
+    }
+    if (options.run && server) {
+        // A crash or endless loop in the program would take the server down
+        fprintf(stderr, "Error: --run is not available on a compile server\n");
+        goto done;
+    }
+    if (multiple && output_file && (compile_only || object_only)) {
+        fprintf(stderr, "Error: -o cannot name the outputs of several input files\n");
+        goto done;
+    }
+    if (options.run || multiple) {
+        verbose = 0;
+    }
+    options.stats = print_stats || stats_json;
+    
+    // Cached outputs depend on the compiler binary itself and every option
+    // that changes the generated code
+    if (!options.cache_dir) {
+        const char* cache_dir = getenv("TINYC_CACHE_DIR");
+        if (cache_dir && cache_dir[0] != '\0') options.cache_dir = cache_dir;
+    }
+    if (server) {
+        options.memory_cache = server->outputs;
+    }
+    if (options.cache_dir || options.memory_cache) {
+        char identity[CACHE_KEY_SIZE];
+        if (server) {
+            strcpy(identity, server->identity);
+        } else {
+            cache_compiler_identity(identity);
+        }
+        snprintf(options.cache_configuration, sizeof(options.cache_configuration),
+                 "tcc=%s output=%s level=%d inline=%d", identity, compile_only ? "assembly" : "object",
+                 options.optimizer.level, options.optimizer.inline_threshold);
+    }
+    
+    // Several inputs already keep the threads busy one file each
+    if (parallel_functions && !multiple) {
+        options.function_threads = thread_count > 0 ? (size_t)thread_count : pool_default_threads();
+    }
+    
+    // A single input writes -o (or out.o / out.s); several write their
+    // outputs next to the sources and -o names the executable
+    compile_job_t* jobs = calloc(input_count, sizeof(compile_job_t));
+    if (!jobs) goto done;
+    const char* extension = compile_only ? ".s" : ".o";
+    for (size_t i = 0; i < input_count; i++) {
+        jobs[i].options = &options;
+        jobs[i].input_file = inputs[i];
+        if (!multiple && output_file) {
+            jobs[i].output_file = strdup(output_file);
+        } else if (!multiple || strcmp(inputs[i], "-") == 0) {
+            jobs[i].output_file = strdup(compile_only ? "out.s" : "out.o");
+        } else {
+            jobs[i].output_file = replace_extension(inputs[i], extension);
+        }
+        if (!jobs[i].output_file) goto cleanup;
+    }
+    
+    // Phases 1-4, concurrently when there are several inputs
+    size_t failures = 0;
+    if (multiple) {
+        size_t threads = thread_count > 0 ? (size_t)thread_count : pool_default_threads();
+        pool_t* pool = pool_create(threads < input_count ? threads : input_count);
+        if (!pool) {
+            fprintf(stderr, "Error: Could not start compiler threads\n");
+            goto cleanup;
+        }
+        printf("TinyC Compiler - compiling %zu files on %zu thread%s\n", input_count,
+               pool->thread_count, pool->thread_count == 1 ? "" : "s");
+        for (size_t i = 0; i < input_count; i++) {
+            if (!pool_submit(pool, compile_file, &jobs[i])) compile_file(&jobs[i]);
+        }
+        pool_destroy(pool);
+        
+        for (size_t i = 0; i < input_count; i++) {
+            if (jobs[i].success) {
+                printf("✓ %s -> %s%s\n", jobs[i].input_file, jobs[i].output_file,
+                       jobs[i].cached ? " (cached)" : "");
+            } else {
+                printf("✗ %s failed\n", jobs[i].input_file);
+                failures++;
+            }
+        }
+    } else {
+        compile_file(&jobs[0]);
+        failures = !jobs[0].success;
+    }
+    compiled = 1;
+    if (failures > 0) goto cleanup;
+    
+    // Phase 5 (--run): call main directly
+    if (options.run) {
+        // The image is loaded while symbol names are still interned
+        const char* unresolved = NULL;
+        jit_image_t* image = jit_load(jobs[0].object, runtime_symbols,
+                                      sizeof(runtime_symbols) / sizeof(runtime_symbols[0]), &unresolved);
+        int (*entry)(void) = (int (*)(void))jit_lookup(image, "main");
+        if (!image) {
+            if (unresolved) {
+                fprintf(stderr, "Error: Undefined function '%s'\n", unresolved);
+            } else {
+                fprintf(stderr, "Error: Could not load the program into memory\n");
+            }
+        } else if (!entry) {
+            fprintf(stderr, "Error: No main function to run\n");
+        } else {
+            intern_reset();
+            fflush(stdout);
+            status = entry();
+            flush();
+            fflush(stdout);
+        }
+        jit_destroy(image);
+        goto cleanup;
+    }
+    
+    // Phase 5: Linking (optional)
+    if (!compile_only && !object_only) {
+        printf("\n=== LINKING ===\n");
         
-        // Determine executable name
-        char* exe_name = malloc(strlen(input_file) + 10);
-        strcpy(exe_name, input_file);
-        char* dot = strrchr(exe_name, '.');
-        if (dot) *dot = '\0';
+        // Determine executable name (a.out when compiling stdin or several files)
+        char* exe_name;
+        if (multiple) {
+            exe_name = strdup(output_file ? output_file : "a.out");
+        } else if (strcmp(inputs[0], "-") == 0) {
+            exe_name = strdup("a.out");
+        } else {
+            exe_name = replace_extension(inputs[0], "");
+        }
+        
+        // The runtime is prebuilt next to the compiler; fall back to its source
+        char runtime[PATH_MAX];
+        if (server) {
+            snprintf(runtime, sizeof(runtime), "%s", server->runtime);
+        } else {
+            find_runtime(argv[0], runtime, sizeof(runtime));
+        }
         
-        // Assembly and link command
-        char link_cmd[512];
-        snprintf(link_cmd, sizeof(link_cmd), 
-                "gcc -m64 -no-pie %s runtime/runtime.c -o %s",
-                output_file, exe_name);
+        // One link for every object; gcc only drives the linker here
+        size_t command_size = strlen(runtime) + (exe_name ? strlen(exe_name) : 0) + 64;
+        for (size_t i = 0; i < input_count; i++) {
+            command_size += strlen(jobs[i].output_file) + 1;
+        }
+        char* link_cmd = malloc(command_size);
+        if (!exe_name || !link_cmd) {
+            free(exe_name);
+            free(link_cmd);
+            goto cleanup;
+        }
+        size_t length = (size_t)snprintf(link_cmd, command_size, "gcc -m64 -no-pie");
+        for (size_t i = 0; i < input_count; i++) {
+            length += (size_t)snprintf(link_cmd + length, command_size - length, " %s", jobs[i].output_file);
+        }
+        snprintf(link_cmd + length, command_size - length, " %s -o %s", runtime, exe_name);
         
         printf("Running: %s\n", link_cmd);
+        if (options.stats) stats_begin(&link_stats, STATS_LINK);
         int link_result = system(link_cmd);
+        if (options.stats) stats_end(&link_stats);
         
         if (link_result == 0) {
-            printf("✓ Assembly and linking completed successfully!\n");
+            printf("✓ Linking completed successfully!\n");
             printf("  Executable created: %s\n", exe_name);
             printf("\nRun your program with: ./%s\n", exe_name);
         } else {
-            printf("✗ Assembly and linking failed!\n");
-            printf("  You can still use the assembly file: %s\n", output_file);
+            printf("✗ Linking failed!\n");
+            printf("  You can still use the object file%s: %s%s\n", multiple ? "s" : "",
+                   jobs[0].output_file, multiple ? ", ..." : "");
         }
         
+        free(link_cmd);
         free(exe_name);
     }
     
     printf("\n✓ Compilation completed successfully!\n");
-    return 0;
-}
\ No newline at end of file
+    status = 0;
+    
+cleanup:
+    // --run leaves stdout to the program
+    if (compiled && options.stats) {
+        FILE* text_output = print_stats ? (options.run ? stderr : stdout) : NULL;
+        if (!report_stats(jobs, input_count, &link_stats, text_output, stats_json) && status == 0) status = 1;
+    }
+    for (size_t i = 0; i < input_count; i++) {
+        free(jobs[i].output_file);
+        object_destroy(jobs[i].object);
+    }
+    free(jobs);
+done:
+    for (size_t i = 0; i < input_count; i++) {
+        free(inputs[i]);
+    }
+    free(inputs);
+    
+    // A server keeps interned names for its next requests
+    if (!server) intern_reset();
+    return status;
+}
+
+// Helper: One --server request (a server_handler_t)
+static int serve_request(int argc, char** argv, void* context) {
+    int status = compile_command(argc, argv, context);
+    if (intern_count() > SERVER_INTERN_LIMIT) intern_reset();
+    return status;
+}
+
+// Helper: Serve compile requests on socket_path until interrupted
+static int run_server(const char* program_name, const char* socket_path) {
+    server_state_t server;
+    memset(&server, 0, sizeof(server));
+    cache_compiler_identity(server.identity);
+    
+    // Requests run in their clients' directories, so the runtime is found
+    // once by absolute path; without a prebuilt object its source is
+    // compiled now instead of at every link
+    char runtime[PATH_MAX];
+    if (find_runtime(program_name, runtime, sizeof(runtime))) {
+        char directory[PATH_MAX];
+        int resolved = 1;
+        if (runtime[0] == '/') {
+            snprintf(server.runtime, sizeof(server.runtime), "%s", runtime);
+        } else {
+            resolved = getcwd(directory, sizeof(directory)) &&
+                       (size_t)snprintf(server.runtime, sizeof(server.runtime), "%s/%s", directory, runtime) <
+                           sizeof(server.runtime);
+        }
+        if (!resolved) {
+            fprintf(stderr, "Error: Could not resolve the runtime '%s'\n", runtime);
+            return 1;
+        }
+    } else {
+        snprintf(server.runtime, sizeof(server.runtime), "/tmp/tinyc-runtime-XXXXXX");
+        int fd = mkstemp(server.runtime);
+        if (fd < 0) {
+            fprintf(stderr, "Error: Could not create the runtime object\n");
+            return 1;
+        }
+        close(fd);
+        server.runtime_built = 1;
+        
+        char command[2 * PATH_MAX + 64];
+        snprintf(command, sizeof(command), "gcc -m64 -c -x c %s -o %s", runtime, server.runtime);
+        if (system(command) != 0) {
+            fprintf(stderr, "Error: Could not compile the runtime '%s'\n", runtime);
+            unlink(server.runtime);
+            return 1;
+        }
+    }
+    
+    server.outputs = cache_memory_create(SERVER_CACHE_BYTES);
+    if (!server.outputs) {
+        if (server.runtime_built) unlink(server.runtime);
+        return 1;
+    }
+    
+    int success = server_run(socket_path, serve_request, &server);
+    
+    cache_memory_destroy(server.outputs);
+    if (server.runtime_built) unlink(server.runtime);
+    intern_reset();
+    return success ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "--server") == 0) {
+        return run_server(argv[0], argv[2]);
+    }
+    
+    // Requests carry the program name and then the compiler's own arguments
+    const char* socket_path = NULL;
+    int first_argument = 1;
+    if (argc >= 3 && strcmp(argv[1], "--connect") == 0) {
+        socket_path = argv[2];
+        first_argument = 3;
+    } else {
+        // --run always runs here (servers refuse it)
+        const char* server = getenv("TINYC_SERVER");
+        if (server && server[0] != '\0') socket_path = server;
+        for (int i = 1; i < argc && socket_path; i++) {
+            if (strcmp(argv[i], "--run") == 0) socket_path = NULL;
+        }
+    }
+    if (socket_path) {
+        argv[first_argument - 1] = argv[0];
+        int status = 1;
+        const int streams[3] = {0, 1, 2};
+        fflush(stdout);
+        int result = server_request(socket_path, argc - first_argument + 1, argv + first_argument - 1, streams, &status);
+        if (result == 1) return status;
+        if (result < 0) {
+            fprintf(stderr, "Error: Lost the connection to the compile server on '%s'\n", socket_path);
+            return 1;
+        }
+        
+        // $TINYC_SERVER is only a shortcut; without a server, compile here
+        if (first_argument > 1) {
+            fprintf(stderr, "Error: No compile server on '%s'\n", socket_path);
+            return 1;
+        }
+    }
+    return compile_command(argc, argv, NULL);
+}
@@ -0,0 +1,740 @@
+// src/object.c
+#include <elf.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "object.h"
+#include "utils.h"
+
+// Hardware encoding of each register_t
+static const unsigned char register_codes[MAX_REGISTERS] = {
+    [REG_RAX] = 0, [REG_RCX] = 1, [REG_RDX] = 2, [REG_RBX] = 3,
+    [REG_RSP] = 4, [REG_RBP] = 5, [REG_RSI] = 6, [REG_RDI] = 7,
+    [REG_R8] = 8, [REG_R9] = 9, [REG_R10] = 10, [REG_R11] = 11,
+    [REG_R12] = 12, [REG_R13] = 13, [REG_R14] = 14, [REG_R15] = 15
+};
+
+// Section header indices of the written object
+enum {
+    SECTION_NULL,
+    SECTION_TEXT,
+    SECTION_DATA,
+    SECTION_NOTE,         // Empty .note.GNU-stack: the stack is not executable
+    SECTION_SYMTAB,
+    SECTION_STRTAB,
+    SECTION_RELA_TEXT,
+    SECTION_SHSTRTAB,
+    SECTION_COUNT
+};
+
+// Fixed symbol table entries ahead of the named symbols
+#define SYMBOL_TEXT 1
+#define SYMBOL_DATA 2
+#define SYMBOL_FIRST_NAMED 3
+
+// Object lifecycle
+object_t* object_create(void) {
+    object_t* object = calloc(1, sizeof(object_t));
+    return object;
+}
+
+void object_destroy(object_t* object) {
+    if (!object) return;
+
+    free(object->text.data);
+    free(object->data.data);
+    free(object->symbols);
+    free(object->fixups);
+    free(object->label_offsets);
+    free(object->label_fixups);
+    free(object);
+}
+
+// Byte buffers
+static void object_append(object_buffer_t* buffer, const void* bytes, size_t size) {
+    if (buffer->size + size > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 256;
+        while (capacity < buffer->size + size) capacity *= 2;
+        unsigned char* data = realloc(buffer->data, capacity);
+        if (!data) return;
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, bytes, size);
+    buffer->size += size;
+}
+
+static void object_append_byte(object_buffer_t* buffer, unsigned char byte) {
+    object_append(buffer, &byte, 1);
+}
+
+// Little-endian value of size bytes
+static void object_append_value(object_buffer_t* buffer, unsigned long value, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        object_append_byte(buffer, (unsigned char)(value >> (8 * i)));
+    }
+}
+
+// Symbols
+
+// Helper: Symbol called name (interned), created undefined if missing
+static object_symbol_t* object_symbol(object_t* object, const char* name) {
+    for (size_t i = 0; i < object->symbol_count; i++) {
+        if (object->symbols[i].name == name) return &object->symbols[i];
+    }
+
+    if (object->symbol_count >= object->symbol_capacity) {
+        size_t capacity = object->symbol_capacity ? object->symbol_capacity * 2 : 16;
+        object_symbol_t* symbols = realloc(object->symbols, capacity * sizeof(object_symbol_t));
+        if (!symbols) return NULL;
+        object->symbols = symbols;
+        object->symbol_capacity = capacity;
+    }
+
+    object_symbol_t* symbol = &object->symbols[object->symbol_count++];
+    memset(symbol, 0, sizeof(*symbol));
+    symbol->name = name;
+    symbol->section = OBJECT_UNDEFINED;
+    return symbol;
+}
+
+void object_set_global(object_t* object, const char* name) {
+    object_symbol_t* symbol = object_symbol(object, intern_string(name));
+    if (symbol) symbol->global = 1;
+}
+
+// Helper: Record a 32-bit reference to symbol at the end of .text
+static void object_add_fixup(object_t* object, const char* symbol, long addend, int branch) {
+    // Referenced names get a symbol now; those never defined stay undefined
+    if (!object_symbol(object, symbol)) return;
+
+    if (object->fixup_count >= object->fixup_capacity) {
+        size_t capacity = object->fixup_capacity ? object->fixup_capacity * 2 : 32;
+        object_fixup_t* fixups = realloc(object->fixups, capacity * sizeof(object_fixup_t));
+        if (!fixups) return;
+        object->fixups = fixups;
+        object->fixup_capacity = capacity;
+    }
+
+    object_fixup_t* fixup = &object->fixups[object->fixup_count++];
+    fixup->offset = object->text.size;
+    fixup->symbol = symbol;
+    fixup->addend = addend;
+    fixup->branch = branch;
+    object_append_value(&object->text, 0, 4);
+}
+
+// Helper: Record a 32-bit jump field to local label at the end of .text
+static int object_add_label_fixup(object_t* object, long label) {
+    if (object->label_fixup_count >= object->label_fixup_capacity) {
+        size_t capacity = object->label_fixup_capacity ? object->label_fixup_capacity * 2 : 32;
+        object_label_fixup_t* fixups = realloc(object->label_fixups, capacity * sizeof(object_label_fixup_t));
+        if (!fixups) return 0;
+        object->label_fixups = fixups;
+        object->label_fixup_capacity = capacity;
+    }
+
+    object_label_fixup_t* fixup = &object->label_fixups[object->label_fixup_count++];
+    fixup->offset = object->text.size;
+    fixup->label = label;
+    object_append_value(&object->text, 0, 4);
+    return 1;
+}
+
+// Data
+void object_add_string(object_t* object, const char* label, const char* value) {
+    object_symbol_t* symbol = object_symbol(object, intern_string(label));
+    if (!symbol) return;
+    symbol->section = OBJECT_DATA;
+    symbol->offset = object->data.size;
+
+    for (const char* c = value; *c; c++) {
+        if (*c != '\\' || !c[1]) {
+            object_append_byte(&object->data, (unsigned char)*c);
+            continue;
+        }
+
+        c++;
+        unsigned char byte = (unsigned char)*c;
+        switch (*c) {
+            case 'b': byte = '\b'; break;
+            case 'f': byte = '\f'; break;
+            case 'n': byte = '\n'; break;
+            case 'r': byte = '\r'; break;
+            case 't': byte = '\t'; break;
+            case 'x': {
+                char* end;
+                byte = (unsigned char)strtol(c + 1, &end, 16);
+                if (end != c + 1) c = end - 1;
+                break;
+            }
+            default:
+                if (*c >= '0' && *c <= '7') {
+                    // Up to three octal digits, as in C
+                    int digits = 0;
+                    byte = 0;
+                    while (digits < 3 && *c >= '0' && *c <= '7') {
+                        byte = (unsigned char)(byte * 8 + (*c - '0'));
+                        c++;
+                        digits++;
+                    }
+                    c--;
+                }
+                break;
+        }
+        object_append_byte(&object->data, byte);
+    }
+    object_append_byte(&object->data, 0);
+}
+
+// Instruction encoding
+
+// Helper: True if value fits a sign-extended immediate of bits
+static int object_fits(long value, int bits) {
+    return bits == 8 ? value >= -128 && value <= 127 : value >= INT_MIN && value <= INT_MAX;
+}
+
+// Helper: Condition code of a jcc / setcc for a comparison
+static unsigned char object_condition_code(ast_operator_t condition) {
+    switch (condition) {
+        case OP_EQ: return 0x4;
+        case OP_NE: return 0x5;
+        case OP_LT: return 0xC;
+        case OP_GE: return 0xD;
+        case OP_LE: return 0xE;
+        case OP_GT: return 0xF;
+        default: return 0x4;
+    }
+}
+
+// Helper: True if operand is a register, memory or %rip-relative operand
+static int object_is_rm(const asm_operand_t* operand) {
+    return operand->kind == ASM_OPERAND_REGISTER || operand->kind == ASM_OPERAND_MEMORY ||
+           (operand->kind == ASM_OPERAND_SYMBOL && strstr(operand->text, "(%rip)"));
+}
+
+// Helper: True if a byte register operand needs a REX prefix (%spl..%dil)
+static int object_needs_rex(const asm_operand_t* operand) {
+    if (operand->kind != ASM_OPERAND_REGISTER || operand->size != 1) return 0;
+    int code = register_codes[operand->reg];
+    return code >= 4 && code <= 7;
+}
+
+/**
+ * Helper: Emit [REX] opcode ModRM [SIB] [displacement]
+ *
+ * reg is the register or opcode extension of the ModRM reg field, rm the
+ * register or memory operand, and immediate_size the bytes that follow the
+ * displacement (they shift the %rip-relative addend). force_rex is set when
+ * a byte register in the reg field needs a REX prefix.
+ */
+static void object_emit_modrm(object_t* object, int wide, const unsigned char* opcode, size_t opcode_size,
+                              int reg, const asm_operand_t* rm, int immediate_size, int force_rex) {
+    object_buffer_t* text = &object->text;
+    int base = rm->kind == ASM_OPERAND_SYMBOL ? 0 : register_codes[rm->reg];
+
+    unsigned char rex = 0x40 | (wide ? 0x08 : 0) | (reg >= 8 ? 0x04 : 0) | (base >= 8 ? 0x01 : 0);
+    if (rex != 0x40 || force_rex || object_needs_rex(rm)) object_append_byte(text, rex);
+    object_append(text, opcode, opcode_size);
+
+    reg &= 7;
+    if (rm->kind == ASM_OPERAND_REGISTER) {
+        object_append_byte(text, (unsigned char)(0xC0 | reg << 3 | (base & 7)));
+        return;
+    }
+
+    if (rm->kind == ASM_OPERAND_SYMBOL) {
+        // symbol(%rip): mod 00, r/m 101, disp32 relative to the next instruction
+        char name[256];
+        size_t length = strcspn(rm->text, "(");
+        if (length >= sizeof(name)) length = sizeof(name) - 1;
+        memcpy(name, rm->text, length);
+        name[length] = '\0';
+
+        object_append_byte(text, (unsigned char)(0x05 | reg << 3));
+        object_add_fixup(object, intern_string(name), -4 - immediate_size, 0);
+        return;
+    }
+
+    // %rbp and %r13 have no displacement-free form; %rsp and %r12 need a SIB
+    int mod = rm->value == 0 && (base & 7) != 5 ? 0 : object_fits(rm->value, 8) ? 1 : 2;
+    object_append_byte(text, (unsigned char)(mod << 6 | reg << 3 | (base & 7)));
+    if ((base & 7) == 4) object_append_byte(text, 0x24);
+    if (mod == 1) object_append_value(text, (unsigned long)rm->value, 1);
+    if (mod == 2) object_append_value(text, (unsigned long)rm->value, 4);
+}
+
+// Helper: Emit a one-byte opcode with ModRM
+static void object_emit_op(object_t* object, int wide, unsigned char opcode, int reg,
+                           const asm_operand_t* rm, int immediate_size) {
+    object_emit_modrm(object, wide, &opcode, 1, reg, rm, immediate_size, 0);
+}
+
+// Helper: Emit an instruction whose register is folded into the opcode (push, pop, movabs)
+static void object_emit_short(object_t* object, int wide, unsigned char opcode, register_t reg) {
+    int code = register_codes[reg];
+    if (wide || code >= 8) object_append_byte(&object->text, (unsigned char)(0x40 | (wide ? 0x08 : 0) | (code >= 8)));
+    object_append_byte(&object->text, (unsigned char)(opcode + (code & 7)));
+}
+
+// Helper: add / sub / cmp, with ModRM extension digit and opcode base
+static int object_encode_alu(object_t* object, const asm_instr_t* instr, int wide, int digit, unsigned char base) {
+    const asm_operand_t* src = &instr->operands[0];
+    const asm_operand_t* dst = &instr->operands[1];
+
+    if (src->kind == ASM_OPERAND_IMMEDIATE && object_is_rm(dst)) {
+        if (object_fits(src->value, 8)) {
+            object_emit_op(object, wide, 0x83, digit, dst, 1);
+            object_append_value(&object->text, (unsigned long)src->value, 1);
+            return 1;
+        }
+        if (!object_fits(src->value, 32)) return 0;
+        object_emit_op(object, wide, 0x81, digit, dst, 4);
+        object_append_value(&object->text, (unsigned long)src->value, 4);
+        return 1;
+    }
+    if (src->kind == ASM_OPERAND_REGISTER && object_is_rm(dst)) {
+        object_emit_op(object, wide, base + 1, register_codes[src->reg], dst, 0);
+        return 1;
+    }
+    if (object_is_rm(src) && dst->kind == ASM_OPERAND_REGISTER) {
+        object_emit_op(object, wide, base + 3, register_codes[dst->reg], src, 0);
+        return 1;
+    }
+    return 0;
+}
+
+// Helper: mov in all the forms codegen and the peephole pass produce
+static int object_encode_mov(object_t* object, const asm_instr_t* instr, int wide) {
+    const asm_operand_t* src = &instr->operands[0];
+    const asm_operand_t* dst = &instr->operands[1];
+
+    if (src->kind == ASM_OPERAND_IMMEDIATE) {
+        if (object_fits(src->value, 32) && object_is_rm(dst)) {
+            object_emit_op(object, wide, 0xC7, 0, dst, 4);
+            object_append_value(&object->text, (unsigned long)src->value, 4);
+            return 1;
+        }
+        if (dst->kind != ASM_OPERAND_REGISTER) return 0;
+
+        // movabs; a value that fits 32 unsigned bits is zero-extended by movl
+        int full = wide && (src->value < 0 || src->value > UINT_MAX);
+        object_emit_short(object, full, 0xB8, dst->reg);
+        object_append_value(&object->text, (unsigned long)src->value, full ? 8 : 4);
+        return 1;
+    }
+    if (src->kind == ASM_OPERAND_REGISTER && object_is_rm(dst)) {
+        object_emit_op(object, wide, 0x89, register_codes[src->reg], dst, 0);
+        return 1;
+    }
+    if (object_is_rm(src) && dst->kind == ASM_OPERAND_REGISTER) {
+        object_emit_op(object, wide, 0x8B, register_codes[dst->reg], src, 0);
+        return 1;
+    }
+    return 0;
+}
+
+// Helper: imul in its two- and three-operand forms
+static int object_encode_imul(object_t* object, const asm_instr_t* instr, int wide) {
+    const asm_operand_t* first = &instr->operands[0];
+    const asm_operand_t* dst = &instr->operands[instr->operand_count - 1];
+    if (dst->kind != ASM_OPERAND_REGISTER) return 0;
+
+    if (first->kind == ASM_OPERAND_IMMEDIATE) {
+        // imulq $n, %r is imulq $n, %r, %r
+        const asm_operand_t* src = instr->operand_count == 3 ? &instr->operands[1] : dst;
+        if (!object_is_rm(src)) return 0;
+        if (object_fits(first->value, 8)) {
+            object_emit_op(object, wide, 0x6B, register_codes[dst->reg], src, 1);
+            object_append_value(&object->text, (unsigned long)first->value, 1);
+            return 1;
+        }
+        if (!object_fits(first->value, 32)) return 0;
+        object_emit_op(object, wide, 0x69, register_codes[dst->reg], src, 4);
+        object_append_value(&object->text, (unsigned long)first->value, 4);
+        return 1;
+    }
+
+    if (instr->operand_count != 2 || !object_is_rm(first)) return 0;
+    static const unsigned char opcode[] = {0x0F, 0xAF};
+    object_emit_modrm(object, wide, opcode, 2, register_codes[dst->reg], first, 0, 0);
+    return 1;
+}
+
+// Helper: Encode one instruction; returns 0 for forms with no encoding here
+static int object_encode_instruction(object_t* object, const asm_instr_t* instr) {
+    object_buffer_t* text = &object->text;
+    const asm_operand_t* operands = instr->operands;
+    int count = instr->operand_count;
+    int wide = instr->suffix == 'q';
+
+    // Only 32- and 64-bit operations are generated (byte forms are explicit below)
+    if (instr->suffix != '\0' && instr->suffix != 'q' && instr->suffix != 'l') return 0;
+
+    switch (instr->opcode) {
+        case ASM_MOV:
+            return count == 2 && object_encode_mov(object, instr, wide);
+
+        case ASM_ADD:
+            return count == 2 && object_encode_alu(object, instr, wide, 0, 0x00);
+        case ASM_SUB:
+            return count == 2 && object_encode_alu(object, instr, wide, 5, 0x28);
+        case ASM_CMP:
+            return count == 2 && object_encode_alu(object, instr, wide, 7, 0x38);
+
+        case ASM_TEST:
+            if (count != 2 || operands[0].kind != ASM_OPERAND_REGISTER || !object_is_rm(&operands[1])) return 0;
+            object_emit_op(object, wide, 0x85, register_codes[operands[0].reg], &operands[1], 0);
+            return 1;
+
+        case ASM_IMUL:
+            return (count == 2 || count == 3) && object_encode_imul(object, instr, wide);
+
+        case ASM_IDIV:
+        case ASM_NEG:
+            if (count != 1 || !object_is_rm(&operands[0])) return 0;
+            object_emit_op(object, wide, 0xF7, instr->opcode == ASM_IDIV ? 7 : 3, &operands[0], 0);
+            return 1;
+
+        case ASM_SAL:
+            if (count != 2 || operands[0].kind != ASM_OPERAND_IMMEDIATE || !object_is_rm(&operands[1])) return 0;
+            if (operands[0].value == 1) {
+                object_emit_op(object, wide, 0xD1, 4, &operands[1], 0);
+                return 1;
+            }
+            object_emit_op(object, wide, 0xC1, 4, &operands[1], 1);
+            object_append_value(text, (unsigned long)operands[0].value, 1);
+            return 1;
+
+        case ASM_LEA:
+            if (count != 2 || operands[0].kind == ASM_OPERAND_REGISTER || !object_is_rm(&operands[0]) ||
+                operands[1].kind != ASM_OPERAND_REGISTER) {
+                return 0;
+            }
+            object_emit_op(object, wide, 0x8D, register_codes[operands[1].reg], &operands[0], 0);
+            return 1;
+
+        case ASM_MOVZB:
+        case ASM_MOVSB: {
+            if (count != 2 || !object_is_rm(&operands[0]) || operands[1].kind != ASM_OPERAND_REGISTER) return 0;
+            unsigned char opcode[] = {0x0F, instr->opcode == ASM_MOVZB ? 0xB6 : 0xBE};
+            object_emit_modrm(object, wide, opcode, 2, register_codes[operands[1].reg], &operands[0], 0, 0);
+            return 1;
+        }
+
+        case ASM_MOVSL:
+            if (!wide || count != 2 || !object_is_rm(&operands[0]) || operands[1].kind != ASM_OPERAND_REGISTER) {
+                return 0;
+            }
+            object_emit_op(object, 1, 0x63, register_codes[operands[1].reg], &operands[0], 0);
+            return 1;
+
+        case ASM_SET: {
+            if (count != 1 || !object_is_rm(&operands[0])) return 0;
+            unsigned char opcode[] = {0x0F, (unsigned char)(0x90 | object_condition_code(instr->condition))};
+            object_emit_modrm(object, 0, opcode, 2, 0, &operands[0], 0, 0);
+            return 1;
+        }
+
+        case ASM_JMP:
+        case ASM_JCC:
+        case ASM_CALL:
+            if (count != 1) return 0;
+            if (operands[0].kind != ASM_OPERAND_SYMBOL &&
+                (operands[0].kind != ASM_OPERAND_LABEL || instr->opcode == ASM_CALL)) {
+                return 0;
+            }
+            if (instr->opcode == ASM_JCC) {
+                object_append_byte(text, 0x0F);
+                object_append_byte(text, (unsigned char)(0x80 | object_condition_code(instr->condition)));
+            } else {
+                object_append_byte(text, instr->opcode == ASM_JMP ? 0xE9 : 0xE8);
+            }
+            if (operands[0].kind == ASM_OPERAND_LABEL) {
+                return object_add_label_fixup(object, operands[0].value);
+            }
+            object_add_fixup(object, operands[0].text, -4, 1);
+            return 1;
+
+        case ASM_PUSH:
+        case ASM_POP:
+            if (count != 1 || !wide) return 0;
+            if (operands[0].kind == ASM_OPERAND_REGISTER) {
+                object_emit_short(object, 0, instr->opcode == ASM_PUSH ? 0x50 : 0x58, operands[0].reg);
+                return 1;
+            }
+            if (instr->opcode == ASM_PUSH && operands[0].kind == ASM_OPERAND_IMMEDIATE) {
+                int small = object_fits(operands[0].value, 8);
+                if (!small && !object_fits(operands[0].value, 32)) return 0;
+                object_append_byte(text, small ? 0x6A : 0x68);
+                object_append_value(text, (unsigned long)operands[0].value, small ? 1 : 4);
+                return 1;
+            }
+            if (!object_is_rm(&operands[0])) return 0;
+            object_emit_op(object, 0, instr->opcode == ASM_PUSH ? 0xFF : 0x8F,
+                           instr->opcode == ASM_PUSH ? 6 : 0, &operands[0], 0);
+            return 1;
+
+        case ASM_RET:
+            object_append_byte(text, 0xC3);
+            return 1;
+
+        case ASM_CQTO:
+            object_append_byte(text, 0x48);
+            object_append_byte(text, 0x99);
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+// Helper: Make room for local labels with values below limit; 0 on failure
+static int object_reserve_labels(object_t* object, long limit) {
+    size_t needed = (size_t)(limit - ASM_RETURN_LABEL);
+    if (needed > object->label_capacity) {
+        size_t* offsets = realloc(object->label_offsets, needed * sizeof(size_t));
+        if (!offsets) return 0;
+        object->label_offsets = offsets;
+        object->label_capacity = needed;
+    }
+    for (size_t i = 0; i < needed; i++) object->label_offsets[i] = SIZE_MAX;
+    return 1;
+}
+
+// Helper: Patch the jumps to local labels of the buffer just encoded
+static int object_resolve_labels(object_t* object, const asm_instr_t* instrs, long limit) {
+    for (size_t f = 0; f < object->label_fixup_count; f++) {
+        const object_label_fixup_t* fixup = &object->label_fixups[f];
+        size_t target = fixup->label >= ASM_RETURN_LABEL && fixup->label < limit ?
+                        object->label_offsets[fixup->label - ASM_RETURN_LABEL] : SIZE_MAX;
+        if (target == SIZE_MAX) {
+            object->failed = 1;
+            object->failed_instr = instrs[fixup->instr];
+            return 0;
+        }
+
+        int32_t displacement = (int32_t)((long)target - 4 - (long)fixup->offset);
+        memcpy(object->text.data + fixup->offset, &displacement, sizeof(displacement));
+    }
+    object->label_fixup_count = 0;
+    return 1;
+}
+
+int object_encode(object_t* object, const asm_instr_t* instrs, size_t count) {
+    long label_limit = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (instrs[i].kind == ASM_LABEL && instrs[i].operand_count == 1 && instrs[i].operands[0].value >= label_limit) {
+            label_limit = instrs[i].operands[0].value + 1;
+        }
+    }
+    if (!object_reserve_labels(object, label_limit)) return 0;
+    object->label_fixup_count = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const asm_instr_t* instr = &instrs[i];
+
+        if (instr->kind == ASM_LABEL && instr->operand_count == 1) {
+            if (instr->operands[0].value >= ASM_RETURN_LABEL) {
+                object->label_offsets[instr->operands[0].value - ASM_RETURN_LABEL] = object->text.size;
+            }
+            continue;
+        }
+        if (instr->kind == ASM_LABEL) {
+            object_symbol_t* symbol = object_symbol(object, instr->text);
+            if (!symbol) return 0;
+            symbol->section = OBJECT_TEXT;
+            symbol->offset = object->text.size;
+            symbol->function = strncmp(instr->text, ".L", 2) != 0;
+            continue;
+        }
+        if (instr->kind == ASM_COMMENT) continue;
+
+        size_t label_fixups = object->label_fixup_count;
+        if (!object_encode_instruction(object, instr)) {
+            object->failed = 1;
+            object->failed_instr = *instr;
+            return 0;
+        }
+        if (object->label_fixup_count > label_fixups) {
+            object->label_fixups[label_fixups].instr = i;
+        }
+    }
+    return object_resolve_labels(object, instrs, label_limit);
+}
+
+// ELF output
+
+// Helper: Offset of name in a string table being built
+static Elf64_Word object_add_name(object_buffer_t* table, const char* name) {
+    Elf64_Word offset = (Elf64_Word)table->size;
+    object_append(table, name, strlen(name) + 1);
+    return offset;
+}
+
+// Helper: Pad buffer with zeros to a multiple of alignment
+static void object_align(object_buffer_t* buffer, size_t alignment) {
+    while (buffer->size % alignment != 0) object_append_byte(buffer, 0);
+}
+
+// Helper: True if symbol goes into the symbol table (.L labels do not)
+static int object_is_exported(const object_symbol_t* symbol) {
+    return strncmp(symbol->name, ".L", 2) != 0;
+}
+
+// Helper: Size of the function starting at symbol (up to the next one)
+static Elf64_Xword object_function_size(const object_t* object, const object_symbol_t* symbol) {
+    size_t end = object->text.size;
+    for (size_t i = 0; i < object->symbol_count; i++) {
+        const object_symbol_t* other = &object->symbols[i];
+        if (other->function && other->section == OBJECT_TEXT && other->offset > symbol->offset &&
+            other->offset < end) {
+            end = other->offset;
+        }
+    }
+    return end - symbol->offset;
+}
+
+int object_write(object_t* object, FILE* output) {
+    object_buffer_t symtab = {0}, strtab = {0}, rela = {0}, shstrtab = {0}, file = {0};
+    int* indices = calloc(object->symbol_count + 1, sizeof(int));
+    int success = indices != NULL;
+
+    // Symbol table: null, the two section symbols, locals, then globals
+    Elf64_Sym symbol = {0};
+    object_append_byte(&strtab, 0);
+    object_append(&symtab, &symbol, sizeof(symbol));
+    symbol.st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+    symbol.st_shndx = SECTION_TEXT;
+    object_append(&symtab, &symbol, sizeof(symbol));
+    symbol.st_shndx = SECTION_DATA;
+    object_append(&symtab, &symbol, sizeof(symbol));
+
+    int next_index = SYMBOL_FIRST_NAMED;
+    int first_global = next_index;
+    for (int global = 0; success && global <= 1; global++) {
+        if (global) first_global = next_index;
+        for (size_t i = 0; i < object->symbol_count; i++) {
+            const object_symbol_t* entry = &object->symbols[i];
+            int is_global = entry->global || entry->section == OBJECT_UNDEFINED;
+            if (is_global != global || !object_is_exported(entry)) continue;
+
+            memset(&symbol, 0, sizeof(symbol));
+            symbol.st_name = object_add_name(&strtab, entry->name);
+            symbol.st_info = ELF64_ST_INFO(global ? STB_GLOBAL : STB_LOCAL,
+                                           entry->function ? STT_FUNC : STT_NOTYPE);
+            if (entry->section != OBJECT_UNDEFINED) {
+                symbol.st_shndx = entry->section == OBJECT_TEXT ? SECTION_TEXT : SECTION_DATA;
+                symbol.st_value = entry->offset;
+            }
+            if (entry->function && entry->section == OBJECT_TEXT) {
+                symbol.st_size = object_function_size(object, entry);
+            }
+            object_append(&symtab, &symbol, sizeof(symbol));
+            indices[i] = next_index++;
+        }
+    }
+
+    // Branches within .text are final; everything else is left to the linker
+    for (size_t f = 0; success && f < object->fixup_count; f++) {
+        const object_fixup_t* fixup = &object->fixups[f];
+        size_t target = 0;
+        while (object->symbols[target].name != fixup->symbol) target++;
+        const object_symbol_t* entry = &object->symbols[target];
+
+        Elf64_Rela relocation = {0};
+        relocation.r_offset = fixup->offset;
+        if (entry->section == OBJECT_TEXT && fixup->branch) {
+            int32_t displacement = (int32_t)((long)entry->offset + fixup->addend - (long)fixup->offset);
+            memcpy(object->text.data + fixup->offset, &displacement, sizeof(displacement));
+            continue;
+        } else if (entry->section != OBJECT_UNDEFINED) {
+            // Against the section, as gas does for local labels
+            int section = entry->section == OBJECT_TEXT ? SYMBOL_TEXT : SYMBOL_DATA;
+            relocation.r_info = ELF64_R_INFO(section, R_X86_64_PC32);
+            relocation.r_addend = (long)entry->offset + fixup->addend;
+        } else if (object_is_exported(entry)) {
+            relocation.r_info = ELF64_R_INFO(indices[target], fixup->branch ? R_X86_64_PLT32 : R_X86_64_PC32);
+            relocation.r_addend = fixup->addend;
+        } else {
+            success = 0;      // Jump to a .L label that was never defined
+            break;
+        }
+        object_append(&rela, &relocation, sizeof(relocation));
+    }
+
+    // Section names
+    static const char* const names[SECTION_COUNT] = {
+        "", ".text", ".data", ".note.GNU-stack", ".symtab", ".strtab", ".rela.text", ".shstrtab"
+    };
+    Elf64_Word name_offsets[SECTION_COUNT];
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        name_offsets[i] = object_add_name(&shstrtab, names[i]);
+    }
+
+    // Layout: header, section contents, then the section header table
+    Elf64_Shdr sections[SECTION_COUNT];
+    memset(sections, 0, sizeof(sections));
+    Elf64_Ehdr header = {0};
+    object_append(&file, &header, sizeof(header));
+
+    const object_buffer_t* contents[SECTION_COUNT] = {
+        NULL, &object->text, &object->data, NULL, &symtab, &strtab, &rela, &shstrtab
+    };
+    static const Elf64_Word types[SECTION_COUNT] = {
+        SHT_NULL, SHT_PROGBITS, SHT_PROGBITS, SHT_PROGBITS, SHT_SYMTAB, SHT_STRTAB, SHT_RELA, SHT_STRTAB
+    };
+    static const Elf64_Xword alignments[SECTION_COUNT] = {0, 16, 1, 1, 8, 1, 8, 1};
+    for (int i = 1; i < SECTION_COUNT; i++) {
+        object_align(&file, alignments[i]);
+        sections[i].sh_name = name_offsets[i];
+        sections[i].sh_type = types[i];
+        sections[i].sh_offset = file.size;
+        sections[i].sh_addralign = alignments[i];
+        if (contents[i]) {
+            sections[i].sh_size = contents[i]->size;
+            if (contents[i]->size > 0) object_append(&file, contents[i]->data, contents[i]->size);
+        }
+    }
+    sections[SECTION_TEXT].sh_flags = SHF_ALLOC | SHF_EXECINSTR;
+    sections[SECTION_DATA].sh_flags = SHF_ALLOC | SHF_WRITE;
+    sections[SECTION_SYMTAB].sh_link = SECTION_STRTAB;
+    sections[SECTION_SYMTAB].sh_info = (Elf64_Word)first_global;
+    sections[SECTION_SYMTAB].sh_entsize = sizeof(Elf64_Sym);
+    sections[SECTION_RELA_TEXT].sh_flags = SHF_INFO_LINK;
+    sections[SECTION_RELA_TEXT].sh_link = SECTION_SYMTAB;
+    sections[SECTION_RELA_TEXT].sh_info = SECTION_TEXT;
+    sections[SECTION_RELA_TEXT].sh_entsize = sizeof(Elf64_Rela);
+
+    object_align(&file, 8);
+    size_t section_offset = file.size;
+    object_append(&file, sections, sizeof(sections));
+
+    memcpy(header.e_ident, ELFMAG, SELFMAG);
+    header.e_ident[EI_CLASS] = ELFCLASS64;
+    header.e_ident[EI_DATA] = ELFDATA2LSB;
+    header.e_ident[EI_VERSION] = EV_CURRENT;
+    header.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    header.e_type = ET_REL;
+    header.e_machine = EM_X86_64;
+    header.e_version = EV_CURRENT;
+    header.e_shoff = section_offset;
+    header.e_ehsize = sizeof(Elf64_Ehdr);
+    header.e_shentsize = sizeof(Elf64_Shdr);
+    header.e_shnum = SECTION_COUNT;
+    header.e_shstrndx = SECTION_SHSTRTAB;
+
+    if (success && file.data) {
+        memcpy(file.data, &header, sizeof(header));
+        success = fwrite(file.data, 1, file.size, output) == file.size && fflush(output) == 0;
+    }
+
+    free(indices);
+    free(symtab.data);
+    free(strtab.data);
+    free(rela.data);
+    free(shstrtab.data);
+    free(file.data);
+    return success && file.data != NULL;
+}
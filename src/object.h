@@ -0,0 +1,108 @@
+// src/object.h
+#ifndef OBJECT_H
+#define OBJECT_H
+
+#include <stdio.h>
+#include "codegen.h"
+
+// Growable contents of one section
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+} object_buffer_t;
+
+// Sections symbols can be defined in
+typedef enum {
+    OBJECT_UNDEFINED,
+    OBJECT_TEXT,
+    OBJECT_DATA
+} object_section_t;
+
+// Named location of the object (function, string literal or external)
+typedef struct {
+    const char* name;     // Interned
+    object_section_t section;
+    size_t offset;
+    int global;
+    int function;
+} object_symbol_t;
+
+// 32-bit field of .text that refers to a symbol, resolved by object_write()
+typedef struct {
+    size_t offset;        // Position of the field in .text
+    const char* symbol;   // Interned
+    long addend;          // Added to the symbol's address minus the field's
+    int branch;           // call / jmp / jcc target rather than %rip-relative data
+} object_fixup_t;
+
+// Jump to a numbered local label of the function being encoded
+typedef struct {
+    size_t offset;        // Position of the 32-bit field in .text
+    long label;           // ASM_OPERAND_LABEL value
+    size_t instr;         // Index of the jump in the encoded buffer
+} object_label_fixup_t;
+
+// ELF64 relocatable object built from codegen's instruction buffer
+// .L labels stay local to the assembler, as with gas; other labels become
+// function symbols, and names that are never defined become undefined
+// globals that the linker resolves (runtime functions).
+struct object {
+    object_buffer_t text;
+    object_buffer_t data;
+
+    object_symbol_t* symbols;
+    size_t symbol_count;
+    size_t symbol_capacity;
+
+    object_fixup_t* fixups;
+    size_t fixup_count;
+    size_t fixup_capacity;
+
+    // Numbered local labels never become symbols: object_encode() resolves
+    // them within the buffer it is given, which holds whole functions
+    size_t* label_offsets;   // Indexed by label value - ASM_RETURN_LABEL
+    size_t label_capacity;
+    object_label_fixup_t* label_fixups;
+    size_t label_fixup_count;
+    size_t label_fixup_capacity;
+
+    int failed;              // An instruction could not be encoded
+    asm_instr_t failed_instr;
+};
+
+// Object lifecycle
+object_t* object_create(void);
+void object_destroy(object_t* object);
+
+/**
+ * @brief Appends machine code for buffered instructions to .text
+ *
+ * Labels define symbols at the current position; comments are skipped.
+ * Jumps always use 32-bit displacements. Jumps to ASM_OPERAND_LABEL labels
+ * must find their label in the same buffer.
+ *
+ * @return int 1 on success, 0 if an instruction has no encoding here (it is
+ *         kept in failed_instr)
+ */
+int object_encode(object_t* object, const asm_instr_t* instrs, size_t count);
+
+// Append a NUL-terminated string to .data under label; value uses the
+// escapes of a gas .string directive, as written in the source
+void object_add_string(object_t* object, const char* label, const char* value);
+
+// Export name (interned) from the object
+void object_set_global(object_t* object, const char* name);
+
+/**
+ * @brief Resolves references and writes the object as ELF64 x86-64
+ *
+ * Branches to symbols defined in .text are resolved in place; data
+ * references and calls to undefined symbols become relocations.
+ *
+ * @return int 1 on success, 0 if a jump targets an undefined .L label or
+ *         the write fails
+ */
+int object_write(object_t* object, FILE* output);
+
+#endif // OBJECT_H
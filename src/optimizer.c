@@ -0,0 +1,1292 @@
+// src/optimizer.c
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "optimizer.h"
+
+// Fold/DCE rounds per function before giving up on a fixed point
+#define OPTIMIZER_MAX_ROUNDS 4
+
+// Largest loop condition, in IR instructions, copied to the bottom of the loop
+#define OPTIMIZER_ROTATE_LIMIT 8
+
+void optimizer_options_init(optimizer_options_t* options) {
+    options->level = 0;
+    options->inline_threshold = OPTIMIZER_DEFAULT_INLINE_THRESHOLD;
+}
+
+// Helper: Two's complement wrap of a result to the 64-bit registers that
+// generated code computes int in, so folding matches unoptimized code
+static long optimizer_wrap(unsigned long value) {
+    return (long)value;
+}
+
+// Helper: value truncated to type and sign-extended back, as the movslq /
+// movsbq after a call does to its int or char result
+static long optimizer_narrow(long value, data_type_t type) {
+    return type == TYPE_CHAR ? (long)(signed char)value : (long)(int)value;
+}
+
+// Constant evaluation
+int optimizer_eval_binary(ast_operator_t oper, long left, long right, long* result) {
+    switch (oper) {
+        case OP_ADD: *result = optimizer_wrap((unsigned long)left + (unsigned long)right); return 1;
+        case OP_SUB: *result = optimizer_wrap((unsigned long)left - (unsigned long)right); return 1;
+        case OP_MUL: *result = optimizer_wrap((unsigned long)left * (unsigned long)right); return 1;
+        case OP_DIV:
+        case OP_MOD:
+            // Keep the trap of the division instruction
+            if (right == 0 || (left == LONG_MIN && right == -1)) return 0;
+            *result = oper == OP_DIV ? left / right : left % right;
+            return 1;
+        case OP_EQ: *result = left == right; return 1;
+        case OP_NE: *result = left != right; return 1;
+        case OP_LT: *result = left < right; return 1;
+        case OP_LE: *result = left <= right; return 1;
+        case OP_GT: *result = left > right; return 1;
+        case OP_GE: *result = left >= right; return 1;
+        case OP_AND: *result = left != 0 && right != 0; return 1;
+        case OP_OR: *result = left != 0 || right != 0; return 1;
+        default: return 0;
+    }
+}
+
+int optimizer_eval_unary(ast_operator_t oper, long operand, long* result) {
+    switch (oper) {
+        case OP_NEG: *result = optimizer_wrap(0UL - (unsigned long)operand); return 1;
+        case OP_POS: *result = operand; return 1;
+        case OP_NOT: *result = operand == 0; return 1;
+        default: return 0;
+    }
+}
+
+// AST constant folding
+
+// Helper: True if value can be an int literal (wider results stay in IR)
+static int optimizer_fits_number(long value) {
+    return value >= INT_MIN && value <= INT_MAX;
+}
+
+// Helper: Replace an expression node by the literal value
+static void optimizer_make_number(ast_node_t* node, long value) {
+    node->type = AST_NUMBER;
+    node->data_type = TYPE_INT;
+    node->data.number.value = (int)value;
+}
+
+// Helper: Fold the operands of node, then node itself
+static size_t optimizer_fold_expression(ast_node_t* node) {
+    size_t folds = 0;
+    long value;
+
+    switch (node->type) {
+        case AST_BINARY_OP: {
+            ast_node_t* left = node->data.binary_op.left;
+            ast_node_t* right = node->data.binary_op.right;
+            folds += optimizer_fold_expression(left);
+            folds += optimizer_fold_expression(right);
+
+            if (node->data.binary_op.oper == OP_ASSIGN || left->type != AST_NUMBER) break;
+
+            // A constant left side decides && and || without evaluating the right
+            ast_operator_t oper = node->data.binary_op.oper;
+            int decided = (oper == OP_AND && left->data.number.value == 0) ||
+                          (oper == OP_OR && left->data.number.value != 0);
+
+            if (decided) {
+                value = oper == OP_OR;
+            } else if (right->type != AST_NUMBER ||
+                       !optimizer_eval_binary(oper, left->data.number.value,
+                                              right->data.number.value, &value) ||
+                       !optimizer_fits_number(value)) {
+                break;
+            }
+
+            ast_destroy(left);
+            ast_destroy(right);
+            optimizer_make_number(node, value);
+            folds++;
+            break;
+        }
+
+        case AST_UNARY_OP: {
+            ast_node_t* operand = node->data.unary_op.operand;
+            folds += optimizer_fold_expression(operand);
+
+            if (operand->type == AST_NUMBER &&
+                optimizer_eval_unary(node->data.unary_op.oper, operand->data.number.value, &value) &&
+                optimizer_fits_number(value)) {
+                ast_destroy(operand);
+                optimizer_make_number(node, value);
+                folds++;
+            }
+            break;
+        }
+
+        case AST_FUNCTION_CALL:
+            for (size_t i = 0; i < node->data.function_call.argument_count; i++) {
+                folds += optimizer_fold_expression(node->data.function_call.arguments[i]);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return folds;
+}
+
+size_t optimizer_fold_ast(ast_node_t* node) {
+    if (!node) return 0;
+
+    size_t folds = 0;
+    switch (node->type) {
+        case AST_PROGRAM:
+            for (size_t i = 0; i < node->data.program.declaration_count; i++) {
+                folds += optimizer_fold_ast(node->data.program.declarations[i]);
+            }
+            break;
+
+        case AST_FUNCTION_DECL:
+            folds += optimizer_fold_ast(node->data.function_decl.body);
+            break;
+
+        case AST_VARIABLE_DECL:
+            if (node->data.variable_decl.initializer) {
+                folds += optimizer_fold_expression(node->data.variable_decl.initializer);
+            }
+            break;
+
+        case AST_COMPOUND_STMT:
+            for (size_t i = 0; i < node->data.compound_stmt.statement_count; i++) {
+                folds += optimizer_fold_ast(node->data.compound_stmt.statements[i]);
+            }
+            break;
+
+        case AST_IF_STMT:
+            folds += optimizer_fold_expression(node->data.if_stmt.condition);
+            folds += optimizer_fold_ast(node->data.if_stmt.then_stmt);
+            folds += optimizer_fold_ast(node->data.if_stmt.else_stmt);
+            break;
+
+        case AST_WHILE_STMT:
+            folds += optimizer_fold_expression(node->data.while_stmt.condition);
+            folds += optimizer_fold_ast(node->data.while_stmt.body);
+            break;
+
+        case AST_FOR_STMT:
+            folds += optimizer_fold_ast(node->data.for_stmt.init);
+            if (node->data.for_stmt.condition) {
+                folds += optimizer_fold_expression(node->data.for_stmt.condition);
+            }
+            if (node->data.for_stmt.update) {
+                folds += optimizer_fold_expression(node->data.for_stmt.update);
+            }
+            folds += optimizer_fold_ast(node->data.for_stmt.body);
+            break;
+
+        case AST_RETURN_STMT:
+            if (node->data.return_stmt.value) {
+                folds += optimizer_fold_expression(node->data.return_stmt.value);
+            }
+            break;
+
+        case AST_EXPRESSION_STMT:
+            folds += optimizer_fold_expression(node->data.expression_stmt.expression);
+            break;
+
+        default:
+            folds += optimizer_fold_expression(node);
+            break;
+    }
+
+    return folds;
+}
+
+// IR constant folding and propagation
+
+// Known constants while scanning a function
+typedef struct {
+    int* def_count;       // Definitions of each vreg
+    unsigned char* global;// Single definition with a constant value
+    int* local_block;     // Block in which local_value holds, or -1
+    long* value;
+} optimizer_constants_t;
+
+// Helper: Constant value of operand vreg in block, if known
+static int optimizer_lookup(const optimizer_constants_t* constants, int vreg, int block, long* value) {
+    if (vreg < 0) return 0;
+    if (constants->global[vreg] || constants->local_block[vreg] == block) {
+        *value = constants->value[vreg];
+        return 1;
+    }
+    return 0;
+}
+
+// Helper: Record what instr in block wrote to its dst
+static void optimizer_record(optimizer_constants_t* constants, const ir_instr_t* instr, int block) {
+    int dst = instr->dst;
+    if (dst == IR_NO_VREG) return;
+
+    if (instr->opcode == IR_CONST) {
+        constants->value[dst] = instr->imm;
+        constants->local_block[dst] = block;
+        if (constants->def_count[dst] == 1) constants->global[dst] = 1;
+    } else {
+        constants->local_block[dst] = -1;
+    }
+}
+
+// Helper: Turn instr into dst = value
+static void optimizer_make_const(ir_instr_t* instr, long value) {
+    instr->opcode = IR_CONST;
+    instr->imm = value;
+    instr->src1 = IR_NO_VREG;
+    instr->src2 = IR_NO_VREG;
+}
+
+// Helper: Operator giving the same result with the operands swapped
+static ast_operator_t optimizer_swapped_operator(ast_operator_t oper) {
+    switch (oper) {
+        case OP_ADD: case OP_MUL: case OP_EQ: case OP_NE: return oper;
+        case OP_LT: return OP_GT;
+        case OP_LE: return OP_GE;
+        case OP_GT: return OP_LT;
+        case OP_GE: return OP_LE;
+        default: return OP_INVALID;
+    }
+}
+
+// Helper: Fold or simplify one instruction; returns 1 if it changed
+static int optimizer_fold_instr(optimizer_constants_t* constants, ir_instr_t* instr, int block,
+                                optimizer_stats_t* stats) {
+    long left, right, result;
+
+    switch (instr->opcode) {
+        case IR_MOV:
+            if (!optimizer_lookup(constants, instr->src1, block, &left)) return 0;
+            optimizer_make_const(instr, left);
+            stats->ir_folds++;
+            return 1;
+
+        case IR_NARROW:
+            if (!optimizer_lookup(constants, instr->src1, block, &left)) return 0;
+            optimizer_make_const(instr, optimizer_narrow(left, instr->type));
+            stats->ir_folds++;
+            return 1;
+
+        case IR_UNARY:
+            if (!optimizer_lookup(constants, instr->src1, block, &left) ||
+                !optimizer_eval_unary(instr->oper, left, &result)) {
+                return 0;
+            }
+            optimizer_make_const(instr, result);
+            stats->ir_folds++;
+            return 1;
+
+        case IR_BINARY: {
+            int left_known = optimizer_lookup(constants, instr->src1, block, &left);
+            int right_known;
+            if (instr->src2 == IR_IMM_OPERAND) {
+                right = instr->imm;
+                right_known = 1;
+            } else {
+                right_known = optimizer_lookup(constants, instr->src2, block, &right);
+            }
+
+            if (left_known && right_known && optimizer_eval_binary(instr->oper, left, right, &result)) {
+                optimizer_make_const(instr, result);
+                stats->ir_folds++;
+                return 1;
+            }
+
+            // The divisor of idiv cannot be an immediate
+            if (instr->oper == OP_DIV || instr->oper == OP_MOD) return 0;
+
+            // Instructions take sign-extended 32-bit immediates only
+            if (right_known && instr->src2 != IR_IMM_OPERAND && right >= INT_MIN && right <= INT_MAX) {
+                instr->src2 = IR_IMM_OPERAND;
+                instr->imm = right;
+                stats->ir_immediates++;
+                return 1;
+            }
+            if (left_known && !right_known && optimizer_swapped_operator(instr->oper) != OP_INVALID &&
+                left >= INT_MIN && left <= INT_MAX) {
+                instr->oper = optimizer_swapped_operator(instr->oper);
+                instr->src1 = instr->src2;
+                instr->src2 = IR_IMM_OPERAND;
+                instr->imm = left;
+                stats->ir_immediates++;
+                return 1;
+            }
+            return 0;
+        }
+
+        case IR_RETURN:
+            if (!optimizer_lookup(constants, instr->src1, block, &left)) return 0;
+            instr->src1 = IR_IMM_OPERAND;
+            instr->imm = left;
+            stats->ir_immediates++;
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+size_t optimizer_fold_ir(ir_function_t* function, optimizer_stats_t* stats) {
+    if (!ir_build_cfg(function) || function->vreg_count == 0) return 0;
+
+    size_t vreg_count = function->vreg_count;
+    optimizer_constants_t constants;
+    constants.def_count = calloc(vreg_count, sizeof(int));
+    constants.global = calloc(vreg_count, sizeof(unsigned char));
+    constants.local_block = malloc(vreg_count * sizeof(int));
+    constants.value = malloc(vreg_count * sizeof(long));
+
+    size_t changes = 0;
+    if (constants.def_count && constants.global && constants.local_block && constants.value) {
+        for (size_t i = 0; i < function->instr_count; i++) {
+            if (function->instrs[i].dst != IR_NO_VREG) constants.def_count[function->instrs[i].dst]++;
+        }
+
+        // A single definition reaches every use, so its constant holds in all
+        // blocks; other values are only tracked to the end of their block.
+        // Folding can expose constants to earlier blocks (loop headers), so
+        // repeat until nothing changes.
+        int changed = 1;
+        while (changed) {
+            changed = 0;
+            for (size_t v = 0; v < vreg_count; v++) constants.local_block[v] = -1;
+
+            for (size_t b = 0; b < function->block_count; b++) {
+                ir_block_t* block = &function->blocks[b];
+                for (size_t i = block->start; i < block->end; i++) {
+                    ir_instr_t* instr = &function->instrs[i];
+                    if (optimizer_fold_instr(&constants, instr, (int)b, stats)) {
+                        changed = 1;
+                        changes++;
+                    }
+                    optimizer_record(&constants, instr, (int)b);
+                }
+            }
+        }
+    }
+
+    free(constants.def_count);
+    free(constants.global);
+    free(constants.local_block);
+    free(constants.value);
+
+    // Block boundaries are unchanged, but uses moved into immediates
+    if (changes > 0) ir_invalidate_cfg(function);
+    return changes;
+}
+
+// AST dead code elimination
+
+// Helper: Simplify a statement; returns its replacement, or NULL to drop it
+static ast_node_t* optimizer_prune_statement(ast_node_t* node, size_t* pruned) {
+    if (!node) return NULL;
+
+    switch (node->type) {
+        case AST_FUNCTION_DECL:
+            node->data.function_decl.body = optimizer_prune_statement(node->data.function_decl.body, pruned);
+            return node;
+
+        case AST_COMPOUND_STMT: {
+            size_t kept = 0;
+            size_t count = node->data.compound_stmt.statement_count;
+            ast_node_t** statements = node->data.compound_stmt.statements;
+
+            for (size_t i = 0; i < count; i++) {
+                ast_node_t* statement = optimizer_prune_statement(statements[i], pruned);
+                if (statement) statements[kept++] = statement;
+
+                // Nothing after a return can run
+                if (statement && statement->type == AST_RETURN_STMT) {
+                    for (size_t j = i + 1; j < count; j++) {
+                        ast_destroy(statements[j]);
+                        (*pruned)++;
+                    }
+                    break;
+                }
+            }
+            node->data.compound_stmt.statement_count = kept;
+            return node;
+        }
+
+        case AST_IF_STMT: {
+            node->data.if_stmt.then_stmt = optimizer_prune_statement(node->data.if_stmt.then_stmt, pruned);
+            node->data.if_stmt.else_stmt = optimizer_prune_statement(node->data.if_stmt.else_stmt, pruned);
+
+            ast_node_t* condition = node->data.if_stmt.condition;
+            if (condition->type != AST_NUMBER) return node;
+
+            ast_node_t** taken = condition->data.number.value ? &node->data.if_stmt.then_stmt
+                                                              : &node->data.if_stmt.else_stmt;
+
+            // A bare declaration would leak its name into the enclosing scope
+            if (*taken && (*taken)->type == AST_VARIABLE_DECL) return node;
+
+            ast_node_t* replacement = *taken;
+            *taken = NULL;
+            ast_destroy(node);
+            (*pruned)++;
+            return replacement;
+        }
+
+        case AST_WHILE_STMT:
+            node->data.while_stmt.body = optimizer_prune_statement(node->data.while_stmt.body, pruned);
+            if (node->data.while_stmt.condition->type == AST_NUMBER &&
+                node->data.while_stmt.condition->data.number.value == 0) {
+                ast_destroy(node);
+                (*pruned)++;
+                return NULL;
+            }
+            return node;
+
+        case AST_FOR_STMT: {
+            node->data.for_stmt.body = optimizer_prune_statement(node->data.for_stmt.body, pruned);
+
+            ast_node_t* condition = node->data.for_stmt.condition;
+            ast_node_t* init = node->data.for_stmt.init;
+            if (!condition || condition->type != AST_NUMBER || condition->data.number.value != 0) {
+                return node;
+            }
+
+            // Only the initializer runs; a declaration there is scoped to the loop
+            if (init && init->type == AST_VARIABLE_DECL) return node;
+
+            node->data.for_stmt.init = NULL;
+            ast_destroy(node);
+            (*pruned)++;
+            return init;
+        }
+
+        default:
+            return node;
+    }
+}
+
+size_t optimizer_prune_ast(ast_node_t* node) {
+    if (!node) return 0;
+
+    size_t pruned = 0;
+    if (node->type == AST_PROGRAM) {
+        for (size_t i = 0; i < node->data.program.declaration_count; i++) {
+            optimizer_prune_statement(node->data.program.declarations[i], &pruned);
+        }
+    } else {
+        optimizer_prune_statement(node, &pruned);
+    }
+    return pruned;
+}
+
+// IR dead code elimination
+
+// Helper: True if instr only computes its dst
+static int optimizer_is_pure(const ir_instr_t* instr) {
+    switch (instr->opcode) {
+        case IR_CONST:
+        case IR_STRING:
+        case IR_MOV:
+        case IR_NARROW:
+        case IR_BINARY:
+        case IR_UNARY:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// Helper: Drop the instructions marked in removed
+static void optimizer_compact(ir_function_t* function, const unsigned char* removed) {
+    size_t kept = 0;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        if (removed[i]) {
+            free(function->instrs[i].args);
+        } else {
+            function->instrs[kept++] = function->instrs[i];
+        }
+    }
+    function->instr_count = kept;
+    ir_invalidate_cfg(function);
+}
+
+// Helper: Constant tested by the conditional jump at index of block, if known
+static int optimizer_branch_constant(const ir_function_t* function, const ir_block_t* block,
+                                     size_t index, const int* def_index, long* value) {
+    int vreg = function->instrs[index].src1;
+
+    // The last write in the block wins, otherwise a single definition elsewhere
+    for (size_t i = index; i > block->start; i--) {
+        const ir_instr_t* instr = &function->instrs[i - 1];
+        if (instr->dst != vreg) continue;
+        if (instr->opcode != IR_CONST) return 0;
+        *value = instr->imm;
+        return 1;
+    }
+
+    if (def_index[vreg] < 0) return 0;
+    const ir_instr_t* def = &function->instrs[def_index[vreg]];
+    if (def->opcode != IR_CONST) return 0;
+    *value = def->imm;
+    return 1;
+}
+
+// Helper: Resolve constant branches and delete blocks the entry cannot reach
+static size_t optimizer_remove_unreachable(ir_function_t* function, unsigned char* removed) {
+    size_t changes = 0;
+
+    // Definition index of vregs written exactly once (-1 otherwise)
+    int* def_index = malloc(function->vreg_count * sizeof(int));
+    int* stack = malloc(function->block_count * sizeof(int));
+    unsigned char* reached = calloc(function->block_count, 1);
+    if (!def_index || !stack || !reached) goto done;
+
+    for (int v = 0; v < function->vreg_count; v++) def_index[v] = -2;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        int dst = function->instrs[i].dst;
+        if (dst != IR_NO_VREG) def_index[dst] = def_index[dst] == -2 ? (int)i : -1;
+    }
+    for (int v = 0; v < function->vreg_count; v++) {
+        if (def_index[v] == -2) def_index[v] = -1;
+    }
+
+    for (size_t b = 0; b < function->block_count; b++) {
+        ir_block_t* block = &function->blocks[b];
+        size_t last = block->end - 1;
+        ir_instr_t* instr = &function->instrs[last];
+        long value;
+
+        if ((instr->opcode != IR_JUMP_ZERO && instr->opcode != IR_JUMP_NONZERO) ||
+            !optimizer_branch_constant(function, block, last, def_index, &value)) {
+            continue;
+        }
+
+        if ((value == 0) == (instr->opcode == IR_JUMP_ZERO)) {
+            instr->opcode = IR_JUMP;
+            instr->src1 = IR_NO_VREG;
+        } else {
+            removed[last] = 1;
+        }
+        changes++;
+    }
+
+    // Walk the CFG from the entry; a folded branch keeps only the live edge
+    size_t depth = 0;
+    stack[depth++] = 0;
+    reached[0] = 1;
+    while (depth > 0) {
+        ir_block_t* block = &function->blocks[stack[--depth]];
+        ir_instr_t* last = &function->instrs[block->end - 1];
+
+        for (size_t s = 0; s < block->successor_count; s++) {
+            int successor = block->successors[s];
+            if (last->opcode == IR_JUMP && successor != function->label_blocks[last->imm]) continue;
+            if (removed[block->end - 1] && s > 0) continue;   // Fallthrough is successors[0]
+            if (!reached[successor]) {
+                reached[successor] = 1;
+                stack[depth++] = successor;
+            }
+        }
+    }
+
+    for (size_t b = 0; b < function->block_count; b++) {
+        if (reached[b]) continue;
+        for (size_t i = function->blocks[b].start; i < function->blocks[b].end; i++) {
+            if (!removed[i]) changes++;
+            removed[i] = 1;
+        }
+    }
+
+done:
+    free(def_index);
+    free(stack);
+    free(reached);
+    return changes;
+}
+
+// Helper: Remove jumps to the next instruction and labels nobody targets
+static size_t optimizer_remove_redundant_jumps(ir_function_t* function, unsigned char* removed) {
+    size_t changes = 0;
+    size_t* references = calloc(function->label_count + 1, sizeof(size_t));
+    if (!references) return 0;
+
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->opcode != IR_JUMP && instr->opcode != IR_JUMP_ZERO &&
+            instr->opcode != IR_JUMP_NONZERO) {
+            continue;
+        }
+
+        // Jumping over nothing but labels is falling through
+        size_t next = i + 1;
+        while (next < function->instr_count && function->instrs[next].opcode == IR_LABEL &&
+               function->instrs[next].imm != instr->imm) {
+            next++;
+        }
+        if (next < function->instr_count && function->instrs[next].opcode == IR_LABEL) {
+            removed[i] = 1;
+            changes++;
+        } else {
+            references[instr->imm]++;
+        }
+    }
+
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->opcode == IR_LABEL && references[instr->imm] == 0) {
+            removed[i] = 1;
+            changes++;
+        }
+    }
+
+    free(references);
+    return changes;
+}
+
+// Helper: Remove side-effect free definitions whose value is never read
+static size_t optimizer_remove_dead_definitions(ir_function_t* function, unsigned char* removed) {
+    if (!ir_compute_liveness(function)) return 0;
+
+    size_t words = function->live_words;
+    unsigned long* live = malloc(words * sizeof(unsigned long));
+    if (!live) return 0;
+
+    // Walking each block backwards from its live-out set also catches
+    // chains of dead temporaries within the block
+    size_t changes = 0;
+    for (size_t b = 0; b < function->block_count; b++) {
+        ir_block_t* block = &function->blocks[b];
+        memcpy(live, block->live_out, words * sizeof(unsigned long));
+
+        for (size_t i = block->end; i > block->start; i--) {
+            ir_instr_t* instr = &function->instrs[i - 1];
+
+            if (instr->dst != IR_NO_VREG && !ir_bitset_test(live, instr->dst)) {
+                if (optimizer_is_pure(instr)) {
+                    removed[i - 1] = 1;
+                    changes++;
+                    continue;
+                }
+                if (instr->opcode == IR_CALL) {
+                    instr->dst = IR_NO_VREG;
+                    changes++;
+                }
+            }
+
+            if (instr->dst != IR_NO_VREG) ir_bitset_clear(live, instr->dst);
+            for (size_t u = 0; u < ir_instr_use_count(instr); u++) {
+                ir_bitset_set(live, ir_instr_use(instr, u));
+            }
+        }
+    }
+
+    free(live);
+    return changes;
+}
+
+size_t optimizer_eliminate_dead_code(ir_function_t* function, optimizer_stats_t* stats) {
+    size_t total = 0;
+
+    // Each step can expose more work for the others
+    for (;;) {
+        if (!ir_build_cfg(function) || function->block_count == 0) break;
+
+        unsigned char* removed = calloc(function->instr_count, 1);
+        if (!removed) break;
+
+        size_t changes = optimizer_remove_unreachable(function, removed);
+        optimizer_compact(function, removed);
+
+        memset(removed, 0, function->instr_count);
+        changes += optimizer_remove_redundant_jumps(function, removed);
+        optimizer_compact(function, removed);
+
+        memset(removed, 0, function->instr_count);
+        changes += optimizer_remove_dead_definitions(function, removed);
+        optimizer_compact(function, removed);
+
+        free(removed);
+        if (changes == 0) break;
+        total += changes;
+    }
+
+    stats->ir_removed += total;
+    return total;
+}
+
+// Function inlining
+
+// Helper: Function of program named name (interned), or NULL
+static ir_function_t* optimizer_find_function(ir_program_t* program, const char* name) {
+    for (size_t i = 0; i < program->function_count; i++) {
+        if (program->functions[i]->name == name) return program->functions[i];
+    }
+    return NULL;
+}
+
+size_t optimizer_inline_cost(const ir_function_t* function) {
+    size_t cost = 0;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_opcode_t opcode = function->instrs[i].opcode;
+        if (opcode == IR_CALL) return (size_t)-1;
+        if (opcode != IR_LABEL && opcode != IR_PARAM) cost++;
+    }
+    return cost;
+}
+
+// Helper: True if calls to callee may be replaced by its body
+static int optimizer_can_inline(const ir_function_t* callee, int threshold) {
+    if (!callee) return 0;
+    return optimizer_inline_cost(callee) <= (size_t)threshold;
+}
+
+// Helper: Caller vreg standing for callee vreg at the current call site
+static int optimizer_map_vreg(ir_function_t* caller, const ir_function_t* callee, int* map, int vreg) {
+    if (vreg < 0) return vreg;
+    if (map[vreg] < 0) map[vreg] = ir_new_vreg(caller, callee->vreg_flags[vreg]);
+    return map[vreg];
+}
+
+// Helper: Append callee's body in place of call to caller
+// Parameters become copies of the argument vregs and every return stores
+// the result and jumps past the inlined body. Int and char results are
+// narrowed there, as the call would have narrowed them in %rax.
+static int optimizer_inline_call(ir_function_t* caller, const ir_instr_t* call, const ir_function_t* callee) {
+    int* vreg_map = malloc((callee->vreg_count + 1) * sizeof(int));
+    int* label_map = malloc((callee->label_count + 1) * sizeof(int));
+    if (!vreg_map || !label_map) {
+        free(vreg_map);
+        free(label_map);
+        return 0;
+    }
+
+    for (int v = 0; v < callee->vreg_count; v++) vreg_map[v] = -1;
+    for (int l = 0; l < callee->label_count; l++) label_map[l] = ir_new_label(caller);
+    int end_label = ir_new_label(caller);
+
+    for (size_t i = 0; i < callee->instr_count; i++) {
+        ir_instr_t source = callee->instrs[i];
+        int dst = optimizer_map_vreg(caller, callee, vreg_map, source.dst);
+        ir_instr_t* instr;
+
+        switch (source.opcode) {
+            case IR_PARAM:
+                if ((size_t)source.imm >= call->arg_count) break;
+                instr = ir_emit(caller, IR_MOV);
+                instr->dst = dst;
+                instr->src1 = call->args[source.imm];
+                instr->type = source.type;
+                break;
+
+            case IR_RETURN:
+                if (call->dst != IR_NO_VREG) {
+                    // A return without a value leaves 0 in %rax
+                    int src = optimizer_map_vreg(caller, callee, vreg_map, source.src1);
+                    int narrow = call->type == TYPE_INT || call->type == TYPE_CHAR;
+                    instr = ir_emit(caller, src < 0 ? IR_CONST : narrow ? IR_NARROW : IR_MOV);
+                    instr->dst = call->dst;
+                    instr->src1 = src >= 0 ? src : IR_NO_VREG;
+                    instr->imm = source.src1 == IR_IMM_OPERAND ? optimizer_narrow(source.imm, call->type) : 0;
+                    instr->type = call->type;
+                }
+                instr = ir_emit(caller, IR_JUMP);
+                instr->imm = end_label;
+                break;
+
+            default:
+                instr = ir_emit(caller, source.opcode);
+                *instr = source;
+                instr->dst = dst;
+                instr->src1 = optimizer_map_vreg(caller, callee, vreg_map, source.src1);
+                instr->src2 = optimizer_map_vreg(caller, callee, vreg_map, source.src2);
+                instr->args = NULL;
+                instr->arg_count = 0;
+                if (source.opcode == IR_LABEL || source.opcode == IR_JUMP ||
+                    source.opcode == IR_JUMP_ZERO || source.opcode == IR_JUMP_NONZERO) {
+                    instr->imm = label_map[source.imm];
+                }
+                break;
+        }
+    }
+
+    ir_emit(caller, IR_LABEL)->imm = end_label;
+
+    free(vreg_map);
+    free(label_map);
+    return 1;
+}
+
+// Helper: Inline every eligible call of function; returns the number inlined
+static size_t optimizer_inline_function(ir_program_t* program, ir_function_t* function, int threshold) {
+    // Rebuild the instruction list, splicing callee bodies in at call sites
+    ir_instr_t* instrs = function->instrs;
+    size_t count = function->instr_count;
+    size_t inlined = 0;
+
+    function->instr_capacity = count + 16;
+    function->instrs = malloc(function->instr_capacity * sizeof(ir_instr_t));
+    function->instr_count = 0;
+    if (!function->instrs) {
+        function->instrs = instrs;
+        function->instr_count = count;
+        function->instr_capacity = count;
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        ir_instr_t* instr = &instrs[i];
+        ir_function_t* callee = instr->opcode == IR_CALL ? optimizer_find_function(program, instr->name) : NULL;
+
+        if (callee && callee != function && optimizer_can_inline(callee, threshold) &&
+            optimizer_inline_call(function, instr, callee)) {
+            free(instr->args);
+            inlined++;
+            continue;
+        }
+
+        ir_instr_t* copy = ir_emit(function, instr->opcode);
+        if (!copy) break;
+        *copy = *instr;
+    }
+
+    free(instrs);
+    ir_invalidate_cfg(function);
+    return inlined;
+}
+
+size_t optimizer_inline_calls(ir_program_t* program, int threshold, optimizer_stats_t* stats) {
+    if (threshold <= 0) return 0;
+
+    size_t inlined = 0;
+    for (size_t i = 0; i < program->function_count; i++) {
+        ir_function_t* function = program->functions[i];
+
+        int has_calls = 0;
+        for (size_t j = 0; j < function->instr_count && !has_calls; j++) {
+            has_calls = function->instrs[j].opcode == IR_CALL;
+        }
+        if (has_calls) inlined += optimizer_inline_function(program, function, threshold);
+    }
+
+    stats->inlined_calls += inlined;
+    return inlined;
+}
+
+// Loop optimization
+
+// Loop in the instruction list: the label at header and the last backward
+// jump to it at latch. Structured statements keep each body contiguous.
+typedef struct {
+    size_t header;
+    size_t latch;
+} optimizer_loop_t;
+
+// Helper: True if instr may transfer control to the label in imm
+static int optimizer_is_jump(const ir_instr_t* instr) {
+    return instr->opcode == IR_JUMP || instr->opcode == IR_JUMP_ZERO ||
+           instr->opcode == IR_JUMP_NONZERO;
+}
+
+// Helper: Position of every label of function (-1 if absent)
+static int* optimizer_label_positions(const ir_function_t* function) {
+    int* positions = malloc((function->label_count + 1) * sizeof(int));
+    if (!positions) return NULL;
+
+    for (int l = 0; l < function->label_count; l++) positions[l] = -1;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        if (function->instrs[i].opcode == IR_LABEL) positions[function->instrs[i].imm] = (int)i;
+    }
+    return positions;
+}
+
+// Helper: Locate the loop headed by label; fails unless code outside the
+// loop can only enter it by falling into the header
+static int optimizer_find_loop(const ir_function_t* function, int label, optimizer_loop_t* loop) {
+    int* positions = optimizer_label_positions(function);
+    if (!positions) return 0;
+
+    int header = positions[label];
+    int latch = -1;
+    for (size_t i = header + 1; header >= 0 && i < function->instr_count; i++) {
+        if (optimizer_is_jump(&function->instrs[i]) && function->instrs[i].imm == label) latch = (int)i;
+    }
+
+    int ok = latch > header;
+    for (size_t i = 0; ok && i < function->instr_count; i++) {
+        if (!optimizer_is_jump(&function->instrs[i])) continue;
+        int target = positions[function->instrs[i].imm];
+        int inside = (int)i >= header && (int)i <= latch;
+        if (target >= header && target <= latch && !inside) ok = 0;
+    }
+
+    free(positions);
+    loop->header = header;
+    loop->latch = latch;
+    return ok;
+}
+
+// Helper: Make room for count more instructions
+static int optimizer_reserve(ir_function_t* function, size_t count) {
+    if (function->instr_count + count > function->instr_capacity) {
+        size_t capacity = function->instr_capacity * 2 + count;
+        ir_instr_t* grown = realloc(function->instrs, capacity * sizeof(ir_instr_t));
+        if (!grown) return 0;
+        function->instrs = grown;
+        function->instr_capacity = capacity;
+    }
+    return 1;
+}
+
+// Helper: Insert count instructions before position
+static int optimizer_insert(ir_function_t* function, size_t position, const ir_instr_t* instrs, size_t count) {
+    if (!optimizer_reserve(function, count)) return 0;
+
+    memmove(&function->instrs[position + count], &function->instrs[position],
+            (function->instr_count - position) * sizeof(ir_instr_t));
+    memcpy(&function->instrs[position], instrs, count * sizeof(ir_instr_t));
+    function->instr_count += count;
+    ir_invalidate_cfg(function);
+    return 1;
+}
+
+// Helper: Definitions of each vreg in the whole function and inside loop
+static int* optimizer_count_definitions(const ir_function_t* function, const optimizer_loop_t* loop) {
+    int* counts = calloc(2 * (function->vreg_count + 1), sizeof(int));
+    if (!counts) return NULL;
+
+    int* loop_counts = counts + function->vreg_count + 1;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        int dst = function->instrs[i].dst;
+        if (dst == IR_NO_VREG) continue;
+        counts[dst]++;
+        if (i > loop->header && i < loop->latch) loop_counts[dst]++;
+    }
+    return counts;
+}
+
+// Helper: True if instr computes the same temporary on every iteration
+static int optimizer_is_invariant(const ir_function_t* function, const ir_instr_t* instr,
+                                  const int* def_count, const int* loop_defs) {
+    if (instr->opcode != IR_BINARY && instr->opcode != IR_UNARY) return 0;
+
+    // Division may trap where the loop would not have executed it, and
+    // comparisons stay next to the branch that tests them
+    if (instr->oper == OP_DIV || instr->oper == OP_MOD) return 0;
+    if (instr->oper >= OP_EQ && instr->oper <= OP_GE) return 0;
+
+    if ((function->vreg_flags[instr->dst] & IR_VREG_VARIABLE) || def_count[instr->dst] != 1) return 0;
+    for (size_t u = 0; u < ir_instr_use_count(instr); u++) {
+        if (loop_defs[ir_instr_use(instr, u)] > 0) return 0;
+    }
+    return 1;
+}
+
+// Helper: Move loop-invariant computations in front of the loop header
+static size_t optimizer_hoist_invariants(ir_function_t* function, const optimizer_loop_t* loop) {
+    size_t length = loop->latch - loop->header + 1;
+    int* def_count = optimizer_count_definitions(function, loop);
+    ir_instr_t* reordered = malloc(length * sizeof(ir_instr_t));
+    unsigned char* hoisted = calloc(length, 1);
+    size_t count = 0;
+
+    if (def_count && reordered && hoisted) {
+        int* loop_defs = def_count + function->vreg_count + 1;
+
+        // In program order an invariant can feed later ones
+        for (size_t i = loop->header + 1; i < loop->latch; i++) {
+            ir_instr_t* instr = &function->instrs[i];
+            if (!optimizer_is_invariant(function, instr, def_count, loop_defs)) continue;
+            hoisted[i - loop->header] = 1;
+            loop_defs[instr->dst] = 0;
+            count++;
+        }
+
+        // Hoisted instructions first, then the loop in its original order
+        size_t next = 0;
+        for (size_t pass = 0; pass < 2; pass++) {
+            for (size_t i = 0; i < length; i++) {
+                if (hoisted[i] == (pass == 0)) reordered[next++] = function->instrs[loop->header + i];
+            }
+        }
+        if (count > 0) {
+            memcpy(&function->instrs[loop->header], reordered, length * sizeof(ir_instr_t));
+            ir_invalidate_cfg(function);
+        }
+    }
+
+    free(def_count);
+    free(reordered);
+    free(hoisted);
+    return count;
+}
+
+// Helper: Step of instr at index if it is vreg = vreg + constant, written
+// directly or as a copy of the temporary computed just before
+static int optimizer_induction_step(const ir_function_t* function, size_t index, int vreg, long* step) {
+    const ir_instr_t* instr = &function->instrs[index];
+    if (instr->opcode == IR_MOV && index > 0 && function->instrs[index - 1].dst == instr->src1) {
+        instr = &function->instrs[index - 1];
+    }
+
+    if (instr->opcode != IR_BINARY || instr->src1 != vreg || instr->src2 != IR_IMM_OPERAND) return 0;
+    if (instr->oper == OP_ADD) {
+        *step = instr->imm;
+        return 1;
+    }
+    if (instr->oper == OP_SUB) {
+        *step = -instr->imm;
+        return 1;
+    }
+    return 0;
+}
+
+// Helper: True if every definition of vreg in loop is an induction step
+// whose scaled step fits an immediate; records the definitions and steps
+static int optimizer_is_induction(const ir_function_t* function, const optimizer_loop_t* loop, int vreg,
+                                  long scale, size_t* defs, long* steps, size_t* count) {
+    *count = 0;
+    for (size_t i = loop->header + 1; i < loop->latch; i++) {
+        if (function->instrs[i].dst != vreg) continue;
+
+        long step;
+        if (!optimizer_induction_step(function, i, vreg, &step)) return 0;
+        if (step > INT_MAX / labs(scale) || step < INT_MIN / labs(scale)) return 0;
+        defs[*count] = i;
+        steps[*count] = step * scale;
+        (*count)++;
+    }
+    return *count > 0;
+}
+
+// Helper: Replace one multiplication of an induction variable by a constant
+// with a running product updated alongside the variable
+static size_t optimizer_reduce_induction(ir_function_t* function, const optimizer_loop_t* loop) {
+    size_t length = loop->latch - loop->header;
+    int* def_count = optimizer_count_definitions(function, loop);
+    size_t* defs = malloc(length * sizeof(size_t));
+    long* steps = malloc(length * sizeof(long));
+    size_t reduced = 0;
+
+    for (size_t m = loop->header + 1; def_count && defs && steps && m < loop->latch && !reduced; m++) {
+        ir_instr_t multiply = function->instrs[m];
+        size_t count;
+
+        // Shifts are already as cheap as the add that would replace them
+        if (multiply.opcode != IR_BINARY || multiply.oper != OP_MUL || multiply.src2 != IR_IMM_OPERAND) continue;
+        if (multiply.imm == 0 || (labs(multiply.imm) & (labs(multiply.imm) - 1)) == 0) continue;
+        if ((function->vreg_flags[multiply.dst] & IR_VREG_VARIABLE) || def_count[multiply.dst] != 1) continue;
+        if (!optimizer_is_induction(function, loop, multiply.src1, multiply.imm, defs, steps, &count)) continue;
+
+        // The updates and the initial product cannot fail once room is made
+        int product = ir_new_vreg(function, IR_VREG_VARIABLE);
+        if (product == IR_NO_VREG || !optimizer_reserve(function, count + 1)) break;
+
+        // Rewrite the multiply before any insertion can move it
+        ir_instr_t* copy = &function->instrs[m];
+        copy->opcode = IR_MOV;
+        copy->oper = OP_INVALID;
+        copy->src1 = product;
+        copy->src2 = IR_NO_VREG;
+        copy->imm = 0;
+
+        // Until the variable changes again the product can be read directly,
+        // which usually leaves the copy dead
+        for (size_t i = m + 1; i < function->instr_count; i++) {
+            ir_instr_t* instr = &function->instrs[i];
+            if (instr->opcode == IR_LABEL) break;
+            if (instr->src1 == multiply.dst) instr->src1 = product;
+            if (instr->src2 == multiply.dst) instr->src2 = product;
+            for (size_t a = 0; a < instr->arg_count; a++) {
+                if (instr->args[a] == multiply.dst) instr->args[a] = product;
+            }
+            if (instr->dst == multiply.src1 || optimizer_is_jump(instr) || instr->opcode == IR_RETURN) break;
+        }
+
+        // product = variable * scale holds throughout the loop; the updates
+        // go in from the back so the recorded positions stay valid
+        ir_instr_t update = multiply;
+        update.oper = OP_ADD;
+        update.dst = product;
+        update.src1 = product;
+        for (size_t d = count; d > 0; d--) {
+            update.imm = steps[d - 1];
+            optimizer_insert(function, defs[d - 1] + 1, &update, 1);
+        }
+
+        ir_instr_t initial = multiply;
+        initial.dst = product;
+        optimizer_insert(function, loop->header, &initial, 1);
+        reduced = 1;
+    }
+
+    free(def_count);
+    free(defs);
+    free(steps);
+    return reduced;
+}
+
+// Helper: Turn a loop that tests its condition at the top and jumps back
+// unconditionally into a guarded one that tests a copy of the condition at
+// the bottom, leaving one branch per iteration
+static size_t optimizer_rotate_loop(ir_function_t* function, const optimizer_loop_t* loop) {
+    if (function->instrs[loop->latch].opcode != IR_JUMP) return 0;
+
+    // The header block must compute the condition and leave the loop
+    size_t exit = loop->header + 1;
+    while (exit < loop->latch && optimizer_is_pure(&function->instrs[exit])) exit++;
+    if (exit >= loop->latch || exit - loop->header > OPTIMIZER_ROTATE_LIMIT) return 0;
+
+    ir_instr_t test = function->instrs[exit];
+    if (test.opcode != IR_JUMP_ZERO && test.opcode != IR_JUMP_NONZERO) return 0;
+
+    // ... to the code the back jump falls through to
+    int leaves = 0;
+    for (size_t i = loop->latch + 1; i < function->instr_count && function->instrs[i].opcode == IR_LABEL; i++) {
+        if (function->instrs[i].imm == test.imm) leaves = 1;
+    }
+    if (!leaves || !ir_compute_liveness(function)) return 0;
+
+    size_t length = exit - loop->header;
+    int header_block = function->label_blocks[function->instrs[loop->header].imm];
+    int vreg_count = function->vreg_count;
+    int* rename = malloc((vreg_count + 1) * sizeof(int));
+    ir_instr_t* copy = malloc((length + 1) * sizeof(ir_instr_t));
+    if (!rename || !copy) {
+        free(rename);
+        free(copy);
+        return 0;
+    }
+
+    // Temporaries of the condition get fresh vregs in the copy, so each
+    // comparison still feeds only the jump right after it
+    for (int v = 0; v < vreg_count; v++) rename[v] = v;
+    int body_label = ir_new_label(function);
+    for (size_t i = 0; i < length; i++) {
+        ir_instr_t instr = function->instrs[loop->header + 1 + i];
+        if (instr.src1 >= 0) instr.src1 = rename[instr.src1];
+        if (instr.src2 >= 0) instr.src2 = rename[instr.src2];
+
+        if (instr.opcode == IR_JUMP_ZERO || instr.opcode == IR_JUMP_NONZERO) {
+            instr.opcode = instr.opcode == IR_JUMP_ZERO ? IR_JUMP_NONZERO : IR_JUMP_ZERO;
+            instr.imm = body_label;
+        } else if (!(function->vreg_flags[instr.dst] & IR_VREG_VARIABLE) &&
+                   !ir_vreg_live_out(function, header_block, instr.dst)) {
+            int fresh = ir_new_vreg(function, function->vreg_flags[instr.dst]);
+            if (fresh != IR_NO_VREG) rename[instr.dst] = fresh;
+            instr.dst = rename[instr.dst];
+        }
+        copy[i] = instr;
+    }
+
+    // The copy replaces the back jump, and the body gets a label to return to
+    function->instrs[loop->latch] = copy[0];
+    int ok = optimizer_insert(function, loop->latch + 1, copy + 1, length - 1);
+    ir_instr_t label = {0};
+    label.opcode = IR_LABEL;
+    label.oper = OP_INVALID;
+    label.type = TYPE_INT;
+    label.dst = label.src1 = label.src2 = IR_NO_VREG;
+    label.imm = body_label;
+    if (ok) ok = optimizer_insert(function, exit + 1, &label, 1);
+
+    free(rename);
+    free(copy);
+    ir_invalidate_cfg(function);
+    return ok;
+}
+
+size_t optimizer_optimize_loops(ir_function_t* function, optimizer_stats_t* stats) {
+    int* positions = optimizer_label_positions(function);
+    int* headers = malloc((function->label_count + 1) * sizeof(int));
+    size_t header_count = 0;
+    if (!positions || !headers) {
+        free(positions);
+        free(headers);
+        return 0;
+    }
+
+    // Headers in the order of their back jumps puts inner loops first, so
+    // what they hoist can leave the enclosing loop as well
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (!optimizer_is_jump(instr) || positions[instr->imm] < 0 || positions[instr->imm] > (int)i) continue;
+
+        int known = 0;
+        for (size_t h = 0; h < header_count && !known; h++) known = headers[h] == instr->imm;
+        if (!known) headers[header_count++] = (int)instr->imm;
+    }
+    free(positions);
+
+    // Every step moves instructions, so the loop is located again after it
+    size_t changes = 0;
+    optimizer_loop_t loop;
+    for (size_t h = 0; h < header_count; h++) {
+        if (!optimizer_find_loop(function, headers[h], &loop)) continue;
+
+        size_t hoisted = optimizer_hoist_invariants(function, &loop);
+        stats->loop_hoisted += hoisted;
+
+        size_t limit = loop.latch - loop.header;
+        while (limit-- > 0 && optimizer_find_loop(function, headers[h], &loop) &&
+               optimizer_reduce_induction(function, &loop)) {
+            stats->loop_reduced++;
+            changes++;
+        }
+
+        if (optimizer_find_loop(function, headers[h], &loop) && optimizer_rotate_loop(function, &loop)) {
+            stats->loops_rotated++;
+            changes++;
+        }
+        changes += hoisted;
+    }
+
+    free(headers);
+    return changes;
+}
+
+// Helper: Alternate folding and DCE on function until neither changes anything
+static void optimizer_simplify_function(ir_function_t* function, optimizer_stats_t* stats) {
+    // Removing branches can merge constant paths that folding missed
+    for (int round = 0; round < OPTIMIZER_MAX_ROUNDS; round++) {
+        size_t changes = optimizer_fold_ir(function, stats);
+        changes += optimizer_eliminate_dead_code(function, stats);
+        if (changes == 0) break;
+    }
+}
+
+// Pass drivers
+void optimizer_optimize_ast(ast_node_t* ast, const optimizer_options_t* options, optimizer_stats_t* stats) {
+    if (!ast || options->level < 1) return;
+    stats->ast_folds += optimizer_fold_ast(ast);
+    stats->ast_pruned += optimizer_prune_ast(ast);
+}
+
+void optimizer_optimize_ir(ir_program_t* program, const optimizer_options_t* options, optimizer_stats_t* stats) {
+    if (!program || options->level < 1) return;
+
+    for (size_t i = 0; i < program->function_count; i++) {
+        optimizer_simplify_function(program->functions[i], stats);
+    }
+
+    // Callees are inlined in their simplified form, and a caller that became
+    // a leaf can itself be inlined in the next round
+    for (int round = 0; round < OPTIMIZER_MAX_ROUNDS; round++) {
+        if (optimizer_inline_calls(program, options->inline_threshold, stats) == 0) break;
+
+        for (size_t i = 0; i < program->function_count; i++) {
+            optimizer_simplify_function(program->functions[i], stats);
+        }
+    }
+
+    // Loops are restructured last, once their bodies are as small as
+    // inlining and folding make them
+    for (size_t i = 0; i < program->function_count; i++) {
+        if (optimizer_optimize_loops(program->functions[i], stats) > 0) {
+            optimizer_simplify_function(program->functions[i], stats);
+        }
+    }
+}
@@ -0,0 +1,127 @@
+// src/optimizer.h
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "ast.h"
+#include "ir.h"
+
+// Largest callee, in IR instructions, inlined by default
+#define OPTIMIZER_DEFAULT_INLINE_THRESHOLD 16
+
+// Optimization settings (selected with -O<level> in main.c)
+typedef struct {
+    int level;            // 0 disables every pass
+    int inline_threshold; // Largest callee inlined at -O1; 0 disables inlining
+} optimizer_options_t;
+
+// Statistics collected while optimizing
+typedef struct {
+    size_t ast_folds;     // AST expressions replaced by a literal
+    size_t ast_pruned;    // AST statements removed or replaced by a branch
+    size_t ir_folds;      // IR instructions rewritten to constants
+    size_t ir_immediates; // Operands turned into immediates
+    size_t ir_removed;    // IR instructions deleted or simplified by DCE
+    size_t inlined_calls; // Call sites replaced by the callee's body
+    size_t loop_hoisted;  // Loop-invariant IR instructions moved out of loops
+    size_t loop_reduced;  // Induction variable multiplications turned into adds
+    size_t loops_rotated; // Loops changed to test their condition at the bottom
+} optimizer_stats_t;
+
+// Pass drivers
+void optimizer_options_init(optimizer_options_t* options);
+void optimizer_optimize_ast(ast_node_t* ast, const optimizer_options_t* options, optimizer_stats_t* stats);
+void optimizer_optimize_ir(ir_program_t* program, const optimizer_options_t* options, optimizer_stats_t* stats);
+
+/**
+ * @brief Folds constant subexpressions of the AST in place
+ *
+ * Operators whose operands are literals are rewritten into AST_NUMBER nodes,
+ * so the transformation needs no allocation. Division by zero and other
+ * expressions with undefined results are left for run time.
+ *
+ * @return size_t Number of expressions folded
+ */
+size_t optimizer_fold_ast(ast_node_t* node);
+
+/**
+ * @brief Removes dead statements from the AST in place
+ *
+ * Branches of if statements with a literal condition are replaced by the
+ * branch taken, loops whose condition is literal zero are dropped, and
+ * statements following a return in the same block are deleted. Run
+ * optimizer_fold_ast() first so that constant conditions are literals.
+ *
+ * @return size_t Number of statements removed or replaced
+ */
+size_t optimizer_prune_ast(ast_node_t* node);
+
+/**
+ * @brief Constant folding and propagation over one IR function
+ *
+ * Constants flow from vregs with a single definition to all their uses, and
+ * from any definition to later uses in the same basic block. Folded results
+ * become IR_CONST, and constant right-hand operands of arithmetic and
+ * comparisons become immediates (IR_IMM_OPERAND).
+ *
+ * @return size_t Number of instructions changed
+ */
+size_t optimizer_fold_ir(ir_function_t* function, optimizer_stats_t* stats);
+
+/**
+ * @brief Dead and unreachable code elimination over one IR function
+ *
+ * Conditional jumps on a known constant become unconditional or disappear,
+ * blocks the entry cannot reach are deleted along with jumps to the next
+ * instruction and unused labels, and side-effect free definitions whose
+ * value is never read are removed (unused calls keep only the call). Unused
+ * locals therefore never reach register allocation. Steps repeat until
+ * nothing changes.
+ *
+ * @return size_t Number of instructions removed or rewritten
+ */
+size_t optimizer_eliminate_dead_code(ir_function_t* function, optimizer_stats_t* stats);
+
+/**
+ * @brief Inlines calls to small leaf functions of program
+ *
+ * A callee qualifies when it is defined in program, makes no calls (so it
+ * cannot recurse) and costs at most threshold instructions. Its body is
+ * copied into the caller with fresh vregs and labels.
+ *
+ * @return size_t Number of call sites inlined
+ */
+size_t optimizer_inline_calls(ir_program_t* program, int threshold, optimizer_stats_t* stats);
+size_t optimizer_inline_cost(const ir_function_t* function);  // (size_t)-1 if not a leaf
+
+/**
+ * @brief Loop-invariant code motion, induction variable strength reduction
+ *        and loop rotation over one IR function
+ *
+ * A loop is a label, the last backward jump to it and everything in
+ * between, provided outside code can only enter it through the label.
+ * Inner loops are handled first:
+ * - side-effect free arithmetic on values the loop never changes moves in
+ *   front of the header (division, which may trap, and comparisons stay)
+ * - i * c, where every update of i in the loop adds a constant, becomes a
+ *   copy of a running product that is bumped next to each update
+ * - a header that tests the condition and exits is copied over the back
+ *   jump with its branch inverted, so the original test only guards entry
+ *
+ * Run folding and dead code elimination afterwards to drop the labels and
+ * constant guards this leaves.
+ *
+ * @return size_t Number of instructions hoisted plus loops changed
+ */
+size_t optimizer_optimize_loops(ir_function_t* function, optimizer_stats_t* stats);
+
+/**
+ * @brief Evaluates a binary operator the way generated code does: in 64
+ *        bits, wrapping on overflow
+ *
+ * @return int 1 and the result in *result, or 0 if the operation must not be
+ *         folded (division by zero, LONG_MIN / -1, non-arithmetic operators)
+ */
+int optimizer_eval_binary(ast_operator_t oper, long left, long right, long* result);
+int optimizer_eval_unary(ast_operator_t oper, long operand, long* result);
+
+#endif // OPTIMIZER_H
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "parser.h"
 
 // Create parser
@@ -12,6 +13,7 @@ parser_t* parser_create(lexer_t* lexer) {
     if (!parser) return NULL;
     
     parser->lexer = lexer;
+    parser->arena = NULL;
     parser->error_count = 0;
     parser->error_capacity = 10;
     parser->panic_mode = 0;
@@ -25,22 +27,26 @@ parser_t* parser_create(lexer_t* lexer) {
     // Initialize with first token
     parser->current_token = lexer_next_token(lexer);
     parser->previous_token.type = TOKEN_EOF;
-    parser->previous_token.value = NULL;
+    parser->previous_token.start = 0;
+    parser->previous_token.length = 0;
     parser->previous_token.line = 0;
     parser->previous_token.column = 0;
+    parser->previous_token.message = NULL;
+    parser->previous_token.name = NULL;
     
     return parser;
 }
 
+// Allocate subsequently parsed AST nodes from an arena (NULL selects the heap)
+void parser_set_arena(parser_t* parser, arena_t* arena) {
+    if (!parser) return;
+    parser->arena = arena;
+}
+
 // Destroy parser
 void parser_destroy(parser_t* parser) {
     if (!parser) return;
     
-    // Free any remaining token values that we allocated
-    if (parser->previous_token.value) {
-        free(parser->previous_token.value);
-    }
-    
     for (size_t i = 0; i < parser->error_count; i++) {
         free(parser->errors[i].message);
     }
@@ -48,11 +54,24 @@ void parser_destroy(parser_t* parser) {
     free(parser);
 }
 
+// Helper: Give node the source position of token; returns node
+static ast_node_t* parser_at(ast_node_t* node, token_t token) {
+    ast_set_position(node, token.line, token.column);
+    return node;
+}
+
 // Utility functions
 int parser_check(parser_t* parser, token_type_t type) {
     return parser->current_token.type == type;
 }
 
+// offset 0 is the current token, 1 the one after it, and so on
+int parser_check_ahead(parser_t* parser, size_t offset, token_type_t type) {
+    if (offset == 0) return parser_check(parser, type);
+    if (parser->current_token.type == TOKEN_EOF) return type == TOKEN_EOF;
+    return lexer_peek_token_at(parser->lexer, offset - 1).type == type;
+}
+
 int parser_match(parser_t* parser, token_type_t type) {
     if (parser_check(parser, type)) {
         parser_advance(parser);
@@ -62,23 +81,8 @@ int parser_match(parser_t* parser, token_type_t type) {
 }
 
 token_t parser_advance(parser_t* parser) {
-    // Free the previous token's value if we allocated it
-    if (parser->previous_token.value) {
-        free(parser->previous_token.value);
-        parser->previous_token.value = NULL;
-    }
-    
-    // Copy the current token, including copying its value
-    parser->previous_token.type = parser->current_token.type;
-    parser->previous_token.line = parser->current_token.line;
-    parser->previous_token.column = parser->current_token.column;
-    
-    if (parser->current_token.value) {
-        parser->previous_token.value = malloc(strlen(parser->current_token.value) + 1);
-        strcpy(parser->previous_token.value, parser->current_token.value);
-    } else {
-        parser->previous_token.value = NULL;
-    }
+    // Tokens are plain source spans, so no copying is needed
+    parser->previous_token = parser->current_token;
     
     if (parser->current_token.type != TOKEN_EOF) {
         parser->current_token = lexer_next_token(parser->lexer);
@@ -87,6 +91,14 @@ token_t parser_advance(parser_t* parser) {
     return parser->previous_token;
 }
 
+// Intern a token's text (identifiers arrive already interned from the lexer)
+const char* parser_token_string(parser_t* parser, token_t token) {
+    if (token.name) {
+        return token.name;
+    }
+    return intern_string_n(lexer_token_text(parser->lexer, token), token.length);
+}
+
 void parser_consume(parser_t* parser, token_type_t type, const char* error_message) {
     if (parser->current_token.type == type) {
         parser_advance(parser);
@@ -207,9 +219,40 @@ data_type_t token_to_data_type(int token_type) {
     }
 }
 
+// Convert token type to binary operator
+ast_operator_t token_to_binary_operator(int token_type) {
+    switch (token_type) {
+        case TOKEN_ASSIGN: return OP_ASSIGN;
+        case TOKEN_PLUS: return OP_ADD;
+        case TOKEN_MINUS: return OP_SUB;
+        case TOKEN_MULTIPLY: return OP_MUL;
+        case TOKEN_DIVIDE: return OP_DIV;
+        case TOKEN_MODULO: return OP_MOD;
+        case TOKEN_EQUAL: return OP_EQ;
+        case TOKEN_NOT_EQUAL: return OP_NE;
+        case TOKEN_LESS: return OP_LT;
+        case TOKEN_LESS_EQUAL: return OP_LE;
+        case TOKEN_GREATER: return OP_GT;
+        case TOKEN_GREATER_EQUAL: return OP_GE;
+        case TOKEN_LOGICAL_AND: return OP_AND;
+        case TOKEN_LOGICAL_OR: return OP_OR;
+        default: return OP_INVALID;
+    }
+}
+
+// Convert token type to unary operator
+ast_operator_t token_to_unary_operator(int token_type) {
+    switch (token_type) {
+        case TOKEN_MINUS: return OP_NEG;
+        case TOKEN_PLUS: return OP_POS;
+        case TOKEN_LOGICAL_NOT: return OP_NOT;
+        default: return OP_INVALID;
+    }
+}
+
 // Main parsing function
 ast_node_t* parser_parse_program(parser_t* parser) {
-    ast_node_t* program = ast_create_program();
+    ast_node_t* program = ast_create_program(parser->arena);
     if (!program) return NULL;
     
     while (!parser_check(parser, TOKEN_EOF)) {
@@ -220,7 +263,7 @@ ast_node_t* parser_parse_program(parser_t* parser) {
         
         ast_node_t* declaration = parser_parse_declaration(parser);
         if (declaration) {
-            ast_add_declaration(program, declaration);
+            ast_add_declaration(parser->arena, program, declaration);
         }
         
         if (parser->panic_mode) {
@@ -240,27 +283,20 @@ ast_node_t* parser_parse_declaration(parser_t* parser) {
         return NULL;
     }
     
-    // Make a copy of the identifier name
-    char* name = malloc(strlen(parser->current_token.value) + 1);
-    strcpy(name, parser->current_token.value);
-    parser_advance(parser);
+    token_t name = parser_advance(parser);
     
     if (parser_check(parser, TOKEN_LEFT_PAREN)) {
         // Function declaration
-        ast_node_t* func = parser_parse_function_declaration(parser, type, name);
-        free(name);
-        return func;
+        return parser_at(parser_parse_function_declaration(parser, type, parser_token_string(parser, name)), name);
     } else {
         // Variable declaration
-        ast_node_t* var = parser_parse_variable_declaration(parser, type, name);
-        free(name);
-        return var;
+        return parser_at(parser_parse_variable_declaration(parser, type, parser_token_string(parser, name)), name);
     }
 }
 
 // Parse function declaration
 ast_node_t* parser_parse_function_declaration(parser_t* parser, data_type_t return_type, const char* name) {
-    ast_node_t* function = ast_create_function_decl(return_type, name);
+    ast_node_t* function = ast_create_function_decl(parser->arena, return_type, name);
     if (!function) return NULL;
     
     parser_consume(parser, TOKEN_LEFT_PAREN, "Expected '(' after function name");
@@ -270,7 +306,7 @@ ast_node_t* parser_parse_function_declaration(parser_t* parser, data_type_t retu
         do {
             ast_node_t* param = parser_parse_parameter(parser);
             if (param) {
-                ast_add_parameter(function, param);
+                ast_add_parameter(parser->arena, function, param);
             }
         } while (parser_match(parser, TOKEN_COMMA));
     }
@@ -291,15 +327,16 @@ ast_node_t* parser_parse_function_declaration(parser_t* parser, data_type_t retu
 
 // Parse variable declaration
 ast_node_t* parser_parse_variable_declaration(parser_t* parser, data_type_t var_type, const char* name) {
-    ast_node_t* initializer = NULL;
+    ast_node_t* var = ast_create_variable_decl(parser->arena, var_type, name, NULL);
+    if (!var) return NULL;
     
     if (parser_match(parser, TOKEN_ASSIGN)) {
-        initializer = parser_parse_expression(parser);
+        var->data.variable_decl.initializer = parser_parse_expression(parser);
     }
     
     parser_consume(parser, TOKEN_SEMICOLON, "Expected ';' after variable declaration");
     
-    return ast_create_variable_decl(var_type, name, initializer);
+    return var;
 }
 
 // Parse parameter
@@ -311,14 +348,9 @@ ast_node_t* parser_parse_parameter(parser_t* parser) {
         return NULL;
     }
     
-    // Make a copy of the parameter name
-    char* name = malloc(strlen(parser->current_token.value) + 1);
-    strcpy(name, parser->current_token.value);
-    parser_advance(parser);
+    token_t name = parser_advance(parser);
     
-    ast_node_t* param = ast_create_parameter(param_type, name);
-    free(name);
-    return param;
+    return parser_at(ast_create_parameter(parser->arena, param_type, parser_token_string(parser, name)), name);
 }
 
 // Parse statement
@@ -348,15 +380,16 @@ ast_node_t* parser_parse_statement(parser_t* parser) {
 
 // Parse compound statement
 ast_node_t* parser_parse_compound_statement(parser_t* parser) {
+    token_t brace = parser->current_token;
     parser_consume(parser, TOKEN_LEFT_BRACE, "Expected '{'");
     
-    ast_node_t* compound = ast_create_compound_stmt();
+    ast_node_t* compound = parser_at(ast_create_compound_stmt(parser->arena), brace);
     if (!compound) return NULL;
     
     while (!parser_check(parser, TOKEN_RIGHT_BRACE) && !parser_check(parser, TOKEN_EOF)) {
         ast_node_t* stmt = parser_parse_statement(parser);
         if (stmt) {
-            ast_add_statement(compound, stmt);
+            ast_add_statement(parser->arena, compound, stmt);
         }
         
         if (parser->panic_mode) {
@@ -371,6 +404,7 @@ ast_node_t* parser_parse_compound_statement(parser_t* parser) {
 
 // Parse if statement
 ast_node_t* parser_parse_if_statement(parser_t* parser) {
+    token_t keyword = parser->current_token;
     parser_consume(parser, TOKEN_IF, "Expected 'if'");
     parser_consume(parser, TOKEN_LEFT_PAREN, "Expected '(' after 'if'");
     
@@ -385,11 +419,12 @@ ast_node_t* parser_parse_if_statement(parser_t* parser) {
         else_stmt = parser_parse_statement(parser);
     }
     
-    return ast_create_if_stmt(condition, then_stmt, else_stmt);
+    return parser_at(ast_create_if_stmt(parser->arena, condition, then_stmt, else_stmt), keyword);
 }
 
 // Parse while statement
 ast_node_t* parser_parse_while_statement(parser_t* parser) {
+    token_t keyword = parser->current_token;
     parser_consume(parser, TOKEN_WHILE, "Expected 'while'");
     parser_consume(parser, TOKEN_LEFT_PAREN, "Expected '(' after 'while'");
     
@@ -399,11 +434,12 @@ ast_node_t* parser_parse_while_statement(parser_t* parser) {
     
     ast_node_t* body = parser_parse_statement(parser);
     
-    return ast_create_while_stmt(condition, body);
+    return parser_at(ast_create_while_stmt(parser->arena, condition, body), keyword);
 }
 
 // Parse for statement
 ast_node_t* parser_parse_for_statement(parser_t* parser) {
+    token_t keyword = parser->current_token;
     parser_consume(parser, TOKEN_FOR, "Expected 'for'");
     parser_consume(parser, TOKEN_LEFT_PAREN, "Expected '(' after 'for'");
     
@@ -435,11 +471,12 @@ ast_node_t* parser_parse_for_statement(parser_t* parser) {
     
     ast_node_t* body = parser_parse_statement(parser);
     
-    return ast_create_for_stmt(init, condition, update, body);
+    return parser_at(ast_create_for_stmt(parser->arena, init, condition, update, body), keyword);
 }
 
 // Parse return statement
 ast_node_t* parser_parse_return_statement(parser_t* parser) {
+    token_t keyword = parser->current_token;
     parser_consume(parser, TOKEN_RETURN, "Expected 'return'");
     
     ast_node_t* value = NULL;
@@ -449,11 +486,12 @@ ast_node_t* parser_parse_return_statement(parser_t* parser) {
     
     parser_consume(parser, TOKEN_SEMICOLON, "Expected ';' after return statement");
     
-    return ast_create_return_stmt(value);
+    return parser_at(ast_create_return_stmt(parser->arena, value), keyword);
 }
 
 // Parse expression statement
 ast_node_t* parser_parse_expression_statement(parser_t* parser) {
+    token_t start = parser->current_token;
     ast_node_t* expression = NULL;
     
     if (!parser_check(parser, TOKEN_SEMICOLON)) {
@@ -462,7 +500,7 @@ ast_node_t* parser_parse_expression_statement(parser_t* parser) {
     
     parser_consume(parser, TOKEN_SEMICOLON, "Expected ';' after expression");
     
-    return ast_create_expression_stmt(expression);
+    return parser_at(ast_create_expression_stmt(parser->arena, expression), start);
 }
 
 // Expression parsing with precedence (recursive descent)
@@ -474,8 +512,9 @@ ast_node_t* parser_parse_assignment(parser_t* parser) {
     ast_node_t* expr = parser_parse_logical_or(parser);
     
     if (parser_match(parser, TOKEN_ASSIGN)) {
+        token_t assign = parser->previous_token;
         ast_node_t* value = parser_parse_assignment(parser);
-        return ast_create_binary_op("=", expr, value);
+        return parser_at(ast_create_binary_op(parser->arena, OP_ASSIGN, expr, value), assign);
     }
     
     return expr;
@@ -485,8 +524,9 @@ ast_node_t* parser_parse_logical_or(parser_t* parser) {
     ast_node_t* expr = parser_parse_logical_and(parser);
     
     while (parser_match(parser, TOKEN_LOGICAL_OR)) {
+        token_t oper = parser->previous_token;
         ast_node_t* right = parser_parse_logical_and(parser);
-        expr = ast_create_binary_op("||", expr, right);
+        expr = parser_at(ast_create_binary_op(parser->arena, OP_OR, expr, right), oper);
     }
     
     return expr;
@@ -496,8 +536,9 @@ ast_node_t* parser_parse_logical_and(parser_t* parser) {
     ast_node_t* expr = parser_parse_equality(parser);
     
     while (parser_match(parser, TOKEN_LOGICAL_AND)) {
+        token_t oper = parser->previous_token;
         ast_node_t* right = parser_parse_equality(parser);
-        expr = ast_create_binary_op("&&", expr, right);
+        expr = parser_at(ast_create_binary_op(parser->arena, OP_AND, expr, right), oper);
     }
     
     return expr;
@@ -507,9 +548,10 @@ ast_node_t* parser_parse_equality(parser_t* parser) {
     ast_node_t* expr = parser_parse_relational(parser);
     
     while (parser_match(parser, TOKEN_EQUAL) || parser_match(parser, TOKEN_NOT_EQUAL)) {
-        char* op = (parser->previous_token.type == TOKEN_EQUAL) ? "==" : "!=";
+        token_t oper = parser->previous_token;
+        ast_operator_t op = token_to_binary_operator(oper.type);
         ast_node_t* right = parser_parse_relational(parser);
-        expr = ast_create_binary_op(op, expr, right);
+        expr = parser_at(ast_create_binary_op(parser->arena, op, expr, right), oper);
     }
     
     return expr;
@@ -520,16 +562,10 @@ ast_node_t* parser_parse_relational(parser_t* parser) {
     
     while (parser_match(parser, TOKEN_LESS) || parser_match(parser, TOKEN_LESS_EQUAL) ||
            parser_match(parser, TOKEN_GREATER) || parser_match(parser, TOKEN_GREATER_EQUAL)) {
-        char* op;
-        switch (parser->previous_token.type) {
-            case TOKEN_LESS: op = "<"; break;
-            case TOKEN_LESS_EQUAL: op = "<="; break;
-            case TOKEN_GREATER: op = ">"; break;
-            case TOKEN_GREATER_EQUAL: op = ">="; break;
-            default: op = "?";
-        }
+        token_t oper = parser->previous_token;
+        ast_operator_t op = token_to_binary_operator(oper.type);
         ast_node_t* right = parser_parse_additive(parser);
-        expr = ast_create_binary_op(op, expr, right);
+        expr = parser_at(ast_create_binary_op(parser->arena, op, expr, right), oper);
     }
     
     return expr;
@@ -539,9 +575,10 @@ ast_node_t* parser_parse_additive(parser_t* parser) {
     ast_node_t* expr = parser_parse_multiplicative(parser);
     
     while (parser_match(parser, TOKEN_PLUS) || parser_match(parser, TOKEN_MINUS)) {
-        char* op = (parser->previous_token.type == TOKEN_PLUS) ? "+" : "-";
+        token_t oper = parser->previous_token;
+        ast_operator_t op = token_to_binary_operator(oper.type);
         ast_node_t* right = parser_parse_multiplicative(parser);
-        expr = ast_create_binary_op(op, expr, right);
+        expr = parser_at(ast_create_binary_op(parser->arena, op, expr, right), oper);
     }
     
     return expr;
@@ -551,15 +588,10 @@ ast_node_t* parser_parse_multiplicative(parser_t* parser) {
     ast_node_t* expr = parser_parse_unary(parser);
     
     while (parser_match(parser, TOKEN_MULTIPLY) || parser_match(parser, TOKEN_DIVIDE) || parser_match(parser, TOKEN_MODULO)) {
-        char* op;
-        switch (parser->previous_token.type) {
-            case TOKEN_MULTIPLY: op = "*"; break;
-            case TOKEN_DIVIDE: op = "/"; break;
-            case TOKEN_MODULO: op = "%"; break;
-            default: op = "?";
-        }
+        token_t oper = parser->previous_token;
+        ast_operator_t op = token_to_binary_operator(oper.type);
         ast_node_t* right = parser_parse_unary(parser);
-        expr = ast_create_binary_op(op, expr, right);
+        expr = parser_at(ast_create_binary_op(parser->arena, op, expr, right), oper);
     }
     
     return expr;
@@ -567,15 +599,10 @@ ast_node_t* parser_parse_multiplicative(parser_t* parser) {
 
 ast_node_t* parser_parse_unary(parser_t* parser) {
     if (parser_match(parser, TOKEN_LOGICAL_NOT) || parser_match(parser, TOKEN_MINUS) || parser_match(parser, TOKEN_PLUS)) {
-        char* op;
-        switch (parser->previous_token.type) {
-            case TOKEN_LOGICAL_NOT: op = "!"; break;
-            case TOKEN_MINUS: op = "-"; break;
-            case TOKEN_PLUS: op = "+"; break;
-            default: op = "?";
-        }
+        token_t oper = parser->previous_token;
+        ast_operator_t op = token_to_unary_operator(oper.type);
         ast_node_t* operand = parser_parse_unary(parser);
-        return ast_create_unary_op(op, operand);
+        return parser_at(ast_create_unary_op(parser->arena, op, operand), oper);
     }
     
     return parser_parse_postfix(parser);
@@ -591,14 +618,18 @@ ast_node_t* parser_parse_postfix(parser_t* parser) {
             return NULL;
         }
         
-        ast_node_t* call = ast_create_function_call(expr->data.identifier.name);
+        ast_node_t* call = ast_create_function_call(parser->arena, expr->data.identifier.name);
+        if (call) {
+            call->line = expr->line;
+            call->column = expr->column;
+        }
         ast_destroy(expr); // Free the identifier node
         
         if (!parser_check(parser, TOKEN_RIGHT_PAREN)) {
             do {
                 ast_node_t* arg = parser_parse_expression(parser);
                 if (arg) {
-                    ast_add_argument(call, arg);
+                    ast_add_argument(parser->arena, call, arg);
                 }
             } while (parser_match(parser, TOKEN_COMMA));
         }
@@ -612,29 +643,29 @@ ast_node_t* parser_parse_postfix(parser_t* parser) {
 
 ast_node_t* parser_parse_primary(parser_t* parser) {
     if (parser_match(parser, TOKEN_NUMBER)) {
-        if (!parser->previous_token.value) {
-            return ast_create_number(0);
+        // Convert the digits directly from the source span, stopping before the
+        // value leaves int (literals are 32-bit, see README)
+        const char* digits = lexer_token_text(parser->lexer, parser->previous_token);
+        unsigned long value = 0;
+        for (size_t i = 0; i < parser->previous_token.length; i++) {
+            value = value * 10 + (unsigned long)(digits[i] - '0');
+            if (value > INT_MAX) {
+                parser_error(parser, "Number literal out of range");
+                value = 0;
+                break;
+            }
         }
-        int value = atoi(parser->previous_token.value);
-        return ast_create_number(value);
+        return parser_at(ast_create_number(parser->arena, (int)value), parser->previous_token);
     }
     
     if (parser_match(parser, TOKEN_STRING)) {
-        // Make a copy of the value
-        char* value = malloc(strlen(parser->previous_token.value) + 1);
-        strcpy(value, parser->previous_token.value);
-        ast_node_t* node = ast_create_string(value);
-        free(value);
-        return node;
+        return parser_at(ast_create_string(parser->arena, parser_token_string(parser, parser->previous_token)),
+                         parser->previous_token);
     }
     
     if (parser_match(parser, TOKEN_IDENTIFIER)) {
-        // Make a copy of the value
-        char* name = malloc(strlen(parser->previous_token.value) + 1);
-        strcpy(name, parser->previous_token.value);
-        ast_node_t* node = ast_create_identifier(name);
-        free(name);
-        return node;
+        return parser_at(ast_create_identifier(parser->arena, parser_token_string(parser, parser->previous_token)),
+                         parser->previous_token);
     }
     
     if (parser_match(parser, TOKEN_LEFT_PAREN)) {
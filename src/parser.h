@@ -20,6 +20,7 @@ typedef struct {
     lexer_t* lexer;
     token_t current_token;
     token_t previous_token;
+    arena_t* arena;        // Arena for AST nodes (NULL = heap allocation)
     
     // Error handling
     parse_error_t* errors;
@@ -31,6 +32,7 @@ typedef struct {
 // Parser lifecycle
 parser_t* parser_create(lexer_t* lexer);
 void parser_destroy(parser_t* parser);
+void parser_set_arena(parser_t* parser, arena_t* arena);
 
 // Main parsing functions
 ast_node_t* parser_parse_program(parser_t* parser);
@@ -66,7 +68,9 @@ ast_node_t* parser_parse_primary(parser_t* parser);
 data_type_t parser_parse_type(parser_t* parser);
 int parser_match(parser_t* parser, token_type_t type);
 int parser_check(parser_t* parser, token_type_t type);
+int parser_check_ahead(parser_t* parser, size_t offset, token_type_t type);  // offset < LEXER_MAX_LOOKAHEAD
 token_t parser_advance(parser_t* parser);
+const char* parser_token_string(parser_t* parser, token_t token);
 void parser_consume(parser_t* parser, token_type_t type, const char* error_message);
 
 // Error handling
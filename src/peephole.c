@@ -0,0 +1,707 @@
+// src/peephole.c
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "peephole.h"
+
+// Locations tracked by liveness, one bit each: the registers, the flags and
+// the first spill slots below %rbp
+typedef uint64_t peephole_set_t;
+
+#define PEEPHOLE_REGISTER(reg) ((peephole_set_t)1 << (reg))
+#define PEEPHOLE_FLAGS ((peephole_set_t)1 << MAX_REGISTERS)
+#define PEEPHOLE_FIRST_SLOT (MAX_REGISTERS + 1)
+#define PEEPHOLE_SLOT_COUNT (64 - PEEPHOLE_FIRST_SLOT)
+#define PEEPHOLE_ALL (~(peephole_set_t)0)
+
+// Upper bound on rounds of rewriting per function
+#define PEEPHOLE_MAX_ROUNDS 8
+
+// How far back a load looks for the store it can be forwarded from
+#define PEEPHOLE_FORWARD_WINDOW 16
+
+// Registers a call may read (arguments, in order) and clobber (caller-saved)
+static const register_t argument_registers[MAX_REGISTER_ARGS] = {
+    REG_RDI, REG_RSI, REG_RDX, REG_RCX, REG_R8, REG_R9
+};
+static const peephole_set_t clobbered_set =
+    PEEPHOLE_REGISTER(REG_RAX) | PEEPHOLE_REGISTER(REG_RCX) | PEEPHOLE_REGISTER(REG_RDX) |
+    PEEPHOLE_REGISTER(REG_RSI) | PEEPHOLE_REGISTER(REG_RDI) | PEEPHOLE_REGISTER(REG_R8) |
+    PEEPHOLE_REGISTER(REG_R9) | PEEPHOLE_REGISTER(REG_R10) | PEEPHOLE_REGISTER(REG_R11) |
+    PEEPHOLE_FLAGS;
+
+// Live at ret: the return value, callee-saved registers and the frame
+static const peephole_set_t return_set =
+    PEEPHOLE_REGISTER(REG_RAX) | PEEPHOLE_REGISTER(REG_RBX) | PEEPHOLE_REGISTER(REG_R12) |
+    PEEPHOLE_REGISTER(REG_R13) | PEEPHOLE_REGISTER(REG_R14) | PEEPHOLE_REGISTER(REG_R15) |
+    PEEPHOLE_REGISTER(REG_RSP) | PEEPHOLE_REGISTER(REG_RBP);
+
+// What an instruction reads and writes
+typedef struct {
+    peephole_set_t use;
+    peephole_set_t def;
+    int removable;        // No effect besides writing def
+} peephole_effects_t;
+
+// Helper: Liveness bit of operand, or 0 if it is not tracked
+static peephole_set_t peephole_location(const asm_operand_t* operand) {
+    if (operand->kind == ASM_OPERAND_REGISTER) {
+        return PEEPHOLE_REGISTER(operand->reg);
+    }
+    if (operand->kind == ASM_OPERAND_MEMORY && operand->reg == REG_RBP &&
+        operand->value < 0 && operand->value % 8 == 0 && -operand->value / 8 <= PEEPHOLE_SLOT_COUNT) {
+        return (peephole_set_t)1 << (PEEPHOLE_FIRST_SLOT - 1 - operand->value / 8);
+    }
+    return 0;
+}
+
+static int peephole_same_operand(const asm_operand_t* a, const asm_operand_t* b) {
+    if (a->kind != b->kind) return 0;
+    switch (a->kind) {
+        case ASM_OPERAND_REGISTER: return a->reg == b->reg && a->size == b->size;
+        case ASM_OPERAND_IMMEDIATE: return a->value == b->value;
+        case ASM_OPERAND_MEMORY: return a->reg == b->reg && a->value == b->value;
+        case ASM_OPERAND_SYMBOL: return a->text == b->text;
+        case ASM_OPERAND_LABEL: return a->text == b->text && a->value == b->value;
+    }
+    return 0;
+}
+
+// Helper: True if the ASM_LABEL line label defines the jump target target
+static int peephole_is_label(const asm_instr_t* label, const asm_operand_t* target) {
+    if (label->kind != ASM_LABEL) return 0;
+    if (label->operand_count == 1) return peephole_same_operand(&label->operands[0], target);
+    return target->kind == ASM_OPERAND_SYMBOL && target->text == label->text;
+}
+
+static void peephole_read(peephole_effects_t* effects, const asm_operand_t* operand) {
+    if (operand->kind == ASM_OPERAND_MEMORY) {
+        effects->use |= PEEPHOLE_REGISTER(operand->reg);
+    }
+    effects->use |= peephole_location(operand);
+}
+
+static void peephole_write(peephole_effects_t* effects, const asm_instr_t* instr, const asm_operand_t* operand) {
+    if (operand->kind == ASM_OPERAND_MEMORY) {
+        effects->use |= PEEPHOLE_REGISTER(operand->reg);
+    }
+
+    peephole_set_t location = peephole_location(operand);
+    if (!location) {
+        effects->removable = 0;  // Memory we know nothing about
+        return;
+    }
+    effects->def |= location;
+    if (location & (PEEPHOLE_REGISTER(REG_RSP) | PEEPHOLE_REGISTER(REG_RBP))) {
+        effects->removable = 0;  // The frame is never dead
+    }
+
+    // 8- and 16-bit register writes and narrow stores keep the other bits
+    int full = operand->kind == ASM_OPERAND_REGISTER ? operand->size >= 4 : instr->suffix == 'q';
+    if (!full) effects->use |= location;
+}
+
+static peephole_effects_t peephole_effects(const asm_instr_t* instr) {
+    peephole_effects_t effects = {0, 0, 1};
+    const asm_operand_t* operands = instr->operands;
+    int count = instr->operand_count;
+
+    if (instr->kind != ASM_INSTRUCTION) {
+        effects.removable = 0;
+        return effects;
+    }
+
+    switch (instr->opcode) {
+        case ASM_MOV:
+        case ASM_MOVZB:
+        case ASM_MOVSB:
+        case ASM_MOVSL:
+            if (count != 2) break;
+            peephole_read(&effects, &operands[0]);
+            peephole_write(&effects, instr, &operands[1]);
+            return effects;
+
+        case ASM_LEA:
+            if (count != 2) break;
+            if (operands[0].kind == ASM_OPERAND_MEMORY) {
+                effects.use |= PEEPHOLE_REGISTER(operands[0].reg);  // Address only
+            }
+            peephole_write(&effects, instr, &operands[1]);
+            return effects;
+
+        case ASM_ADD:
+        case ASM_SUB:
+        case ASM_SAL:
+        case ASM_IMUL:
+            if (count != 2 && !(count == 3 && instr->opcode == ASM_IMUL)) break;
+            peephole_read(&effects, &operands[0]);
+            peephole_read(&effects, &operands[1]);
+            peephole_write(&effects, instr, &operands[count - 1]);
+            effects.def |= PEEPHOLE_FLAGS;
+            return effects;
+
+        case ASM_NEG:
+            if (count != 1) break;
+            peephole_read(&effects, &operands[0]);
+            peephole_write(&effects, instr, &operands[0]);
+            effects.def |= PEEPHOLE_FLAGS;
+            return effects;
+
+        case ASM_CMP:
+        case ASM_TEST:
+            if (count != 2) break;
+            peephole_read(&effects, &operands[0]);
+            peephole_read(&effects, &operands[1]);
+            effects.def |= PEEPHOLE_FLAGS;
+            return effects;
+
+        case ASM_SET:
+            // Codegen zero-extends every setcc result, so the byte written
+            // is all of the register that is ever read
+            if (count != 1 || operands[0].kind != ASM_OPERAND_REGISTER) break;
+            effects.def |= PEEPHOLE_REGISTER(operands[0].reg);
+            effects.use |= PEEPHOLE_FLAGS;
+            return effects;
+
+        case ASM_CQTO:
+            effects.use |= PEEPHOLE_REGISTER(REG_RAX);
+            effects.def |= PEEPHOLE_REGISTER(REG_RDX);
+            return effects;
+
+        case ASM_IDIV:
+            // Kept even when dead: dividing by zero traps
+            if (count != 1) break;
+            peephole_read(&effects, &operands[0]);
+            effects.use |= PEEPHOLE_REGISTER(REG_RAX) | PEEPHOLE_REGISTER(REG_RDX);
+            effects.def |= PEEPHOLE_REGISTER(REG_RAX) | PEEPHOLE_REGISTER(REG_RDX) | PEEPHOLE_FLAGS;
+            effects.removable = 0;
+            return effects;
+
+        case ASM_PUSH:
+            if (count != 1) break;
+            peephole_read(&effects, &operands[0]);
+            effects.removable = 0;
+            return effects;
+
+        case ASM_POP:
+            if (count != 1) break;
+            peephole_write(&effects, instr, &operands[0]);
+            effects.removable = 0;
+            return effects;
+
+        case ASM_CALL:
+            for (int i = 0; i < instr->call_arguments && i < MAX_REGISTER_ARGS; i++) {
+                effects.use |= PEEPHOLE_REGISTER(argument_registers[i]);
+            }
+            effects.def = clobbered_set;
+            effects.removable = 0;
+            return effects;
+
+        case ASM_RET:
+            effects.use = return_set;
+            effects.removable = 0;
+            return effects;
+
+        case ASM_JMP:
+            effects.removable = 0;
+            return effects;
+
+        case ASM_JCC:
+            effects.use = PEEPHOLE_FLAGS;
+            effects.removable = 0;
+            return effects;
+
+        case ASM_OTHER:
+            break;
+    }
+
+    // Unknown shape: assume it reads everything
+    effects.use = PEEPHOLE_ALL;
+    effects.def = 0;
+    effects.removable = 0;
+    return effects;
+}
+
+// Helper: Liveness of every location after each instruction (NULL if out
+// of memory)
+static peephole_set_t* peephole_liveness(const asm_instr_t* instrs, size_t count) {
+    peephole_set_t* live_out = calloc(count + 1, sizeof(peephole_set_t));
+    peephole_set_t* live_in = calloc(count + 1, sizeof(peephole_set_t));
+    peephole_effects_t* effects = malloc((count + 1) * sizeof(peephole_effects_t));
+    int* targets = malloc((count + 1) * sizeof(int));
+    if (!live_out || !live_in || !effects || !targets) {
+        free(live_out);
+        free(live_in);
+        free(effects);
+        free(targets);
+        return NULL;
+    }
+
+    // Local labels of the function are numbered, so their ids (shifted past
+    // ASM_RETURN_LABEL) index the label positions; named labels are rare
+    // enough to look up one by one
+    long label_limit = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (instrs[i].kind == ASM_LABEL && instrs[i].operand_count == 1 && instrs[i].operands[0].value >= label_limit) {
+            label_limit = instrs[i].operands[0].value + 1;
+        }
+    }
+    int* label_index = malloc((label_limit + 1) * sizeof(int));
+    if (!label_index) {
+        free(live_out);
+        free(live_in);
+        free(effects);
+        free(targets);
+        return NULL;
+    }
+    for (long i = 0; i <= label_limit; i++) label_index[i] = -1;
+    for (size_t i = 0; i < count; i++) {
+        const asm_instr_t* instr = &instrs[i];
+        if (instr->kind == ASM_LABEL && instr->operand_count == 1 && instr->operands[0].value >= ASM_RETURN_LABEL) {
+            label_index[instr->operands[0].value - ASM_RETURN_LABEL] = (int)i;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const asm_instr_t* instr = &instrs[i];
+        effects[i] = peephole_effects(instr);
+        targets[i] = -1;
+        if (instr->kind != ASM_INSTRUCTION || (instr->opcode != ASM_JMP && instr->opcode != ASM_JCC) ||
+            instr->operand_count != 1) {
+            continue;
+        }
+
+        const asm_operand_t* target = &instr->operands[0];
+        if (target->kind == ASM_OPERAND_LABEL) {
+            // Labels are per function, so one of another function is unknown
+            if (target->value >= ASM_RETURN_LABEL && target->value < label_limit) {
+                int position = label_index[target->value - ASM_RETURN_LABEL];
+                if (position >= 0 && peephole_is_label(&instrs[position], target)) targets[i] = position;
+            }
+        } else if (target->kind == ASM_OPERAND_SYMBOL) {
+            for (size_t l = 0; l < count && targets[i] < 0; l++) {
+                if (peephole_is_label(&instrs[l], target)) targets[i] = (int)l;
+            }
+        }
+    }
+    free(label_index);
+
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (size_t i = count; i > 0; i--) {
+            size_t index = i - 1;
+            const asm_instr_t* instr = &instrs[index];
+            int jump = instr->kind == ASM_INSTRUCTION && (instr->opcode == ASM_JMP || instr->opcode == ASM_JCC);
+            int falls_through = instr->kind != ASM_INSTRUCTION ||
+                                (instr->opcode != ASM_JMP && instr->opcode != ASM_RET);
+
+            peephole_set_t out = 0;
+            if (falls_through) out |= index + 1 < count ? live_in[index + 1] : PEEPHOLE_ALL;
+            if (jump) out |= targets[index] >= 0 ? live_in[targets[index]] : PEEPHOLE_ALL;
+
+            peephole_set_t in = effects[index].use | (out & ~effects[index].def);
+            if (in != live_in[index] || out != live_out[index]) {
+                live_in[index] = in;
+                live_out[index] = out;
+                changed = 1;
+            }
+        }
+    }
+
+    free(live_in);
+    free(effects);
+    free(targets);
+    return live_out;
+}
+
+static int peephole_is_move(const asm_instr_t* instr) {
+    return instr->kind == ASM_INSTRUCTION && instr->opcode == ASM_MOV && instr->suffix == 'q' &&
+           instr->operand_count == 2;
+}
+
+static int peephole_is_full_register(const asm_operand_t* operand) {
+    return operand->kind == ASM_OPERAND_REGISTER && operand->size == 8;
+}
+
+// Helper: log2 of value if it is a positive power of two, else -1
+static int peephole_log2(long value) {
+    if (value <= 0 || (value & (value - 1)) != 0) return -1;
+    int shift = 0;
+    while ((1L << shift) != value) shift++;
+    return shift;
+}
+
+// Helper: True if label follows position index, with only labels in between
+static int peephole_label_follows(const asm_instr_t* instrs, size_t count, size_t index, const asm_operand_t* label) {
+    for (size_t i = index + 1; i < count && instrs[i].kind != ASM_INSTRUCTION; i++) {
+        if (peephole_is_label(&instrs[i], label)) return 1;
+    }
+    return 0;
+}
+
+// Helper: Insert an uninitialized instruction before position index (NULL,
+// leaving the buffer as it was, if out of memory)
+static asm_instr_t* peephole_insert(codegen_t* codegen, size_t index) {
+    if (codegen->instr_count >= codegen->instr_capacity) {
+        asm_instr_t* instrs = realloc(codegen->instrs, codegen->instr_capacity * 2 * sizeof(asm_instr_t));
+        if (!instrs) return NULL;
+        codegen->instrs = instrs;
+        codegen->instr_capacity *= 2;
+    }
+    memmove(&codegen->instrs[index + 1], &codegen->instrs[index],
+            (codegen->instr_count - index) * sizeof(asm_instr_t));
+    codegen->instr_count++;
+    return &codegen->instrs[index];
+}
+
+// imulq $2^k, x -> salq $k, x (three-operand forms copy the source first)
+static size_t peephole_reduce_multiplies(codegen_t* codegen) {
+    size_t rewritten = 0;
+
+    for (size_t i = 0; i < codegen->instr_count; i++) {
+        asm_instr_t* instr = &codegen->instrs[i];
+        if (instr->kind != ASM_INSTRUCTION || instr->opcode != ASM_IMUL || instr->suffix != 'q' ||
+            instr->operand_count < 2 || instr->operands[0].kind != ASM_OPERAND_IMMEDIATE) {
+            continue;
+        }
+        int shift = peephole_log2(instr->operands[0].value);
+        asm_operand_t* target = &instr->operands[instr->operand_count - 1];
+        if (shift < 1 || !peephole_is_full_register(target)) continue;
+
+        if (instr->operand_count == 3 && !peephole_same_operand(&instr->operands[1], target)) {
+            asm_operand_t source = instr->operands[1];
+            asm_instr_t* move = peephole_insert(codegen, i);
+            if (!move) break;
+            *move = codegen->instrs[i + 1];
+            move->opcode = ASM_MOV;
+            move->operands[0] = source;
+            move->operands[1] = move->operands[2];
+            move->operand_count = 2;
+            instr = &codegen->instrs[++i];
+            target = &instr->operands[2];
+        }
+
+        instr->opcode = ASM_SAL;
+        instr->operands[0].value = shift;
+        instr->operands[1] = *target;
+        instr->operand_count = 2;
+        rewritten++;
+    }
+    return rewritten;
+}
+
+// Helper: Register a load from slot can read instead, found by walking back
+// from the end of out to the store that last wrote the slot (REG_NONE if
+// the store is not a register or the register changed since)
+static register_t peephole_forwarded_register(const asm_instr_t* out, size_t out_count, const asm_operand_t* slot) {
+    peephole_set_t location = peephole_location(slot);
+    peephole_set_t written = 0;
+
+    for (size_t i = out_count; i > 0 && out_count - i < PEEPHOLE_FORWARD_WINDOW; i--) {
+        const asm_instr_t* instr = &out[i - 1];
+        if (instr->kind == ASM_LABEL) break;
+        if (instr->kind != ASM_INSTRUCTION) continue;
+        if (instr->opcode == ASM_JMP || instr->opcode == ASM_JCC || instr->opcode == ASM_CALL ||
+            instr->opcode == ASM_RET || instr->opcode == ASM_OTHER) {
+            break;
+        }
+
+        if (peephole_is_move(instr) && peephole_same_operand(&instr->operands[1], slot)) {
+            const asm_operand_t* source = &instr->operands[0];
+            if (peephole_is_full_register(source) && !(written & PEEPHOLE_REGISTER(source->reg))) {
+                return source->reg;
+            }
+            break;
+        }
+
+        peephole_effects_t effects = peephole_effects(instr);
+        if (effects.def & location) break;
+        written |= effects.def;
+    }
+    return REG_NONE;
+}
+
+// Helper: If out ends with "setcc %r8; movzbl %r8, %r32; [movq %r64, x;] test x",
+// return the condition tested, or -1
+static int peephole_flag_condition(const asm_instr_t* out, size_t out_count) {
+    if (out_count < 3) return -1;
+
+    const asm_instr_t* test = &out[out_count - 1];
+    const asm_operand_t* value;
+    if (test->kind == ASM_INSTRUCTION && test->opcode == ASM_TEST && test->operand_count == 2 &&
+        peephole_same_operand(&test->operands[0], &test->operands[1])) {
+        value = &test->operands[1];
+    } else if (test->kind == ASM_INSTRUCTION && test->opcode == ASM_CMP && test->operand_count == 2 &&
+               test->operands[0].kind == ASM_OPERAND_IMMEDIATE && test->operands[0].value == 0) {
+        value = &test->operands[1];
+    } else {
+        return -1;
+    }
+
+    size_t i = out_count - 2;
+    register_t reg;
+    if (peephole_is_move(&out[i]) && peephole_same_operand(&out[i].operands[1], value) &&
+        peephole_is_full_register(&out[i].operands[0])) {
+        reg = out[i].operands[0].reg;
+        if (i-- == 0) return -1;
+    } else if (peephole_is_full_register(value)) {
+        reg = value->reg;
+    } else {
+        return -1;
+    }
+
+    const asm_instr_t* extend = &out[i];
+    if (extend->kind != ASM_INSTRUCTION || extend->opcode != ASM_MOVZB || extend->operand_count != 2 ||
+        extend->operands[0].kind != ASM_OPERAND_REGISTER || extend->operands[0].reg != reg ||
+        extend->operands[0].size != 1 || extend->operands[1].kind != ASM_OPERAND_REGISTER ||
+        extend->operands[1].reg != reg || extend->operands[1].size < 4 || i == 0) {
+        return -1;
+    }
+
+    const asm_instr_t* set = &out[i - 1];
+    if (set->kind != ASM_INSTRUCTION || set->opcode != ASM_SET || set->operand_count != 1 ||
+        set->operands[0].kind != ASM_OPERAND_REGISTER || set->operands[0].reg != reg) {
+        return -1;
+    }
+    return set->condition;
+}
+
+// Rewrites that only look at neighbouring instructions
+static size_t peephole_local(codegen_t* codegen) {
+    asm_instr_t* instrs = codegen->instrs;
+    size_t count = codegen->instr_count;
+    size_t w = 0;
+    size_t rewritten = 0;
+
+    for (size_t r = 0; r < count; r++) {
+        asm_instr_t instr = instrs[r];
+        asm_instr_t* previous = w > 0 ? &instrs[w - 1] : NULL;
+
+        if (peephole_is_move(&instr)) {
+            // movq x, x
+            if (peephole_same_operand(&instr.operands[0], &instr.operands[1])) {
+                rewritten++;
+                continue;
+            }
+
+            // movq a, b; movq b, a
+            if (previous && peephole_is_move(previous) &&
+                peephole_same_operand(&previous->operands[0], &instr.operands[1]) &&
+                peephole_same_operand(&previous->operands[1], &instr.operands[0])) {
+                rewritten++;
+                continue;
+            }
+
+            // movq %reg, slot; ...; movq slot, x -> movq %reg, x
+            if (peephole_location(&instr.operands[0]) && instr.operands[0].kind == ASM_OPERAND_MEMORY) {
+                register_t reg = peephole_forwarded_register(instrs, w, &instr.operands[0]);
+                if (reg != REG_NONE) {
+                    instr.operands[0].kind = ASM_OPERAND_REGISTER;
+                    instr.operands[0].reg = reg;
+                    instr.operands[0].size = 8;
+                    instr.operands[0].value = 0;
+                    rewritten++;
+                    if (peephole_same_operand(&instr.operands[0], &instr.operands[1])) continue;
+                }
+            }
+        }
+
+        if (instr.kind == ASM_INSTRUCTION && instr.opcode == ASM_JCC &&
+            (instr.condition == OP_EQ || instr.condition == OP_NE)) {
+            // setcc / movzbl / test / je|jne -> jcc on the flags of the compare;
+            // setcc and movzbl keep the flags, and are removed later if dead
+            int condition = peephole_flag_condition(instrs, w);
+            if (condition >= 0) {
+                instr.condition = instr.condition == OP_NE ? (ast_operator_t)condition :
+                                  codegen_inverse_condition((ast_operator_t)condition);
+                w--;
+                previous = w > 0 ? &instrs[w - 1] : NULL;
+                rewritten++;
+            }
+        }
+
+        if (instr.kind == ASM_INSTRUCTION && instr.opcode == ASM_JMP && instr.operand_count == 1) {
+            // jmp to the next instruction
+            if (peephole_label_follows(instrs, count, r, &instr.operands[0])) {
+                rewritten++;
+                continue;
+            }
+
+            // jcc L1; jmp L2; L1: -> j!cc L2; L1:
+            if (previous && previous->kind == ASM_INSTRUCTION && previous->opcode == ASM_JCC &&
+                previous->operand_count == 1 &&
+                peephole_label_follows(instrs, count, r, &previous->operands[0])) {
+                previous->condition = codegen_inverse_condition(previous->condition);
+                previous->operands[0] = instr.operands[0];
+                rewritten++;
+                continue;
+            }
+        }
+
+        instrs[w++] = instr;
+    }
+
+    codegen->instr_count = w;
+    return rewritten;
+}
+
+// Helper: Rewrite "movq a, tmp; op x, tmp; movq tmp, a" with tmp dead after
+// the store into "op x, a" in place of the load
+static int peephole_operate_in_place(asm_instr_t* load, const asm_instr_t* op, const asm_instr_t* store,
+                                     peephole_set_t live) {
+    if (!peephole_is_move(load) || !peephole_is_move(store) || op->kind != ASM_INSTRUCTION || op->suffix != 'q') {
+        return 0;
+    }
+    const asm_operand_t* home = &load->operands[0];
+    const asm_operand_t* temporary = &load->operands[1];
+    if (!peephole_same_operand(&store->operands[0], temporary) || !peephole_same_operand(&store->operands[1], home) ||
+        !peephole_is_full_register(temporary) || (live & peephole_location(temporary)) ||
+        !(peephole_is_full_register(home) || home->kind == ASM_OPERAND_MEMORY)) {
+        return 0;
+    }
+
+    asm_instr_t result = *op;
+    switch (op->opcode) {
+        case ASM_ADD:
+        case ASM_SUB:
+        case ASM_SAL:
+        case ASM_IMUL:
+            if (op->operand_count != 2 || !peephole_same_operand(&op->operands[1], temporary)) return 0;
+            if (op->opcode == ASM_IMUL && home->kind != ASM_OPERAND_REGISTER) return 0;
+            if (peephole_same_operand(&op->operands[0], temporary)) result.operands[0] = *home;
+            if (result.operands[0].kind == ASM_OPERAND_MEMORY && home->kind == ASM_OPERAND_MEMORY) return 0;
+            result.operands[1] = *home;
+            break;
+
+        case ASM_NEG:
+            if (op->operand_count != 1 || !peephole_same_operand(&op->operands[0], temporary)) return 0;
+            result.operands[0] = *home;
+            break;
+
+        default:
+            return 0;
+    }
+
+    *load = result;
+    return 1;
+}
+
+// Helper: Replace tmp by x where instr reads it, given "movq x, tmp" just
+// before and tmp dead after instr. Fails if the result is not encodable.
+static int peephole_propagate_copy(const asm_instr_t* move, asm_instr_t* instr, peephole_set_t live) {
+    if (!peephole_is_move(move) || instr->kind != ASM_INSTRUCTION || instr->suffix != 'q') return 0;
+
+    const asm_operand_t* source = &move->operands[0];
+    const asm_operand_t* temporary = &move->operands[1];
+    peephole_set_t location = peephole_location(temporary);
+    if (!location || (live & location) || source->kind == ASM_OPERAND_SYMBOL ||
+        (source->kind == ASM_OPERAND_REGISTER && source->size != 8)) {
+        return 0;
+    }
+
+    // Operands read but not written
+    int first = 0, last = 0;
+    switch (instr->opcode) {
+        case ASM_MOV:
+        case ASM_ADD:
+        case ASM_SUB:
+        case ASM_IMUL:
+            if (instr->operand_count != 2 || peephole_same_operand(&instr->operands[1], temporary)) return 0;
+            break;
+        case ASM_CMP:
+        case ASM_TEST:
+            if (instr->operand_count != 2) return 0;
+            last = 1;
+            break;
+        case ASM_PUSH:
+            if (instr->operand_count != 1) return 0;
+            break;
+        default:
+            return 0;
+    }
+
+    asm_instr_t result = *instr;
+    int replaced = 0;
+    for (int i = first; i <= last; i++) {
+        if (peephole_same_operand(&result.operands[i], temporary)) {
+            result.operands[i] = *source;
+            replaced++;
+        }
+    }
+    if (!replaced) return 0;
+
+    int memory = 0;
+    for (int i = 0; i < result.operand_count; i++) {
+        const asm_operand_t* operand = &result.operands[i];
+        if (operand->kind == ASM_OPERAND_MEMORY || operand->kind == ASM_OPERAND_SYMBOL) memory++;
+        if (operand->kind == ASM_OPERAND_IMMEDIATE && i > 0) return 0;
+    }
+    if (memory > 1) return 0;
+    if (result.opcode == ASM_IMUL && result.operands[1].kind != ASM_OPERAND_REGISTER) return 0;
+
+    // Only movq to a register takes a 64-bit immediate
+    int wide = result.opcode == ASM_MOV && result.operands[1].kind == ASM_OPERAND_REGISTER;
+    if (source->kind == ASM_OPERAND_IMMEDIATE && !wide && (source->value < INT_MIN || source->value > INT_MAX)) {
+        return 0;
+    }
+
+    *instr = result;
+    return 1;
+}
+
+// Rewrites driven by liveness: dead instructions and move chains
+static size_t peephole_dead(codegen_t* codegen) {
+    asm_instr_t* instrs = codegen->instrs;
+    size_t count = codegen->instr_count;
+    peephole_set_t* live_out = peephole_liveness(instrs, count);
+    if (!live_out) return 0;
+    size_t w = 0;
+    size_t rewritten = 0;
+
+    // Removing a dead instruction or merging a move only shortens live
+    // ranges, so the liveness computed up front stays conservative
+    for (size_t r = 0; r < count; r++) {
+        asm_instr_t instr = instrs[r];
+        peephole_effects_t effects = peephole_effects(&instr);
+
+        if (effects.removable && effects.def && !(effects.def & live_out[r])) {
+            rewritten++;
+            continue;
+        }
+
+        if (w >= 2 && peephole_operate_in_place(&instrs[w - 2], &instrs[w - 1], &instr, live_out[r])) {
+            w--;
+            rewritten++;
+            continue;
+        }
+
+        // movq x, tmp; op tmp, y (tmp dead) -> op x, y
+        if (w > 0 && peephole_propagate_copy(&instrs[w - 1], &instr, live_out[r])) {
+            w--;
+            rewritten++;
+            if (peephole_is_move(&instr) && peephole_same_operand(&instr.operands[0], &instr.operands[1])) {
+                continue;
+            }
+        }
+
+        instrs[w++] = instr;
+    }
+
+    free(live_out);
+    codegen->instr_count = w;
+    return rewritten;
+}
+
+size_t peephole_optimize(codegen_t* codegen) {
+    size_t rewritten = peephole_reduce_multiplies(codegen);
+
+    for (int round = 0; round < PEEPHOLE_MAX_ROUNDS; round++) {
+        size_t changes = peephole_local(codegen);
+        changes += peephole_dead(codegen);
+        rewritten += changes;
+        if (changes == 0) break;
+    }
+    return rewritten;
+}
@@ -0,0 +1,25 @@
+// src/peephole.h
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include "codegen.h"
+
+/**
+ * @brief Peephole optimization of the buffered instructions of one function
+ *
+ * Rewrites codegen->instrs in place:
+ * - removes self moves, moves that undo the previous one and instructions
+ *   whose results are never read (by liveness over registers, flags and
+ *   %rbp spill slots)
+ * - forwards stores to spill slots to later loads in the same block and
+ *   merges move chains through a dead temporary
+ * - branches directly on the flags of a cmp when its setcc result is only
+ *   tested by a following je / jne
+ * - turns imul by a power of two into a shift
+ * - removes jumps to the next instruction and inverts a jcc over a jmp
+ *
+ * @return size_t Number of instructions removed or rewritten
+ */
+size_t peephole_optimize(codegen_t* codegen);
+
+#endif // PEEPHOLE_H
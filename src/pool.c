@@ -0,0 +1,188 @@
+// src/pool.c
+#define _POSIX_C_SOURCE 200809L   // sysconf()
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "pool.h"
+
+// Initial number of tasks each queue can hold (doubled when full)
+#define POOL_QUEUE_CAPACITY 64
+
+size_t pool_default_threads(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t)count : 1;
+}
+
+// Helper: Append task at the tail of queue (caller holds queue->lock)
+static int pool_queue_push(pool_queue_t* queue, pool_task_t task) {
+    if (queue->count == queue->capacity) {
+        size_t capacity = queue->capacity ? queue->capacity * 2 : POOL_QUEUE_CAPACITY;
+        pool_task_t* tasks = malloc(capacity * sizeof(pool_task_t));
+        if (!tasks) return 0;
+        for (size_t i = 0; i < queue->count; i++) {
+            tasks[i] = queue->tasks[(queue->head + i) % queue->capacity];
+        }
+        free(queue->tasks);
+        queue->tasks = tasks;
+        queue->head = 0;
+        queue->capacity = capacity;
+    }
+
+    queue->tasks[(queue->head + queue->count) % queue->capacity] = task;
+    queue->count++;
+    return 1;
+}
+
+// Helper: Take the newest (own queue) or oldest (stealing) task
+static int pool_queue_take(pool_queue_t* queue, int steal, pool_task_t* task) {
+    pthread_mutex_lock(&queue->lock);
+    int found = queue->count > 0;
+    if (found) {
+        if (steal) {
+            *task = queue->tasks[queue->head];
+            queue->head = (queue->head + 1) % queue->capacity;
+        } else {
+            *task = queue->tasks[(queue->head + queue->count - 1) % queue->capacity];
+        }
+        queue->count--;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return found;
+}
+
+// Helper: Next task for worker, own queue first
+static int pool_find_task(pool_worker_t* worker, pool_task_t* task) {
+    pool_t* pool = worker->pool;
+    if (pool_queue_take(&pool->queues[worker->index], 0, task)) return 1;
+
+    for (size_t i = 1; i < pool->thread_count; i++) {
+        size_t victim = (worker->index + i) % pool->thread_count;
+        if (pool_queue_take(&pool->queues[victim], 1, task)) return 1;
+    }
+    return 0;
+}
+
+// Helper: Thread body
+static void* pool_worker_main(void* argument) {
+    pool_worker_t* worker = argument;
+    pool_t* pool = worker->pool;
+
+    for (;;) {
+        // Sleep until a task is queued somewhere, then claim it
+        pthread_mutex_lock(&pool->lock);
+        while (pool->queued == 0 && !pool->stopping) {
+            pthread_cond_wait(&pool->work_available, &pool->lock);
+        }
+        if (pool->queued == 0) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        pool->queued--;
+        pthread_mutex_unlock(&pool->lock);
+
+        // The claim guarantees a task is in some queue
+        pool_task_t task;
+        while (!pool_find_task(worker, &task)) {
+            sched_yield();
+        }
+        task.function(task.argument);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_broadcast(&pool->work_done);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+pool_t* pool_create(size_t thread_count) {
+    if (thread_count == 0) thread_count = pool_default_threads();
+
+    pool_t* pool = calloc(1, sizeof(pool_t));
+    if (!pool) return NULL;
+
+    pool->threads = calloc(thread_count, sizeof(pthread_t));
+    pool->workers = calloc(thread_count, sizeof(pool_worker_t));
+    pool->queues = calloc(thread_count, sizeof(pool_queue_t));
+    if (!pool->threads || !pool->workers || !pool->queues) {
+        free(pool->threads);
+        free(pool->workers);
+        free(pool->queues);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_available, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    // A pool that got fewer threads than asked for still works
+    for (size_t i = 0; i < thread_count; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        pthread_mutex_init(&pool->queues[i].lock, NULL);
+        if (pthread_create(&pool->threads[i], NULL, pool_worker_main, &pool->workers[i]) != 0) {
+            pthread_mutex_destroy(&pool->queues[i].lock);
+            break;
+        }
+        pool->thread_count++;
+    }
+    if (pool->thread_count == 0) {
+        pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void pool_destroy(pool_t* pool) {
+    if (!pool) return;
+
+    pool_wait(pool);
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = 1;
+    pthread_cond_broadcast(&pool->work_available);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    for (size_t i = 0; i < pool->thread_count; i++) {
+        pthread_mutex_destroy(&pool->queues[i].lock);
+        free(pool->queues[i].tasks);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_available);
+    pthread_cond_destroy(&pool->work_done);
+    free(pool->threads);
+    free(pool->workers);
+    free(pool->queues);
+    free(pool);
+}
+
+int pool_submit(pool_t* pool, pool_function_t function, void* argument) {
+    // The counters change together with the queue, so a claimed task is
+    // always in some queue and pending never undercounts
+    pthread_mutex_lock(&pool->lock);
+    pool_queue_t* queue = &pool->queues[pool->next_queue];
+    pool_task_t task = {function, argument};
+    pthread_mutex_lock(&queue->lock);
+    int pushed = pool_queue_push(queue, task);
+    pthread_mutex_unlock(&queue->lock);
+
+    if (pushed) {
+        pool->next_queue = (pool->next_queue + 1) % pool->thread_count;
+        pool->queued++;
+        pool->pending++;
+        pthread_cond_signal(&pool->work_available);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return pushed;
+}
+
+void pool_wait(pool_t* pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,76 @@
+// src/pool.h
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+// Unit of work run by a pool thread
+typedef void (*pool_function_t)(void* argument);
+
+typedef struct {
+    pool_function_t function;
+    void* argument;
+} pool_task_t;
+
+// Per-thread deque: the owner takes from the tail, thieves from the head
+typedef struct {
+    pool_task_t* tasks;   // Ring buffer
+    size_t head;
+    size_t count;
+    size_t capacity;
+    pthread_mutex_t lock;
+} pool_queue_t;
+
+// Work-stealing thread pool
+typedef struct pool pool_t;
+
+typedef struct {
+    pool_t* pool;
+    size_t index;         // Own queue in pool->queues
+} pool_worker_t;
+
+struct pool {
+    pthread_t* threads;
+    pool_worker_t* workers;
+    pool_queue_t* queues;      // One per thread
+    size_t thread_count;
+    size_t next_queue;         // Round-robin target of pool_submit()
+
+    pthread_mutex_t lock;      // Guards the counters below
+    pthread_cond_t work_available;
+    pthread_cond_t work_done;
+    size_t queued;             // Tasks waiting in the queues
+    size_t pending;            // Tasks submitted and not yet finished
+    int stopping;
+};
+
+// Pool lifecycle
+/**
+ * @brief Starts a pool of worker threads
+ *
+ * @param thread_count Number of threads (0 selects the number of online CPUs)
+ * @return pool_t* Pointer to new pool, or NULL on failure
+ */
+pool_t* pool_create(size_t thread_count);
+
+// Wait for all submitted tasks, then stop the threads (safe to call with NULL)
+void pool_destroy(pool_t* pool);
+
+/**
+ * @brief Queues function(argument) to run on some pool thread
+ *
+ * Tasks are dealt round-robin onto the threads' queues; a thread whose queue
+ * runs dry steals the oldest task from another queue.
+ *
+ * @return int 1 on success, 0 if the task could not be queued
+ */
+int pool_submit(pool_t* pool, pool_function_t function, void* argument);
+
+// Block until every submitted task has finished
+void pool_wait(pool_t* pool);
+
+// Number of CPUs available to the process (at least 1)
+size_t pool_default_threads(void);
+
+#endif // POOL_H
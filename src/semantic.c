@@ -4,7 +4,7 @@
 #include <string.h>
 #include "semantic.h"
 
-// Hash function for symbol table
+// Hash function for strings that are not interned (interned names use intern_hash())
 unsigned int hash_string(const char* str) {
     unsigned int hash = 5381;
     int c;
@@ -13,16 +13,32 @@ unsigned int hash_string(const char* str) {
         hash = ((hash << 5) + hash) + c;
     }
     
-    return hash % SYMBOL_TABLE_SIZE;
+    return hash;
+}
+
+// Helper: Grow a dynamic array to hold at least count + 1 items
+static int symbol_table_reserve(void** items, size_t* capacity, size_t count, size_t item_size) {
+    if (count < *capacity) return 1;
+    
+    size_t new_capacity = *capacity ? *capacity * 2 : 16;
+    void* new_items = realloc(*items, new_capacity * item_size);
+    if (!new_items) return 0;
+    
+    *items = new_items;
+    *capacity = new_capacity;
+    return 1;
 }
 
 // Symbol table operations
 symbol_table_t* symbol_table_create(void) {
-    symbol_table_t* table = malloc(sizeof(symbol_table_t));
+    symbol_table_t* table = calloc(1, sizeof(symbol_table_t));
     if (!table) return NULL;
     
-    for (int i = 0; i < SYMBOL_TABLE_SIZE; i++) {
-        table->buckets[i] = NULL;
+    table->capacity = SYMBOL_TABLE_INITIAL_CAPACITY;
+    table->slots = calloc(table->capacity, sizeof(symbol_slot_t));
+    if (!table->slots) {
+        free(table);
+        return NULL;
     }
     
     return table;
@@ -31,68 +47,118 @@ symbol_table_t* symbol_table_create(void) {
 void symbol_table_destroy(symbol_table_t* table) {
     if (!table) return;
     
-    for (int i = 0; i < SYMBOL_TABLE_SIZE; i++) {
-        symbol_t* current = table->buckets[i];
-        while (current) {
-            symbol_t* next = current->next;
-            symbol_destroy(current);
-            current = next;
-        }
+    for (size_t i = 0; i < table->undo_count; i++) {
+        symbol_destroy(table->undo_log[i]);
     }
     
+    free(table->slots);
+    free(table->undo_log);
+    free(table->scope_marks);
     free(table);
 }
 
-symbol_t* symbol_table_lookup(symbol_table_t* table, const char* name) {
-    if (!table || !name) return NULL;
+// Helper: Slot holding name, or the empty slot where it would go; adds the
+// number of slots examined to *probes
+static symbol_slot_t* symbol_table_probe(const symbol_table_t* table, const char* name, size_t* probes) {
+    size_t mask = table->capacity - 1;
+    size_t index = intern_hash(name) & mask;
+    size_t count = 1;
     
-    unsigned int index = hash_string(name);
-    symbol_t* current = table->buckets[index];
+    while (table->slots[index].name && table->slots[index].name != name) {
+        index = (index + 1) & mask;
+        count++;
+    }
+    
+    *probes += count;
+    return &table->slots[index];
+}
+
+static symbol_slot_t* symbol_table_slot(symbol_table_t* table, const char* name) {
+    return symbol_table_probe(table, name, &table->probes);
+}
+
+// Helper: Double the slot array and reinsert every name
+static int symbol_table_grow(symbol_table_t* table) {
+    symbol_slot_t* old_slots = table->slots;
+    size_t old_capacity = table->capacity;
+    
+    table->slots = calloc(old_capacity * 2, sizeof(symbol_slot_t));
+    if (!table->slots) {
+        table->slots = old_slots;
+        return 0;
+    }
+    table->capacity = old_capacity * 2;
     
-    while (current) {
-        if (strcmp(current->name, name) == 0) {
-            return current;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_slots[i].name) {
+            *symbol_table_slot(table, old_slots[i].name) = old_slots[i];
         }
-        current = current->next;
     }
     
-    return NULL;
+    free(old_slots);
+    return 1;
+}
+
+symbol_t* symbol_table_lookup(symbol_table_t* table, const char* name) {
+    if (!table || !name) return NULL;
+    
+    return symbol_table_slot(table, name)->symbol;
 }
 
 int symbol_table_insert(symbol_table_t* table, symbol_t* symbol) {
     if (!table || !symbol) return 0;
     
-    // Check if symbol already exists
-    if (symbol_table_lookup(table, symbol->name)) {
+    // Keep the load factor below 1/2
+    if ((table->name_count + 1) * 2 > table->capacity && !symbol_table_grow(table)) {
+        return 0;
+    }
+    
+    symbol_slot_t* slot = symbol_table_slot(table, symbol->name);
+    
+    // Scope levels only repeat for sibling scopes, which have been popped by now
+    if (slot->symbol && slot->symbol->scope_level == symbol->scope_level) {
         return 0; // Symbol already exists
     }
     
-    unsigned int index = hash_string(symbol->name);
-    symbol->next = table->buckets[index];
-    table->buckets[index] = symbol;
+    if (!symbol_table_reserve((void**)&table->undo_log, &table->undo_capacity,
+                              table->undo_count, sizeof(symbol_t*))) {
+        return 0;
+    }
+    
+    if (!slot->name) {
+        slot->name = symbol->name;
+        table->name_count++;
+    }
+    
+    symbol->shadowed = slot->symbol;
+    slot->symbol = symbol;
+    table->undo_log[table->undo_count++] = symbol;
+    
+    return 1;
+}
+
+int symbol_table_push_scope(symbol_table_t* table) {
+    if (!table) return 0;
     
+    if (!symbol_table_reserve((void**)&table->scope_marks, &table->scope_capacity,
+                              table->scope_count, sizeof(size_t))) {
+        return 0;
+    }
+    
+    table->scope_marks[table->scope_count++] = table->undo_count;
     return 1;
 }
 
-void symbol_table_remove(symbol_table_t* table, const char* name) {
-    if (!table || !name) return;
+void symbol_table_pop_scope(symbol_table_t* table) {
+    if (!table || table->scope_count == 0) return;
     
-    unsigned int index = hash_string(name);
-    symbol_t* current = table->buckets[index];
-    symbol_t* prev = NULL;
+    size_t mark = table->scope_marks[--table->scope_count];
     
-    while (current) {
-        if (strcmp(current->name, name) == 0) {
-            if (prev) {
-                prev->next = current->next;
-            } else {
-                table->buckets[index] = current->next;
-            }
-            symbol_destroy(current);
-            return;
-        }
-        prev = current;
-        current = current->next;
+    // Unwind in reverse declaration order so each name gets its outer symbol back
+    while (table->undo_count > mark) {
+        symbol_t* symbol = table->undo_log[--table->undo_count];
+        symbol_table_slot(table, symbol->name)->symbol = symbol->shadowed;
+        symbol_destroy(symbol);
     }
 }
 
@@ -101,17 +167,17 @@ symbol_t* symbol_create(const char* name, symbol_type_t type, data_type_t data_t
     symbol_t* symbol = malloc(sizeof(symbol_t));
     if (!symbol) return NULL;
     
-    symbol->name = malloc(strlen(name) + 1);
+    symbol->name = intern_string(name);
     if (!symbol->name) {
         free(symbol);
         return NULL;
     }
-    strcpy(symbol->name, name);
     
     symbol->type = type;
     symbol->data_type = data_type;
     symbol->scope_level = 0;
-    symbol->next = NULL;
+    symbol->slot = AST_NO_SLOT;
+    symbol->shadowed = NULL;
     
     // Initialize function info
     symbol->function_info.parameter_types = NULL;
@@ -124,51 +190,31 @@ symbol_t* symbol_create(const char* name, symbol_type_t type, data_type_t data_t
 void symbol_destroy(symbol_t* symbol) {
     if (!symbol) return;
     
-    free(symbol->name);
     if (symbol->function_info.parameter_types) {
         free(symbol->function_info.parameter_types);
     }
     free(symbol);
 }
 
-// Scope operations
-scope_t* scope_create(scope_t* parent, int level) {
-    scope_t* scope = malloc(sizeof(scope_t));
-    if (!scope) return NULL;
-    
-    scope->symbols = symbol_table_create();
-    if (!scope->symbols) {
-        free(scope);
-        return NULL;
-    }
-    
-    scope->level = level;
-    scope->parent = parent;
-    
-    return scope;
-}
-
-void scope_destroy(scope_t* scope) {
-    if (!scope) return;
-    
-    symbol_table_destroy(scope->symbols);
-    free(scope);
-}
-
 // Semantic analyzer lifecycle
 semantic_analyzer_t* semantic_create(void) {
     semantic_analyzer_t* analyzer = malloc(sizeof(semantic_analyzer_t));
     if (!analyzer) return NULL;
     
-    analyzer->current_scope = NULL;
     analyzer->scope_level = 0;
     analyzer->error_count = 0;
     analyzer->error_capacity = 10;
     analyzer->current_function_return_type = TYPE_VOID;
     analyzer->current_function_name = NULL;
+    analyzer->local_count = 0;
+    analyzer->pool = NULL;
+    analyzer->globals = NULL;
     
     analyzer->errors = malloc(analyzer->error_capacity * sizeof(semantic_error_t));
-    if (!analyzer->errors) {
+    analyzer->symbols = symbol_table_create();
+    if (!analyzer->errors || !analyzer->symbols) {
+        free(analyzer->errors);
+        symbol_table_destroy(analyzer->symbols);
         free(analyzer);
         return NULL;
     }
@@ -183,9 +229,7 @@ void semantic_destroy(semantic_analyzer_t* analyzer) {
     if (!analyzer) return;
     
     // Clean up all scopes
-    while (analyzer->current_scope) {
-        semantic_pop_scope(analyzer);
-    }
+    symbol_table_destroy(analyzer->symbols);
     
     // Clean up errors
     for (size_t i = 0; i < analyzer->error_count; i++) {
@@ -194,10 +238,6 @@ void semantic_destroy(semantic_analyzer_t* analyzer) {
     }
     free(analyzer->errors);
     
-    if (analyzer->current_function_name) {
-        free(analyzer->current_function_name);
-    }
-    
     free(analyzer);
 }
 
@@ -205,60 +245,46 @@ void semantic_destroy(semantic_analyzer_t* analyzer) {
 void semantic_push_scope(semantic_analyzer_t* analyzer) {
     if (!analyzer) return;
     
-    scope_t* new_scope = scope_create(analyzer->current_scope, analyzer->scope_level + 1);
-    if (!new_scope) {
+    if (!symbol_table_push_scope(analyzer->symbols)) {
         fprintf(stderr, "Error: Failed to create new scope\n");
         return;
     }
     
-    analyzer->current_scope = new_scope;
     analyzer->scope_level++;
 }
 
 void semantic_pop_scope(semantic_analyzer_t* analyzer) {
-    if (!analyzer || !analyzer->current_scope) return;
+    if (!analyzer || analyzer->scope_level == 0) return;
     
-    scope_t* old_scope = analyzer->current_scope;
-    analyzer->current_scope = old_scope->parent;
+    symbol_table_pop_scope(analyzer->symbols);
     analyzer->scope_level--;
-    
-    scope_destroy(old_scope);
 }
 
 symbol_t* semantic_lookup_symbol(semantic_analyzer_t* analyzer, const char* name) {
     if (!analyzer || !name) return NULL;
     
-    scope_t* current = analyzer->current_scope;
-    while (current) {
-        symbol_t* symbol = symbol_table_lookup(current->symbols, name);
-        if (symbol) {
-            return symbol;
-        }
-        current = current->parent;
+    symbol_t* symbol = symbol_table_lookup(analyzer->symbols, name);
+    if (!symbol && analyzer->globals) {
+        // Other workers read globals too, so the probes are charged to our own table
+        symbol = symbol_table_probe(analyzer->globals, name, &analyzer->symbols->probes)->symbol;
     }
-    
-    return NULL;
+    return symbol;
 }
 
 int semantic_declare_symbol(semantic_analyzer_t* analyzer, symbol_t* symbol) {
-    if (!analyzer || !symbol || !analyzer->current_scope) return 0;
-    
-    // Check if symbol already exists in current scope
-    symbol_t* existing = symbol_table_lookup(analyzer->current_scope->symbols, symbol->name);
-    if (existing) {
-        return 0; // Symbol already declared in this scope
-    }
+    if (!analyzer || !symbol || analyzer->scope_level == 0) return 0;
     
+    // Fails if the symbol already exists in the current scope
     symbol->scope_level = analyzer->scope_level;
-    return symbol_table_insert(analyzer->current_scope->symbols, symbol);
+    return symbol_table_insert(analyzer->symbols, symbol);
 }
 
 // Error handling
 void semantic_error(semantic_analyzer_t* analyzer, const char* message, ast_node_t* node) {
     if (!analyzer || !message) return;
     
-    // For now, we don't have line/column info in AST nodes, so use 0
-    semantic_error_at(analyzer, message, 0, 0, node ? "AST node" : "unknown");
+    // Nodes built outside the parser have no position (line 0)
+    semantic_error_at(analyzer, message, node ? (int)node->line : 0, node ? (int)node->column : 0, NULL);
 }
 
 void semantic_error_at(semantic_analyzer_t* analyzer, const char* message, int line, int column, const char* context) {
@@ -316,6 +342,115 @@ int semantic_analyze(semantic_analyzer_t* analyzer, ast_node_t* ast) {
     return semantic_analyze_program(analyzer, ast);
 }
 
+// Function body analyzed on a pool thread
+typedef struct {
+    semantic_analyzer_t* analyzer;    // Own analyzer, collecting the errors
+    symbol_table_t* globals;          // Shared, read-only while the jobs run
+    ast_node_t* function;
+    int success;
+} semantic_function_job_t;
+
+// Helper: Analyze one function body (a pool_function_t)
+static void semantic_analyze_function_job(void* argument) {
+    semantic_function_job_t* job = argument;
+    job->analyzer = semantic_create();
+    if (!job->analyzer) {
+        job->success = 0;
+        return;
+    }
+    job->analyzer->globals = job->globals;
+    job->success = semantic_analyze_function_decl(job->analyzer, job->function);
+}
+
+// Helper: Second pass with the function bodies spread over analyzer->pool.
+// Once the first pass has declared every function the bodies only read the
+// global scope, so they are independent; errors are merged back in
+// declaration order. Returns 0 (and analyzes nothing) when the program has
+// too few bodies or has global variables, whose visibility depends on order.
+static int semantic_analyze_functions_parallel(semantic_analyzer_t* analyzer, ast_node_t* node,
+                                               int* success) {
+    size_t body_count = 0;
+    for (size_t i = 0; i < node->data.program.declaration_count; i++) {
+        ast_node_t* decl = node->data.program.declarations[i];
+        if (decl->type == AST_VARIABLE_DECL) return 0;
+        if (decl->type == AST_FUNCTION_DECL && decl->data.function_decl.body) body_count++;
+    }
+    if (body_count < 2) return 0;
+    
+    semantic_function_job_t* jobs = calloc(body_count, sizeof(semantic_function_job_t));
+    if (!jobs) return 0;
+    
+    size_t job_count = 0;
+    for (size_t i = 0; i < node->data.program.declaration_count; i++) {
+        ast_node_t* decl = node->data.program.declarations[i];
+        if (decl->type != AST_FUNCTION_DECL || !decl->data.function_decl.body) continue;
+        
+        semantic_function_job_t* job = &jobs[job_count++];
+        job->globals = analyzer->symbols;
+        job->function = decl;
+        if (!pool_submit(analyzer->pool, semantic_analyze_function_job, job)) {
+            semantic_analyze_function_job(job);
+        }
+    }
+    pool_wait(analyzer->pool);
+    
+    for (size_t i = 0; i < job_count; i++) {
+        semantic_analyzer_t* worker = jobs[i].analyzer;
+        if (!jobs[i].success) *success = 0;
+        if (!worker) continue;
+        
+        for (size_t e = 0; e < worker->error_count; e++) {
+            semantic_error_t* error = &worker->errors[e];
+            semantic_error_at(analyzer, error->message, error->line, error->column, error->context);
+        }
+        analyzer->symbols->probes += worker->symbols->probes;
+        semantic_destroy(worker);
+    }
+    
+    free(jobs);
+    return 1;
+}
+
+// Runtime library functions (runtime/runtime.h) callable without a declaration
+static const struct {
+    const char* name;
+    data_type_t return_type;
+    size_t parameter_count;   // 0 or 1
+    data_type_t parameter_type;
+} runtime_functions[] = {
+    {"print", TYPE_VOID, 1, TYPE_CHAR_PTR},
+    {"print_int", TYPE_VOID, 1, TYPE_INT},
+    {"print_char", TYPE_VOID, 1, TYPE_INT},      // Character code; the runtime reads the low byte
+    {"read_int", TYPE_INT, 0, TYPE_VOID},
+    {"flush", TYPE_VOID, 0, TYPE_VOID}
+};
+
+// Helper: Declare the runtime functions the program did not declare itself,
+// so its own prototypes (e.g. print_int returning int) keep working
+static int semantic_declare_runtime_functions(semantic_analyzer_t* analyzer) {
+    for (size_t i = 0; i < sizeof(runtime_functions) / sizeof(runtime_functions[0]); i++) {
+        const char* name = intern_string(runtime_functions[i].name);
+        if (semantic_lookup_symbol(analyzer, name)) continue;
+        
+        symbol_t* symbol = symbol_create(name, SYMBOL_FUNCTION, runtime_functions[i].return_type);
+        if (!symbol) return 0;
+        if (runtime_functions[i].parameter_count > 0) {
+            symbol->function_info.parameter_types = malloc(sizeof(data_type_t));
+            if (!symbol->function_info.parameter_types) {
+                symbol_destroy(symbol);
+                return 0;
+            }
+            symbol->function_info.parameter_types[0] = runtime_functions[i].parameter_type;
+            symbol->function_info.parameter_count = 1;
+        }
+        if (!semantic_declare_symbol(analyzer, symbol)) {
+            symbol_destroy(symbol);
+            return 0;
+        }
+    }
+    return 1;
+}
+
 // AST analysis functions
 int semantic_analyze_program(semantic_analyzer_t* analyzer, ast_node_t* node) {
     if (!node || node->type != AST_PROGRAM) return 0;
@@ -363,8 +498,14 @@ int semantic_analyze_program(semantic_analyzer_t* analyzer, ast_node_t* node) {
             }
         }
     }
+    if (!semantic_declare_runtime_functions(analyzer)) {
+        success = 0;
+    }
     
     // Second pass: analyze function bodies and global variables
+    if (analyzer->pool && semantic_analyze_functions_parallel(analyzer, node, &success)) {
+        return success;
+    }
     for (size_t i = 0; i < node->data.program.declaration_count; i++) {
         ast_node_t* decl = node->data.program.declarations[i];
         
@@ -387,11 +528,7 @@ int semantic_analyze_function_decl(semantic_analyzer_t* analyzer, ast_node_t* no
     
     // Set current function context
     analyzer->current_function_return_type = node->data.function_decl.return_type;
-    if (analyzer->current_function_name) {
-        free(analyzer->current_function_name);
-    }
-    analyzer->current_function_name = malloc(strlen(node->data.function_decl.name) + 1);
-    strcpy(analyzer->current_function_name, node->data.function_decl.name);
+    analyzer->current_function_name = node->data.function_decl.name;
     
     // If function has no body, it's just a declaration
     if (!node->data.function_decl.body) {
@@ -400,6 +537,7 @@ int semantic_analyze_function_decl(semantic_analyzer_t* analyzer, ast_node_t* no
     
     // Create new scope for function
     semantic_push_scope(analyzer);
+    analyzer->local_count = 0;
     
     int success = 1;
     
@@ -420,6 +558,8 @@ int semantic_analyze_function_decl(semantic_analyzer_t* analyzer, ast_node_t* no
             semantic_error(analyzer, error_msg, param);
             if (symbol) symbol_destroy(symbol);
             success = 0;
+        } else {
+            symbol->slot = param->data.parameter.slot = analyzer->local_count++;
         }
     }
     
@@ -430,13 +570,11 @@ int semantic_analyze_function_decl(semantic_analyzer_t* analyzer, ast_node_t* no
     
     // Pop function scope
     semantic_pop_scope(analyzer);
+    node->data.function_decl.local_count = analyzer->local_count;
     
     // Clear function context
     analyzer->current_function_return_type = TYPE_VOID;
-    if (analyzer->current_function_name) {
-        free(analyzer->current_function_name);
-        analyzer->current_function_name = NULL;
-    }
+    analyzer->current_function_name = NULL;
     
     return success;
 }
@@ -462,6 +600,11 @@ int semantic_analyze_variable_decl(semantic_analyzer_t* analyzer, ast_node_t* no
         return 0;
     }
     
+    // Locals are numbered per function; globals (scope level 1) keep no slot
+    if (analyzer->scope_level > 1) {
+        symbol->slot = node->data.variable_decl.slot = analyzer->local_count++;
+    }
+    
     // Check initializer if present
     if (node->data.variable_decl.initializer) {
         data_type_t init_type = semantic_analyze_expression(analyzer, node->data.variable_decl.initializer);
@@ -654,23 +797,34 @@ int semantic_analyze_expression_stmt(semantic_analyzer_t* analyzer, ast_node_t*
 data_type_t semantic_analyze_expression(semantic_analyzer_t* analyzer, ast_node_t* node) {
     if (!node) return TYPE_VOID;
     
+    data_type_t type;
     switch (node->type) {
         case AST_BINARY_OP:
-            return semantic_analyze_binary_op(analyzer, node);
+            type = semantic_analyze_binary_op(analyzer, node);
+            break;
         case AST_UNARY_OP:
-            return semantic_analyze_unary_op(analyzer, node);
+            type = semantic_analyze_unary_op(analyzer, node);
+            break;
         case AST_FUNCTION_CALL:
-            return semantic_analyze_function_call(analyzer, node);
+            type = semantic_analyze_function_call(analyzer, node);
+            break;
         case AST_IDENTIFIER:
-            return semantic_analyze_identifier(analyzer, node);
+            type = semantic_analyze_identifier(analyzer, node);
+            break;
         case AST_NUMBER:
-            return TYPE_INT;
+            type = TYPE_INT;
+            break;
         case AST_STRING:
-            return TYPE_CHAR_PTR;
+            type = TYPE_CHAR_PTR;
+            break;
         default:
             semantic_error(analyzer, "Unknown expression type", node);
             return TYPE_VOID;
     }
+    
+    // Annotate the tree for IR lowering
+    node->data_type = type;
+    return type;
 }
 
 data_type_t semantic_analyze_binary_op(semantic_analyzer_t* analyzer, ast_node_t* node) {
@@ -686,7 +840,7 @@ data_type_t semantic_analyze_binary_op(semantic_analyzer_t* analyzer, ast_node_t
         char error_msg[256];
         snprintf(error_msg, sizeof(error_msg), 
                 "Cannot apply oper '%s' to types '%s' and '%s'",
-                node->data.binary_op.oper,
+                ast_operator_to_string(node->data.binary_op.oper),
                 data_type_to_string(left_type),
                 data_type_to_string(right_type));
         semantic_error(analyzer, error_msg, node);
@@ -706,7 +860,7 @@ data_type_t semantic_analyze_unary_op(semantic_analyzer_t* analyzer, ast_node_t*
         char error_msg[256];
         snprintf(error_msg, sizeof(error_msg), 
                 "Cannot apply unary oper '%s' to type '%s'",
-                node->data.unary_op.oper,
+                ast_operator_to_string(node->data.unary_op.oper),
                 data_type_to_string(operand_type));
         semantic_error(analyzer, error_msg, node);
         return TYPE_VOID;
@@ -779,6 +933,7 @@ data_type_t semantic_analyze_identifier(semantic_analyzer_t* analyzer, ast_node_
         return TYPE_VOID;
     }
     
+    node->data.identifier.slot = symbol->slot;
     return symbol->data_type;
 }
 
@@ -795,52 +950,60 @@ int semantic_type_is_boolean_context(data_type_t type) {
     return semantic_type_is_numeric(type);
 }
 
-data_type_t semantic_get_binary_result_type(const char* oper, data_type_t left, data_type_t right) {
-    // Assignment
-    if (strcmp(oper, "=") == 0) {
-        return semantic_types_compatible(left, right) ? left : TYPE_VOID;
-    }
-    
-    // Arithmetic operations
-    if (strcmp(oper, "+") == 0 || strcmp(oper, "-") == 0 || 
-        strcmp(oper, "*") == 0 || strcmp(oper, "/") == 0 || strcmp(oper, "%") == 0) {
-        if (semantic_type_is_numeric(left) && semantic_type_is_numeric(right)) {
-            return TYPE_INT;
-        }
-        return TYPE_VOID;
-    }
-    
-    // Comparison operations
-    if (strcmp(oper, "<") == 0 || strcmp(oper, ">") == 0 || 
-        strcmp(oper, "<=") == 0 || strcmp(oper, ">=") == 0 ||
-        strcmp(oper, "==") == 0 || strcmp(oper, "!=") == 0) {
-        if (semantic_types_compatible(left, right)) {
-            return TYPE_INT; // Boolean result represented as int
-        }
-        return TYPE_VOID;
-    }
-    
-    // Logical operations
-    if (strcmp(oper, "&&") == 0 || strcmp(oper, "||") == 0) {
-        if (semantic_type_is_boolean_context(left) && semantic_type_is_boolean_context(right)) {
-            return TYPE_INT;
-        }
-        return TYPE_VOID;
+data_type_t semantic_get_binary_result_type(ast_operator_t oper, data_type_t left, data_type_t right) {
+    switch (oper) {
+        // Assignment
+        case OP_ASSIGN:
+            return semantic_types_compatible(left, right) ? left : TYPE_VOID;
+        
+        // Arithmetic operations
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL:
+        case OP_DIV:
+        case OP_MOD:
+            if (semantic_type_is_numeric(left) && semantic_type_is_numeric(right)) {
+                return TYPE_INT;
+            }
+            return TYPE_VOID;
+        
+        // Comparison operations
+        case OP_LT:
+        case OP_GT:
+        case OP_LE:
+        case OP_GE:
+        case OP_EQ:
+        case OP_NE:
+            if (semantic_types_compatible(left, right)) {
+                return TYPE_INT; // Boolean result represented as int
+            }
+            return TYPE_VOID;
+        
+        // Logical operations
+        case OP_AND:
+        case OP_OR:
+            if (semantic_type_is_boolean_context(left) && semantic_type_is_boolean_context(right)) {
+                return TYPE_INT;
+            }
+            return TYPE_VOID;
+        
+        default:
+            return TYPE_VOID;
     }
-    
-    return TYPE_VOID;
 }
 
-data_type_t semantic_get_unary_result_type(const char* oper, data_type_t operand) {
-    if (strcmp(oper, "-") == 0 || strcmp(oper, "+") == 0) {
-        return semantic_type_is_numeric(operand) ? TYPE_INT : TYPE_VOID;
-    }
-    
-    if (strcmp(oper, "!") == 0) {
-        return semantic_type_is_boolean_context(operand) ? TYPE_INT : TYPE_VOID;
+data_type_t semantic_get_unary_result_type(ast_operator_t oper, data_type_t operand) {
+    switch (oper) {
+        case OP_NEG:
+        case OP_POS:
+            return semantic_type_is_numeric(operand) ? TYPE_INT : TYPE_VOID;
+        
+        case OP_NOT:
+            return semantic_type_is_boolean_context(operand) ? TYPE_INT : TYPE_VOID;
+        
+        default:
+            return TYPE_VOID;
     }
-    
-    return TYPE_VOID;
 }
 
 // Utility functions
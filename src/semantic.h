@@ -3,13 +3,12 @@
 #define SEMANTIC_H
 
 #include "ast.h"
+#include "utils.h"
+#include "pool.h"
 
 // Maximum number of semantic errors to collect
 #define MAX_SEMANTIC_ERRORS 100
 
-// Maximum nesting depth for scopes
-#define MAX_SCOPE_DEPTH 32
-
 // Symbol types
 typedef enum {
     SYMBOL_VARIABLE,
@@ -19,10 +18,11 @@ typedef enum {
 
 // Symbol table entry
 typedef struct symbol {
-    char* name;
+    const char* name;     // Interned
     symbol_type_t type;
     data_type_t data_type;
     int scope_level;
+    int slot;             // Function local number (see ast.h), or AST_NO_SLOT
     
     // Additional info for functions
     struct {
@@ -31,23 +31,37 @@ typedef struct symbol {
         int defined;  // 1 if function has body, 0 if just declared
     } function_info;
     
-    struct symbol* next; // For hash table chaining
+    struct symbol* shadowed; // Outer declaration of the same name hidden by this one
 } symbol_t;
 
-// Symbol table (hash table)
-#define SYMBOL_TABLE_SIZE 256
+// Initial number of name slots in a symbol table (power of two)
+#define SYMBOL_TABLE_INITIAL_CAPACITY 64
 
+// Name slot: the innermost visible symbol for an interned name
+typedef struct {
+    const char* name;     // NULL for an empty slot
+    symbol_t* symbol;     // NULL once every declaration of name went out of scope
+} symbol_slot_t;
+
+// Symbol table: a single open-addressing table for the whole scope stack.
+// Declaring a name pushes the new symbol onto the name's shadow chain and
+// records it in the undo log; leaving a scope unwinds the log back to the
+// mark taken on entry, so scope entry/exit cost O(declarations in the scope).
 typedef struct {
-    symbol_t* buckets[SYMBOL_TABLE_SIZE];
+    symbol_slot_t* slots;
+    size_t capacity;
+    size_t name_count;    // Occupied slots (names are never removed)
+    size_t probes;        // Slots examined by every lookup and insert (for --stats)
+    
+    symbol_t** undo_log;  // Symbols in declaration order
+    size_t undo_count;
+    size_t undo_capacity;
+    
+    size_t* scope_marks;  // undo_count at the entry of each open scope
+    size_t scope_count;
+    size_t scope_capacity;
 } symbol_table_t;
 
-// Scope stack
-typedef struct scope {
-    symbol_table_t* symbols;
-    int level;
-    struct scope* parent;
-} scope_t;
-
 // Semantic error
 typedef struct {
     char* message;
@@ -58,7 +72,7 @@ typedef struct {
 
 // Semantic analyzer state
 typedef struct {
-    scope_t* current_scope;
+    symbol_table_t* symbols;
     int scope_level;
     
     // Error handling
@@ -68,7 +82,14 @@ typedef struct {
     
     // Current function context (for return type checking)
     data_type_t current_function_return_type;
-    char* current_function_name;
+    const char* current_function_name;  // Interned
+    int local_count;                    // Slots numbered so far in the current function
+    
+    // Function bodies are analyzed concurrently on pool when it is set (not
+    // owned); each body gets its own analyzer whose lookups fall back to the
+    // program's read-only global scope in globals
+    pool_t* pool;
+    symbol_table_t* globals;
 } semantic_analyzer_t;
 
 // Semantic analyzer lifecycle
@@ -78,23 +99,22 @@ void semantic_destroy(semantic_analyzer_t* analyzer);
 // Main semantic analysis
 int semantic_analyze(semantic_analyzer_t* analyzer, ast_node_t* ast);
 
-// Symbol table operations
+// Symbol table operations (names passed to lookup must be interned)
 symbol_table_t* symbol_table_create(void);
 void symbol_table_destroy(symbol_table_t* table);
 symbol_t* symbol_table_lookup(symbol_table_t* table, const char* name);
-int symbol_table_insert(symbol_table_t* table, symbol_t* symbol);
-void symbol_table_remove(symbol_table_t* table, const char* name);
+int symbol_table_insert(symbol_table_t* table, symbol_t* symbol);  // 0 if already declared in the current scope
+int symbol_table_push_scope(symbol_table_t* table);
+void symbol_table_pop_scope(symbol_table_t* table);                // Destroys the scope's symbols
 
 // Symbol operations
 symbol_t* symbol_create(const char* name, symbol_type_t type, data_type_t data_type);
 void symbol_destroy(symbol_t* symbol);
 
 // Scope management
-scope_t* scope_create(scope_t* parent, int level);
-void scope_destroy(scope_t* scope);
 void semantic_push_scope(semantic_analyzer_t* analyzer);
 void semantic_pop_scope(semantic_analyzer_t* analyzer);
-symbol_t* semantic_lookup_symbol(semantic_analyzer_t* analyzer, const char* name);
+symbol_t* semantic_lookup_symbol(semantic_analyzer_t* analyzer, const char* name);  // name must be interned
 int semantic_declare_symbol(semantic_analyzer_t* analyzer, symbol_t* symbol);
 
 // AST analysis functions
@@ -118,8 +138,8 @@ data_type_t semantic_analyze_identifier(semantic_analyzer_t* analyzer, ast_node_
 int semantic_types_compatible(data_type_t type1, data_type_t type2);
 int semantic_type_is_numeric(data_type_t type);
 int semantic_type_is_boolean_context(data_type_t type);
-data_type_t semantic_get_binary_result_type(const char* operator, data_type_t left, data_type_t right);
-data_type_t semantic_get_unary_result_type(const char* operator, data_type_t operand);
+data_type_t semantic_get_binary_result_type(ast_operator_t oper, data_type_t left, data_type_t right);
+data_type_t semantic_get_unary_result_type(ast_operator_t oper, data_type_t operand);
 
 // Error handling
 void semantic_error(semantic_analyzer_t* analyzer, const char* message, ast_node_t* node);
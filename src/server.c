@@ -0,0 +1,347 @@
+// src/server.c
+#define _POSIX_C_SOURCE 200809L   // sigaction(), fchdir(), MSG_NOSIGNAL
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdio_ext.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "server.h"
+
+// Pending connections the kernel keeps while a request runs
+#define SERVER_BACKLOG 64
+
+// Wire format: a request is a 32-bit payload length, sent together with the
+// three stream descriptors, then the payload: the working directory and
+// each argument, all null-terminated. The reply is a 32-bit exit status.
+
+static volatile sig_atomic_t server_stopping;
+
+static void server_stop(int signal_number) {
+    (void)signal_number;
+    server_stopping = 1;
+}
+
+// Helper: Address of socket_path; 0 if it does not fit
+static int server_address(const char* socket_path, struct sockaddr_un* address) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address->sun_path)) return 0;
+    strcpy(address->sun_path, socket_path);
+    return 1;
+}
+
+// Helper: Socket connected to the server on socket_path, or -1
+static int server_connect(const char* socket_path) {
+    struct sockaddr_un address;
+    if (!server_address(socket_path, &address)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int server_send_all(int fd, const void* data, size_t length) {
+    const char* bytes = data;
+    while (length > 0) {
+        ssize_t sent = send(fd, bytes, length, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        bytes += sent;
+        length -= (size_t)sent;
+    }
+    return 1;
+}
+
+static int server_receive_all(int fd, void* data, size_t length) {
+    char* bytes = data;
+    while (length > 0) {
+        ssize_t received = recv(fd, bytes, length, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return 0;
+        bytes += received;
+        length -= (size_t)received;
+    }
+    return 1;
+}
+
+// Helper: Receive the length of a request and the descriptors sent with it;
+// 0 unless both arrived (descriptors that did arrive are in streams)
+static int server_receive_header(int connection, uint32_t* length, int streams[3]) {
+    union {
+        struct cmsghdr header;
+        char space[CMSG_SPACE(3 * sizeof(int))];
+    } control;
+    struct iovec vector = {length, sizeof(*length)};
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.space;
+    message.msg_controllen = sizeof(control.space);
+
+    ssize_t received;
+    do {
+        received = recvmsg(connection, &message, 0);
+    } while (received < 0 && errno == EINTR);
+    if (received <= 0) return 0;
+
+    size_t count = 0;
+    for (struct cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS) continue;
+        count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        memcpy(streams, CMSG_DATA(header), (count < 3 ? count : 3) * sizeof(int));
+    }
+
+    // The descriptors came with the first byte; the rest may follow
+    size_t header_size = sizeof(*length);
+    if ((size_t)received < header_size &&
+        !server_receive_all(connection, (char*)length + received, header_size - (size_t)received)) {
+        return 0;
+    }
+    return count == 3 && !(message.msg_flags & MSG_CTRUNC);
+}
+
+// Helper: Receive one request on connection, run it and send the status
+static void server_handle(int connection, server_handler_t handler, void* context,
+                          int home, const int saved[3]) {
+    int streams[3] = {-1, -1, -1};
+    uint32_t length = 0;
+    char* payload = NULL;
+    char** argv = NULL;
+    int argc = 0;
+
+    int valid = server_receive_header(connection, &length, streams) &&
+                length > 0 && length <= SERVER_MAX_REQUEST;
+    if (valid) {
+        payload = malloc(length);
+        valid = payload && server_receive_all(connection, payload, length) && payload[length - 1] == '\0';
+    }
+    if (valid) {
+        // The directory, then the arguments
+        for (uint32_t i = 0; i < length; i++) {
+            if (payload[i] == '\0') argc++;
+        }
+        argc--;
+        argv = malloc(((size_t)argc + 1) * sizeof(char*));
+        valid = argc > 0 && argv;
+    }
+
+    int32_t status = 1;
+    if (valid) {
+        char* next = payload + strlen(payload) + 1;
+        for (int i = 0; i < argc; i++) {
+            argv[i] = next;
+            next += strlen(next) + 1;
+        }
+        argv[argc] = NULL;
+
+        fflush(stdout);
+        fflush(stderr);
+        for (int i = 0; i < 3; i++) {
+            dup2(streams[i], i);
+        }
+
+        if (chdir(payload) != 0) {
+            fprintf(stderr, "Error: Could not change to directory '%s'\n", payload);
+        } else {
+            status = handler(argc, argv, context);
+        }
+
+        // Buffered output and unread input both belong to this client
+        fflush(stdout);
+        fflush(stderr);
+        __fpurge(stdin);
+        for (int i = 0; i < 3; i++) {
+            dup2(saved[i], i);
+        }
+        clearerr(stdin);
+        clearerr(stdout);
+        clearerr(stderr);
+        if (fchdir(home) != 0) {
+            fprintf(stderr, "Warning: Could not return to the server's directory\n");
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (streams[i] >= 0) close(streams[i]);
+    }
+    free(argv);
+    free(payload);
+    server_send_all(connection, &status, sizeof(status));
+}
+
+int server_run(const char* socket_path, server_handler_t handler, void* context) {
+    struct sockaddr_un address;
+    if (!server_address(socket_path, &address)) {
+        fprintf(stderr, "Error: Socket path '%s' is too long\n", socket_path);
+        return 0;
+    }
+
+    // A socket nobody answers on is left over from a server that is gone
+    struct stat info;
+    if (lstat(socket_path, &info) == 0) {
+        int existing = server_connect(socket_path);
+        if (existing >= 0) {
+            close(existing);
+            fprintf(stderr, "Error: A server is already running on '%s'\n", socket_path);
+            return 0;
+        }
+        if (!S_ISSOCK(info.st_mode)) {
+            fprintf(stderr, "Error: '%s' exists and is not a socket\n", socket_path);
+            return 0;
+        }
+        unlink(socket_path);
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(listener, SERVER_BACKLOG) != 0) {
+        fprintf(stderr, "Error: Could not listen on '%s': %s\n", socket_path, strerror(errno));
+        if (listener >= 0) close(listener);
+        return 0;
+    }
+
+    // Every request changes directory and streams; these bring them back
+    int home = open(".", O_RDONLY | O_DIRECTORY);
+    int saved[3];
+    for (int i = 0; i < 3; i++) {
+        saved[i] = dup(i);
+    }
+    if (home < 0 || saved[0] < 0 || saved[1] < 0 || saved[2] < 0) {
+        fprintf(stderr, "Error: Could not save the server's directory and streams\n");
+        for (int i = 0; i < 3; i++) {
+            if (saved[i] >= 0) close(saved[i]);
+        }
+        if (home >= 0) close(home);
+        close(listener);
+        unlink(socket_path);
+        return 0;
+    }
+
+    // Requests restart interrupted calls; only the wait below sees signals
+    struct sigaction stop, ignore, old_interrupt, old_terminate, old_pipe;
+    memset(&stop, 0, sizeof(stop));
+    stop.sa_handler = server_stop;
+    stop.sa_flags = SA_RESTART;
+    sigemptyset(&stop.sa_mask);
+    memset(&ignore, 0, sizeof(ignore));
+    ignore.sa_handler = SIG_IGN;
+    sigemptyset(&ignore.sa_mask);
+    server_stopping = 0;
+    sigaction(SIGINT, &stop, &old_interrupt);
+    sigaction(SIGTERM, &stop, &old_terminate);
+    sigaction(SIGPIPE, &ignore, &old_pipe);
+
+    int success = 1;
+    while (!server_stopping) {
+        // poll() is never restarted, so a signal ends the wait
+        struct pollfd waiting = {listener, POLLIN, 0};
+        if (poll(&waiting, 1, -1) < 0) {
+            if (errno == EINTR) continue;
+            success = 0;
+            break;
+        }
+
+        int connection = accept(listener, NULL, NULL);
+        if (connection < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            fprintf(stderr, "Error: Could not accept a request: %s\n", strerror(errno));
+            success = 0;
+            break;
+        }
+        server_handle(connection, handler, context, home, saved);
+        close(connection);
+    }
+
+    sigaction(SIGINT, &old_interrupt, NULL);
+    sigaction(SIGTERM, &old_terminate, NULL);
+    sigaction(SIGPIPE, &old_pipe, NULL);
+    for (int i = 0; i < 3; i++) {
+        close(saved[i]);
+    }
+    close(home);
+    close(listener);
+    unlink(socket_path);
+    return success;
+}
+
+int server_request(const char* socket_path, int argc, char** argv, const int streams[3], int* status) {
+    char* directory = getcwd(NULL, 0);
+    if (!directory) return 0;
+
+    size_t length = strlen(directory) + 1;
+    for (int i = 0; i < argc; i++) {
+        length += strlen(argv[i]) + 1;
+    }
+    char* payload = length <= SERVER_MAX_REQUEST ? malloc(length) : NULL;
+    int connection = payload ? server_connect(socket_path) : -1;
+    if (connection < 0) {
+        free(payload);
+        free(directory);
+        return 0;
+    }
+
+    size_t offset = strlen(directory) + 1;
+    memcpy(payload, directory, offset);
+    for (int i = 0; i < argc; i++) {
+        size_t size = strlen(argv[i]) + 1;
+        memcpy(payload + offset, argv[i], size);
+        offset += size;
+    }
+    free(directory);
+
+    uint32_t header = (uint32_t)length;
+    union {
+        struct cmsghdr header;
+        char space[CMSG_SPACE(3 * sizeof(int))];
+    } control;
+    memset(&control, 0, sizeof(control));
+    struct iovec vector = {&header, sizeof(header)};
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.space;
+    message.msg_controllen = sizeof(control.space);
+
+    struct cmsghdr* rights = CMSG_FIRSTHDR(&message);
+    rights->cmsg_level = SOL_SOCKET;
+    rights->cmsg_type = SCM_RIGHTS;
+    rights->cmsg_len = CMSG_LEN(3 * sizeof(int));
+    memcpy(CMSG_DATA(rights), streams, 3 * sizeof(int));
+
+    ssize_t sent;
+    do {
+        sent = sendmsg(connection, &message, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    if (sent < 0) {
+        free(payload);
+        close(connection);
+        return 0;
+    }
+
+    // Four bytes always fit in an empty socket buffer
+    int32_t reply;
+    int result = (size_t)sent == sizeof(header) && server_send_all(connection, payload, length) &&
+                 server_receive_all(connection, &reply, sizeof(reply));
+    free(payload);
+    close(connection);
+    if (!result) return -1;
+
+    *status = reply;
+    return 1;
+}
@@ -0,0 +1,43 @@
+// src/server.h
+#ifndef SERVER_H
+#define SERVER_H
+
+// Compile server: a long-running compiler that takes requests on a Unix
+// domain socket. A client sends its working directory, its command line and
+// its stdin, stdout and stderr descriptors; the server runs the request in
+// that directory with those descriptors as its own standard streams, then
+// answers with the exit status. Requests are handled one at a time, so
+// whatever the handler keeps between them needs no locking.
+
+// Largest request (working directory and arguments) accepted
+#define SERVER_MAX_REQUEST (1024 * 1024)
+
+/**
+ * @brief Runs one request; argv[0] is the client's program name
+ *
+ * @return int Exit status for the client
+ */
+typedef int (*server_handler_t)(int argc, char** argv, void* context);
+
+/**
+ * @brief Serves requests on socket_path until SIGINT or SIGTERM
+ *
+ * @return int 1 after a clean shutdown (the socket is removed), 0 if the
+ *         socket could not be set up (e.g. another server owns it)
+ *
+ * @note Replaces a stale socket file left by a server that is gone, and
+ *       ignores SIGPIPE so clients that disappear cannot stop the server
+ */
+int server_run(const char* socket_path, server_handler_t handler, void* context);
+
+/**
+ * @brief Sends a request to the server on socket_path and waits for it
+ *
+ * @param streams Descriptors the request uses as stdin, stdout and stderr
+ * @param status Receives the exit status of the request
+ * @return int 1 when the request ran, 0 if no server could be reached
+ *         (nothing was sent), -1 if the connection was lost after sending
+ */
+int server_request(const char* socket_path, int argc, char** argv, const int streams[3], int* status);
+
+#endif // SERVER_H
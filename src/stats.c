@@ -0,0 +1,193 @@
+// src/stats.c
+#define _POSIX_C_SOURCE 200809L   // clock_gettime()
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include "stats.h"
+
+// mallinfo2() appeared in glibc 2.33; older ones only have the int-sized mallinfo()
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define STATS_HAVE_MALLINFO2 1
+#endif
+
+static const char* const phase_names[STATS_PHASE_COUNT] = {
+    [STATS_LEX] = "lex",
+    [STATS_PARSE] = "parse",
+    [STATS_SEMANTIC] = "semantic",
+    [STATS_IR] = "ir",
+    [STATS_CODEGEN] = "codegen",
+    [STATS_LINK] = "link"
+};
+
+const char* stats_phase_name(stats_phase_t phase) {
+    return phase >= 0 && phase < STATS_PHASE_COUNT ? phase_names[phase] : "unknown";
+}
+
+// Helper: Monotonic wall clock in seconds
+static double stats_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// Helper: Bytes the allocator has handed out and not yet freed, or -1
+static long long stats_heap_in_use(void) {
+#ifdef STATS_HAVE_MALLINFO2
+    struct mallinfo2 info = mallinfo2();
+    return (long long)(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+static long stats_peak_rss_kb(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss;   // Kilobytes on Linux
+}
+
+// Phase timing
+void stats_begin(compile_stats_t* stats, stats_phase_t phase) {
+    stats->current = phase;
+    stats->start_heap = stats_heap_in_use();
+    stats->start_seconds = stats_now();
+}
+
+void stats_end(compile_stats_t* stats) {
+    double now = stats_now();
+    stats_phase_result_t* result = &stats->phases[stats->current];
+    long long heap = stats_heap_in_use();
+
+    // A phase measured in several pieces adds them up; unknown stays unknown
+    result->heap_known = heap >= 0 && stats->start_heap >= 0 && (!result->ran || result->heap_known);
+    result->heap_bytes = result->heap_known ? result->heap_bytes + heap - stats->start_heap : 0;
+    result->seconds += now - stats->start_seconds;
+    result->ran = 1;
+    result->peak_rss_kb = stats_peak_rss_kb();
+}
+
+// Optimizer counters by name, in the order they are reported
+#define STATS_OPTIMIZER_FIELD(field) {#field, offsetof(optimizer_stats_t, field)}
+static const struct {
+    const char* name;
+    size_t offset;
+} optimizer_fields[] = {
+    STATS_OPTIMIZER_FIELD(ast_folds), STATS_OPTIMIZER_FIELD(ast_pruned),
+    STATS_OPTIMIZER_FIELD(ir_folds), STATS_OPTIMIZER_FIELD(ir_immediates),
+    STATS_OPTIMIZER_FIELD(ir_removed), STATS_OPTIMIZER_FIELD(inlined_calls),
+    STATS_OPTIMIZER_FIELD(loop_hoisted), STATS_OPTIMIZER_FIELD(loop_reduced),
+    STATS_OPTIMIZER_FIELD(loops_rotated)
+};
+
+#define OPTIMIZER_FIELD_COUNT (sizeof(optimizer_fields) / sizeof(optimizer_fields[0]))
+
+static size_t stats_optimizer_value(const optimizer_stats_t* optimizer, size_t field) {
+    size_t value;
+    memcpy(&value, (const char*)optimizer + optimizer_fields[field].offset, sizeof(value));
+    return value;
+}
+
+// Text report
+void stats_print(FILE* output, const compile_stats_t* stats) {
+    fprintf(output, "=== COMPILE STATISTICS: %s ===\n", stats->input_file);
+    if (stats->cached) {
+        fprintf(output, "(output taken from the cache, no phase ran)\n\n");
+        return;
+    }
+
+    fprintf(output, "%-10s %12s %12s %14s\n", "phase", "time (ms)", "heap (KB)", "peak RSS (KB)");
+    for (int phase = 0; phase < STATS_PHASE_COUNT; phase++) {
+        const stats_phase_result_t* result = &stats->phases[phase];
+        if (!result->ran) continue;
+        fprintf(output, "%-10s %12.3f ", stats_phase_name((stats_phase_t)phase), result->seconds * 1000.0);
+        if (!result->heap_known) {
+            fprintf(output, "%12s", "n/a");
+        } else {
+            fprintf(output, "%12.1f", (double)result->heap_bytes / 1024.0);
+        }
+        fprintf(output, " %14ld\n", result->peak_rss_kb);
+    }
+
+    fprintf(output, "tokens: %zu, AST nodes: %zu, symbol probes: %zu\n",
+            stats->tokens, stats->ast_nodes, stats->symbol_probes);
+    fprintf(output, "IR instructions: %zu, machine instructions: %zu\n",
+            stats->ir_instructions, stats->instructions);
+
+    // Only the passes that changed something are worth a line
+    const char* separator = "optimizer: ";
+    for (size_t i = 0; i < OPTIMIZER_FIELD_COUNT; i++) {
+        size_t value = stats_optimizer_value(&stats->optimizer, i);
+        if (value == 0) continue;
+        fprintf(output, "%s%s %zu", separator, optimizer_fields[i].name, value);
+        separator = ", ";
+    }
+    fprintf(output, "%s\n", separator[0] == 'o' ? "" : "\n");
+}
+
+// JSON report
+static void stats_json_string(FILE* output, const char* text) {
+    fputc('"', output);
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(output, "\\%c", *c);
+        } else if (*c < 0x20) {
+            fprintf(output, "\\u%04x", *c);
+        } else {
+            fputc(*c, output);
+        }
+    }
+    fputc('"', output);
+}
+
+static void stats_json_phase(FILE* output, const stats_phase_result_t* result) {
+    fprintf(output, "{\"seconds\": %.6f, \"heap_bytes\": ", result->seconds);
+    if (!result->heap_known) {
+        fprintf(output, "null");
+    } else {
+        fprintf(output, "%lld", result->heap_bytes);
+    }
+    fprintf(output, ", \"peak_rss_kb\": %ld}", result->peak_rss_kb);
+}
+
+void stats_write_json(FILE* output, const compile_stats_t* files, size_t count, const stats_phase_result_t* link) {
+    fprintf(output, "{\n  \"files\": [");
+    for (size_t f = 0; f < count; f++) {
+        const compile_stats_t* stats = &files[f];
+        fprintf(output, "%s\n    {\n      \"input\": ", f == 0 ? "" : ",");
+        stats_json_string(output, stats->input_file);
+        fprintf(output, ",\n      \"cached\": %s,\n      \"phases\": {", stats->cached ? "true" : "false");
+
+        const char* separator = "";
+        for (int phase = 0; phase < STATS_PHASE_COUNT; phase++) {
+            if (!stats->phases[phase].ran) continue;
+            fprintf(output, "%s\n        \"%s\": ", separator, stats_phase_name((stats_phase_t)phase));
+            stats_json_phase(output, &stats->phases[phase]);
+            separator = ",";
+        }
+        fprintf(output, "%s},\n", separator[0] ? "\n      " : "");
+
+        fprintf(output, "      \"counters\": {\"tokens\": %zu, \"ast_nodes\": %zu, \"symbol_probes\": %zu, "
+                "\"ir_instructions\": %zu, \"instructions\": %zu},\n",
+                stats->tokens, stats->ast_nodes, stats->symbol_probes, stats->ir_instructions,
+                stats->instructions);
+
+        fprintf(output, "      \"optimizer\": {");
+        for (size_t i = 0; i < OPTIMIZER_FIELD_COUNT; i++) {
+            fprintf(output, "%s\"%s\": %zu", i == 0 ? "" : ", ", optimizer_fields[i].name,
+                    stats_optimizer_value(&stats->optimizer, i));
+        }
+        fprintf(output, "}\n    }");
+    }
+    fprintf(output, "%s]", count > 0 ? "\n  " : "");
+
+    if (link && link->ran) {
+        fprintf(output, ",\n  \"link\": ");
+        stats_json_phase(output, link);
+    }
+    fprintf(output, "\n}\n");
+}
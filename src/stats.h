@@ -0,0 +1,70 @@
+// src/stats.h
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include "optimizer.h"
+
+// Compiler phases measured by --stats
+typedef enum {
+    STATS_LEX,            // A separate pass over the tokens (parsing scans them again)
+    STATS_PARSE,
+    STATS_SEMANTIC,
+    STATS_IR,             // AST optimization, lowering and IR optimization
+    STATS_CODEGEN,        // Instruction selection, peephole pass and writing the output
+    STATS_LINK,           // The external gcc link of all objects
+    STATS_PHASE_COUNT
+} stats_phase_t;
+
+// Cost of one phase
+typedef struct {
+    int ran;
+    double seconds;       // Wall time
+    int heap_known;       // 0 where malloc cannot tell how much is in use
+    long long heap_bytes; // Net growth of the heap in use (negative if the phase freed more)
+    long peak_rss_kb;     // Peak resident set of the process when the phase ended
+} stats_phase_result_t;
+
+// Measurements of one compiled file. Memory figures are process-wide, so
+// with several inputs compiled at once they include the other files.
+typedef struct {
+    const char* input_file;
+    int cached;           // Output came from the cache; no phase ran
+    stats_phase_result_t phases[STATS_PHASE_COUNT];
+
+    size_t tokens;
+    size_t ast_nodes;
+    size_t symbol_probes;    // Hash slots examined by symbol table lookups and inserts
+    size_t ir_instructions;  // After IR optimization
+    size_t instructions;     // Machine instructions emitted (after the peephole pass)
+    optimizer_stats_t optimizer;
+
+    // Phase being measured
+    stats_phase_t current;
+    double start_seconds;
+    long long start_heap; // -1 if unknown
+} compile_stats_t;
+
+// Phase timing (one phase at a time per compile_stats_t); a phase begun
+// again adds to its earlier measurement
+void stats_begin(compile_stats_t* stats, stats_phase_t phase);
+void stats_end(compile_stats_t* stats);
+
+// Lower-case name of phase, as used in the reports
+const char* stats_phase_name(stats_phase_t phase);
+
+/**
+ * @brief Prints a table of the phases and counters of stats
+ */
+void stats_print(FILE* output, const compile_stats_t* stats);
+
+/**
+ * @brief Writes the measurements of every file, and of the link if one
+ *        ran, as a JSON object
+ *
+ * @param link Measurement of STATS_LINK, or NULL without a link
+ */
+void stats_write_json(FILE* output, const compile_stats_t* files, size_t count, const stats_phase_result_t* link);
+
+#endif // STATS_H
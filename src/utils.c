@@ -0,0 +1,265 @@
+// src/utils.c
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "utils.h"
+
+// All arena allocations are aligned to this boundary
+#define ARENA_ALIGNMENT sizeof(void*)
+
+// Helper: Round size up to the arena alignment
+static size_t arena_align(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+// Helper: Create a chunk able to hold at least min_size bytes
+static arena_chunk_t* arena_chunk_create(size_t min_size, size_t chunk_size) {
+    size_t capacity = min_size > chunk_size ? min_size : chunk_size;
+
+    arena_chunk_t* chunk = malloc(sizeof(arena_chunk_t) + capacity);
+    if (!chunk) {
+        fprintf(stderr, "Error: Failed to allocate arena chunk\n");
+        return NULL;
+    }
+
+    chunk->next = NULL;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+
+    return chunk;
+}
+
+// Arena lifecycle
+arena_t* arena_create(size_t chunk_size) {
+    arena_t* arena = malloc(sizeof(arena_t));
+    if (!arena) return NULL;
+
+    arena->chunk_size = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE;
+    arena->bytes_allocated = 0;
+    arena->head = arena_chunk_create(0, arena->chunk_size);
+    if (!arena->head) {
+        free(arena);
+        return NULL;
+    }
+
+    return arena;
+}
+
+void arena_destroy(arena_t* arena) {
+    if (!arena) return;
+
+    arena_chunk_t* chunk = arena->head;
+    while (chunk) {
+        arena_chunk_t* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    free(arena);
+}
+
+// Arena allocation
+void* arena_alloc(arena_t* arena, size_t size) {
+    if (!arena) return NULL;
+
+    size = arena_align(size);
+
+    arena_chunk_t* chunk = arena->head;
+    if (chunk->used + size > chunk->capacity) {
+        chunk = arena_chunk_create(size, arena->chunk_size);
+        if (!chunk) return NULL;
+
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+
+    void* ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->bytes_allocated += size;
+
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void* arena_realloc(arena_t* arena, void* ptr, size_t old_size, size_t new_size) {
+    if (!arena) return NULL;
+    if (!ptr) return arena_alloc(arena, new_size);
+    if (new_size <= old_size) return ptr;
+
+    old_size = arena_align(old_size);
+    new_size = arena_align(new_size);
+
+    // Extend in place if this is the most recent allocation and there is room
+    arena_chunk_t* chunk = arena->head;
+    if ((char*)ptr + old_size == chunk->data + chunk->used &&
+        chunk->used - old_size + new_size <= chunk->capacity) {
+        memset((char*)ptr + old_size, 0, new_size - old_size);
+        chunk->used += new_size - old_size;
+        arena->bytes_allocated += new_size - old_size;
+        return ptr;
+    }
+
+    void* new_ptr = arena_alloc(arena, new_size);
+    if (!new_ptr) return NULL;
+
+    memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
+}
+
+char* arena_strndup(arena_t* arena, const char* str, size_t length) {
+    if (!str) return NULL;
+
+    char* copy = arena_alloc(arena, length + 1);
+    if (!copy) return NULL;
+
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+
+    return copy;
+}
+
+char* arena_strdup(arena_t* arena, const char* str) {
+    if (!str) return NULL;
+    return arena_strndup(arena, str, strlen(str));
+}
+
+// Interned string entry (the interned pointer is entry->text)
+typedef struct {
+    unsigned int hash;
+    size_t length;
+    char text[];
+} intern_entry_t;
+
+// Initial number of slots in the intern table (power of two)
+#define INTERN_INITIAL_CAPACITY 1024
+
+// Global intern table (open addressing, linear probing). Entries never move
+// once created, so only insertion needs the lock; the accessors read fields
+// that are fixed when the entry is published.
+static struct {
+    intern_entry_t** slots;
+    size_t capacity;
+    size_t count;
+    arena_t* storage;
+    pthread_mutex_t lock;
+} intern_table = {NULL, 0, 0, NULL, PTHREAD_MUTEX_INITIALIZER};
+
+// Helper: Recover the entry header from an interned pointer
+static intern_entry_t* intern_entry(const char* interned) {
+    return (intern_entry_t*)(interned - offsetof(intern_entry_t, text));
+}
+
+// Helper: FNV-1a hash of a byte range
+static unsigned int intern_hash_bytes(const char* str, size_t length) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Helper: Double the table size and reinsert all entries
+static int intern_grow(void) {
+    size_t new_capacity = intern_table.capacity ? intern_table.capacity * 2 : INTERN_INITIAL_CAPACITY;
+    intern_entry_t** new_slots = calloc(new_capacity, sizeof(intern_entry_t*));
+    if (!new_slots) return 0;
+
+    for (size_t i = 0; i < intern_table.capacity; i++) {
+        intern_entry_t* entry = intern_table.slots[i];
+        if (!entry) continue;
+
+        size_t index = entry->hash & (new_capacity - 1);
+        while (new_slots[index]) {
+            index = (index + 1) & (new_capacity - 1);
+        }
+        new_slots[index] = entry;
+    }
+
+    free(intern_table.slots);
+    intern_table.slots = new_slots;
+    intern_table.capacity = new_capacity;
+
+    return 1;
+}
+
+// Helper: Find or insert str (caller holds intern_table.lock)
+static const char* intern_insert(const char* str, size_t length) {
+    if (!intern_table.storage) {
+        intern_table.storage = arena_create(0);
+        if (!intern_table.storage) return NULL;
+    }
+
+    // Keep the load factor below 1/2
+    if ((intern_table.count + 1) * 2 > intern_table.capacity && !intern_grow()) {
+        return NULL;
+    }
+
+    unsigned int hash = intern_hash_bytes(str, length);
+    size_t index = hash & (intern_table.capacity - 1);
+
+    while (intern_table.slots[index]) {
+        intern_entry_t* entry = intern_table.slots[index];
+        if (entry->hash == hash && entry->length == length &&
+            memcmp(entry->text, str, length) == 0) {
+            return entry->text;
+        }
+        index = (index + 1) & (intern_table.capacity - 1);
+    }
+
+    intern_entry_t* entry = arena_alloc(intern_table.storage, sizeof(intern_entry_t) + length + 1);
+    if (!entry) return NULL;
+
+    entry->hash = hash;
+    entry->length = length;
+    memcpy(entry->text, str, length);
+    entry->text[length] = '\0';
+
+    intern_table.slots[index] = entry;
+    intern_table.count++;
+
+    return entry->text;
+}
+
+const char* intern_string_n(const char* str, size_t length) {
+    if (!str) return NULL;
+
+    pthread_mutex_lock(&intern_table.lock);
+    const char* interned = intern_insert(str, length);
+    pthread_mutex_unlock(&intern_table.lock);
+    return interned;
+}
+
+const char* intern_string(const char* str) {
+    if (!str) return NULL;
+    return intern_string_n(str, strlen(str));
+}
+
+unsigned int intern_hash(const char* interned) {
+    return intern_entry(interned)->hash;
+}
+
+size_t intern_length(const char* interned) {
+    return intern_entry(interned)->length;
+}
+
+size_t intern_count(void) {
+    pthread_mutex_lock(&intern_table.lock);
+    size_t count = intern_table.count;
+    pthread_mutex_unlock(&intern_table.lock);
+    return count;
+}
+
+void intern_reset(void) {
+    pthread_mutex_lock(&intern_table.lock);
+    free(intern_table.slots);
+    arena_destroy(intern_table.storage);
+
+    intern_table.slots = NULL;
+    intern_table.capacity = 0;
+    intern_table.count = 0;
+    intern_table.storage = NULL;
+    pthread_mutex_unlock(&intern_table.lock);
+}
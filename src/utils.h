@@ -0,0 +1,112 @@
+// src/utils.h
+#ifndef UTILS_H
+#define UTILS_H
+
+#include <stddef.h>
+
+// Default size of a single arena chunk
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+// Arena chunk (allocations are bumped out of data[])
+typedef struct arena_chunk {
+    struct arena_chunk* next;
+    size_t capacity;
+    size_t used;
+    char data[];
+} arena_chunk_t;
+
+// Arena allocator: many small allocations, one bulk free
+typedef struct {
+    arena_chunk_t* head;       // Chunk currently being allocated from
+    size_t chunk_size;         // Minimum size of newly created chunks
+    size_t bytes_allocated;    // Total bytes handed out (for statistics)
+} arena_t;
+
+// Arena lifecycle
+/**
+ * @brief Creates a new arena
+ *
+ * @param chunk_size Minimum chunk size in bytes (0 selects ARENA_DEFAULT_CHUNK_SIZE)
+ * @return arena_t* Pointer to new arena, or NULL on failure
+ *
+ * @note Everything allocated from the arena is released by arena_destroy()
+ */
+arena_t* arena_create(size_t chunk_size);
+
+/**
+ * @brief Destroys an arena and frees every allocation made from it
+ *
+ * @param arena The arena to destroy
+ *
+ * @note Safe to call with NULL pointer
+ */
+void arena_destroy(arena_t* arena);
+
+// Arena allocation
+/**
+ * @brief Allocates zero-initialized, pointer-aligned memory from the arena
+ *
+ * @param arena The arena to allocate from
+ * @param size Number of bytes to allocate
+ * @return void* Pointer to the memory, or NULL on failure
+ */
+void* arena_alloc(arena_t* arena, size_t size);
+
+/**
+ * @brief Grows an allocation previously returned by the arena
+ *
+ * @param arena The arena that owns ptr
+ * @param ptr Existing allocation (may be NULL)
+ * @param old_size Current size of the allocation
+ * @param new_size Requested size
+ * @return void* Pointer to the (possibly moved) allocation, or NULL on failure
+ *
+ * @note Extends in place when ptr is the most recent allocation, otherwise copies
+ */
+void* arena_realloc(arena_t* arena, void* ptr, size_t old_size, size_t new_size);
+
+/**
+ * @brief Copies length bytes of str into the arena and null-terminates them
+ */
+char* arena_strndup(arena_t* arena, const char* str, size_t length);
+
+/**
+ * @brief Copies a null-terminated string into the arena
+ */
+char* arena_strdup(arena_t* arena, const char* str);
+
+// String interning
+// Every distinct string maps to one stable pointer, so interned strings can be
+// compared with ==. The hash and length of an interned string are stored
+// alongside it and retrieved in O(1). Interning is thread-safe.
+
+/**
+ * @brief Interns length bytes of str
+ *
+ * @return const char* The canonical null-terminated copy, or NULL on failure
+ *
+ * @note The returned pointer stays valid until intern_reset()
+ */
+const char* intern_string_n(const char* str, size_t length);
+
+/**
+ * @brief Interns a null-terminated string
+ */
+const char* intern_string(const char* str);
+
+// Accessors (only valid on pointers returned by intern_string*)
+unsigned int intern_hash(const char* interned);
+size_t intern_length(const char* interned);
+
+// Number of distinct strings currently interned
+size_t intern_count(void);
+
+/**
+ * @brief Frees every interned string
+ *
+ * @warning Invalidates all pointers previously returned by intern_string*;
+ *          no other thread may be using the table
+ */
+void intern_reset(void);
+
+#endif // UTILS_H
@@ -0,0 +1,373 @@
+// tests/test_runner.c
+// Integration test runner: compiles .tc programs with the real compiler and
+// checks the result against directives written in the program's comments:
+//
+//   // FLAGS: -O1            Extra compiler options
+//   // INPUTS: a.tc b.tc     Other files of the program, next to this one
+//   // CHECK: text           text occurs in the assembly, after the previous CHECK
+//   // CHECK-NOT: text       text does not occur between the surrounding CHECKs
+//   // EXPECT-EXIT: 42       Program exit status
+//   // EXPECT-OUTPUT: text   Next line of the program's stdout
+//   // EXPECT-ERROR          Compilation must fail
+//
+// Programs are run three times: assembled by gcc from the --compile-only
+// output, linked from the compiler's own ELF object (-c) with the prebuilt
+// runtime.o next to the compiler, and in memory with --run. Programs with
+// INPUTS are instead built from copies in the work directory in a single
+// multi-file compiler invocation. Files without directives are skipped.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define MAX_DIRECTIVES 64
+#define MAX_LINE 512
+#define MAX_COMMAND 2048
+
+// Directive kinds
+typedef enum {
+    DIRECTIVE_CHECK,
+    DIRECTIVE_CHECK_NOT,
+    DIRECTIVE_EXPECT_OUTPUT
+} directive_kind_t;
+
+typedef struct {
+    directive_kind_t kind;
+    char text[MAX_LINE];
+} directive_t;
+
+// Expectations parsed from one test file
+typedef struct {
+    char flags[MAX_LINE];
+    char inputs[MAX_LINE];
+    directive_t directives[MAX_DIRECTIVES];
+    int directive_count;
+    int expect_exit;          // -1 if the exit status is not checked
+    int expect_error;
+    int has_directives;
+} test_spec_t;
+
+// Helper: Text after "prefix" if line starts with it (leading blanks skipped)
+static const char* match_directive(const char* line, const char* prefix) {
+    size_t length = strlen(prefix);
+    if (strncmp(line, prefix, length) != 0) return NULL;
+    line += length;
+    while (*line == ' ' || *line == '\t') line++;
+    return line;
+}
+
+// Helper: Strip the trailing newline and blanks of line in place
+static void trim_line(char* line) {
+    size_t length = strlen(line);
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r' ||
+                          line[length - 1] == ' ' || line[length - 1] == '\t')) {
+        line[--length] = '\0';
+    }
+}
+
+static void add_directive(test_spec_t* spec, directive_kind_t kind, const char* text) {
+    if (spec->directive_count >= MAX_DIRECTIVES) return;
+    directive_t* directive = &spec->directives[spec->directive_count++];
+    directive->kind = kind;
+    snprintf(directive->text, sizeof(directive->text), "%s", text);
+}
+
+static int parse_spec(const char* path, test_spec_t* spec) {
+    FILE* file = fopen(path, "r");
+    if (!file) return 0;
+
+    memset(spec, 0, sizeof(*spec));
+    spec->expect_exit = -1;
+
+    char line[MAX_LINE];
+    while (fgets(line, sizeof(line), file)) {
+        trim_line(line);
+        const char* comment = strstr(line, "//");
+        if (!comment) continue;
+        comment += 2;
+        while (*comment == ' ') comment++;
+
+        const char* text;
+        if ((text = match_directive(comment, "FLAGS:"))) {
+            snprintf(spec->flags, sizeof(spec->flags), "%s", text);
+        } else if ((text = match_directive(comment, "INPUTS:"))) {
+            snprintf(spec->inputs, sizeof(spec->inputs), "%s", text);
+        } else if ((text = match_directive(comment, "CHECK-NOT:"))) {
+            add_directive(spec, DIRECTIVE_CHECK_NOT, text);
+        } else if ((text = match_directive(comment, "CHECK:"))) {
+            add_directive(spec, DIRECTIVE_CHECK, text);
+        } else if ((text = match_directive(comment, "EXPECT-EXIT:"))) {
+            spec->expect_exit = atoi(text);
+        } else if ((text = match_directive(comment, "EXPECT-OUTPUT:"))) {
+            add_directive(spec, DIRECTIVE_EXPECT_OUTPUT, text);
+        } else if (match_directive(comment, "EXPECT-ERROR")) {
+            spec->expect_error = 1;
+        } else {
+            continue;
+        }
+        spec->has_directives = 1;
+    }
+
+    fclose(file);
+    return 1;
+}
+
+// Helper: Read a whole file into a heap buffer
+static char* read_file(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* buffer = malloc(size + 1);
+    if (buffer) {
+        size_t read = fread(buffer, 1, size, file);
+        buffer[read] = '\0';
+    }
+    fclose(file);
+    return buffer;
+}
+
+// Helper: Exit status of a shell command, or -1 if it did not exit normally
+static int run_command(const char* command) {
+    int status = system(command);
+    if (status == -1 || !WIFEXITED(status)) return -1;
+    return WEXITSTATUS(status);
+}
+
+// Helper: True if text occurs in [start, end)
+static int occurs_between(const char* start, const char* end, const char* text) {
+    const char* found = strstr(start, text);
+    return found && found + strlen(text) <= end;
+}
+
+// Helper: Verify CHECK / CHECK-NOT directives against the assembly
+// As in LLVM's FileCheck, a CHECK-NOT applies to the text between the
+// previous CHECK match (or the start) and the next one (or the end).
+static int check_assembly(const test_spec_t* spec, const char* assembly) {
+    const char* cursor = assembly;
+    const char* end = assembly + strlen(assembly);
+    int pending = 0;   // First CHECK-NOT not yet verified
+
+    for (int i = 0; i <= spec->directive_count; i++) {
+        const directive_t* directive = i < spec->directive_count ? &spec->directives[i] : NULL;
+        if (directive && directive->kind != DIRECTIVE_CHECK) continue;
+
+        const char* found = end;
+        if (directive) {
+            found = strstr(cursor, directive->text);
+            if (!found) {
+                printf("    CHECK not found: %s\n", directive->text);
+                return 0;
+            }
+        }
+
+        for (; pending < i; pending++) {
+            const directive_t* negative = &spec->directives[pending];
+            if (negative->kind == DIRECTIVE_CHECK_NOT && occurs_between(cursor, found, negative->text)) {
+                printf("    CHECK-NOT matched: %s\n", negative->text);
+                return 0;
+            }
+        }
+        pending = i + 1;
+
+        if (directive) cursor = found + strlen(directive->text);
+    }
+    return 1;
+}
+
+// Helper: Verify EXPECT-OUTPUT lines against the program's stdout
+static int check_output(const test_spec_t* spec, const char* output_path) {
+    FILE* output = fopen(output_path, "r");
+    if (!output) return 0;
+
+    int success = 1;
+    char line[MAX_LINE];
+    for (int i = 0; i < spec->directive_count && success; i++) {
+        const directive_t* directive = &spec->directives[i];
+        if (directive->kind != DIRECTIVE_EXPECT_OUTPUT) continue;
+
+        if (!fgets(line, sizeof(line), output)) {
+            printf("    Missing output line: %s\n", directive->text);
+            success = 0;
+            break;
+        }
+        trim_line(line);
+        if (strcmp(line, directive->text) != 0) {
+            printf("    Output mismatch: expected '%s', got '%s'\n", directive->text, line);
+            success = 0;
+        }
+    }
+
+    fclose(output);
+    return success;
+}
+
+static int has_output_directives(const test_spec_t* spec) {
+    for (int i = 0; i < spec->directive_count; i++) {
+        if (spec->directives[i].kind == DIRECTIVE_EXPECT_OUTPUT) return 1;
+    }
+    return 0;
+}
+
+// Helper: Run command with stdout in output_path and check the expectations
+static int check_run(const test_spec_t* spec, const char* command, const char* output_path, const char* what) {
+    char redirected[MAX_COMMAND];
+    snprintf(redirected, sizeof(redirected), "%s > %s", command, output_path);
+    int exit_status = run_command(redirected);
+
+    if (spec->expect_exit >= 0 && exit_status != spec->expect_exit) {
+        printf("    Exit status %d, expected %d (%s)\n", exit_status, spec->expect_exit, what);
+        return 0;
+    }
+    return check_output(spec, output_path);
+}
+
+// Helper: Link object_path with runtime, run it and check the expectations
+static int run_program(const test_spec_t* spec, const char* object_path, const char* runtime,
+                       const char* exe_path, const char* output_path) {
+    char command[MAX_COMMAND];
+    snprintf(command, sizeof(command), "gcc -m64 -no-pie %s %s -o %s 2>/dev/null",
+             object_path, runtime, exe_path);
+    if (run_command(command) != 0) {
+        printf("    Linking %s failed\n", object_path);
+        return 0;
+    }
+    return check_run(spec, exe_path, output_path, object_path);
+}
+
+// Helper: Copy path and its INPUTS into work_dir and build them together
+static int run_multi_file(const char* compiler, const char* work_dir, const char* path,
+                          const test_spec_t* spec, const char* exe_path, const char* output_path,
+                          const char* log_path) {
+    const char* slash = strrchr(path, '/');
+    int dir_length = slash ? (int)(slash - path + 1) : 0;
+
+    // Sources are copied so the per-file objects land in the work directory
+    char copy[MAX_COMMAND], build[MAX_COMMAND];
+    size_t copy_length = (size_t)snprintf(copy, sizeof(copy), "cp %s", path);
+    size_t build_length = (size_t)snprintf(build, sizeof(build), "%s %s -o %s %s/%s",
+                                           compiler, spec->flags, exe_path, work_dir, slash ? slash + 1 : path);
+
+    char inputs[MAX_LINE];
+    snprintf(inputs, sizeof(inputs), "%s", spec->inputs);
+    for (char* input = strtok(inputs, " \t"); input; input = strtok(NULL, " \t")) {
+        copy_length += (size_t)snprintf(copy + copy_length, sizeof(copy) - copy_length, " %.*s%s",
+                                        dir_length, path, input);
+        build_length += (size_t)snprintf(build + build_length, sizeof(build) - build_length, " %s/%s",
+                                         work_dir, input);
+    }
+    snprintf(copy + copy_length, sizeof(copy) - copy_length, " %s", work_dir);
+    snprintf(build + build_length, sizeof(build) - build_length, " > %s 2>&1", log_path);
+
+    if (run_command(copy) != 0) {
+        printf("    Copying the inputs of %s failed\n", path);
+        return 0;
+    }
+    if (run_command(build) != 0) {
+        printf("    Multi-file build failed (see %s)\n", log_path);
+        return 0;
+    }
+    return check_run(spec, exe_path, output_path, "multi-file build");
+}
+
+// Run one test file; returns 1 on success
+static int run_test(const char* compiler, const char* work_dir, const char* path, const test_spec_t* spec) {
+    // Name the artifacts after the file so parallel directories don't collide
+    const char* base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+
+    char assembly_path[MAX_LINE], object_path[MAX_LINE], runtime_path[MAX_LINE];
+    char exe_path[MAX_LINE], log_path[MAX_LINE], output_path[MAX_LINE];
+    snprintf(assembly_path, sizeof(assembly_path), "%s/%s.s", work_dir, base);
+    snprintf(object_path, sizeof(object_path), "%s/%s.o", work_dir, base);
+    snprintf(exe_path, sizeof(exe_path), "%s/%s.exe", work_dir, base);
+    snprintf(log_path, sizeof(log_path), "%s/%s.log", work_dir, base);
+    snprintf(output_path, sizeof(output_path), "%s/%s.out", work_dir, base);
+
+    char command[MAX_COMMAND];
+    snprintf(command, sizeof(command), "%s %s --compile-only -o %s %s > %s 2>&1",
+             compiler, spec->flags, assembly_path, path, log_path);
+    int compile_status = run_command(command);
+
+    if (spec->expect_error) {
+        if (compile_status == 0) {
+            printf("    Compilation succeeded but an error was expected\n");
+            return 0;
+        }
+        return 1;
+    }
+    if (compile_status != 0) {
+        printf("    Compilation failed (see %s)\n", log_path);
+        return 0;
+    }
+
+    char* assembly = read_file(assembly_path);
+    if (!assembly) return 0;
+    int success = check_assembly(spec, assembly);
+    free(assembly);
+    if (!success) return 0;
+
+    if (spec->expect_exit < 0 && !has_output_directives(spec)) return 1;
+
+    if (spec->inputs[0]) {
+        return run_multi_file(compiler, work_dir, path, spec, exe_path, output_path, log_path);
+    }
+
+    if (!run_program(spec, assembly_path, "runtime/runtime.c", exe_path, output_path)) return 0;
+
+    snprintf(command, sizeof(command), "%s %s -c -o %s %s > %s 2>&1",
+             compiler, spec->flags, object_path, path, log_path);
+    if (run_command(command) != 0) {
+        printf("    Compilation to an object failed (see %s)\n", log_path);
+        return 0;
+    }
+
+    const char* slash = strrchr(compiler, '/');
+    snprintf(runtime_path, sizeof(runtime_path), "%.*sruntime.o",
+             slash ? (int)(slash - compiler + 1) : 0, compiler);
+    if (!run_program(spec, object_path, runtime_path, exe_path, output_path)) return 0;
+
+    snprintf(command, sizeof(command), "%s %s --run %s", compiler, spec->flags, path);
+    return check_run(spec, command, output_path, "--run");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <compiler> <work_dir> <test.tc>...\n", argv[0]);
+        return 1;
+    }
+
+    const char* compiler = argv[1];
+    const char* work_dir = argv[2];
+    int passed = 0, failed = 0, skipped = 0;
+
+    printf("=== RUNNING INTEGRATION TESTS ===\n\n");
+
+    for (int i = 3; i < argc; i++) {
+        test_spec_t spec;
+        if (!parse_spec(argv[i], &spec)) {
+            printf("✗ %s (cannot read)\n", argv[i]);
+            failed++;
+            continue;
+        }
+        if (!spec.has_directives) {
+            skipped++;
+            continue;
+        }
+
+        if (run_test(compiler, work_dir, argv[i], &spec)) {
+            printf("✓ %s passed\n", argv[i]);
+            passed++;
+        } else {
+            printf("✗ %s FAILED\n", argv[i]);
+            failed++;
+        }
+    }
+
+    printf("\n%d passed, %d failed, %d skipped\n", passed, failed, skipped);
+    return failed > 0;
+}
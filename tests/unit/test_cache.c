@@ -0,0 +1,139 @@
+// tests/unit/test_cache.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include "../../src/cache.h"
+
+#define CACHE_DIR "test_cache_dir"
+
+// Test helper functions
+void write_file(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+    assert(file);
+    fputs(text, file);
+    fclose(file);
+}
+
+int file_equals(const char* path, const char* text) {
+    char buffer[256];
+    FILE* file = fopen(path, "r");
+    if (!file) return 0;
+    size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    buffer[length] = '\0';
+    return strcmp(buffer, text) == 0;
+}
+
+void test_keys() {
+    printf("Testing cache keys...\n");
+
+    const char* source = "int main() { return 0; }";
+    char key[CACHE_KEY_SIZE], same[CACHE_KEY_SIZE], other[CACHE_KEY_SIZE];
+    cache_key(source, strlen(source), "level=0", key);
+    cache_key(source, strlen(source), "level=0", same);
+    assert(strlen(key) == CACHE_KEY_SIZE - 1);
+    assert(strcmp(key, same) == 0);
+
+    // Any change to the source or the configuration changes the key
+    cache_key(source, strlen(source), "level=1", other);
+    assert(strcmp(key, other) != 0);
+    cache_key(source, strlen(source) - 1, "level=0", other);
+    assert(strcmp(key, other) != 0);
+    cache_key("int main() { return 1; }", strlen(source), "level=0", other);
+    assert(strcmp(key, other) != 0);
+
+    // The boundary between configuration and source matters
+    cache_key("b", 1, "a", key);
+    cache_key("", 0, "ab", other);
+    assert(strcmp(key, other) != 0);
+
+    char identity[CACHE_KEY_SIZE], again[CACHE_KEY_SIZE];
+    cache_compiler_identity(identity);
+    cache_compiler_identity(again);
+    assert(identity[0] != '\0' && strcmp(identity, again) == 0);
+
+    printf("✓ Cache key test passed!\n\n");
+}
+
+void test_store_and_fetch() {
+    printf("Testing storing and fetching entries...\n");
+
+    const char* key = "0123456789abcdef0123456789abcdef";
+    assert(!cache_fetch(CACHE_DIR, key, ".s", "test_cache_out.s"));
+
+    // Storing creates the directory
+    write_file("test_cache_in.s", "main:\n    ret\n");
+    assert(cache_store(CACHE_DIR, key, ".s", "test_cache_in.s"));
+    assert(cache_fetch(CACHE_DIR, key, ".s", "test_cache_out.s"));
+    assert(file_equals("test_cache_out.s", "main:\n    ret\n"));
+
+    // Extensions keep assembly and objects apart; a store replaces an entry
+    assert(!cache_fetch(CACHE_DIR, key, ".o", "test_cache_out.s"));
+    write_file("test_cache_in.s", "main:\n    xorl %eax, %eax\n    ret\n");
+    assert(cache_store(CACHE_DIR, key, ".s", "test_cache_in.s"));
+    assert(cache_fetch(CACHE_DIR, key, ".s", "test_cache_out.s"));
+    assert(file_equals("test_cache_out.s", "main:\n    xorl %eax, %eax\n    ret\n"));
+
+    assert(!cache_store(CACHE_DIR, key, ".s", "test_cache_missing.s"));
+
+    unlink(CACHE_DIR "/0123456789abcdef0123456789abcdef.s");
+    rmdir(CACHE_DIR);
+    unlink("test_cache_in.s");
+    unlink("test_cache_out.s");
+
+    printf("✓ Store and fetch test passed!\n\n");
+}
+
+void test_memory_cache() {
+    printf("Testing the in-memory cache...\n");
+
+    const char* first = "0123456789abcdef0123456789abcdef";
+    const char* second = "fedcba9876543210fedcba9876543210";
+    cache_memory_t* cache = cache_memory_create(32);
+    assert(cache);
+    assert(!cache_memory_fetch(cache, first, "test_cache_out.s"));
+
+    write_file("test_cache_in.s", "main:\n    ret\n");
+    assert(cache_memory_store(cache, first, "test_cache_in.s"));
+    unlink("test_cache_in.s");
+    assert(cache_memory_fetch(cache, first, "test_cache_out.s"));
+    assert(file_equals("test_cache_out.s", "main:\n    ret\n"));
+
+    // A store replaces an entry
+    write_file("test_cache_in.s", "f:\n    ret\n");
+    assert(cache_memory_store(cache, first, "test_cache_in.s"));
+    assert(cache_memory_fetch(cache, first, "test_cache_out.s"));
+    assert(file_equals("test_cache_out.s", "f:\n    ret\n"));
+
+    // 11 + 23 bytes exceed the limit, so the older entry goes
+    write_file("test_cache_in.s", "g:\n    xorl %eax, %eax\n");
+    assert(cache_memory_store(cache, second, "test_cache_in.s"));
+    assert(!cache_memory_fetch(cache, first, "test_cache_out.s"));
+    assert(cache_memory_fetch(cache, second, "test_cache_out.s"));
+    assert(file_equals("test_cache_out.s", "g:\n    xorl %eax, %eax\n"));
+
+    // Outputs larger than the whole store are not kept
+    write_file("test_cache_in.s", "main:\n    xorl %eax, %eax\n    ret\n");
+    assert(!cache_memory_store(cache, first, "test_cache_in.s"));
+    assert(!cache_memory_store(cache, first, "test_cache_missing.s"));
+    assert(cache_memory_fetch(cache, second, "test_cache_out.s"));
+
+    cache_memory_destroy(cache);
+    unlink("test_cache_in.s");
+    unlink("test_cache_out.s");
+
+    printf("✓ In-memory cache test passed!\n\n");
+}
+
+int main() {
+    printf("=== RUNNING COMPILE CACHE TESTS ===\n\n");
+
+    test_keys();
+    test_store_and_fetch();
+    test_memory_cache();
+
+    printf("🎉 All compile cache tests passed!\n");
+    return 0;
+}
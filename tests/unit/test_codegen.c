@@ -10,6 +10,8 @@
 #include "../../src/ast.h"
 #include "../../src/semantic.h"
 #include "../../src/codegen.h"
+#include "../../src/pool.h"
+#include "../../src/utils.h"
 
 // Test helper functions
 int compile_and_assemble(const char* source, const char* output_exe) {
@@ -214,6 +216,252 @@ void test_function_with_parameters() {
     printf("✓ Function with parameters test passed!\n\n");
 }
 
+void test_many_arguments() {
+    printf("Testing arguments passed on the stack...\n");
+    
+    // Eight arguments: the last two go on the stack, and odd and even
+    // numbers of stack arguments exercise the call-site alignment padding
+    const char* source = 
+        "int sum8(int a, int b, int c, int d, int e, int f, int g, int h) {\n"
+        "    return a + b * 2 + c + d + e + f + g * 3 + h;\n"
+        "}\n"
+        "int pick7(int a, int b, int c, int d, int e, int f, int g) {\n"
+        "    return g - a;\n"
+        "}\n"
+        "int main() {\n"
+        "    int s = sum8(1, 2, 3, 4, 5, 6, 7, 8);\n"
+        "    return s + pick7(s, 0, 0, 0, 0, 0, 100) - sum8(0, 0, 0, 0, 0, 0, 1, 0);\n"
+        "}";
+    
+    assert(compile_and_assemble(source, "test_many_args"));
+    
+    int exit_code = run_program_and_get_exit_code("./test_many_args");
+    assert(exit_code == 97);  // 52 + (100 - 52) - 3
+    
+    unlink("test_many_args");
+    printf("✓ Stack arguments test passed!\n\n");
+}
+
+void test_register_pressure() {
+    printf("Testing register pressure...\n");
+    
+    // More values live across calls than there are callee-saved registers,
+    // plus an expression deep enough to exhaust the temporaries
+    const char* source = 
+        "int id(int x) {\n"
+        "    return x;\n"
+        "}\n"
+        "int main() {\n"
+        "    int a = id(1);\n"
+        "    int b = id(2);\n"
+        "    int c = id(3);\n"
+        "    int d = id(4);\n"
+        "    int e = id(5);\n"
+        "    int f = id(6);\n"
+        "    int g = id(7);\n"
+        "    int h = id(8);\n"
+        "    int deep = (a + (b + (c + (d + (e + (f + (g + (h + (a * (b - (c - (d - 7))))))))))));\n"
+        "    return a + b + c + d + e + f + g + h + deep % 7 + 100 / id(3) % 10;\n"
+        "}";
+    
+    assert(compile_and_assemble(source, "test_pressure"));
+    
+    int exit_code = run_program_and_get_exit_code("./test_pressure");
+    assert(exit_code == 43);  // 36 + 32 % 7 + 100 / 3 % 10 = 36 + 4 + 3
+    
+    unlink("test_pressure");
+    printf("✓ Register pressure test passed!\n\n");
+}
+
+void test_recursion() {
+    printf("Testing recursion...\n");
+    
+    const char* source = 
+        "int factorial(int n) {\n"
+        "    if (n <= 1) {\n"
+        "        return 1;\n"
+        "    }\n"
+        "    return n * factorial(n - 1);\n"
+        "}\n"
+        "int main() {\n"
+        "    int total = 0;\n"
+        "    for (int i = 1; i <= 5; i = i + 1) {\n"
+        "        if (i % 2 == 1 && i != 3 || i == 4) {\n"
+        "            total = total + factorial(i);\n"
+        "        }\n"
+        "    }\n"
+        "    return total;\n"
+        "}";
+    
+    assert(compile_and_assemble(source, "test_recursion"));
+    
+    int exit_code = run_program_and_get_exit_code("./test_recursion");
+    assert(exit_code == 145);  // 1! + 4! + 5! = 1 + 24 + 120
+    
+    unlink("test_recursion");
+    printf("✓ Recursion test passed!\n\n");
+}
+
+// Generate assembly for source into path, with function bodies analyzed and
+// generated on pool when it is set
+int generate_assembly(const char* source, pool_t* pool, const char* path) {
+    lexer_t* lexer = lexer_create(source);
+    parser_t* parser = parser_create(lexer);
+    ast_node_t* ast = parser_parse_program(parser);
+    assert(ast && !parser_has_errors(parser));
+    
+    semantic_analyzer_t* analyzer = semantic_create();
+    analyzer->pool = pool;
+    int success = semantic_analyze(analyzer, ast) && !semantic_has_errors(analyzer);
+    
+    codegen_t* codegen = codegen_create(path);
+    assert(codegen);
+    codegen->pool = pool;
+    codegen->peephole = 1;
+    success = success && codegen_generate(codegen, ast);
+    
+    codegen_destroy(codegen);
+    semantic_destroy(analyzer);
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    return success;
+}
+
+// Read a whole file into a heap buffer
+char* read_file(const char* path) {
+    FILE* file = fopen(path, "r");
+    assert(file);
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* text = malloc(size + 1);
+    assert(text && fread(text, 1, size, file) == (size_t)size);
+    text[size] = '\0';
+    fclose(file);
+    return text;
+}
+
+void test_parallel_functions() {
+    printf("Testing parallel function generation...\n");
+    
+    // Strings are first used in different functions and shared between them
+    const char* source = 
+        "int print(char* s);\n"
+        "int first(int x) {\n"
+        "    print(\"b\");\n"
+        "    return x + 1;\n"
+        "}\n"
+        "int second(int x) {\n"
+        "    print(\"c\");\n"
+        "    print(\"a\");\n"
+        "    print(\"b\");\n"
+        "    return first(x) * 2;\n"
+        "}\n"
+        "int third(int x) {\n"
+        "    int total = 0;\n"
+        "    while (x > 0) { total = total + x; x = x - 1; }\n"
+        "    print(\"a\");\n"
+        "    return total;\n"
+        "}\n"
+        "int main() {\n"
+        "    print(\"d\");\n"
+        "    return second(third(3)) - 2;\n"
+        "}";
+    
+    assert(generate_assembly(source, NULL, "test_sequential.s"));
+    pool_t* pool = pool_create(3);
+    assert(pool);
+    assert(generate_assembly(source, pool, "test_parallel.s"));
+    pool_destroy(pool);
+    
+    // Identical output, with the strings numbered in order of first use
+    char* sequential = read_file("test_sequential.s");
+    char* parallel = read_file("test_parallel.s");
+    assert(strcmp(sequential, parallel) == 0);
+    const char* b = strstr(parallel, ".LC0:\n    .string \"b\"");
+    const char* d = strstr(parallel, ".LC3:\n    .string \"d\"");
+    assert(b && d && b < d);
+    free(sequential);
+    free(parallel);
+    
+    int result = system("gcc -m64 -no-pie test_parallel.s runtime/runtime.c -o test_parallel > /dev/null 2>&1");
+    assert(result == 0);
+    assert(run_program_and_get_exit_code("./test_parallel") == 12);  // (3+2+1 + 1) * 2 - 2
+    
+    unlink("test_sequential.s");
+    unlink("test_parallel.s");
+    unlink("test_parallel");
+    printf("✓ Parallel function generation test passed!\n\n");
+}
+
+// Write count structured and textual copies of the same instructions, with
+// a long comment in between, through the assembly writer into path
+void write_instructions(const char* path, int use_writev, size_t count) {
+    codegen_t* codegen = codegen_create(path);
+    assert(codegen);
+    codegen->use_writev = use_writev;
+    
+    const char* function = intern_string("f");
+    char comment[2000];
+    memset(comment, 'x', sizeof(comment) - 1);
+    comment[sizeof(comment) - 1] = '\0';
+    
+    for (size_t i = 0; i < count; i++) {
+        codegen_emit_local_label(codegen, function, (long)i);
+        codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_immediate_operand(-(long)i),
+                           codegen_memory_operand(REG_RBP, -8));
+        codegen_emit_instr(codegen, ASM_JCC, '\0', 1, codegen_label_operand(function, ASM_RETURN_LABEL))->condition =
+            OP_LE;
+        codegen_emit_instr(codegen, ASM_MOVZB, 'l', 2, codegen_register_operand(REG_R8, 1),
+                           codegen_register_operand(REG_R9, 4));
+        if (i == count / 2) codegen_emit_comment(codegen, comment);
+        
+        char label[32];
+        snprintf(label, sizeof(label), ".Lf.%zu", i);
+        codegen_emit_label(codegen, label);
+        codegen_emit(codegen, "movq $%ld, -8(%%rbp)", -(long)i);
+        codegen_emit(codegen, "jle .Lf.return");
+        codegen_emit(codegen, "movzbl %%r8b, %%r9d");
+        if (i % 1000 == 0) codegen_flush(codegen);
+    }
+    codegen_flush(codegen);
+    assert(!codegen->write_failed);
+    codegen_destroy(codegen);
+}
+
+void test_assembly_writer() {
+    printf("Testing the buffered assembly writer...\n");
+    
+    // Structured instructions print as the text they were parsed from
+    write_instructions("test_writer.s", 0, 2);
+    char* text = read_file("test_writer.s");
+    const char* half =
+        ".Lf.0:\n"
+        "    movq $0, -8(%rbp)\n"
+        "    jle .Lf.return\n"
+        "    movzbl %r8b, %r9d\n";
+    assert(strncmp(text, half, strlen(half)) == 0);
+    assert(strncmp(text + strlen(half), half, strlen(half)) == 0);
+    assert(strstr(text, ".Lf.1:\n    movq $-1, -8(%rbp)\n"));
+    free(text);
+    
+    // Far more text than the chunks hold, written with fwrite() and writev()
+    write_instructions("test_writer.s", 0, 40000);
+    write_instructions("test_writev.s", 1, 40000);
+    char* written = read_file("test_writer.s");
+    char* gathered = read_file("test_writev.s");
+    assert(strlen(written) > 2 * CODEGEN_MAX_CHUNKS * CODEGEN_CHUNK_SIZE);
+    assert(strcmp(written, gathered) == 0);
+    assert(strstr(written, "    movzbl %r8b, %r9d\n    # xxxx"));
+    free(written);
+    free(gathered);
+    
+    unlink("test_writer.s");
+    unlink("test_writev.s");
+    printf("✓ Assembly writer test passed!\n\n");
+}
+
 int main() {
     printf("=== RUNNING CODE GENERATION TESTS ===\n\n");
     
@@ -228,9 +476,12 @@ int main() {
     test_arithmetic_operations();
     test_if_statement();
     test_while_loop();
-    
-    // Note: Function calls are more complex and might need more work
-    // test_function_with_parameters();
+    test_function_with_parameters();
+    test_many_arguments();
+    test_register_pressure();
+    test_recursion();
+    test_parallel_functions();
+    test_assembly_writer();
     
     printf("🎉 All code generation tests passed!\n");
     return 0;
@@ -0,0 +1,332 @@
+// tests/unit/test_ir.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/lexer.h"
+#include "../../src/parser.h"
+#include "../../src/ast.h"
+#include "../../src/semantic.h"
+#include "../../src/ir.h"
+
+// Test helper functions
+ir_program_t* lower_string(const char* source) {
+    lexer_t* lexer = lexer_create(source);
+    parser_t* parser = parser_create(lexer);
+    ast_node_t* ast = parser_parse_program(parser);
+    assert(ast && !parser_has_errors(parser));
+
+    semantic_analyzer_t* analyzer = semantic_create();
+    assert(semantic_analyze(analyzer, ast) && !semantic_has_errors(analyzer));
+
+    ir_program_t* program = ir_lower_program(ast);
+    assert(program);
+
+    semantic_destroy(analyzer);
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+
+    return program;
+}
+
+// Index of the block whose first instruction is label
+size_t block_of_label(ir_function_t* function, long label) {
+    for (size_t b = 0; b < function->block_count; b++) {
+        ir_instr_t* first = &function->instrs[function->blocks[b].start];
+        if (first->opcode == IR_LABEL && first->imm == label) return b;
+    }
+    assert(0);
+    return 0;
+}
+
+void test_type_annotations() {
+    printf("Testing type annotations in lowered IR...\n");
+
+    const char* source =
+        "char* name();\n"
+        "int main() {\n"
+        "    char* s = name();\n"
+        "    int n = 1 + 2;\n"
+        "    return n;\n"
+        "}";
+
+    ir_program_t* program = lower_string(source);
+    assert(program->function_count == 1);  // Prototypes are not lowered
+
+    ir_function_t* function = program->functions[0];
+    int saw_call = 0, saw_add = 0;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->opcode == IR_CALL) {
+            assert(instr->type == TYPE_CHAR_PTR);
+            saw_call = 1;
+        }
+        if (instr->opcode == IR_BINARY && instr->oper == OP_ADD) {
+            assert(instr->type == TYPE_INT);
+            saw_add = 1;
+        }
+    }
+    assert(saw_call && saw_add);
+
+    ir_program_destroy(program);
+    printf("✓ Type annotations test passed!\n\n");
+}
+
+void test_cfg_construction() {
+    printf("Testing CFG construction...\n");
+
+    const char* source =
+        "int main() {\n"
+        "    int i = 0;\n"
+        "    while (i < 10) {\n"
+        "        i = i + 1;\n"
+        "    }\n"
+        "    return i;\n"
+        "}";
+
+    ir_program_t* program = lower_string(source);
+    ir_function_t* function = program->functions[0];
+    assert(ir_build_cfg(function));
+
+    // entry -> header -> { body, exit }, body -> header
+    ir_instr_t* header_label = NULL;
+    for (size_t i = 0; i < function->instr_count && !header_label; i++) {
+        if (function->instrs[i].opcode == IR_LABEL) header_label = &function->instrs[i];
+    }
+    assert(header_label);
+
+    size_t header = block_of_label(function, header_label->imm);
+    ir_block_t* block = &function->blocks[header];
+    assert(block->predecessor_count == 2);   // Entry and the back edge
+    assert(block->successor_count == 2);     // Body (fallthrough) and exit
+
+    ir_block_t* body = &function->blocks[block->successors[0]];
+    assert(body->successor_count == 1 && body->successors[0] == (int)header);
+
+    // Blocks partition the instruction list
+    size_t covered = 0;
+    for (size_t b = 0; b < function->block_count; b++) {
+        assert(function->blocks[b].start == covered);
+        covered = function->blocks[b].end;
+    }
+    assert(covered == function->instr_count);
+
+    ir_program_destroy(program);
+    printf("✓ CFG construction test passed!\n\n");
+}
+
+void test_liveness() {
+    printf("Testing liveness analysis...\n");
+
+    const char* source =
+        "int main() {\n"
+        "    int sum = 0;\n"
+        "    int unused = 5;\n"
+        "    for (int i = 0; i < 4; i = i + 1) {\n"
+        "        sum = sum + i;\n"
+        "    }\n"
+        "    return sum;\n"
+        "}";
+
+    ir_program_t* program = lower_string(source);
+    ir_function_t* function = program->functions[0];
+    assert(ir_compute_liveness(function));
+
+    // Variables get vregs in declaration order: sum, unused, i
+    int sum = -1, unused = -1, i = -1;
+    for (int v = 0; v < function->vreg_count; v++) {
+        if (!(function->vreg_flags[v] & IR_VREG_VARIABLE)) continue;
+        if (sum < 0) sum = v;
+        else if (unused < 0) unused = v;
+        else if (i < 0) i = v;
+    }
+    assert(i >= 0);
+
+    size_t header = 0;
+    for (size_t b = 0; b < function->block_count; b++) {
+        if (function->blocks[b].predecessor_count == 2) header = b;
+    }
+    assert(header > 0);
+
+    // Loop-carried values are live into the header, dead stores are not
+    assert(ir_vreg_live_in(function, header, sum));
+    assert(ir_vreg_live_in(function, header, i));
+    assert(!ir_vreg_live_in(function, header, unused));
+    assert(!ir_vreg_live_out(function, 0, unused));
+
+    // Intervals cover the whole loop, including the back edge
+    ir_interval_t* intervals = malloc(function->vreg_count * sizeof(ir_interval_t));
+    ir_compute_intervals(function, intervals);
+    ir_block_t* latch = &function->blocks[function->blocks[header].predecessors[1]];
+    assert(intervals[i].start <= (int)function->blocks[header].start);
+    assert(intervals[i].end >= (int)latch->end - 1);
+    assert(!intervals[sum].crosses_call);
+
+    free(intervals);
+    ir_program_destroy(program);
+    printf("✓ Liveness analysis test passed!\n\n");
+}
+
+void test_intervals_across_calls() {
+    printf("Testing live intervals across calls...\n");
+
+    const char* source =
+        "int f(int x);\n"
+        "int main() {\n"
+        "    int kept = 3;\n"
+        "    int arg = 4;\n"
+        "    int r = f(arg);\n"
+        "    return r + kept;\n"
+        "}";
+
+    ir_program_t* program = lower_string(source);
+    ir_function_t* function = program->functions[0];
+
+    ir_interval_t* intervals = malloc(function->vreg_count * sizeof(ir_interval_t));
+    ir_compute_intervals(function, intervals);
+
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->opcode != IR_CALL) continue;
+
+        // The argument dies at the call, the result is born there
+        assert(!intervals[instr->args[0]].crosses_call);
+        assert(!intervals[instr->dst].crosses_call);
+    }
+
+    int kept = -1;
+    for (int v = 0; v < function->vreg_count && kept < 0; v++) {
+        if (function->vreg_flags[v] & IR_VREG_VARIABLE) kept = v;
+    }
+    assert(intervals[kept].crosses_call);
+
+    free(intervals);
+    ir_program_destroy(program);
+    printf("✓ Live intervals across calls test passed!\n\n");
+}
+
+void test_condition_branches() {
+    printf("Testing condition lowering to branches...\n");
+
+    const char* source =
+        "int main() {\n"
+        "    int a = 1;\n"
+        "    int b = 2;\n"
+        "    if (a < b && !(a == 0 || b > 5)) {\n"
+        "        return 1;\n"
+        "    }\n"
+        "    while (1) {\n"
+        "        return 2;\n"
+        "    }\n"
+        "}";
+
+    ir_program_t* program = lower_string(source);
+    ir_function_t* function = program->functions[0];
+
+    // Each comparison feeds its own jump; no truth value is built for && / ||
+    // and the constant loop condition needs no test at all
+    size_t compares = 0, jumps = 0;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->opcode == IR_BINARY) {
+            assert(instr->oper == OP_LT || instr->oper == OP_EQ || instr->oper == OP_GT);
+            assert(i + 1 < function->instr_count);
+            ir_instr_t* next = &function->instrs[i + 1];
+            assert(next->opcode == IR_JUMP_ZERO || next->opcode == IR_JUMP_NONZERO);
+            assert(next->src1 == instr->dst);
+            compares++;
+        }
+        if (instr->opcode == IR_JUMP_ZERO || instr->opcode == IR_JUMP_NONZERO) jumps++;
+        assert(instr->opcode != IR_UNARY);
+    }
+    assert(compares == 3 && jumps == 3);
+
+    ir_program_destroy(program);
+    printf("✓ Condition lowering test passed!\n\n");
+}
+
+void test_slot_lookups() {
+    printf("Testing slot lookups against name lookups...\n");
+
+    // Shadowing, including an initializer that reads the name it declares
+    const char* source =
+        "int f(int a, int b) {\n"
+        "    int x = a;\n"
+        "    {\n"
+        "        int x = x + b;\n"
+        "        a = x;\n"
+        "    }\n"
+        "    for (int i = 0; i < b; i = i + 1) { int a = i; x = x + a; }\n"
+        "    return x + a;\n"
+        "}";
+
+    lexer_t* lexer = lexer_create(source);
+    parser_t* parser = parser_create(lexer);
+    ast_node_t* ast = parser_parse_program(parser);
+    semantic_analyzer_t* analyzer = semantic_create();
+    assert(ast && semantic_analyze(analyzer, ast));
+    // Lowering reads only the slots left in the tree, not the analyzer
+    semantic_destroy(analyzer);
+
+    ir_program_t* slots = ir_lower_program(ast);
+
+    // Without slots every identifier is resolved by name
+    ast_node_t* func = ast->data.program.declarations[0];
+    assert(func->data.function_decl.local_count == 6);
+    func->data.function_decl.local_count = 0;
+    ir_program_t* names = ir_lower_program(ast);
+
+    ir_function_t* left = slots->functions[0];
+    ir_function_t* right = names->functions[0];
+    assert(left->instr_count == right->instr_count);
+    for (size_t i = 0; i < left->instr_count; i++) {
+        assert(left->instrs[i].opcode == right->instrs[i].opcode);
+        assert(left->instrs[i].dst == right->instrs[i].dst);
+        assert(left->instrs[i].src1 == right->instrs[i].src1);
+        assert(left->instrs[i].src2 == right->instrs[i].src2);
+    }
+
+    ir_program_destroy(slots);
+    ir_program_destroy(names);
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    printf("✓ Slot lookup test passed!\n\n");
+}
+
+void test_unresolved_globals() {
+    printf("Testing globals that lowering cannot resolve...\n");
+
+    ir_program_t* program = lower_string("int f(int a) { return a; }");
+    assert(program->unresolved == NULL);
+    ir_program_destroy(program);
+
+    // The write is reported first; the read must not become a silent 0 either
+    program = lower_string("int g;\nint main() {\n    g = 5;\n    return g + 1;\n}");
+    assert(program->unresolved && strcmp(program->unresolved, "g") == 0);
+    assert(program->unresolved_line == 3 && program->unresolved_column == 5);
+    ir_program_destroy(program);
+
+    program = lower_string("int g;\nint main() {\n    return g + 1;\n}");
+    assert(program->unresolved && strcmp(program->unresolved, "g") == 0);
+    assert(program->unresolved_line == 3 && program->unresolved_column == 12);
+    ir_program_destroy(program);
+
+    printf("✓ Unresolved global test passed!\n\n");
+}
+
+int main() {
+    printf("=== RUNNING IR UNIT TESTS ===\n\n");
+
+    test_type_annotations();
+    test_cfg_construction();
+    test_liveness();
+    test_intervals_across_calls();
+    test_condition_branches();
+    test_slot_lookups();
+    test_unresolved_globals();
+
+    printf("🎉 All IR tests passed!\n");
+    return 0;
+}
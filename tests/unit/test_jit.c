@@ -0,0 +1,116 @@
+// tests/unit/test_jit.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/codegen.h"
+#include "../../src/object.h"
+#include "../../src/jit.h"
+#include "../../src/utils.h"
+
+// Test helper functions
+// Encode lines as codegen would buffer them (a trailing ':' makes a label)
+object_t* encode_lines(const char* const* lines, size_t count) {
+    object_t* object = object_create();
+    assert(object);
+
+    for (size_t i = 0; i < count; i++) {
+        asm_instr_t instr;
+        size_t length = strlen(lines[i]);
+        if (lines[i][length - 1] == ':') {
+            char label[64];
+            snprintf(label, sizeof(label), "%.*s", (int)(length - 1), lines[i]);
+            memset(&instr, 0, sizeof(instr));
+            instr.kind = ASM_LABEL;
+            instr.text = intern_string(label);
+        } else {
+            assert(codegen_parse_instruction(lines[i], &instr));
+        }
+        assert(object_encode(object, &instr, 1));
+    }
+    return object;
+}
+
+#define COUNT_OF(array) (sizeof(array) / sizeof((array)[0]))
+
+// Imports called from the loaded code
+static long last_argument;
+
+static long triple(long n) {
+    last_argument = n;
+    return 3 * n;
+}
+
+void test_load_and_call() {
+    printf("Testing loading and calling code...\n");
+
+    // twice(n) calls the import, loops over a local label and reads .data
+    const char* lines[] = {
+        "twice:",
+        "pushq %rbx",
+        "movq %rdi, %rbx",
+        "call triple",
+        "subq %rbx, %rax",
+        "popq %rbx",
+        "ret",
+        "count:",
+        "movq $0, %rax",
+        ".Lcount.1:",
+        "addq $1, %rax",
+        "cmpq %rdi, %rax",
+        "jl .Lcount.1",
+        "ret",
+        "greeting:",
+        "leaq .LC0(%rip), %rax",
+        "ret"
+    };
+    object_t* object = encode_lines(lines, COUNT_OF(lines));
+    object_add_string(object, ".LC0", "hi\\n");
+
+    jit_symbol_t imports[] = {{"unused", NULL}, {"triple", (void*)triple}};
+    const char* error = "unset";
+    jit_image_t* image = jit_load(object, imports, COUNT_OF(imports), &error);
+    assert(image && error == NULL);
+
+    long (*twice)(long) = (long (*)(long))jit_lookup(image, "twice");
+    long (*count)(long) = (long (*)(long))jit_lookup(image, "count");
+    const char* (*greeting)(void) = (const char* (*)(void))jit_lookup(image, "greeting");
+    assert(twice && count && greeting);
+    assert(jit_lookup(image, "triple") == NULL && jit_lookup(image, "missing") == NULL);
+
+    assert(twice(21) == 42 && last_argument == 21);
+    assert(count(7) == 7);
+    assert(strcmp(greeting(), "hi\n") == 0);
+    assert(jit_lookup(image, ".LC0") == greeting());
+
+    jit_destroy(image);
+    object_destroy(object);
+
+    printf("✓ Loading and calling test passed!\n\n");
+}
+
+void test_unresolved_import() {
+    printf("Testing unresolved imports...\n");
+
+    const char* lines[] = {"main:", "call missing", "ret"};
+    object_t* object = encode_lines(lines, COUNT_OF(lines));
+
+    const char* error = NULL;
+    assert(jit_load(object, NULL, 0, &error) == NULL);
+    assert(error && strcmp(error, "missing") == 0);
+
+    jit_destroy(NULL);
+    object_destroy(object);
+
+    printf("✓ Unresolved import test passed!\n\n");
+}
+
+int main() {
+    printf("=== RUNNING JIT LOADER TESTS ===\n\n");
+
+    test_load_and_call();
+    test_unresolved_import();
+
+    printf("🎉 All JIT loader tests passed!\n");
+    return 0;
+}
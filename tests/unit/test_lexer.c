@@ -4,12 +4,13 @@
 #include <string.h>
 #include <assert.h>
 #include "../../src/lexer.h"
+#include "../../src/utils.h"
 
 // Test helper function
-void assert_token(token_t token, token_type_t expected_type, const char* expected_value) {
+void assert_token(lexer_t* lexer, token_t token, token_type_t expected_type, const char* expected_value) {
     printf("  Token: %s", token_type_to_string(token.type));
-    if (token.value) {
-        printf(" '%s'", token.value);
+    if (TOKEN_HAS_VALUE(token)) {
+        printf(" '%.*s'", (int)token.length, lexer_token_text(lexer, token));
     }
     printf(" [%d:%d]", token.line, token.column);
     
@@ -21,7 +22,7 @@ void assert_token(token_t token, token_type_t expected_type, const char* expecte
     }
     
     if (expected_value) {
-        if (token.value && strcmp(token.value, expected_value) == 0) {
+        if (TOKEN_HAS_VALUE(token) && lexer_token_equals(lexer, token, expected_value)) {
             printf(" ✓");
         } else {
             printf(" ✗ (expected value '%s')", expected_value);
@@ -36,40 +37,87 @@ void test_keywords() {
     printf("Testing keywords...\n");
     lexer_t* lexer = lexer_create("int char void if else while for return");
     
-    assert_token(lexer_next_token(lexer), TOKEN_INT, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_CHAR, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_VOID, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_IF, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_ELSE, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_WHILE, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_FOR, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_RETURN, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_EOF, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_INT, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_CHAR, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_VOID, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IF, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_ELSE, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_WHILE, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_FOR, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_RETURN, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_EOF, NULL);
     
     lexer_destroy(lexer);
     printf("Keywords test passed!\n\n");
 }
 
+void test_keyword_hash() {
+    printf("Testing keyword hash...\n");
+    
+    // Every C89 keyword has its own slot, so any of them can be added
+    const char* c_keywords[] = {
+        "auto", "break", "case", "char", "const", "continue", "default", "do",
+        "double", "else", "enum", "extern", "float", "for", "goto", "if",
+        "int", "long", "register", "return", "short", "signed", "sizeof", "static",
+        "struct", "switch", "typedef", "union", "unsigned", "void", "volatile", "while"
+    };
+    size_t count = sizeof(c_keywords) / sizeof(c_keywords[0]);
+    assert(count == 32);
+    
+    int used[KEYWORD_HASH_SIZE] = {0};
+    size_t recognized = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t length = strlen(c_keywords[i]);
+        unsigned int slot = KEYWORD_HASH(c_keywords[i], length);
+        assert(slot < KEYWORD_HASH_SIZE && !used[slot]);
+        used[slot] = 1;
+        
+        // The table holds the language's keywords in their hash slots
+        if (lexer_lookup_keyword(c_keywords[i], length) != TOKEN_IDENTIFIER) recognized++;
+    }
+    assert(recognized == 8);
+    
+    printf("Keyword hash test passed!\n\n");
+}
+
+void test_keyword_lookup() {
+    printf("Testing keyword lookup...\n");
+    
+    assert(lexer_lookup_keyword("int", 3) == TOKEN_INT);
+    assert(lexer_lookup_keyword("return", 6) == TOKEN_RETURN);
+    assert(lexer_lookup_keyword("if(x)", 2) == TOKEN_IF);
+    
+    // Near misses must not match
+    assert(lexer_lookup_keyword("in", 2) == TOKEN_IDENTIFIER);
+    assert(lexer_lookup_keyword("integer", 7) == TOKEN_IDENTIFIER);
+    assert(lexer_lookup_keyword("Int", 3) == TOKEN_IDENTIFIER);
+    assert(lexer_lookup_keyword("fir", 3) == TOKEN_IDENTIFIER);
+    assert(lexer_lookup_keyword("whilst", 6) == TOKEN_IDENTIFIER);
+    assert(lexer_lookup_keyword("x", 1) == TOKEN_IDENTIFIER);
+    
+    printf("Keyword lookup test passed!\n\n");
+}
+
 void test_operators() {
     printf("Testing operators...\n");
     lexer_t* lexer = lexer_create("+ - * / % = == != < <= > >= && || !");
     
-    assert_token(lexer_next_token(lexer), TOKEN_PLUS, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_MINUS, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_MULTIPLY, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_DIVIDE, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_MODULO, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_ASSIGN, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_EQUAL, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_NOT_EQUAL, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_LESS, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_LESS_EQUAL, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_GREATER, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_GREATER_EQUAL, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_LOGICAL_AND, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_LOGICAL_OR, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_LOGICAL_NOT, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_EOF, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_PLUS, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_MINUS, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_MULTIPLY, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_DIVIDE, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_MODULO, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_ASSIGN, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_EQUAL, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_NOT_EQUAL, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_LESS, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_LESS_EQUAL, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_GREATER, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_GREATER_EQUAL, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_LOGICAL_AND, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_LOGICAL_OR, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_LOGICAL_NOT, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_EOF, NULL);
     
     lexer_destroy(lexer);
     printf("Operators test passed!\n\n");
@@ -79,13 +127,13 @@ void test_punctuation() {
     printf("Testing punctuation...\n");
     lexer_t* lexer = lexer_create("; , ( ) { }");
     
-    assert_token(lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_COMMA, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_LEFT_PAREN, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_RIGHT_PAREN, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_LEFT_BRACE, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_RIGHT_BRACE, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_EOF, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_COMMA, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_LEFT_PAREN, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_RIGHT_PAREN, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_LEFT_BRACE, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_RIGHT_BRACE, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_EOF, NULL);
     
     lexer_destroy(lexer);
     printf("Punctuation test passed!\n\n");
@@ -95,12 +143,12 @@ void test_identifiers() {
     printf("Testing identifiers...\n");
     lexer_t* lexer = lexer_create("main foo bar123 _test variable_name");
     
-    assert_token(lexer_next_token(lexer), TOKEN_IDENTIFIER, "main");
-    assert_token(lexer_next_token(lexer), TOKEN_IDENTIFIER, "foo");
-    assert_token(lexer_next_token(lexer), TOKEN_IDENTIFIER, "bar123");
-    assert_token(lexer_next_token(lexer), TOKEN_IDENTIFIER, "_test");
-    assert_token(lexer_next_token(lexer), TOKEN_IDENTIFIER, "variable_name");
-    assert_token(lexer_next_token(lexer), TOKEN_EOF, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "main");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "foo");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "bar123");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "_test");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "variable_name");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_EOF, NULL);
     
     lexer_destroy(lexer);
     printf("Identifiers test passed!\n\n");
@@ -110,11 +158,11 @@ void test_numbers() {
     printf("Testing numbers...\n");
     lexer_t* lexer = lexer_create("42 0 123 999");
     
-    assert_token(lexer_next_token(lexer), TOKEN_NUMBER, "42");
-    assert_token(lexer_next_token(lexer), TOKEN_NUMBER, "0");
-    assert_token(lexer_next_token(lexer), TOKEN_NUMBER, "123");
-    assert_token(lexer_next_token(lexer), TOKEN_NUMBER, "999");
-    assert_token(lexer_next_token(lexer), TOKEN_EOF, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_NUMBER, "42");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_NUMBER, "0");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_NUMBER, "123");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_NUMBER, "999");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_EOF, NULL);
     
     lexer_destroy(lexer);
     printf("Numbers test passed!\n\n");
@@ -124,10 +172,10 @@ void test_strings() {
     printf("Testing strings...\n");
     lexer_t* lexer = lexer_create("\"Hello, World!\" \"test\" \"\"");
     
-    assert_token(lexer_next_token(lexer), TOKEN_STRING, "Hello, World!");
-    assert_token(lexer_next_token(lexer), TOKEN_STRING, "test");
-    assert_token(lexer_next_token(lexer), TOKEN_STRING, "");
-    assert_token(lexer_next_token(lexer), TOKEN_EOF, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_STRING, "Hello, World!");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_STRING, "test");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_STRING, "");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_EOF, NULL);
     
     lexer_destroy(lexer);
     printf("Strings test passed!\n\n");
@@ -137,16 +185,16 @@ void test_comments() {
     printf("Testing comments...\n");
     lexer_t* lexer = lexer_create("int x; // line comment\nint y; /* block comment */ int z;");
     
-    assert_token(lexer_next_token(lexer), TOKEN_INT, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_IDENTIFIER, "x");
-    assert_token(lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_INT, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_IDENTIFIER, "y");
-    assert_token(lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_INT, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_IDENTIFIER, "z");
-    assert_token(lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_EOF, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_INT, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "x");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_INT, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "y");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_INT, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "z");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_EOF, NULL);
     
     lexer_destroy(lexer);
     printf("Comments test passed!\n\n");
@@ -162,30 +210,211 @@ void test_complete_program() {
     
     lexer_t* lexer = lexer_create(program);
     
-    assert_token(lexer_next_token(lexer), TOKEN_INT, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_IDENTIFIER, "main");
-    assert_token(lexer_next_token(lexer), TOKEN_LEFT_PAREN, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_RIGHT_PAREN, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_LEFT_BRACE, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_INT, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_IDENTIFIER, "x");
-    assert_token(lexer_next_token(lexer), TOKEN_ASSIGN, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_NUMBER, "42");
-    assert_token(lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_RETURN, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_IDENTIFIER, "x");
-    assert_token(lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_RIGHT_BRACE, NULL);
-    assert_token(lexer_next_token(lexer), TOKEN_EOF, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_INT, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "main");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_LEFT_PAREN, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_RIGHT_PAREN, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_LEFT_BRACE, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_INT, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "x");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_ASSIGN, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_NUMBER, "42");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_RETURN, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "x");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_RIGHT_BRACE, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_EOF, NULL);
     
     lexer_destroy(lexer);
     printf("Complete program test passed!\n\n");
 }
 
+void test_token_spans() {
+    printf("Testing token spans...\n");
+    const char* source = "int answer = 42;\n  print(\"hi\");";
+    lexer_t* lexer = lexer_create(source);
+    
+    // Tokens refer back into the source instead of owning copies
+    token_t kw = lexer_next_token(lexer);
+    assert(kw.start == 0 && kw.length == 3);
+    
+    token_t ident = lexer_next_token(lexer);
+    assert(ident.type == TOKEN_IDENTIFIER);
+    assert(ident.start == 4 && ident.length == 6);
+    assert(lexer_token_text(lexer, ident) == lexer->source + 4);
+    assert(ident.line == 1 && ident.column == 5);
+    
+    token_t assign = lexer_next_token(lexer);
+    assert(assign.type == TOKEN_ASSIGN);
+    assert(assign.column == 12);
+    
+    token_t number = lexer_next_token(lexer);
+    assert(lexer_token_equals(lexer, number, "42"));
+    
+    lexer_next_token(lexer); // ;
+    token_t call = lexer_next_token(lexer);
+    assert(call.line == 2 && call.column == 3);
+    
+    lexer_next_token(lexer); // (
+    token_t str = lexer_next_token(lexer);
+    assert(str.type == TOKEN_STRING);
+    assert(lexer_token_equals(lexer, str, "hi"));
+    
+    // Spans of earlier tokens stay valid while lexing continues
+    assert(lexer_token_equals(lexer, ident, "answer"));
+    lexer_destroy(lexer);
+    
+    lexer = lexer_create("@");
+    token_t bad = lexer_next_token(lexer);
+    assert(bad.type == TOKEN_ERROR);
+    assert(bad.message != NULL);
+    assert(lexer_token_equals(lexer, bad, "@"));
+    lexer_destroy(lexer);
+    
+    printf("Token spans test passed!\n\n");
+}
+
+void test_interning() {
+    printf("Testing string interning...\n");
+    lexer_t* lexer = lexer_create("count = count + counter;");
+    
+    // Identical identifiers share one interned pointer
+    token_t first = lexer_next_token(lexer);
+    lexer_next_token(lexer); // =
+    token_t second = lexer_next_token(lexer);
+    lexer_next_token(lexer); // +
+    token_t third = lexer_next_token(lexer);
+    
+    assert(first.name != NULL);
+    assert(first.name == second.name);
+    assert(first.name != third.name);
+    assert(first.name == intern_string("count"));
+    assert(intern_length(third.name) == 7);
+    lexer_destroy(lexer);
+    
+    // Keywords are recognized before interning and carry no name
+    size_t before = intern_count();
+    lexer = lexer_create("while return");
+    token_t keyword = lexer_next_token(lexer);
+    assert(keyword.type == TOKEN_WHILE && keyword.name == NULL);
+    assert(lexer_next_token(lexer).type == TOKEN_RETURN);
+    assert(intern_count() == before);
+    lexer_destroy(lexer);
+    
+    printf("String interning test passed!\n\n");
+}
+
+void test_input_modes() {
+    printf("Testing input modes...\n");
+    
+    // Borrowed buffers are lexed in place and need no terminator
+    const char buffer[] = {'x', ' ', '+', ' ', '1', '!'};
+    lexer_t* lexer = lexer_create_from_buffer(buffer, 5);
+    token_t ident = lexer_next_token(lexer);
+    assert(lexer_token_text(lexer, ident) == buffer);
+    assert(lexer_next_token(lexer).type == TOKEN_PLUS);
+    assert(lexer_next_token(lexer).type == TOKEN_NUMBER);
+    assert(lexer_next_token(lexer).type == TOKEN_EOF);
+    lexer_destroy(lexer);
+    
+    // Streams are read in chunks, tokens may straddle a chunk boundary
+    FILE* stream = tmpfile();
+    assert(stream != NULL);
+    size_t padding = LEXER_STREAM_CHUNK_SIZE - 3;
+    for (size_t i = 0; i < padding; i++) {
+        fputc(' ', stream);
+    }
+    fputs("counter = 7;", stream);
+    rewind(stream);
+    
+    lexer = lexer_create_from_stream(stream);
+    assert(lexer != NULL);
+    token_t straddling = lexer_next_token(lexer);
+    assert(straddling.type == TOKEN_IDENTIFIER);
+    assert(straddling.start == padding);
+    assert(lexer_token_equals(lexer, straddling, "counter"));
+    assert(lexer_next_token(lexer).type == TOKEN_ASSIGN);
+    assert(lexer_next_token(lexer).type == TOKEN_NUMBER);
+    assert(lexer_next_token(lexer).type == TOKEN_SEMICOLON);
+    assert(lexer_next_token(lexer).type == TOKEN_EOF);
+    assert(lexer_token_equals(lexer, straddling, "counter"));
+    lexer_destroy(lexer);
+    fclose(stream);
+    
+    printf("Input modes test passed!\n\n");
+}
+
+void test_lookahead() {
+    printf("Testing token lookahead...\n");
+    lexer_t* lexer = lexer_create("a = b + c;");
+    
+    // Peeking scans ahead once; consuming then replays the buffered tokens
+    assert(lexer_peek_token(lexer).type == TOKEN_IDENTIFIER);
+    assert(lexer_peek_token_at(lexer, 1).type == TOKEN_ASSIGN);
+    assert(lexer_peek_token_at(lexer, 3).type == TOKEN_PLUS);
+    assert(lexer_peek_token_at(lexer, LEXER_MAX_LOOKAHEAD).type == TOKEN_ERROR);
+    
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "a");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_ASSIGN, NULL);
+    assert(lexer_peek_token_at(lexer, 2).type == TOKEN_IDENTIFIER);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "b");
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_PLUS, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "c");
+    assert(lexer_peek_token_at(lexer, 1).type == TOKEN_EOF);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_SEMICOLON, NULL);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_EOF, NULL);
+    
+    // Reset drops anything still buffered
+    lexer_peek_token_at(lexer, 2);
+    lexer_reset(lexer);
+    assert_token(lexer, lexer_next_token(lexer), TOKEN_IDENTIFIER, "a");
+    lexer_destroy(lexer);
+    
+    printf("Token lookahead test passed!\n\n");
+}
+
+void test_bulk_scanning() {
+    printf("Testing bulk scanning...\n");
+    const char* source =
+        "                                \t\t\n"
+        "  a_rather_long_identifier_name_beyond_sixteen_bytes1234567890 = 12345678901234567;\n"
+        "/* spans\n   lines */  x // trailing\n"
+        "\n\n      y";
+    lexer_t* lexer = lexer_create(source);
+    
+    token_t ident = lexer_next_token(lexer);
+    assert(ident.type == TOKEN_IDENTIFIER);
+    assert(ident.length == 60);
+    assert(ident.line == 2 && ident.column == 3);
+    
+    token_t assign = lexer_next_token(lexer);
+    assert(assign.line == 2 && assign.column == 64);
+    
+    token_t number = lexer_next_token(lexer);
+    assert(number.type == TOKEN_NUMBER && number.length == 17);
+    lexer_next_token(lexer); // ;
+    
+    // Line numbers keep counting through comments
+    token_t x = lexer_next_token(lexer);
+    assert(lexer_token_equals(lexer, x, "x"));
+    assert(x.line == 4 && x.column == 14);
+    
+    token_t y = lexer_next_token(lexer);
+    assert(lexer_token_equals(lexer, y, "y"));
+    assert(y.line == 7 && y.column == 7);
+    assert(lexer_next_token(lexer).type == TOKEN_EOF);
+    lexer_destroy(lexer);
+    
+    printf("Bulk scanning test passed!\n\n");
+}
+
 int main() {
     printf("=== RUNNING LEXER TESTS ===\n\n");
     
     test_keywords();
+    test_keyword_lookup();
+    test_keyword_hash();
     test_operators();
     test_punctuation();
     test_identifiers();
@@ -193,6 +422,11 @@ int main() {
     test_strings();
     test_comments();
     test_complete_program();
+    test_token_spans();
+    test_interning();
+    test_input_modes();
+    test_lookahead();
+    test_bulk_scanning();
     
     printf("🎉 All lexer tests passed!\n");
     return 0;
@@ -0,0 +1,238 @@
+// tests/unit/test_object.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <elf.h>
+#include "../../src/codegen.h"
+#include "../../src/object.h"
+#include "../../src/utils.h"
+
+// Test helper functions
+// Encode lines as codegen would buffer them (a trailing ':' makes a label)
+int encode_lines(object_t* object, const char* const* lines, size_t count) {
+    asm_instr_t instrs[32];
+    assert(count <= 32);
+
+    for (size_t i = 0; i < count; i++) {
+        size_t length = strlen(lines[i]);
+        if (lines[i][length - 1] == ':') {
+            char label[64];
+            snprintf(label, sizeof(label), "%.*s", (int)(length - 1), lines[i]);
+            memset(&instrs[i], 0, sizeof(instrs[i]));
+            instrs[i].kind = ASM_LABEL;
+            instrs[i].text = intern_string(label);
+        } else {
+            assert(codegen_parse_instruction(lines[i], &instrs[i]));
+        }
+    }
+    return object_encode(object, instrs, count);
+}
+
+void check_encoding(const char* line, const unsigned char* expected, size_t size) {
+    object_t* object = object_create();
+    assert(object);
+    assert(encode_lines(object, &line, 1));
+
+    if (object->text.size != size || memcmp(object->text.data, expected, size) != 0) {
+        printf("Encoding of '%s':", line);
+        for (size_t i = 0; i < object->text.size; i++) printf(" %02x", object->text.data[i]);
+        printf("\n");
+        fflush(stdout);
+    }
+    assert(object->text.size == size && memcmp(object->text.data, expected, size) == 0);
+    object_destroy(object);
+}
+
+#define CHECK_ENCODING(line, ...) do { \
+        static const unsigned char bytes[] = {__VA_ARGS__}; \
+        check_encoding(line, bytes, sizeof(bytes)); \
+    } while (0)
+
+// Write object to memory; returns the file contents and its size
+unsigned char* write_object(object_t* object, size_t* size) {
+    FILE* output = tmpfile();
+    assert(output);
+    if (!object_write(object, output)) {
+        fclose(output);
+        return NULL;
+    }
+    *size = (size_t)ftell(output);
+    rewind(output);
+    unsigned char* data = malloc(*size);
+    assert(fread(data, 1, *size, output) == *size);
+    fclose(output);
+    return data;
+}
+
+void test_instruction_encoding() {
+    printf("Testing instruction encoding...\n");
+
+    CHECK_ENCODING("movq %rsp, %rbp", 0x48, 0x89, 0xE5);
+    CHECK_ENCODING("movq -8(%rbp), %rcx", 0x48, 0x8B, 0x4D, 0xF8);
+    CHECK_ENCODING("movq %r12, -512(%rbp)", 0x4C, 0x89, 0xA5, 0x00, 0xFE, 0xFF, 0xFF);
+    CHECK_ENCODING("movq 16(%rsp), %rax", 0x48, 0x8B, 0x44, 0x24, 0x10);
+    CHECK_ENCODING("movq $-1, %rax", 0x48, 0xC7, 0xC0, 0xFF, 0xFF, 0xFF, 0xFF);
+    CHECK_ENCODING("movq $4294967296, %r9", 0x49, 0xB9, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00);
+    CHECK_ENCODING("addq $1, %r12", 0x49, 0x83, 0xC4, 0x01);
+    CHECK_ENCODING("subq $1000, %rsp", 0x48, 0x81, 0xEC, 0xE8, 0x03, 0x00, 0x00);
+    CHECK_ENCODING("cmpq %rsi, %rdi", 0x48, 0x39, 0xF7);
+    CHECK_ENCODING("imulq $3, %rcx, %rdx", 0x48, 0x6B, 0xD1, 0x03);
+    CHECK_ENCODING("imulq %r8, %rbx", 0x49, 0x0F, 0xAF, 0xD8);
+    CHECK_ENCODING("idivq %rcx", 0x48, 0xF7, 0xF9);
+    CHECK_ENCODING("salq $3, %r13", 0x49, 0xC1, 0xE5, 0x03);
+    CHECK_ENCODING("setle %al", 0x0F, 0x9E, 0xC0);
+    CHECK_ENCODING("movzbl %al, %eax", 0x0F, 0xB6, 0xC0);
+    CHECK_ENCODING("movzbl %sil, %eax", 0x40, 0x0F, 0xB6, 0xC6);
+    CHECK_ENCODING("pushq %r12", 0x41, 0x54);
+    CHECK_ENCODING("popq %rbp", 0x5D);
+    CHECK_ENCODING("cqto", 0x48, 0x99);
+    CHECK_ENCODING("ret", 0xC3);
+
+    // Mnemonics the encoder does not know are reported, not guessed
+    object_t* object = object_create();
+    const char* line = "leave";
+    assert(!encode_lines(object, &line, 1));
+    assert(object->failed && object->failed_instr.opcode == ASM_OTHER);
+    object_destroy(object);
+
+    printf("✓ Instruction encoding test passed!\n\n");
+}
+
+void test_branch_resolution() {
+    printf("Testing branch and data references...\n");
+
+    object_t* object = object_create();
+    const char* lines[] = {
+        "main:",
+        "jmp .Lmain.1",
+        "leaq .LC0(%rip), %rdi",
+        ".Lmain.1:",
+        "call print",
+        "jne .Lmain.1",
+        "ret"
+    };
+    assert(encode_lines(object, lines, sizeof(lines) / sizeof(lines[0])));
+    object_add_string(object, ".LC0", "a\\n\\101\\x42\\\"");
+    object_set_global(object, "main");
+
+    size_t size;
+    unsigned char* file = write_object(object, &size);
+    assert(file);
+
+    // Escapes are decoded into .data
+    assert(object->data.size == 6 && memcmp(object->data.data, "a\nAB\"", 6) == 0);
+
+    // Local branches are resolved: jmp skips the leaq, jne returns to the call
+    const unsigned char* text = object->text.data;
+    assert(text[0] == 0xE9 && text[1] == 7 && text[2] == 0 && text[3] == 0 && text[4] == 0);
+    assert(text[12] == 0xE8);
+    int32_t back;
+    memcpy(&back, text + 19, sizeof(back));
+    assert(text[17] == 0x0F && text[18] == 0x85 && back == -(int32_t)(23 - 12));
+
+    // Relocations remain for the string and the runtime call
+    const Elf64_Ehdr* header = (const Elf64_Ehdr*)file;
+    assert(memcmp(header->e_ident, ELFMAG, SELFMAG) == 0 && header->e_type == ET_REL);
+    const Elf64_Shdr* sections = (const Elf64_Shdr*)(file + header->e_shoff);
+    const Elf64_Shdr* rela = NULL;
+    const Elf64_Shdr* symtab = NULL;
+    for (int i = 0; i < header->e_shnum; i++) {
+        if (sections[i].sh_type == SHT_RELA) rela = &sections[i];
+        if (sections[i].sh_type == SHT_SYMTAB) symtab = &sections[i];
+    }
+    assert(rela && symtab && rela->sh_size == 2 * sizeof(Elf64_Rela));
+
+    const Elf64_Rela* relocations = (const Elf64_Rela*)(file + rela->sh_offset);
+    assert(relocations[0].r_offset == 8 && ELF64_R_TYPE(relocations[0].r_info) == R_X86_64_PC32);
+    assert(relocations[0].r_addend == -4);
+    assert(relocations[1].r_offset == 13 && ELF64_R_TYPE(relocations[1].r_info) == R_X86_64_PLT32);
+
+    // .L labels stay out of the symbol table; main is global, print undefined
+    const Elf64_Sym* symbols = (const Elf64_Sym*)(file + symtab->sh_offset);
+    const char* names = (const char*)(file + sections[symtab->sh_link].sh_offset);
+    size_t symbol_count = symtab->sh_size / sizeof(Elf64_Sym);
+    int found = 0;
+    for (size_t i = 1; i < symbol_count; i++) {
+        const char* name = names + symbols[i].st_name;
+        assert(strncmp(name, ".L", 2) != 0);
+        if (strcmp(name, "main") == 0) {
+            assert(ELF64_ST_BIND(symbols[i].st_info) == STB_GLOBAL && symbols[i].st_size == 24);
+            found++;
+        } else if (strcmp(name, "print") == 0) {
+            assert(symbols[i].st_shndx == SHN_UNDEF && i >= symtab->sh_info);
+            found++;
+        }
+    }
+    assert(found == 2);
+
+    free(file);
+    object_destroy(object);
+
+    // A jump to a label that is never defined cannot be written
+    object = object_create();
+    const char* dangling[] = {"f:", "jmp .Lf.9"};
+    assert(encode_lines(object, dangling, 2));
+    assert(!write_object(object, &size));
+    object_destroy(object);
+
+    printf("✓ Branch and data reference test passed!\n\n");
+}
+
+void test_local_labels() {
+    printf("Testing numbered local labels...\n");
+
+    // Same code as the textual .L labels above, built the way codegen does
+    codegen_t* codegen = codegen_create("/dev/null");
+    assert(codegen);
+    const char* main_name = intern_string("main");
+    codegen_emit_label(codegen, "main");
+    codegen_emit_instr(codegen, ASM_JMP, '\0', 1, codegen_label_operand(main_name, 1));
+    codegen_emit(codegen, "leaq .LC0(%%rip), %%rdi");
+    codegen_emit_local_label(codegen, main_name, 1);
+    codegen_emit_instr(codegen, ASM_CALL, '\0', 1, codegen_symbol_operand(intern_string("print")));
+    codegen_emit_instr(codegen, ASM_JCC, '\0', 1, codegen_label_operand(main_name, 1))->condition = OP_NE;
+    codegen_emit_instr(codegen, ASM_JMP, '\0', 1, codegen_label_operand(main_name, ASM_RETURN_LABEL));
+    codegen_emit_local_label(codegen, main_name, ASM_RETURN_LABEL);
+    codegen_emit_instr(codegen, ASM_RET, '\0', 0);
+
+    object_t* object = object_create();
+    assert(object_encode(object, codegen->instrs, codegen->instr_count));
+    const unsigned char* text = object->text.data;
+    assert(object->text.size == 29);
+    assert(text[0] == 0xE9 && text[1] == 7 && text[2] == 0 && text[3] == 0 && text[4] == 0);
+    int32_t back, forward;
+    memcpy(&back, text + 19, sizeof(back));
+    memcpy(&forward, text + 24, sizeof(forward));
+    assert(text[17] == 0x0F && text[18] == 0x85 && back == -(int32_t)(23 - 12));
+    assert(text[23] == 0xE9 && forward == 0 && text[28] == 0xC3);
+
+    // They are resolved without becoming symbols
+    for (size_t i = 0; i < object->symbol_count; i++) {
+        assert(strncmp(object->symbols[i].name, ".Lmain", 6) != 0);
+    }
+    object_destroy(object);
+
+    // A jump must find its label among the instructions encoded with it
+    codegen->instr_count = 0;
+    codegen_emit_label(codegen, "f");
+    codegen_emit_instr(codegen, ASM_JMP, '\0', 1, codegen_label_operand(intern_string("f"), 9));
+    object = object_create();
+    assert(!object_encode(object, codegen->instrs, codegen->instr_count));
+    assert(object->failed && object->failed_instr.opcode == ASM_JMP);
+    object_destroy(object);
+    codegen_destroy(codegen);
+
+    printf("✓ Local label test passed!\n\n");
+}
+
+int main() {
+    printf("=== RUNNING OBJECT WRITER TESTS ===\n\n");
+
+    test_instruction_encoding();
+    test_branch_resolution();
+    test_local_labels();
+
+    printf("🎉 All object writer tests passed!\n");
+    return 0;
+}
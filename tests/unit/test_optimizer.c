@@ -0,0 +1,526 @@
+// tests/unit/test_optimizer.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include "../../src/lexer.h"
+#include "../../src/parser.h"
+#include "../../src/ast.h"
+#include "../../src/semantic.h"
+#include "../../src/ir.h"
+#include "../../src/optimizer.h"
+
+// Test helper functions
+ast_node_t* analyze_string(const char* source) {
+    lexer_t* lexer = lexer_create(source);
+    parser_t* parser = parser_create(lexer);
+    ast_node_t* ast = parser_parse_program(parser);
+    assert(ast && !parser_has_errors(parser));
+
+    semantic_analyzer_t* analyzer = semantic_create();
+    assert(semantic_analyze(analyzer, ast) && !semantic_has_errors(analyzer));
+
+    semantic_destroy(analyzer);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    return ast;
+}
+
+// Value expression of the nth statement of the first function with a body
+ast_node_t* statement_value(ast_node_t* ast, size_t index) {
+    for (size_t i = 0; i < ast->data.program.declaration_count; i++) {
+        ast_node_t* function = ast->data.program.declarations[i];
+        if (!function->data.function_decl.body) continue;
+
+        ast_node_t* statement = function->data.function_decl.body->data.compound_stmt.statements[index];
+        if (statement->type == AST_RETURN_STMT) return statement->data.return_stmt.value;
+        if (statement->type == AST_VARIABLE_DECL) return statement->data.variable_decl.initializer;
+        return statement->data.expression_stmt.expression;
+    }
+    assert(0);
+    return NULL;
+}
+
+// Lower source and run IR folding on its only function
+ir_program_t* fold_string(const char* source, optimizer_stats_t* stats) {
+    ast_node_t* ast = analyze_string(source);
+    ir_program_t* program = ir_lower_program(ast);
+    ast_destroy(ast);
+    assert(program && program->function_count == 1);
+
+    optimizer_fold_ir(program->functions[0], stats);
+    return program;
+}
+
+// The final explicit return of function
+ir_instr_t* last_return(ir_function_t* function) {
+    for (size_t i = function->instr_count - 1; i > 0; i--) {
+        ir_instr_t* instr = &function->instrs[i - 1];
+        if (instr->opcode == IR_RETURN) return instr;
+    }
+    assert(0);
+    return NULL;
+}
+
+void test_ast_folding() {
+    printf("Testing AST constant folding...\n");
+
+    const char* source =
+        "int f();\n"
+        "int main() {\n"
+        "    int a = (2 + 3) * 4 - !0;\n"
+        "    int b = -(7 / 2) + 10 % 4;\n"
+        "    int c = 1 / 0;\n"
+        "    int d = 0 && f();\n"
+        "    int e = 1 < 2 == 1;\n"
+        "    int g = 2147483647 + 1;\n"
+        "    return a + f();\n"
+        "}";
+
+    ast_node_t* ast = analyze_string(source);
+    size_t folds = optimizer_fold_ast(ast);
+    assert(folds > 0);
+
+    ast_node_t* a = statement_value(ast, 0);
+    assert(a->type == AST_NUMBER && a->data.number.value == 19);
+    assert(a->data_type == TYPE_INT);
+
+    ast_node_t* b = statement_value(ast, 1);
+    assert(b->type == AST_NUMBER && b->data.number.value == -1);
+
+    // Division by zero is left for run time
+    assert(statement_value(ast, 2)->type == AST_BINARY_OP);
+
+    // Short-circuit makes the call unreachable
+    ast_node_t* d = statement_value(ast, 3);
+    assert(d->type == AST_NUMBER && d->data.number.value == 0);
+
+    ast_node_t* e = statement_value(ast, 4);
+    assert(e->type == AST_NUMBER && e->data.number.value == 1);
+
+    // A result wider than an int literal is left to the IR folder
+    assert(statement_value(ast, 5)->type == AST_BINARY_OP);
+
+    assert(statement_value(ast, 6)->type == AST_BINARY_OP);
+
+    ast_destroy(ast);
+    printf("✓ AST constant folding test passed!\n\n");
+}
+
+void test_constant_evaluation() {
+    printf("Testing constant evaluation...\n");
+
+    long result;
+    assert(optimizer_eval_binary(OP_SUB, 3, 10, &result) && result == -7);
+    assert(optimizer_eval_binary(OP_DIV, -7, 2, &result) && result == -3);
+    assert(optimizer_eval_binary(OP_MOD, -7, 2, &result) && result == -1);
+    assert(!optimizer_eval_binary(OP_MOD, 1, 0, &result));
+    assert(!optimizer_eval_binary(OP_DIV, LONG_MIN, -1, &result));
+
+    // int arithmetic runs in 64-bit registers, so it only wraps at 64 bits
+    assert(optimizer_eval_binary(OP_ADD, 2147483647L, 1, &result) && result == 2147483648L);
+    assert(optimizer_eval_binary(OP_MUL, 65536, 65536, &result) && result == 4294967296L);
+    assert(optimizer_eval_binary(OP_DIV, -2147483647L - 1, -1, &result) && result == 2147483648L);
+    assert(optimizer_eval_binary(OP_ADD, LONG_MAX, 1, &result) && result == LONG_MIN);
+    assert(optimizer_eval_unary(OP_NEG, LONG_MIN, &result) && result == LONG_MIN);
+
+    assert(optimizer_eval_unary(OP_NOT, 5, &result) && result == 0);
+    assert(optimizer_eval_unary(OP_NEG, 5, &result) && result == -5);
+
+    printf("✓ Constant evaluation test passed!\n\n");
+}
+
+void test_ir_propagation() {
+    printf("Testing IR constant propagation...\n");
+
+    const char* source =
+        "int main() {\n"
+        "    int x = 6;\n"
+        "    int y = x * 7;\n"
+        "    int z = y;\n"
+        "    z = z - 2;\n"
+        "    return z;\n"
+        "}";
+
+    optimizer_stats_t stats = {0};
+    ir_program_t* program = fold_string(source, &stats);
+    ir_function_t* function = program->functions[0];
+
+    // Every value is known, so nothing is computed at run time
+    for (size_t i = 0; i < function->instr_count; i++) {
+        assert(function->instrs[i].opcode != IR_BINARY);
+    }
+
+    ir_instr_t* ret = last_return(function);
+    assert(ret->src1 == IR_IMM_OPERAND && ret->imm == 40);
+    assert(stats.ir_folds > 0);
+
+    ir_program_destroy(program);
+    printf("✓ IR constant propagation test passed!\n\n");
+}
+
+void test_ir_immediates() {
+    printf("Testing IR immediate operands...\n");
+
+    const char* source =
+        "int main(int a) {\n"
+        "    int limit = 10;\n"
+        "    int scaled = 3 * a;\n"
+        "    return limit > scaled / 2;\n"
+        "}";
+
+    optimizer_stats_t stats = {0};
+    ir_program_t* program = fold_string(source, &stats);
+    ir_function_t* function = program->functions[0];
+
+    int saw_mul = 0, saw_div = 0, saw_compare = 0;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->opcode != IR_BINARY) continue;
+
+        if (instr->oper == OP_MUL) {
+            // Commutative operands are swapped to put the constant on the right
+            assert(instr->src2 == IR_IMM_OPERAND && instr->imm == 3);
+            saw_mul = 1;
+        } else if (instr->oper == OP_DIV) {
+            // idiv needs the divisor in a register
+            assert(instr->src2 != IR_IMM_OPERAND);
+            saw_div = 1;
+        } else {
+            // 10 > x becomes x < 10
+            assert(instr->oper == OP_LT && instr->src2 == IR_IMM_OPERAND && instr->imm == 10);
+            saw_compare = 1;
+        }
+        assert(ir_instr_use_count(instr) == (instr->src2 == IR_IMM_OPERAND ? 1u : 2u));
+    }
+    assert(saw_mul && saw_div && saw_compare);
+    assert(stats.ir_immediates >= 2);
+
+    ir_program_destroy(program);
+    printf("✓ IR immediate operands test passed!\n\n");
+}
+
+void test_ir_loop_variables() {
+    printf("Testing IR propagation through loops...\n");
+
+    const char* source =
+        "int main() {\n"
+        "    int i = 0;\n"
+        "    while (i < 3) {\n"
+        "        i = i + 1;\n"
+        "    }\n"
+        "    return i;\n"
+        "}";
+
+    optimizer_stats_t stats = {0};
+    ir_program_t* program = fold_string(source, &stats);
+    ir_function_t* function = program->functions[0];
+
+    // i has two definitions, so its initial value must not reach the loop
+    int saw_compare = 0;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->opcode == IR_BINARY && instr->oper == OP_LT) {
+            assert(instr->src1 >= 0);
+            saw_compare = 1;
+        }
+    }
+    assert(saw_compare);
+    assert(last_return(function)->src1 >= 0);
+
+    ir_program_destroy(program);
+    printf("✓ IR propagation through loops test passed!\n\n");
+}
+
+void test_ast_pruning() {
+    printf("Testing AST dead statement removal...\n");
+
+    const char* source =
+        "int f();\n"
+        "int main() {\n"
+        "    if (0) f();\n"
+        "    if (1) f(); else return 2;\n"
+        "    while (0) f();\n"
+        "    for (; 1 - 1;) f();\n"
+        "    return f();\n"
+        "    f();\n"
+        "}";
+
+    ast_node_t* ast = analyze_string(source);
+    optimizer_fold_ast(ast);
+    assert(optimizer_prune_ast(ast) == 5);
+
+    // Only the taken branch and the return remain
+    ast_node_t* body = ast->data.program.declarations[1]->data.function_decl.body;
+    assert(body->data.compound_stmt.statement_count == 2);
+    assert(body->data.compound_stmt.statements[0]->type == AST_EXPRESSION_STMT);
+    assert(body->data.compound_stmt.statements[1]->type == AST_RETURN_STMT);
+
+    ast_destroy(ast);
+    printf("✓ AST dead statement removal test passed!\n\n");
+}
+
+void test_ir_dead_code() {
+    printf("Testing IR dead code elimination...\n");
+
+    const char* source =
+        "int f(int x);\n"
+        "int main() {\n"
+        "    int unused = 5 * 5;\n"
+        "    int debug = 0;\n"
+        "    int kept = f(1);\n"
+        "    f(2);\n"
+        "    if (debug) {\n"
+        "        kept = f(3);\n"
+        "    }\n"
+        "    return kept;\n"
+        "    kept = 4;\n"
+        "}";
+
+    optimizer_stats_t stats = {0};
+    ir_program_t* program = fold_string(source, &stats);
+    ir_function_t* function = program->functions[0];
+    assert(optimizer_eliminate_dead_code(function, &stats) > 0);
+
+    // Both calls that can run survive, even the one whose value is unused
+    size_t calls = 0;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        assert(instr->opcode != IR_LABEL && instr->opcode != IR_JUMP_ZERO);
+        assert(instr->opcode != IR_CONST || instr->dst != IR_NO_VREG);
+        if (instr->opcode == IR_CALL) calls++;
+    }
+    assert(calls == 2);
+
+    // The unused local is gone, so only f(1)'s result reaches the allocator
+    ir_interval_t* intervals = malloc(function->vreg_count * sizeof(ir_interval_t));
+    ir_compute_intervals(function, intervals);
+    int live_variables = 0;
+    for (int v = 0; v < function->vreg_count; v++) {
+        if ((function->vreg_flags[v] & IR_VREG_VARIABLE) && intervals[v].start >= 0) live_variables++;
+    }
+    assert(live_variables == 1);
+
+    // The explicit return now ends the function
+    assert(function->instrs[function->instr_count - 1].opcode == IR_RETURN);
+
+    free(intervals);
+    ir_program_destroy(program);
+    printf("✓ IR dead code elimination test passed!\n\n");
+}
+
+// Lower source and run the -O1 IR pipeline with the given inline threshold
+ir_program_t* optimize_string(const char* source, int inline_threshold, optimizer_stats_t* stats) {
+    ast_node_t* ast = analyze_string(source);
+    ir_program_t* program = ir_lower_program(ast);
+    ast_destroy(ast);
+    assert(program);
+
+    optimizer_options_t options;
+    optimizer_options_init(&options);
+    options.level = 1;
+    options.inline_threshold = inline_threshold;
+    optimizer_optimize_ir(program, &options, stats);
+    return program;
+}
+
+// Function of program called name
+ir_function_t* function_named(ir_program_t* program, const char* name) {
+    for (size_t i = 0; i < program->function_count; i++) {
+        if (strcmp(program->functions[i]->name, name) == 0) return program->functions[i];
+    }
+    assert(0);
+    return NULL;
+}
+
+// Number of calls to callee in function
+size_t count_calls(ir_function_t* function, const char* callee) {
+    size_t calls = 0;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->opcode == IR_CALL && strcmp(instr->name, callee) == 0) calls++;
+    }
+    return calls;
+}
+
+void test_inlining() {
+    printf("Testing function inlining...\n");
+
+    const char* source =
+        "int square(int x) { return x * x; }\n"
+        "int sum_squares(int a, int b) { return square(a) + square(b); }\n"
+        "int fact(int n) { if (n <= 1) return 1; return n * fact(n - 1); }\n"
+        "int main() {\n"
+        "    int r = fact(3);\n"
+        "    return sum_squares(3, 4) + r;\n"
+        "}";
+
+    optimizer_stats_t stats = {0};
+    ir_program_t* program = optimize_string(source, OPTIMIZER_DEFAULT_INLINE_THRESHOLD, &stats);
+    ir_function_t* main_function = function_named(program, "main");
+
+    // sum_squares becomes a leaf once square is inlined, then folds away in main
+    assert(count_calls(function_named(program, "sum_squares"), "square") == 0);
+    assert(count_calls(main_function, "sum_squares") == 0);
+    assert(stats.inlined_calls == 3);
+
+    // Recursive functions are never inlined
+    assert(count_calls(main_function, "fact") == 1);
+    assert(count_calls(function_named(program, "fact"), "fact") == 1);
+
+    int saw_add = 0;
+    for (size_t i = 0; i < main_function->instr_count; i++) {
+        ir_instr_t* instr = &main_function->instrs[i];
+        if (instr->opcode == IR_BINARY && instr->oper == OP_ADD) {
+            assert(instr->src2 == IR_IMM_OPERAND && instr->imm == 25);
+            saw_add = 1;
+        }
+    }
+    assert(saw_add);
+    ir_program_destroy(program);
+
+    // A zero threshold disables inlining, a small one keeps larger callees
+    memset(&stats, 0, sizeof(stats));
+    program = optimize_string(source, 0, &stats);
+    assert(stats.inlined_calls == 0);
+    assert(count_calls(function_named(program, "main"), "sum_squares") == 1);
+    ir_program_destroy(program);
+
+    program = optimize_string(source, 2, &stats);
+    assert(optimizer_inline_cost(function_named(program, "square")) == 2);
+    assert(count_calls(function_named(program, "sum_squares"), "square") == 0);
+    assert(count_calls(function_named(program, "main"), "sum_squares") == 1);
+    ir_program_destroy(program);
+
+    printf("✓ Function inlining test passed!\n\n");
+}
+
+void test_loop_optimization() {
+    printf("Testing loop optimizations...\n");
+
+    const char* source =
+        "int main(int n, int k) {\n"
+        "    int s = 0;\n"
+        "    for (int i = 0; i < n; i = i + 1) {\n"
+        "        s = s + i * 12 + k * 3;\n"
+        "        s = s / 2;\n"
+        "    }\n"
+        "    return s;\n"
+        "}";
+
+    optimizer_stats_t stats = {0};
+    ir_program_t* program = optimize_string(source, 0, &stats);
+    ir_function_t* function = program->functions[0];
+    assert(stats.loop_hoisted == 1 && stats.loop_reduced == 1 && stats.loops_rotated == 1);
+
+    // The guard in front of the body keeps k * 3, the body adds 12 to the
+    // running product and ends in the copied test
+    size_t body = 0;
+    while (body < function->instr_count && function->instrs[body].opcode != IR_LABEL) body++;
+    assert(body < function->instr_count);
+
+    int saw_invariant = 0, saw_step = 0, saw_division = 0;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->opcode == IR_BINARY && instr->oper == OP_MUL) {
+            assert(i < body);
+            saw_invariant |= instr->imm == 3;
+        }
+        if (instr->opcode == IR_BINARY && instr->oper == OP_ADD && instr->imm == 12) {
+            assert(i > body && instr->dst == instr->src1);
+            saw_step = 1;
+        }
+        if (instr->opcode == IR_BINARY && instr->oper == OP_DIV) {
+            assert(i > body);  // Never hoisted
+            saw_division = 1;
+        }
+        if (i > body && (instr->opcode == IR_JUMP_ZERO || instr->opcode == IR_JUMP_NONZERO)) {
+            assert(instr->opcode == IR_JUMP_NONZERO && instr->imm == function->instrs[body].imm);
+        }
+        assert(instr->opcode != IR_JUMP);
+    }
+    assert(saw_invariant && saw_step && saw_division);
+
+    ir_program_destroy(program);
+    printf("✓ Loop optimizations test passed!\n\n");
+}
+
+void test_induction_update_first() {
+    printf("Testing strength reduction after the induction update...\n");
+
+    // The update comes before both the branch and the multiply it feeds
+    const char* source =
+        "int main(int w, int q) {\n"
+        "    int m = 0;\n"
+        "    while (w > 0) {\n"
+        "        w = w - 1;\n"
+        "        if (q) { q = q + 1; }\n"
+        "        m = m + w * 6;\n"
+        "    }\n"
+        "    return m + q;\n"
+        "}";
+
+    optimizer_stats_t stats = {0};
+    ir_program_t* program = optimize_string(source, 0, &stats);
+    ir_function_t* function = program->functions[0];
+    assert(stats.loop_reduced == 1);
+
+    size_t body = 0;
+    while (body < function->instr_count && function->instrs[body].opcode != IR_LABEL) body++;
+    assert(body < function->instr_count);
+
+    // Only the initial product is multiplied, in front of the loop, and the
+    // body steps it by -6 before anything reads it
+    size_t multiplies = 0, update = 0;
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->opcode == IR_BINARY && instr->oper == OP_MUL) {
+            assert(i < body && instr->imm == 6);
+            multiplies++;
+        }
+        if (instr->opcode == IR_BINARY && instr->oper == OP_ADD && instr->imm == -6) {
+            assert(i > body && instr->dst == instr->src1 && update == 0);
+            update = i;
+        }
+    }
+    assert(multiplies == 1 && update > 0);
+
+    int product = function->instrs[update].dst;
+    for (size_t i = body; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (i != update && (instr->src1 == product || instr->src2 == product)) assert(i > update);
+    }
+
+    // Every branch still has its label
+    for (size_t i = 0; i < function->instr_count; i++) {
+        ir_instr_t* instr = &function->instrs[i];
+        if (instr->opcode != IR_JUMP && instr->opcode != IR_JUMP_ZERO && instr->opcode != IR_JUMP_NONZERO) continue;
+        int found = 0;
+        for (size_t j = 0; j < function->instr_count && !found; j++) {
+            found = function->instrs[j].opcode == IR_LABEL && function->instrs[j].imm == instr->imm;
+        }
+        assert(found);
+    }
+
+    ir_program_destroy(program);
+    printf("✓ Induction update ordering test passed!\n\n");
+}
+
+int main() {
+    printf("=== RUNNING OPTIMIZER UNIT TESTS ===\n\n");
+
+    test_constant_evaluation();
+    test_ast_folding();
+    test_ir_propagation();
+    test_ir_immediates();
+    test_ir_loop_variables();
+    test_ast_pruning();
+    test_ir_dead_code();
+    test_inlining();
+    test_loop_optimization();
+    test_induction_update_first();
+
+    printf("🎉 All optimizer tests passed!\n");
+    return 0;
+}
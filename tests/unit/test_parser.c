@@ -103,7 +103,7 @@ void test_function_with_parameters() {
     ast_node_t* ret_stmt = body->data.compound_stmt.statements[0];
     ast_node_t* expr = ret_stmt->data.return_stmt.value;
     assert(expr->type == AST_BINARY_OP);
-    assert(strcmp(expr->data.binary_op.oper, "+") == 0);
+    assert(expr->data.binary_op.oper == OP_ADD);
     
     ast_destroy(ast);
     printf("✓ Function with parameters test passed!\n\n");
@@ -165,7 +165,7 @@ void test_expressions() {
     
     // Should be: 1 + (2 * 3) due to precedence
     assert(expr->type == AST_BINARY_OP);
-    assert(strcmp(expr->data.binary_op.oper, "+") == 0);
+    assert(expr->data.binary_op.oper == OP_ADD);
     
     ast_node_t* left = expr->data.binary_op.left;
     assert(left->type == AST_NUMBER);
@@ -173,7 +173,7 @@ void test_expressions() {
     
     ast_node_t* right = expr->data.binary_op.right;
     assert(right->type == AST_BINARY_OP);
-    assert(strcmp(right->data.binary_op.oper, "*") == 0);
+    assert(right->data.binary_op.oper == OP_MUL);
     assert(right->data.binary_op.left->data.number.value == 2);
     assert(right->data.binary_op.right->data.number.value == 3);
     
@@ -250,7 +250,7 @@ void test_if_statement() {
     // Check condition (x > 0)
     ast_node_t* condition = if_stmt->data.if_stmt.condition;
     assert(condition->type == AST_BINARY_OP);
-    assert(strcmp(condition->data.binary_op.oper, ">") == 0);
+    assert(condition->data.binary_op.oper == OP_GT);
     
     ast_destroy(ast);
     printf("✓ If statement test passed!\n\n");
@@ -281,12 +281,139 @@ void test_while_statement() {
     // Check condition (x < 10)
     ast_node_t* condition = while_stmt->data.while_stmt.condition;
     assert(condition->type == AST_BINARY_OP);
-    assert(strcmp(condition->data.binary_op.oper, "<") == 0);
+    assert(condition->data.binary_op.oper == OP_LT);
     
     ast_destroy(ast);
     printf("✓ While statement test passed!\n\n");
 }
 
+void test_arena_allocation() {
+    printf("Testing arena-allocated AST...\n");
+    
+    const char* source = 
+        "int main() {\n"
+        "    int x = 1;\n"
+        "    x = x + 2;\n"
+        "    x = x + 3;\n"
+        "    x = x + 4;\n"
+        "    x = x + 5;\n"
+        "    return foo(x, 1, 2, 3, 4, 5);\n"
+        "}";
+    
+    arena_t* arena = arena_create(0);
+    assert(arena != NULL);
+    
+    lexer_t* lexer = lexer_create(source);
+    parser_t* parser = parser_create(lexer);
+    parser_set_arena(parser, arena);
+    ast_node_t* ast = parser_parse_program(parser);
+    
+    assert(!parser_has_errors(parser));
+    assert(ast != NULL);
+    assert(ast->flags & AST_FLAG_ARENA);
+    
+    ast_node_t* func = ast->data.program.declarations[0];
+    assert(strcmp(func->data.function_decl.name, "main") == 0);
+    
+    ast_node_t* body = func->data.function_decl.body;
+    assert(body->data.compound_stmt.statement_count == 6);
+    assert(body->data.compound_stmt.statements[0]->type == AST_VARIABLE_DECL);
+    
+    ast_node_t* call = body->data.compound_stmt.statements[5]->data.return_stmt.value;
+    assert(call->type == AST_FUNCTION_CALL);
+    assert(call->data.function_call.argument_count == 6);
+    assert(call->data.function_call.arguments[5]->data.number.value == 5);
+    assert(ast_count_nodes(ast) == 37);
+    assert(ast_count_nodes(call) == 7);
+    
+    // ast_destroy is a no-op on arena trees; the arena frees everything at once
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    arena_destroy(arena);
+    
+    printf("✓ Arena allocation test passed!\n\n");
+}
+
+void test_source_positions() {
+    printf("Testing source positions and node sizes...\n");
+    
+    const char* source = 
+        "int main(int n) {\n"
+        "    if (n < 2)\n"
+        "        return f(-n, \"s\");\n"
+        "    int x = n * 3;\n"
+        "}";
+    
+    ast_node_t* ast = parse_string(source);
+    assert(ast != NULL);
+    
+    ast_node_t* func = ast->data.program.declarations[0];
+    assert(func->line == 1 && func->column == 5);
+    assert(func->data.function_decl.parameters[0]->column == 14);
+    
+    ast_node_t* body = func->data.function_decl.body;
+    assert(body->line == 1 && body->column == 17);
+    
+    // Statements start at their keyword, operators at the operator token
+    ast_node_t* if_stmt = body->data.compound_stmt.statements[0];
+    assert(if_stmt->line == 2 && if_stmt->column == 5);
+    ast_node_t* condition = if_stmt->data.if_stmt.condition;
+    assert(condition->line == 2 && condition->column == 11);
+    assert(condition->data.binary_op.left->column == 9);
+    
+    ast_node_t* ret = if_stmt->data.if_stmt.then_stmt;
+    assert(ret->line == 3 && ret->column == 9);
+    ast_node_t* call = ret->data.return_stmt.value;
+    assert(call->line == 3 && call->column == 16);
+    assert(call->data.function_call.arguments[0]->column == 18);
+    assert(call->data.function_call.arguments[1]->column == 22);
+    
+    ast_node_t* decl = body->data.compound_stmt.statements[1];
+    assert(decl->line == 4 && decl->column == 9);
+    assert(decl->data.variable_decl.initializer->column == 15);
+    
+    // Nodes are only as large as their own data; a number fits in any
+    // expression node it may be folded from
+    assert(ast_node_size(AST_NUMBER) < sizeof(ast_node_t));
+    assert(ast_node_size(AST_IDENTIFIER) < sizeof(ast_node_t));
+    assert(ast_node_size(AST_NUMBER) <= ast_node_size(AST_BINARY_OP));
+    assert(ast_node_size(AST_NUMBER) <= ast_node_size(AST_UNARY_OP));
+    assert(ast_node_size(AST_FUNCTION_DECL) <= sizeof(ast_node_t));
+    
+    ast_destroy(ast);
+    printf("✓ Source position test passed!\n\n");
+}
+
+void test_number_range() {
+    printf("Testing number literal range...\n");
+    
+    ast_node_t* ast = parse_string("int main() { return 2147483647; }");
+    assert(ast != NULL);
+    ast_node_t* ret = ast->data.program.declarations[0]->data.function_decl.body->data.compound_stmt.statements[0];
+    assert(ret->data.return_stmt.value->data.number.value == 2147483647);
+    ast_destroy(ast);
+    
+    // One past INT_MAX, and a literal long enough to overflow the accumulator
+    const char* sources[] = {
+        "int main() { return 2147483648; }",
+        "int main() { return 99999999999999999999999; }",
+    };
+    for (size_t i = 0; i < sizeof(sources) / sizeof(sources[0]); i++) {
+        lexer_t* lexer = lexer_create(sources[i]);
+        parser_t* parser = parser_create(lexer);
+        ast = parser_parse_program(parser);
+        assert(parser_has_errors(parser));
+        assert(strcmp(parser->errors[0].message, "Number literal out of range") == 0);
+        assert(parser->errors[0].column == 21);
+        if (ast) ast_destroy(ast);
+        parser_destroy(parser);
+        lexer_destroy(lexer);
+    }
+    
+    printf("✓ Number literal range test passed!\n\n");
+}
+
 void test_error_handling() {
     printf("Testing error handling...\n");
     
@@ -319,6 +446,9 @@ int main() {
     test_function_call();
     test_if_statement();
     test_while_statement();
+    test_arena_allocation();
+    test_source_positions();
+    test_number_range();
     test_error_handling();
     
     printf("🎉 All parser tests passed!\n");
@@ -0,0 +1,349 @@
+// tests/unit/test_peephole.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/codegen.h"
+#include "../../src/peephole.h"
+
+// Test helper functions
+// Run the peephole pass over the instructions buffered in codegen (then
+// destroyed) and return the assembly it writes
+char* peephole_codegen_string(codegen_t* codegen) {
+    peephole_optimize(codegen);
+
+    FILE* output = tmpfile();
+    assert(output);
+    for (size_t i = 0; i < codegen->instr_count; i++) {
+        codegen_print_instruction(output, &codegen->instrs[i]);
+    }
+    long size = ftell(output);
+    rewind(output);
+    char* text = malloc(size + 1);
+    size_t read = fread(text, 1, size, output);
+    text[read] = '\0';
+    fclose(output);
+
+    codegen_destroy(codegen);
+    return text;
+}
+
+// Buffer lines as codegen would (a trailing ':' makes a label) and return
+// the assembly the peephole pass writes for them
+char* peephole_string(const char* const* lines, size_t count) {
+    codegen_t* codegen = codegen_create("/dev/null");
+    assert(codegen);
+
+    for (size_t i = 0; i < count; i++) {
+        size_t length = strlen(lines[i]);
+        if (lines[i][length - 1] == ':') {
+            char label[64];
+            snprintf(label, sizeof(label), "%.*s", (int)(length - 1), lines[i]);
+            codegen_emit_label(codegen, label);
+        } else {
+            codegen_emit(codegen, "%s", lines[i]);
+        }
+    }
+    return peephole_codegen_string(codegen);
+}
+
+#define COUNT_OF(array) (sizeof(array) / sizeof((array)[0]))
+
+void check_peephole(const char* const* lines, size_t count, const char* expected) {
+    char* text = peephole_string(lines, count);
+    if (strcmp(text, expected) != 0) {
+        printf("Expected:\n%sGot:\n%s", expected, text);
+        fflush(stdout);
+    }
+    assert(strcmp(text, expected) == 0);
+    free(text);
+}
+
+void test_instruction_parsing() {
+    printf("Testing instruction parsing...\n");
+
+    asm_instr_t instr;
+    assert(codegen_parse_instruction("movq -16(%rbp), %rcx", &instr));
+    assert(instr.opcode == ASM_MOV && instr.suffix == 'q' && instr.operand_count == 2);
+    assert(instr.operands[0].kind == ASM_OPERAND_MEMORY);
+    assert(instr.operands[0].reg == REG_RBP && instr.operands[0].value == -16);
+    assert(instr.operands[1].kind == ASM_OPERAND_REGISTER && instr.operands[1].reg == REG_RCX);
+
+    assert(codegen_parse_instruction("setle %al", &instr));
+    assert(instr.opcode == ASM_SET && instr.condition == OP_LE);
+    assert(instr.operands[0].reg == REG_RAX && instr.operands[0].size == 1);
+
+    assert(codegen_parse_instruction("movzbl %al, %eax", &instr));
+    assert(instr.opcode == ASM_MOVZB && instr.suffix == 'l' && instr.operands[1].size == 4);
+
+    assert(codegen_parse_instruction("imulq $8, %rsi, %rdi", &instr));
+    assert(instr.opcode == ASM_IMUL && instr.operand_count == 3);
+    assert(instr.operands[0].kind == ASM_OPERAND_IMMEDIATE && instr.operands[0].value == 8);
+
+    assert(codegen_parse_instruction("leaq .LC0(%rip), %rax", &instr));
+    assert(instr.opcode == ASM_LEA && instr.operands[0].kind == ASM_OPERAND_SYMBOL);
+    assert(strcmp(instr.operands[0].text, ".LC0(%rip)") == 0);
+
+    assert(codegen_parse_instruction("jne .Lmain.3", &instr));
+    assert(instr.opcode == ASM_JCC && instr.condition == OP_NE);
+
+    // Printing reproduces the text
+    const char* lines[] = {"movq -16(%rbp), %rcx", "leaq .LC0(%rip), %rax", "cqto", "call print_int"};
+    check_peephole(lines, 0, "");
+    for (size_t i = 0; i < COUNT_OF(lines); i++) {
+        assert(codegen_parse_instruction(lines[i], &instr));
+        FILE* output = tmpfile();
+        codegen_print_instruction(output, &instr);
+        rewind(output);
+        char text[64] = {0};
+        assert(fgets(text, sizeof(text), output));
+        fclose(output);
+        assert(strncmp(text, "    ", 4) == 0 && strncmp(text + 4, lines[i], strlen(lines[i])) == 0);
+    }
+
+    printf("✓ Instruction parsing test passed!\n\n");
+}
+
+void test_move_cleanup() {
+    printf("Testing move cleanup...\n");
+
+    // Self moves go, the spill round trip is forwarded and then dead, and
+    // copies through dead temporaries collapse
+    const char* lines[] = {
+        "f:",
+        "movq %rdi, %rdi",
+        "movq %rdi, %rsi",
+        "movq %rsi, %rax",
+        "movq %rax, -8(%rbp)",
+        "movq -8(%rbp), %rcx",
+        "addq %rcx, %rax",
+        "ret"
+    };
+    check_peephole(lines, COUNT_OF(lines),
+        "f:\n"
+        "    movq %rdi, %rax\n"
+        "    addq %rax, %rax\n"
+        "    ret\n");
+
+    // Load, operate and store back through a temporary
+    const char* update[] = {
+        "f:",
+        "movq %rbx, %rsi",
+        "addq $1, %rsi",
+        "movq %rsi, %rbx",
+        "movq %rbx, %rax",
+        "ret"
+    };
+    check_peephole(update, COUNT_OF(update),
+        "f:\n"
+        "    addq $1, %rbx\n"
+        "    movq %rbx, %rax\n"
+        "    ret\n");
+
+    // A value stored to a slot that is read later stays
+    const char* kept[] = {
+        "f:",
+        "movq %rdi, -8(%rbp)",
+        "call g",
+        "movq -8(%rbp), %rax",
+        "ret"
+    };
+    check_peephole(kept, COUNT_OF(kept),
+        "f:\n"
+        "    movq %rdi, -8(%rbp)\n"
+        "    call g\n"
+        "    movq -8(%rbp), %rax\n"
+        "    ret\n");
+
+    printf("✓ Move cleanup test passed!\n\n");
+}
+
+void test_branch_fusion() {
+    printf("Testing compare and branch fusion...\n");
+
+    const char* lines[] = {
+        "f:",
+        "cmpq $10, %rcx",
+        "setl %al",
+        "movzbl %al, %eax",
+        "movq %rax, %rsi",
+        "testq %rsi, %rsi",
+        "je .Lf.1",
+        "movq $1, %rax",
+        "ret",
+        ".Lf.1:",
+        "movq $2, %rax",
+        "ret"
+    };
+    check_peephole(lines, COUNT_OF(lines),
+        "f:\n"
+        "    cmpq $10, %rcx\n"
+        "    jge .Lf.1\n"
+        "    movq $1, %rax\n"
+        "    ret\n"
+        ".Lf.1:\n"
+        "    movq $2, %rax\n"
+        "    ret\n");
+
+    // Spilled flag values and jne keep the condition
+    const char* spilled[] = {
+        "f:",
+        "cmpq %rsi, %rdi",
+        "setle %al",
+        "movzbl %al, %eax",
+        "movq %rax, -8(%rbp)",
+        "cmpq $0, -8(%rbp)",
+        "jne .Lf.1",
+        "movq $1, %rax",
+        "ret",
+        ".Lf.1:",
+        "movq $2, %rax",
+        "ret"
+    };
+    check_peephole(spilled, COUNT_OF(spilled),
+        "f:\n"
+        "    cmpq %rsi, %rdi\n"
+        "    jle .Lf.1\n"
+        "    movq $1, %rax\n"
+        "    ret\n"
+        ".Lf.1:\n"
+        "    movq $2, %rax\n"
+        "    ret\n");
+
+    // The flag value is still materialized when it is used afterwards
+    const char* used[] = {
+        "f:",
+        "cmpq %rsi, %rdi",
+        "sete %al",
+        "movzbl %al, %eax",
+        "testq %rax, %rax",
+        "je .Lf.1",
+        "movq $5, %rax",
+        ".Lf.1:",
+        "ret"
+    };
+    check_peephole(used, COUNT_OF(used),
+        "f:\n"
+        "    cmpq %rsi, %rdi\n"
+        "    sete %al\n"
+        "    movzbl %al, %eax\n"
+        "    jne .Lf.1\n"
+        "    movq $5, %rax\n"
+        ".Lf.1:\n"
+        "    ret\n");
+
+    printf("✓ Compare and branch fusion test passed!\n\n");
+}
+
+void test_strength_reduction() {
+    printf("Testing multiplication strength reduction...\n");
+
+    const char* lines[] = {
+        "f:",
+        "imulq $8, %rcx",
+        "imulq $4, -8(%rbp), %rsi",
+        "imulq $6, %rdi",
+        "addq %rcx, %rsi",
+        "addq %rdi, %rsi",
+        "movq %rsi, %rax",
+        "ret"
+    };
+    check_peephole(lines, COUNT_OF(lines),
+        "f:\n"
+        "    salq $3, %rcx\n"
+        "    movq -8(%rbp), %rsi\n"
+        "    salq $2, %rsi\n"
+        "    imulq $6, %rdi\n"
+        "    addq %rcx, %rsi\n"
+        "    addq %rdi, %rsi\n"
+        "    movq %rsi, %rax\n"
+        "    ret\n");
+
+    printf("✓ Multiplication strength reduction test passed!\n\n");
+}
+
+void test_jump_cleanup() {
+    printf("Testing jump cleanup...\n");
+
+    const char* lines[] = {
+        "f:",
+        "cmpq %rsi, %rdi",
+        "jl .Lf.1",
+        "jmp .Lf.2",
+        ".Lf.1:",
+        "movq $1, %rax",
+        "jmp .Lf.3",
+        ".Lf.2:",
+        "movq $2, %rax",
+        "jmp .Lf.3",
+        ".Lf.3:",
+        "ret"
+    };
+    check_peephole(lines, COUNT_OF(lines),
+        "f:\n"
+        "    cmpq %rsi, %rdi\n"
+        "    jge .Lf.2\n"
+        ".Lf.1:\n"
+        "    movq $1, %rax\n"
+        "    jmp .Lf.3\n"
+        ".Lf.2:\n"
+        "    movq $2, %rax\n"
+        ".Lf.3:\n"
+        "    ret\n");
+
+    // Jumps to numbered labels, as codegen emits them: %rcx is dead at the
+    // target of the jne, so the first assignment goes, as does the jmp to
+    // the label right after it
+    codegen_t* codegen = codegen_create("/dev/null");
+    assert(codegen);
+    const char* f = intern_string("f");
+    asm_operand_t rcx = codegen_register_operand(REG_RCX, 8);
+    codegen_emit_label(codegen, "f");
+    codegen_emit_instr(codegen, ASM_CMP, 'q', 2, codegen_register_operand(REG_RSI, 8),
+                       codegen_register_operand(REG_RDI, 8));
+    codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_immediate_operand(5), rcx);
+    codegen_emit_instr(codegen, ASM_JCC, '\0', 1, codegen_label_operand(f, 1))->condition = OP_NE;
+    codegen_emit_instr(codegen, ASM_JMP, '\0', 1, codegen_label_operand(f, 2));
+    codegen_emit_local_label(codegen, f, 2);
+    codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_immediate_operand(6), rcx);
+    codegen_emit_instr(codegen, ASM_JMP, '\0', 1, codegen_label_operand(f, ASM_RETURN_LABEL));
+    codegen_emit_local_label(codegen, f, 1);
+    codegen_emit_instr(codegen, ASM_MOV, 'q', 2, codegen_immediate_operand(7), rcx);
+    codegen_emit_local_label(codegen, f, ASM_RETURN_LABEL);
+    codegen_emit_instr(codegen, ASM_MOV, 'q', 2, rcx, codegen_register_operand(REG_RAX, 8));
+    codegen_emit_instr(codegen, ASM_RET, '\0', 0);
+    char* text = peephole_codegen_string(codegen);
+    const char* expected =
+        "f:\n"
+        "    cmpq %rsi, %rdi\n"
+        "    jne .Lf.1\n"
+        ".Lf.2:\n"
+        "    movq $6, %rcx\n"
+        "    jmp .Lf.return\n"
+        ".Lf.1:\n"
+        "    movq $7, %rcx\n"
+        ".Lf.return:\n"
+        "    movq %rcx, %rax\n"
+        "    ret\n";
+    if (strcmp(text, expected) != 0) {
+        printf("Expected:\n%sGot:\n%s", expected, text);
+        fflush(stdout);
+    }
+    assert(strcmp(text, expected) == 0);
+    free(text);
+
+    printf("✓ Jump cleanup test passed!\n\n");
+}
+
+int main() {
+    printf("=== RUNNING PEEPHOLE OPTIMIZER TESTS ===\n\n");
+
+    test_instruction_parsing();
+    test_move_cleanup();
+    test_branch_fusion();
+    test_strength_reduction();
+    test_jump_cleanup();
+
+    printf("🎉 All peephole optimizer tests passed!\n");
+    return 0;
+}
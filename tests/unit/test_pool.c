@@ -0,0 +1,101 @@
+// tests/unit/test_pool.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/pool.h"
+#include "../../src/utils.h"
+
+#define TASK_COUNT 1000
+
+// Test helper functions
+static pthread_mutex_t sum_lock = PTHREAD_MUTEX_INITIALIZER;
+static long sum;
+
+static void add_task(void* argument) {
+    long* value = argument;
+    pthread_mutex_lock(&sum_lock);
+    sum += *value;
+    pthread_mutex_unlock(&sum_lock);
+    *value = -1;
+}
+
+void test_run_all_tasks() {
+    printf("Testing that every task runs once...\n");
+
+    static long values[TASK_COUNT];
+    for (size_t threads = 1; threads <= 8; threads *= 2) {
+        pool_t* pool = pool_create(threads);
+        assert(pool && pool->thread_count == threads);
+
+        sum = 0;
+        for (long i = 0; i < TASK_COUNT; i++) {
+            values[i] = i;
+            assert(pool_submit(pool, add_task, &values[i]));
+        }
+        pool_wait(pool);
+        assert(sum == (long)TASK_COUNT * (TASK_COUNT - 1) / 2);
+        for (size_t i = 0; i < TASK_COUNT; i++) {
+            assert(values[i] == -1);
+        }
+
+        // The pool can be reused after waiting
+        values[0] = 5;
+        assert(pool_submit(pool, add_task, &values[0]));
+        pool_destroy(pool);
+        assert(values[0] == -1);
+    }
+
+    assert(pool_default_threads() >= 1);
+    pool_destroy(NULL);
+
+    printf("✓ Task execution test passed!\n\n");
+}
+
+// Each task interns the same names and records the pointers it got
+typedef struct {
+    const char* names[64];
+} intern_job_t;
+
+static void intern_task(void* argument) {
+    intern_job_t* job = argument;
+    for (size_t i = 0; i < 64; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "name_%zu", i);
+        job->names[i] = intern_string(name);
+    }
+}
+
+void test_concurrent_interning() {
+    printf("Testing concurrent string interning...\n");
+
+    intern_job_t jobs[32];
+    pool_t* pool = pool_create(4);
+    assert(pool);
+    for (size_t i = 0; i < 32; i++) {
+        assert(pool_submit(pool, intern_task, &jobs[i]));
+    }
+    pool_destroy(pool);
+
+    // Every thread saw one canonical copy of each name
+    for (size_t i = 0; i < 32; i++) {
+        for (size_t n = 0; n < 64; n++) {
+            assert(jobs[i].names[n] == jobs[0].names[n]);
+        }
+    }
+    assert(strcmp(jobs[0].names[7], "name_7") == 0);
+    assert(intern_count() == 64);
+    intern_reset();
+
+    printf("✓ Concurrent interning test passed!\n\n");
+}
+
+int main() {
+    printf("=== RUNNING THREAD POOL TESTS ===\n\n");
+
+    test_run_all_tasks();
+    test_concurrent_interning();
+
+    printf("🎉 All thread pool tests passed!\n");
+    return 0;
+}
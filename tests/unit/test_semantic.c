@@ -136,6 +136,64 @@ void test_scope_management() {
     printf("✓ Scope management semantic test passed!\n\n");
 }
 
+void test_shadowing() {
+    printf("Testing shadowing...\n");
+    
+    // Inner declarations shadow outer ones and disappear at scope exit
+    const char* source = 
+        "int main() {\n"
+        "    int x = 1;\n"
+        "    { char* x = \"inner\"; }\n"
+        "    { int x = 2; { int x = 3; } x = x + 1; }\n"
+        "    return x;\n"
+        "}";
+    assert(analyze_string(source) == 1);
+    
+    // A name declared in a closed block is not visible afterwards
+    const char* leaked = 
+        "int main() {\n"
+        "    { int y = 1; }\n"
+        "    return y;\n"
+        "}";
+    assert(analyze_string(leaked) == 0);
+    
+    // Redeclaring in the same scope is still an error
+    const char* duplicate = 
+        "int main() {\n"
+        "    int z = 1;\n"
+        "    int z = 2;\n"
+        "    return z;\n"
+        "}";
+    assert(analyze_string(duplicate) == 0);
+    
+    // Direct table use: shadow chain and undo on pop
+    symbol_table_t* table = symbol_table_create();
+    const char* name = intern_string("v");
+    symbol_table_push_scope(table);
+    symbol_t* outer = symbol_create("v", SYMBOL_VARIABLE, TYPE_INT);
+    outer->scope_level = 1;
+    assert(symbol_table_insert(table, outer));
+    
+    // Nesting far beyond the old fixed scope depth
+    for (int level = 2; level <= 200; level++) {
+        symbol_table_push_scope(table);
+        symbol_t* inner = symbol_create("v", SYMBOL_VARIABLE, TYPE_CHAR);
+        inner->scope_level = level;
+        assert(symbol_table_insert(table, inner));
+        assert(symbol_table_lookup(table, name) == inner);
+        assert(inner->shadowed != NULL);
+    }
+    for (int level = 200; level >= 2; level--) {
+        symbol_table_pop_scope(table);
+    }
+    assert(symbol_table_lookup(table, name) == outer);
+    symbol_table_pop_scope(table);
+    assert(symbol_table_lookup(table, name) == NULL);
+    symbol_table_destroy(table);
+    
+    printf("✓ Shadowing semantic test passed!\n\n");
+}
+
 void test_undeclared_variable_error() {
     printf("Testing undeclared variable error...\n");
     
@@ -219,6 +277,150 @@ void test_void_function_return() {
     printf("✓ Void function return test passed!\n\n");
 }
 
+void test_parallel_function_bodies() {
+    printf("Testing parallel analysis of function bodies...\n");
+    
+    // Errors in several bodies, including calls to later functions
+    const char* source = 
+        "int a(int x) { return later(x) + y; }\n"
+        "int b(int x) { return a(1, 2); }\n"
+        "int c(int x) { int x = 1; return x; }\n"
+        "int later(int n) { return n; }\n"
+        "int main() { return later(a(1)) + nope; }";
+    
+    semantic_analyzer_t* results[2];
+    ast_node_t* asts[2];
+    lexer_t* lexers[2];
+    parser_t* parsers[2];
+    pool_t* pool = pool_create(4);
+    assert(pool);
+    for (int run = 0; run < 2; run++) {
+        lexers[run] = lexer_create(source);
+        parsers[run] = parser_create(lexers[run]);
+        asts[run] = parser_parse_program(parsers[run]);
+        assert(asts[run] && !parser_has_errors(parsers[run]));
+        
+        results[run] = semantic_create();
+        results[run]->pool = run == 1 ? pool : NULL;
+        assert(!semantic_analyze(results[run], asts[run]));
+    }
+    pool_destroy(pool);
+    
+    // Same errors in the same order
+    assert(results[0]->error_count >= 4);
+    assert(results[1]->error_count == results[0]->error_count);
+    for (size_t i = 0; i < results[0]->error_count; i++) {
+        assert(strcmp(results[0]->errors[i].message, results[1]->errors[i].message) == 0);
+        assert(results[0]->errors[i].line == results[1]->errors[i].line);
+        assert(results[0]->errors[i].column == results[1]->errors[i].column);
+    }
+    
+    // Worker lookups are counted in the main table
+    assert(results[0]->symbols->probes > 0);
+    assert(results[1]->symbols->probes > 0);
+    
+    for (int run = 0; run < 2; run++) {
+        semantic_destroy(results[run]);
+        ast_destroy(asts[run]);
+        parser_destroy(parsers[run]);
+        lexer_destroy(lexers[run]);
+    }
+    
+    printf("✓ Parallel analysis test passed!\n\n");
+}
+
+void test_local_slots() {
+    printf("Testing local slots and error positions...\n");
+    
+    const char* source = 
+        "int g;\n"
+        "int f(int a, int b) {\n"
+        "    int x = a;\n"
+        "    {\n"
+        "        int x = b;\n"
+        "        a = x;\n"
+        "    }\n"
+        "    return x + g + c;\n"
+        "}";
+    
+    lexer_t* lexer = lexer_create(source);
+    parser_t* parser = parser_create(lexer);
+    ast_node_t* ast = parser_parse_program(parser);
+    assert(ast && !parser_has_errors(parser));
+    
+    semantic_analyzer_t* analyzer = semantic_create();
+    assert(!semantic_analyze(analyzer, ast));
+    
+    // Parameters and locals are numbered in declaration order; globals have no slot
+    ast_node_t* global = ast->data.program.declarations[0];
+    assert(global->data.variable_decl.slot == AST_NO_SLOT);
+    ast_node_t* func = ast->data.program.declarations[1];
+    assert(func->data.function_decl.local_count == 4);
+    assert(func->data.function_decl.parameters[0]->data.parameter.slot == 0);
+    assert(func->data.function_decl.parameters[1]->data.parameter.slot == 1);
+    
+    ast_node_t* body = func->data.function_decl.body;
+    ast_node_t* outer = body->data.compound_stmt.statements[0];
+    ast_node_t* block = body->data.compound_stmt.statements[1];
+    ast_node_t* inner = block->data.compound_stmt.statements[0];
+    assert(outer->data.variable_decl.slot == 2);
+    assert(inner->data.variable_decl.slot == 3);
+    assert(outer->data.variable_decl.initializer->data.identifier.slot == 0);
+    
+    // Identifiers carry the slot of the declaration they resolve to
+    ast_node_t* assign = block->data.compound_stmt.statements[1]->data.expression_stmt.expression;
+    assert(assign->data.binary_op.left->data.identifier.slot == 0);
+    assert(assign->data.binary_op.right->data.identifier.slot == 3);
+    
+    ast_node_t* sum = body->data.compound_stmt.statements[2]->data.return_stmt.value;
+    ast_node_t* x_plus_g = sum->data.binary_op.left;
+    assert(x_plus_g->data.binary_op.left->data.identifier.slot == 2);
+    assert(x_plus_g->data.binary_op.right->data.identifier.slot == AST_NO_SLOT);
+    
+    // Errors point at the offending node
+    assert(analyzer->error_count >= 1);
+    assert(strstr(analyzer->errors[0].message, "'c'"));
+    assert(analyzer->errors[0].line == 8 && analyzer->errors[0].column == 20);
+    
+    semantic_destroy(analyzer);
+    ast_destroy(ast);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    
+    printf("✓ Local slots test passed!\n\n");
+}
+
+void test_runtime_functions() {
+    printf("Testing runtime functions without declarations...\n");
+    
+    const char* source = 
+        "int main() {\n"
+        "    print(\"n\");\n"
+        "    print_int(read_int() + 1);\n"
+        "    print_char(10);\n"
+        "    flush();\n"
+        "    return 0;\n"
+        "}";
+    assert(analyze_string(source) == 1);
+    
+    // The program's own declarations take precedence
+    const char* prototype = 
+        "int print_int(int x);\n"
+        "int main() { return print_int(1); }";
+    assert(analyze_string(prototype) == 1);
+    
+    const char* own_flush = 
+        "int flush(int x) { return x; }\n"
+        "int main() { return flush(3); }";
+    assert(analyze_string(own_flush) == 1);
+    
+    // Still checked like any other call
+    assert(analyze_string("int main() { flush(1); return 0; }") == 0);
+    assert(analyze_string("int main() { return read_int() + print_int(1); }") == 0);
+    
+    printf("✓ Runtime functions test passed!\n\n");
+}
+
 int main() {
     printf("=== RUNNING SEMANTIC ANALYSIS TESTS ===\n\n");
     
@@ -230,6 +432,10 @@ int main() {
     test_type_checking();
     test_scope_management();
     test_void_function_return();
+    test_shadowing();
+    test_parallel_function_bodies();
+    test_runtime_functions();
+    test_local_slots();
     
     // Negative tests (should fail)
     test_undeclared_variable_error();
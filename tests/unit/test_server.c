@@ -0,0 +1,156 @@
+// tests/unit/test_server.c
+#define _POSIX_C_SOURCE 200809L   // kill(), nanosleep()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../../src/server.h"
+
+#define SOCKET_PATH "test_server.sock"
+#define CLIENT_DIR "test_server_dir"
+
+// Test helper functions
+void write_file(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+    assert(file);
+    fputs(text, file);
+    fclose(file);
+}
+
+int file_equals(const char* path, const char* text) {
+    char buffer[4096];
+    FILE* file = fopen(path, "r");
+    if (!file) return 0;
+    size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    buffer[length] = '\0';
+    return strcmp(buffer, text) == 0;
+}
+
+// Request handler: prints its directory, arguments and first input byte,
+// and returns the argument count
+static int echo_handler(int argc, char** argv, void* context) {
+    (void)context;
+    char* directory = getcwd(NULL, 0);
+    printf("%s:", directory);
+    free(directory);
+    for (int i = 0; i < argc; i++) {
+        printf(" %s", argv[i]);
+    }
+    printf("\n");
+    fprintf(stderr, "input %c\n", getchar());
+    return argc;
+}
+
+// Helper: Run one request from the current directory with the given input
+static int request(const char* socket_path, const char* input, int argc, char** argv, int* status) {
+    write_file("test_server_in.txt", input);
+    int streams[3] = {
+        open("test_server_in.txt", O_RDONLY),
+        open("test_server_out.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644),
+        open("test_server_err.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644)
+    };
+    assert(streams[0] >= 0 && streams[1] >= 0 && streams[2] >= 0);
+    int result = server_request(socket_path, argc, argv, streams, status);
+    for (int i = 0; i < 3; i++) {
+        close(streams[i]);
+    }
+    return result;
+}
+
+void test_requests() {
+    printf("Testing requests to a server process...\n");
+
+    // Nothing is sent without a server
+    int status = -1;
+    char* arguments[] = {"tcc", "-O1", "main.tc"};
+    assert(request(SOCKET_PATH, "x", 3, arguments, &status) == 0);
+    assert(status == -1);
+
+    fflush(stdout);
+    pid_t server = fork();
+    assert(server >= 0);
+    if (server == 0) {
+        _exit(server_run(SOCKET_PATH, echo_handler, NULL) ? 0 : 1);
+    }
+
+    // Wait for the socket to accept requests
+    struct timespec pause = {0, 10 * 1000 * 1000};
+    int result = 0;
+    for (int attempt = 0; attempt < 500 && result == 0; attempt++) {
+        result = request(SOCKET_PATH, "xx", 3, arguments, &status);
+        if (result == 0) nanosleep(&pause, NULL);
+    }
+    assert(result == 1 && status == 3);
+
+    char* directory = getcwd(NULL, 0);
+    char expected[4096];
+    snprintf(expected, sizeof(expected), "%s: tcc -O1 main.tc\n", directory);
+    assert(file_equals("test_server_out.txt", expected));
+    assert(file_equals("test_server_err.txt", "input x\n"));
+
+    // Requests run in the client's directory, and input left unread by one
+    // request does not reach the next
+    mkdir(CLIENT_DIR, 0777);
+    assert(chdir(CLIENT_DIR) == 0);
+    assert(request("../" SOCKET_PATH, "y", 1, arguments, &status) == 1 && status == 1);
+    snprintf(expected, sizeof(expected), "%s/" CLIENT_DIR ": tcc\n", directory);
+    assert(file_equals("test_server_out.txt", expected));
+    assert(file_equals("test_server_err.txt", "input y\n"));
+    unlink("test_server_in.txt");
+    unlink("test_server_out.txt");
+    unlink("test_server_err.txt");
+    assert(chdir("..") == 0);
+    rmdir(CLIENT_DIR);
+    free(directory);
+
+    // One server per socket
+    assert(!server_run(SOCKET_PATH, echo_handler, NULL));
+
+    // SIGTERM shuts the server down cleanly and removes the socket
+    assert(kill(server, SIGTERM) == 0);
+    int server_status;
+    assert(waitpid(server, &server_status, 0) == server);
+    assert(WIFEXITED(server_status) && WEXITSTATUS(server_status) == 0);
+    assert(access(SOCKET_PATH, F_OK) != 0);
+    assert(request(SOCKET_PATH, "x", 3, arguments, &status) == 0);
+
+    unlink("test_server_in.txt");
+    unlink("test_server_out.txt");
+    unlink("test_server_err.txt");
+
+    printf("✓ Server request test passed!\n\n");
+}
+
+void test_stale_socket() {
+    printf("Testing setup errors...\n");
+
+    // Some other file in the way is left alone
+    write_file(SOCKET_PATH, "not a socket");
+    assert(!server_run(SOCKET_PATH, echo_handler, NULL));
+    assert(file_equals(SOCKET_PATH, "not a socket"));
+    unlink(SOCKET_PATH);
+
+    char long_path[200];
+    memset(long_path, 'a', sizeof(long_path) - 1);
+    long_path[sizeof(long_path) - 1] = '\0';
+    assert(!server_run(long_path, echo_handler, NULL));
+
+    printf("✓ Setup error test passed!\n\n");
+}
+
+int main() {
+    printf("=== RUNNING COMPILE SERVER TESTS ===\n\n");
+
+    test_requests();
+    test_stale_socket();
+
+    printf("🎉 All compile server tests passed!\n");
+    return 0;
+}
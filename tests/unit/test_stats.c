@@ -0,0 +1,121 @@
+// tests/unit/test_stats.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/stats.h"
+
+// Test helper functions
+// Text written by print to a temporary file (static buffer)
+const char* capture(void (*print)(FILE*, const compile_stats_t*), const compile_stats_t* stats) {
+    static char buffer[8192];
+    FILE* file = tmpfile();
+    assert(file);
+    print(file, stats);
+    rewind(file);
+    size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    buffer[length] = '\0';
+    return buffer;
+}
+
+void write_json(FILE* output, const compile_stats_t* stats) {
+    static stats_phase_result_t link = {1, 0.25, 1, 0, 2048};
+    stats_write_json(output, stats, 1, &link);
+}
+
+void test_phases() {
+    printf("Testing phase measurements...\n");
+
+    compile_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+
+    stats_begin(&stats, STATS_PARSE);
+    char* block = malloc(4 << 20);
+    assert(block);
+    memset(block, 1, 4 << 20);
+    stats_end(&stats);
+
+    const stats_phase_result_t* parse = &stats.phases[STATS_PARSE];
+    assert(parse->ran);
+    assert(parse->seconds >= 0.0);
+    assert(parse->peak_rss_kb > 4096);
+    if (parse->heap_known) {
+        assert(parse->heap_bytes >= 4 << 20);
+    }
+    assert(!stats.phases[STATS_LEX].ran);
+
+    // Measuring a phase again adds to it
+    double seconds = parse->seconds;
+    long long heap_bytes = parse->heap_bytes;
+    stats_begin(&stats, STATS_PARSE);
+    free(block);
+    stats_end(&stats);
+    assert(parse->seconds >= seconds);
+    if (parse->heap_known) {
+        assert(parse->heap_bytes < heap_bytes);
+    }
+
+    assert(strcmp(stats_phase_name(STATS_LEX), "lex") == 0);
+    assert(strcmp(stats_phase_name(STATS_LINK), "link") == 0);
+    assert(strcmp(stats_phase_name(STATS_PHASE_COUNT), "unknown") == 0);
+
+    printf("✓ Phase measurement test passed!\n\n");
+}
+
+void test_reports() {
+    printf("Testing statistics reports...\n");
+
+    compile_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.input_file = "dir/\"odd\".tc";
+    stats.phases[STATS_LEX] = (stats_phase_result_t){1, 0.002, 1, 512, 1000};
+    stats.phases[STATS_CODEGEN] = (stats_phase_result_t){1, 0.5, 0, 0, 3000};
+    stats.tokens = 11;
+    stats.ast_nodes = 22;
+    stats.symbol_probes = 33;
+    stats.ir_instructions = 44;
+    stats.instructions = 55;
+    stats.optimizer.ast_folds = 3;
+    stats.optimizer.inlined_calls = 2;
+
+    // Phases that did not run are left out; unknown heap sizes say so
+    const char* text = capture(stats_print, &stats);
+    assert(strstr(text, "=== COMPILE STATISTICS: dir/\"odd\".tc ==="));
+    assert(strstr(text, "lex               2.000          0.5           1000\n"));
+    assert(strstr(text, "codegen         500.000          n/a           3000\n"));
+    assert(!strstr(text, "parse"));
+    assert(strstr(text, "tokens: 11, AST nodes: 22, symbol probes: 33\n"));
+    assert(strstr(text, "IR instructions: 44, machine instructions: 55\n"));
+    assert(strstr(text, "optimizer: ast_folds 3, inlined_calls 2\n"));
+
+    const char* json = capture(write_json, &stats);
+    assert(strstr(json, "\"input\": \"dir/\\\"odd\\\".tc\""));
+    assert(strstr(json, "\"cached\": false"));
+    assert(strstr(json, "\"lex\": {\"seconds\": 0.002000, \"heap_bytes\": 512, \"peak_rss_kb\": 1000}"));
+    assert(strstr(json, "\"codegen\": {\"seconds\": 0.500000, \"heap_bytes\": null, \"peak_rss_kb\": 3000}"));
+    assert(!strstr(json, "\"parse\""));
+    assert(strstr(json, "\"counters\": {\"tokens\": 11, \"ast_nodes\": 22, \"symbol_probes\": 33, "
+                        "\"ir_instructions\": 44, \"instructions\": 55}"));
+    assert(strstr(json, "\"ast_folds\": 3"));
+    assert(strstr(json, "\"loops_rotated\": 0"));
+    assert(strstr(json, "\"link\": {\"seconds\": 0.250000, \"heap_bytes\": 0, \"peak_rss_kb\": 2048}"));
+
+    // A cache hit has no phases to report
+    stats.cached = 1;
+    text = capture(stats_print, &stats);
+    assert(strstr(text, "taken from the cache"));
+    assert(!strstr(text, "tokens:"));
+
+    printf("✓ Statistics report test passed!\n\n");
+}
+
+int main() {
+    printf("=== RUNNING COMPILE STATISTICS TESTS ===\n\n");
+
+    test_phases();
+    test_reports();
+
+    printf("🎉 All compile statistics tests passed!\n");
+    return 0;
+}